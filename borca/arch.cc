@@ -17,8 +17,15 @@
  *
  */
 
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <fstream>
 #include <iostream>
 #include <math.h>
+#include "diskcache.h"
+#include "log.h"
 #include "nextpnr.h"
 #include "placer1.h"
 #include "placer_heap.h"
@@ -28,159 +35,11 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
-WireInfo &Arch::wire_info(IdString wire)
-{
-    auto w = wires.find(wire);
-    if (w == wires.end()) {
-        std::cout << wire.c_str(this) << '\n';
-        NPNR_ASSERT_FALSE_STR("no wire named " + wire.str(this));
-    }
-    return w->second;
-}
-
-PipInfo &Arch::pip_info(IdString pip)
-{
-    auto p = pips.find(pip);
-    if (p == pips.end())
-        NPNR_ASSERT_FALSE_STR("no pip named " + pip.str(this));
-    return p->second;
-}
-
-BelInfo &Arch::bel_info(IdString bel)
-{
-    auto b = bels.find(bel);
-    if (b == bels.end())
-        NPNR_ASSERT_FALSE_STR("no bel named " + bel.str(this));
-    return b->second;
-}
-
-void Arch::addWire(IdString name, IdString type, int x, int y)
-{
-    NPNR_ASSERT(wires.count(name) == 0);
-    WireInfo &wi = wires[name];
-    wi.name = name;
-    wi.type = type;
-    wi.x = x;
-    wi.y = y;
-
-    wire_ids.push_back(name);
-}
-
-void Arch::addPip(IdString name, IdString type, IdString srcWire, IdString dstWire, DelayInfo delay, Loc loc)
-{
-    NPNR_ASSERT(pips.count(name) == 0);
-    PipInfo &pi = pips[name];
-    pi.name = name;
-    pi.type = type;
-    pi.srcWire = srcWire;
-    pi.dstWire = dstWire;
-    pi.delay = delay;
-    pi.loc = loc;
-
-    wire_info(srcWire).downhill.push_back(name);
-    wire_info(dstWire).uphill.push_back(name);
-    pip_ids.push_back(name);
-
-    if (int(tilePipDimZ.size()) <= loc.x)
-        tilePipDimZ.resize(loc.x + 1);
-
-    if (int(tilePipDimZ[loc.x].size()) <= loc.y)
-        tilePipDimZ[loc.x].resize(loc.y + 1);
-
-    gridDimX = std::max(gridDimX, loc.x + 1);
-    gridDimY = std::max(gridDimY, loc.x + 1);
-    tilePipDimZ[loc.x][loc.y] = std::max(tilePipDimZ[loc.x][loc.y], loc.z + 1);
-}
-
-void Arch::addAlias(IdString name, IdString type, IdString srcWire, IdString dstWire, DelayInfo delay)
-{
-    NPNR_ASSERT(pips.count(name) == 0);
-    PipInfo &pi = pips[name];
-    pi.name = name;
-    pi.type = type;
-    pi.srcWire = srcWire;
-    pi.dstWire = dstWire;
-    pi.delay = delay;
-
-    wire_info(srcWire).aliases.push_back(name);
-    pip_ids.push_back(name);
-}
-
-void Arch::addBel(IdString name, IdString type, Loc loc, bool gb)
-{
-    NPNR_ASSERT(bels.count(name) == 0);
-    NPNR_ASSERT(bel_by_loc.count(loc) == 0);
-    BelInfo &bi = bels[name];
-    bi.name = name;
-    bi.type = type;
-    bi.x = loc.x;
-    bi.y = loc.y;
-    bi.z = loc.z;
-    bi.gb = gb;
-
-    bel_ids.push_back(name);
-    bel_by_loc[loc] = name;
-
-    if (int(bels_by_tile.size()) <= loc.x)
-        bels_by_tile.resize(loc.x + 1);
+void Arch::addGroupBel(IdString group, IdString bel) { groups[group].bels.push_back(getBelByName(bel)); }
 
-    if (int(bels_by_tile[loc.x].size()) <= loc.y)
-        bels_by_tile[loc.x].resize(loc.y + 1);
+void Arch::addGroupWire(IdString group, IdString wire) { groups[group].wires.push_back(getWireByName(wire)); }
 
-    bels_by_tile[loc.x][loc.y].push_back(name);
-
-    if (int(tileBelDimZ.size()) <= loc.x)
-        tileBelDimZ.resize(loc.x + 1);
-
-    if (int(tileBelDimZ[loc.x].size()) <= loc.y)
-        tileBelDimZ[loc.x].resize(loc.y + 1);
-
-    gridDimX = std::max(gridDimX, loc.x + 1);
-    gridDimY = std::max(gridDimY, loc.x + 1);
-    tileBelDimZ[loc.x][loc.y] = std::max(tileBelDimZ[loc.x][loc.y], loc.z + 1);
-}
-
-void Arch::addBelInput(IdString bel, IdString name, IdString wire)
-{
-    NPNR_ASSERT(bel_info(bel).pins.count(name) == 0);
-    PinInfo &pi = bel_info(bel).pins[name];
-    pi.name = name;
-    pi.wire = wire;
-    pi.type = PORT_IN;
-
-    wire_info(wire).downhill_bel_pins.push_back(BelPin{bel, name});
-    wire_info(wire).bel_pins.push_back(BelPin{bel, name});
-}
-
-void Arch::addBelOutput(IdString bel, IdString name, IdString wire)
-{
-    NPNR_ASSERT(bel_info(bel).pins.count(name) == 0);
-    PinInfo &pi = bel_info(bel).pins[name];
-    pi.name = name;
-    pi.wire = wire;
-    pi.type = PORT_OUT;
-
-    wire_info(wire).uphill_bel_pin = BelPin{bel, name};
-    wire_info(wire).bel_pins.push_back(BelPin{bel, name});
-}
-
-void Arch::addBelInout(IdString bel, IdString name, IdString wire)
-{
-    NPNR_ASSERT(bel_info(bel).pins.count(name) == 0);
-    PinInfo &pi = bel_info(bel).pins[name];
-    pi.name = name;
-    pi.wire = wire;
-    pi.type = PORT_INOUT;
-
-    wire_info(wire).downhill_bel_pins.push_back(BelPin{bel, name});
-    wire_info(wire).bel_pins.push_back(BelPin{bel, name});
-}
-
-void Arch::addGroupBel(IdString group, IdString bel) { groups[group].bels.push_back(bel); }
-
-void Arch::addGroupWire(IdString group, IdString wire) { groups[group].wires.push_back(wire); }
-
-void Arch::addGroupPip(IdString group, IdString pip) { groups[group].pips.push_back(pip); }
+void Arch::addGroupPip(IdString group, IdString pip) { groups[group].pips.push_back(getPipByName(pip)); }
 
 void Arch::addGroupGroup(IdString group, IdString grp) { groups[group].groups.push_back(grp); }
 
@@ -192,19 +51,19 @@ void Arch::addDecalGraphic(DecalId decal, const GraphicElement &graphic)
 
 void Arch::setWireDecal(WireId wire, DecalXY decalxy)
 {
-    wire_info(wire).decalxy = decalxy;
+    wire_decals[wire] = decalxy;
     refreshUiWire(wire);
 }
 
 void Arch::setPipDecal(PipId pip, DecalXY decalxy)
 {
-    pip_info(pip).decalxy = decalxy;
+    pip_decals[pip] = decalxy;
     refreshUiPip(pip);
 }
 
 void Arch::setBelDecal(BelId bel, DecalXY decalxy)
 {
-    bel_info(bel).decalxy = decalxy;
+    bel_decals[bel] = decalxy;
     refreshUiBel(bel);
 }
 
@@ -214,11 +73,29 @@ void Arch::setGroupDecal(GroupId group, DecalXY decalxy)
     refreshUiGroup(group);
 }
 
-void Arch::setWireAttr(IdString wire, IdString key, const std::string &value) { wire_info(wire).attrs[key] = value; }
+void Arch::setWireAttr(IdString wire, IdString key, const std::string &value)
+{
+    WireId w = getWireByName(wire);
+    if (w == WireId())
+        NPNR_ASSERT_FALSE_STR("no wire named " + wire.str(this));
+    wire_attrs[w][key] = value;
+}
 
-void Arch::setPipAttr(IdString pip, IdString key, const std::string &value) { pip_info(pip).attrs[key] = value; }
+void Arch::setPipAttr(IdString pip, IdString key, const std::string &value)
+{
+    PipId p = getPipByName(pip);
+    if (p == PipId())
+        NPNR_ASSERT_FALSE_STR("no pip named " + pip.str(this));
+    pip_attrs[p][key] = value;
+}
 
-void Arch::setBelAttr(IdString bel, IdString key, const std::string &value) { bel_info(bel).attrs[key] = value; }
+void Arch::setBelAttr(IdString bel, IdString key, const std::string &value)
+{
+    BelId b = getBelByName(bel);
+    if (b == BelId())
+        NPNR_ASSERT_FALSE_STR("no bel named " + bel.str(this));
+    bel_attrs[b][key] = value;
+}
 
 void Arch::setLutK(int K) { args.K = K; }
 
@@ -228,2085 +105,221 @@ void Arch::setDelayScaling(double scale, double offset)
     args.delayOffset = offset;
 }
 
-void Arch::addCellTimingClock(IdString cell, IdString port) { cellTiming[cell].portClasses[port] = TMG_CLOCK_INPUT; }
+// The constant drivers made by the packer are slices too, but have no timing: their outputs are false startpoints
+// rather than slice outputs
+const CellTiming *Arch::getCellTiming(const CellInfo *cell) const
+{
+    if (cell->name == packerGndName || cell->name == packerVccName)
+        return nullptr;
+    return cellTimings.get(cell);
+}
+
+void Arch::addCellTimingClock(IdString cell, IdString port) { cellTimings.cell_for_update(cell).add_clock(port); }
 
 void Arch::addCellTimingDelay(IdString cell, IdString fromPort, IdString toPort, DelayInfo delay)
 {
-    if (get_or_default(cellTiming[cell].portClasses, fromPort, TMG_IGNORE) == TMG_IGNORE)
-        cellTiming[cell].portClasses[fromPort] = TMG_COMB_INPUT;
-    if (get_or_default(cellTiming[cell].portClasses, toPort, TMG_IGNORE) == TMG_IGNORE)
-        cellTiming[cell].portClasses[toPort] = TMG_COMB_OUTPUT;
-    cellTiming[cell].combDelays[CellDelayKey{fromPort, toPort}] = delay;
+    cellTimings.cell_for_update(cell).add_delay(fromPort, toPort, delay);
 }
 
 void Arch::addCellTimingSetupHold(IdString cell, IdString port, IdString clock, DelayInfo setup, DelayInfo hold)
 {
-    TimingClockingInfo ci;
-    ci.clock_port = clock;
-    ci.edge = RISING_EDGE;
-    ci.setup = setup;
-    ci.hold = hold;
-    cellTiming[cell].clockingInfo[port].push_back(ci);
-    cellTiming[cell].portClasses[port] = TMG_REGISTER_INPUT;
+    cellTimings.cell_for_update(cell).add_setup_hold(port, clock, setup, hold);
 }
 
 void Arch::addCellTimingClockToOut(IdString cell, IdString port, IdString clock, DelayInfo clktoq)
 {
-    TimingClockingInfo ci;
-    ci.clock_port = clock;
-    ci.edge = RISING_EDGE;
-    ci.clockToQ = clktoq;
-    cellTiming[cell].clockingInfo[port].push_back(ci);
-    cellTiming[cell].portClasses[port] = TMG_REGISTER_OUTPUT;
+    cellTimings.cell_for_update(cell).add_clock_to_out(port, clock, clktoq);
 }
 
-// ---------------------------------------------------------------
-
-void Arch::setupPipsForCLB(int x, int y, int numSingleWires, int numDoubleWires, int side) {
-
-    std::string CBType = "";
-    int xWire = x;
-    int yWire = y;
-    int lut0Id = 1;
-    int lut1Id = 0;
-    int dff0Id = 1;
-    int dff1Id = 0;
-
-    if (side == 0) {
-        // East
-        CBType = "CB0";
-        xWire = x;
-        yWire = y;
-        lut0Id = 1;
-        lut1Id = 0;
-        dff0Id = 1 + 8;
-        dff1Id = 0 + 8;
-    } else if (side == 1) {
-        // South
-        CBType = "CB1";
-        xWire = x;
-        yWire = y - 1;
-        lut0Id = 3;
-        lut1Id = 2;
-        dff0Id = 3 + 8;
-        dff1Id = 2 + 8;
-    } else if (side == 2) {
-        // West
-        CBType = "CB0";
-        xWire = x - 1;
-        yWire = y;
-        lut0Id = 5;
-        lut1Id = 4;
-        dff0Id = 5 + 8;
-        dff1Id = 4 + 8;
-    } else if (side == 3) {
-        // North
-        CBType = "CB1";
-        xWire = x;
-        yWire = y;
-        lut0Id = 7;
-        lut1Id = 6;
-        dff0Id = 7 + 8;
-        dff1Id = 6 + 8;
-    }
-
-    NPNR_ASSERT(side < 4);
-
-    if (xWire < 0 || yWire < 0)
-        return;
-
-    // PipInfo
-    IdString pipType = id("PIP");
-
-    // CLB inputs <- ConnectionBlock
-    for (int k = 0; k < 4; k++) {
-        std::string lut1_input_name = "X" + std::to_string(x) +
-                                      "Y" + std::to_string(y) +
-                                      "Z" + std::to_string(lut0Id) +
-                                      "_" + "I" + std::to_string(k);
-        WireId dst1Wire = getWireByName(id(lut1_input_name));
-        std::string lut0_input_name = "X" + std::to_string(x) +
-                                      "Y" + std::to_string(y) +
-                                      "Z" + std::to_string(lut1Id) +
-                                      "_" + "I" + std::to_string(k);
-        WireId dst0Wire = getWireByName(id(lut0_input_name));
-
-        for (int s = 0; s < numSingleWires; s++) {
-            std::string cb_single0_in_name = "X" + std::to_string(xWire) +
-                                             "Y" + std::to_string(yWire) + "_" +
-                                             CBType + "_SINGLE0_IN" + std::to_string(s);
-            std::string cb_single1_in_name = "X" + std::to_string(xWire) +
-                                             "Y" + std::to_string(yWire) + "_" +
-                                             CBType + "_SINGLE1_IN" + std::to_string(s);
-
-            WireId src0Wire = getWireByName(id(cb_single0_in_name));
-            WireId src1Wire = getWireByName(id(cb_single1_in_name));
-
-            std::string pip00Name = "X" + std::to_string(xWire) +
-                                    "Y" + std::to_string(yWire) + "_" +
-                                    CBType + "_SINGLE0_" + std::to_string(s) +
-                                    "->LUT" + std::to_string(lut1Id) + "_I" +
-                                   std::to_string(k);
-            std::string pip01Name = "X" + std::to_string(xWire) +
-                                    "Y" + std::to_string(yWire) + "_" +
-                                    CBType + "_SINGLE0_" + std::to_string(s) +
-                                    "->LUT" + std::to_string(lut0Id) + "_I" +
-                                   std::to_string(k);
-
-            std::string pip10Name = "X" + std::to_string(xWire) +
-                                    "Y" + std::to_string(yWire) + "_" +
-                                    CBType + "_SINGLE1_" + std::to_string(s) +
-                                    "->LUT" + std::to_string(lut1Id) + "_I" +
-                                    std::to_string(k);
-
-            std::string pip11Name = "X" + std::to_string(xWire) +
-                                    "Y" + std::to_string(yWire) + "_" +
-                                    CBType + "_SINGLE1_" + std::to_string(s) +
-                                    "->LUT" + std::to_string(lut0Id) + "_I" +
-                                    std::to_string(k);
-
-            addPip(id(pip00Name), pipType, getWireName(src0Wire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pip01Name), pipType, getWireName(src0Wire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-            addPip(id(pip10Name), pipType, getWireName(src1Wire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pip11Name), pipType, getWireName(src1Wire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        }
+void Arch::addCellTypeTimingClock(IdString type, IdString port) { cellTimings.type_for_update(type).add_clock(port); }
 
-        for (int s = 0; s < numDoubleWires; s++) {
-            std::string cb_double0_in_name = "X" + std::to_string(xWire) +
-                                             "Y" + std::to_string(yWire) + "_" +
-                                             CBType + "_DOUBLE0_IN" + std::to_string(s);
-            std::string cb_double1_in_name = "X" + std::to_string(xWire) +
-                                             "Y" + std::to_string(yWire) + "_" +
-                                             CBType + "_DOUBLE1_IN" + std::to_string(s);
-
-            WireId src0Wire = getWireByName(id(cb_double0_in_name));
-            WireId src1Wire = getWireByName(id(cb_double1_in_name));
-
-            std::string pip00Name = "X" + std::to_string(xWire) +
-                                    "Y" + std::to_string(yWire) + "_" +
-                                    CBType + "_DOUBLE0_" + std::to_string(s) +
-                                    "->LUT" + std::to_string(lut1Id) + "_I" +
-                                    std::to_string(k);
-
-            std::string pip01Name = "X" + std::to_string(xWire) +
-                                    "Y" + std::to_string(yWire) + "_" +
-                                    CBType + "_DOUBLE0_" + std::to_string(s) +
-                                    "->LUT" + std::to_string(lut0Id) + "_I" +
-                                    std::to_string(k);
-
-            std::string pip10Name = "X" + std::to_string(xWire) +
-                                    "Y" + std::to_string(yWire) + "_" +
-                                    CBType + "_DOUBLE1_" + std::to_string(s) +
-                                    "->LUT" + std::to_string(lut1Id) + "_I" +
-                                    std::to_string(k);
-
-            std::string pip11Name = "X" + std::to_string(xWire) +
-                                    "Y" + std::to_string(yWire) + "_" +
-                                    CBType + "_DOUBLE1_" + std::to_string(s) +
-                                    "->LUT" + std::to_string(lut0Id) + "_I" +
-                                    std::to_string(k);
-
-            addPip(id(pip00Name), pipType, getWireName(src0Wire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pip01Name), pipType, getWireName(src0Wire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pip10Name), pipType, getWireName(src1Wire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pip11Name), pipType, getWireName(src1Wire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        }
-    }
-
-    // CLB outputs -> ConnectionBlock
-    std::string clb_comb0_output_name = "X" + std::to_string(x) +
-                                        "Y" + std::to_string(y) +
-                                        "CLB_COMB" + std::to_string(lut1Id);
-    WireId src0CombWire = getWireByName(id(clb_comb0_output_name));
-
-    std::string clb_comb1_output_name = "X" + std::to_string(x) +
-                                        "Y" + std::to_string(y) +
-                                        "CLB_COMB" + std::to_string(lut0Id);
-    WireId src1CombWire = getWireByName(id(clb_comb1_output_name));
-
-    std::string clb_sync0_output_name = "X" + std::to_string(x) +
-                                        "Y" + std::to_string(y) +
-                                        "CLB_SYNC" + std::to_string(dff1Id - 8);
-    WireId src0SyncWire = getWireByName(id(clb_sync0_output_name));
-
-    std::string clb_sync1_output_name = "X" + std::to_string(x) +
-                                        "Y" + std::to_string(y) +
-                                        "CLB_SYNC" + std::to_string(dff0Id - 8);
-    WireId src1SyncWire = getWireByName(id(clb_sync1_output_name));
-
-    for (int s = 0; s < numSingleWires; s++) {
-        std::string cb_single0_out_name = "X" + std::to_string(xWire) +
-                                          "Y" + std::to_string(yWire) +
-                                          "_" + CBType + "_SINGLE0_OUT" + std::to_string(s);
-        std::string cb_single1_out_name = "X" + std::to_string(xWire) +
-                                          "Y" + std::to_string(yWire) +
-                                          "_" + CBType + "_SINGLE1_OUT" + std::to_string(s);
-
-        WireId dst0Wire = getWireByName(id(cb_single0_out_name));
-        WireId dst1Wire = getWireByName(id(cb_single1_out_name));
-
-        std::string pip00LutName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_COMB_O" + std::to_string(lut1Id) +
-                                   "->" + CBType + "_SINGLE0_" + std::to_string(s);
-        std::string pip01LutName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_COMB_O" + std::to_string(lut1Id) +
-                                   "->" + CBType + "_SINGLE1_" + std::to_string(s);
-
-        std::string pip10LutName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_COMB_O" + std::to_string(lut0Id) +
-                                   "->" + CBType + "_SINGLE0_" + std::to_string(s);
-        std::string pip11LutName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_COMB_O" + std::to_string(lut0Id) +
-                                   "->" + CBType + "_SINGLE1_" + std::to_string(s);
-
-        std::string pip00DffName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_SYNC_O" + std::to_string(dff1Id - 8) +
-                                   "->" + CBType + "_SINGLE0_" + std::to_string(s);
-        std::string pip01DffName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_SYNC_O" + std::to_string(dff1Id - 8) +
-                                   "->" + CBType + "_SINGLE1_" + std::to_string(s);
-
-        std::string pip10DffName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_SYNC_O" + std::to_string(dff0Id - 8) +
-                                   "->" + CBType + "_SINGLE0_" + std::to_string(s);
-        std::string pip11DffName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_SYNC_O" + std::to_string(dff0Id - 8) +
-                                   "->" + CBType + "_SINGLE1_" + std::to_string(s);
-
-        addPip(id(pip00LutName), pipType, getWireName(src0CombWire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        addPip(id(pip01LutName), pipType, getWireName(src0CombWire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-        addPip(id(pip10LutName), pipType, getWireName(src1CombWire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        addPip(id(pip11LutName), pipType, getWireName(src1CombWire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-        addPip(id(pip00DffName), pipType, getWireName(src0SyncWire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        addPip(id(pip01DffName), pipType, getWireName(src0SyncWire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-        addPip(id(pip10DffName), pipType, getWireName(src1SyncWire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        addPip(id(pip11DffName), pipType, getWireName(src1SyncWire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-    }
-
-    for (int s = 0; s < numDoubleWires / 2; s++) {
-        std::string cb_double0_out_name = "X" + std::to_string(xWire) +
-                                          "Y" + std::to_string(yWire) +
-                                          "_" + CBType + "_DOUBLE0_OUT" + std::to_string(s);
-        std::string cb_double1_out_name = "X" + std::to_string(xWire) +
-                                          "Y" + std::to_string(yWire) +
-                                          "_" + CBType + "_DOUBLE1_OUT" + std::to_string(s);
-
-        WireId dst0Wire = getWireByName(id(cb_double0_out_name));
-        WireId dst1Wire = getWireByName(id(cb_double1_out_name));
-
-        std::string pip00LutName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_COMB_O" + std::to_string(lut1Id) +
-                                   "->" + CBType + "_DOUBLE0_" + std::to_string(s);
-        std::string pip01LutName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_COMB_O" + std::to_string(lut1Id) +
-                                   "->" + CBType + "_DOUBLE1_" + std::to_string(s);
-
-        std::string pip10LutName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_COMB_O" + std::to_string(lut0Id) +
-                                   "->" + CBType + "_DOUBLE0_" + std::to_string(s);
-        std::string pip11LutName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_COMB_O" + std::to_string(lut0Id) +
-                                   "->" + CBType + "_DOUBLE1_" + std::to_string(s);
-
-        std::string pip00DffName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_SYNC_O" + std::to_string(dff1Id) +
-                                   "->" + CBType + "_DOUBLE0_" + std::to_string(s);
-        std::string pip01DffName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_SYNC_O" + std::to_string(dff1Id) +
-                                   "->" + CBType + "_DOUBLE1_" + std::to_string(s);
-
-        std::string pip10DffName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_SYNC_O" + std::to_string(dff0Id) +
-                                   "->" + CBType + "_DOUBLE0_" + std::to_string(s);
-        std::string pip11DffName = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "_CLB_SYNC_O" + std::to_string(dff0Id) +
-                                   "->" + CBType + "_DOUBLE1_" + std::to_string(s);
-
-        addPip(id(pip00LutName), pipType, getWireName(src0CombWire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        addPip(id(pip01LutName), pipType, getWireName(src0CombWire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-        addPip(id(pip10LutName), pipType, getWireName(src1CombWire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        addPip(id(pip11LutName), pipType, getWireName(src1CombWire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-        addPip(id(pip00DffName), pipType, getWireName(src0SyncWire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        addPip(id(pip01DffName), pipType, getWireName(src0SyncWire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-        addPip(id(pip10DffName), pipType, getWireName(src1SyncWire), getWireName(dst0Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-        addPip(id(pip11DffName), pipType, getWireName(src1SyncWire), getWireName(dst1Wire), getDelayFromNS(0.01), Loc(x, y, 0));
-    }
-
-    // Direct connections between the CLBs
-    // CLB0 -> CLB1
-    for (int i = 0; i < 4; i++) {
-        std::string pipCLB0Comb0_CLB1LUT1In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB0_COMB_O" + std::to_string(lut1Id) +
-                                              "->" + "CLB1_LUT1_I" + std::to_string(i);
-        std::string pipCLB0Comb0_CLB1LUT0In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB0_COMB_O" + std::to_string(lut1Id) +
-                                              "->" + "CLB1_LUT0_I" + std::to_string(i);
-
-        std::string pipCLB0Comb1_CLB1LUT1In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB0_COMB_O" + std::to_string(lut0Id) +
-                                              "->" + "CLB1_LUT1_I" + std::to_string(i);
-        std::string pipCLB0Comb1_CLB1LUT0In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB0_COMB_O" + std::to_string(lut0Id) +
-                                              "->" + "CLB1_LUT0_I" + std::to_string(i);
-
-        std::string pipCLB0Sync0_CLB1LUT1In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB0_SYNC_O" + std::to_string(lut1Id) +
-                                              "->" + "CLB1_LUT1_I" + std::to_string(i);
-        std::string pipCLB0Sync0_CLB1LUT0In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB0_SYNC_O" + std::to_string(lut1Id) +
-                                              "->" + "CLB1_LUT0_I" + std::to_string(i);
-
-        std::string pipCLB0Sync1_CLB1LUT1In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB0_SYNC_O" + std::to_string(lut0Id) +
-                                              "->" + "CLB1_LUT1_I" + std::to_string(i);
-        std::string pipCLB0Sync1_CLB1LUT0In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB0_SYNC_O" + std::to_string(lut0Id) +
-                                              "->" + "CLB1_LUT0_I" + std::to_string(i);
-
-        if (side == 0 && x + 1 < gridDimX) {
-            // East side
-            std::string lut1_in_name = "X" + std::to_string(x + 1) +
-                                       "Y" + std::to_string(y) +
-                                       "Z5_" + 
-                                       "I" + std::to_string(i);
-
-            std::string lut0_in_name = "X" + std::to_string(x + 1) +
-                                       "Y" + std::to_string(y) +
-                                       "Z4_" +
-                                       "I" + std::to_string(i);
-
-            WireId lut1InWire = getWireByName(id(lut1_in_name));
-            WireId lut0InWire = getWireByName(id(lut0_in_name));
-
-            addPip(id(pipCLB0Comb0_CLB1LUT1In), pipType, src0CombWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Comb0_CLB1LUT0In), pipType, src0CombWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Comb1_CLB1LUT1In), pipType, src1CombWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Comb1_CLB1LUT0In), pipType, src1CombWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-            addPip(id(pipCLB0Sync0_CLB1LUT1In), pipType, src0SyncWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Sync0_CLB1LUT0In), pipType, src0SyncWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Sync1_CLB1LUT1In), pipType, src1SyncWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Sync1_CLB1LUT0In), pipType, src1SyncWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-        } else if (side == 3 && y + 1 < gridDimY) {
-            // North side
-            std::string lut1_in_name = "X" + std::to_string(x) +
-                                       "Y" + std::to_string(y + 1) +
-                                       "Z3_" +
-                                       "I" + std::to_string(i);
-
-            std::string lut0_in_name = "X" + std::to_string(x) +
-                                       "Y" + std::to_string(y + 1) +
-                                       "Z2_" +
-                                       "I" + std::to_string(i);
-
-            WireId lut1InWire = getWireByName(id(lut1_in_name));
-            WireId lut0InWire = getWireByName(id(lut0_in_name));
-
-            addPip(id(pipCLB0Comb0_CLB1LUT1In), pipType, src0CombWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Comb0_CLB1LUT0In), pipType, src0CombWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Comb1_CLB1LUT1In), pipType, src1CombWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Comb1_CLB1LUT0In), pipType, src1CombWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-            addPip(id(pipCLB0Sync0_CLB1LUT1In), pipType, src0SyncWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Sync0_CLB1LUT0In), pipType, src0SyncWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Sync1_CLB1LUT1In), pipType, src1SyncWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB0Sync1_CLB1LUT0In), pipType, src1SyncWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-        }
-    }
-
-    // CLB1 -> CLB0
-    for (int i = 0; i < 4; i++) {
-        std::string pipCLB1Comb0_CLB0LUT1In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB1_COMB_O" + std::to_string(lut1Id) +
-                                              "->" + "CLB0_LUT1_I" + std::to_string(i);
-        std::string pipCLB1Comb0_CLB0LUT0In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB1_COMB_O" + std::to_string(lut1Id) +
-                                              "->" + "CLB0_LUT0_I" + std::to_string(i);
-
-        std::string pipCLB1Comb1_CLB0LUT1In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB1_COMB_O" + std::to_string(lut0Id) +
-                                              "->" + "CLB0_LUT1_I" + std::to_string(i);
-        std::string pipCLB1Comb1_CLB0LUT0In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB1_COMB_O" + std::to_string(lut0Id) +
-                                              "->" + "CLB0_LUT0_I" + std::to_string(i);
-
-        std::string pipCLB1Sync0_CLB0LUT1In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB1_SYNC_O" + std::to_string(lut1Id) +
-                                              "->" + "CLB0_LUT1_I" + std::to_string(i);
-        std::string pipCLB1Sync0_CLB0LUT0In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB1_SYNC_O" + std::to_string(lut1Id) +
-                                              "->" + "CLB0_LUT0_I" + std::to_string(i);
-
-        std::string pipCLB1Sync1_CLB0LUT1In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB1_SYNC_O" + std::to_string(lut0Id) +
-                                              "->" + "CLB0_LUT1_I" + std::to_string(i);
-        std::string pipCLB1Sync1_CLB0LUT0In = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CLB1_SYNC_O" + std::to_string(lut0Id) +
-                                              "->" + "CLB0_LUT0_I" + std::to_string(i);
-
-        if (side == 2 && x - 1 >= 0) {
-            // West side
-            std::string lut1_in_name = "X" + std::to_string(x - 1) +
-                                       "Y" + std::to_string(y) +
-                                       "Z1_" +
-                                       "I" + std::to_string(i);
-
-            std::string lut0_in_name = "X" + std::to_string(x - 1) +
-                                       "Y" + std::to_string(y) +
-                                       "Z0_" +
-                                       "I" + std::to_string(i);
-
-            WireId lut1InWire = getWireByName(id(lut1_in_name));
-            WireId lut0InWire = getWireByName(id(lut0_in_name));
-
-            addPip(id(pipCLB1Comb0_CLB0LUT1In), pipType, src0CombWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Comb0_CLB0LUT0In), pipType, src0CombWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Comb1_CLB0LUT1In), pipType, src1CombWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Comb1_CLB0LUT0In), pipType, src1CombWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-            addPip(id(pipCLB1Sync0_CLB0LUT1In), pipType, src0SyncWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Sync0_CLB0LUT0In), pipType, src0SyncWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Sync1_CLB0LUT1In), pipType, src1SyncWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Sync1_CLB0LUT0In), pipType, src1SyncWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-        } else if (side == 1 && y - 1 >= 0) {
-            // South side
-            std::string lut1_in_name = "X" + std::to_string(x) +
-                                       "Y" + std::to_string(y - 1) +
-                                       "Z7_" +
-                                       "I" + std::to_string(i);
-
-            std::string lut0_in_name = "X" + std::to_string(x) +
-                                       "Y" + std::to_string(y - 1) +
-                                       "Z6_" +
-                                       "I" + std::to_string(i);
-
-            WireId lut1InWire = getWireByName(id(lut1_in_name));
-            WireId lut0InWire = getWireByName(id(lut0_in_name));
-
-            addPip(id(pipCLB1Comb0_CLB0LUT1In), pipType, src0CombWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Comb0_CLB0LUT0In), pipType, src0CombWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Comb1_CLB0LUT1In), pipType, src1CombWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Comb1_CLB0LUT0In), pipType, src1CombWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-
-            addPip(id(pipCLB1Sync0_CLB0LUT1In), pipType, src0SyncWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Sync0_CLB0LUT0In), pipType, src0SyncWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Sync1_CLB0LUT1In), pipType, src1SyncWire, getWireName(lut1InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCLB1Sync1_CLB0LUT0In), pipType, src1SyncWire, getWireName(lut0InWire), getDelayFromNS(0.01), Loc(x, y, 0));
-        }
-    }
+void Arch::addCellTypeTimingDelay(IdString type, IdString fromPort, IdString toPort, DelayInfo delay)
+{
+    cellTimings.type_for_update(type).add_delay(fromPort, toPort, delay);
 }
 
-void Arch::setupPipsForSB(int x, int y, int s, int dir1, int dir2) {
-
-    IdString pipType = id("PIP");
-
-    std::string dir1Name = "";
-    std::string dir2Name = "";
-
-    // E:0, S:1, W:2, N:3
-
-    if (dir1 == 0) {
-        dir1Name = "E";
-    } else if (dir1 == 1) {
-        dir1Name = "S";
-    } else if (dir1 == 2) {
-        dir1Name = "W";
-    } else if (dir1 == 3) {
-        dir1Name = "N";
-    }
-
-    if (dir2 == 0) {
-        dir2Name = "E";
-    } else if (dir2 == 1) {
-        dir2Name = "S";
-    } else if (dir2 == 2) {
-        dir2Name = "W";
-    } else if (dir2 == 3) {
-        dir2Name = "N";
-    }
-
-    bool switch_wire = false;
-    if ((dir1Name == "N" && dir2Name == "W") ||
-        (dir1Name == "W" && dir2Name == "N") ||
-        (dir1Name == "E" && dir2Name == "S") ||
-        (dir1Name == "S" && dir2Name == "E"))
-        switch_wire = true;
-
-    int s1 = s;
-    int s2 = s;
-
-    if (switch_wire) {
-        if (s1 % 2 == 0)
-            s2 = s1 + 1;
-        else
-            s2 = s1 - 1;   
-    }
-
-    std::string sbDir1SingleWireOutName = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "_SB_" + dir1Name + "_SINGLE_OUT" +
-                                          std::to_string(s1);
-
-    std::string sbDir2SingleWireInName = "X" + std::to_string(x) +
-                                         "Y" + std::to_string(y) +
-                                         "_SB_" + dir2Name + "_SINGLE_IN" +
-                                         std::to_string(s2);
-
-    std::string pipDir1toDir2SingleName = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "_SB_" + dir1Name + std::to_string(s1) +
-                                          dir2Name + std::to_string(s2) + "_SINGLE";
-
-    WireId sbDir1SingleWireOut = getWireByName(id(sbDir1SingleWireOutName));
-    WireId sbDir2SingleWireIn  = getWireByName(id(sbDir2SingleWireInName));
-
-    addPip(id(pipDir1toDir2SingleName), pipType, getWireName(sbDir1SingleWireOut),
-           getWireName(sbDir2SingleWireIn), getDelayFromNS(0.01), Loc(x, y, 0));
-
-    std::string sbDir1DoubleWireOutName = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "_SB_" + dir1Name + "_DOUBLE_OUT" +
-                                          std::to_string(s1);
-    std::string sbDir2DoubleWireInName = "X" + std::to_string(x) +
-                                         "Y" + std::to_string(y) +
-                                         "_SB_" + dir2Name + "_DOUBLE_IN" +
-                                         std::to_string(s2);
-    std::string pipDir1toDir2DoubleName = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "_SB_" + dir1Name + std::to_string(s1) +
-                                          dir2Name + std::to_string(s2) + "_DOUBLE";
-    WireId sbDir1DoubleWireOut = getWireByName(id(sbDir1DoubleWireOutName));
-    WireId sbDir2DoubleWireIn  = getWireByName(id(sbDir2DoubleWireInName));
-
-    addPip(id(pipDir1toDir2DoubleName), pipType, getWireName(sbDir1DoubleWireOut),
-           getWireName(sbDir2DoubleWireIn), getDelayFromNS(0.01), Loc(x, y, 0));
+void Arch::addCellTypeTimingSetupHold(IdString type, IdString port, IdString clock, DelayInfo setup,
+                                      DelayInfo hold)
+{
+    cellTimings.type_for_update(type).add_setup_hold(port, clock, setup, hold);
+}
 
+void Arch::addCellTypeTimingClockToOut(IdString type, IdString port, IdString clock, DelayInfo clktoq)
+{
+    cellTimings.type_for_update(type).add_clock_to_out(port, clock, clktoq);
 }
 
+// ---------------------------------------------------------------
+
 Arch::Arch(ArchArgs args) : chipName("borca"), args(args)
 {
     // Dummy for empty decals
     decal_graphics[IdString()];
-    gridDimX = 8;
-    gridDimY = 8;
-
-    // Number of cells per Tile
-    // 8 4-LUTs, 8 FFs, 1 CARRY4, 3 MUXES
-    int numBelsPerTile = 8 + 8 + 1 + 3;
-    // Number of PIPs per Tile
-    // 2 x CB + SB
-    int numPipsPerTile = 415 * 2 + 48;
-
-    for (int x = 0; x < gridDimX; x++) {
-      std::vector<int> tmp0, tmp1;
-      for (int y = 0; y < gridDimY; y++) {
-        tmp0.push_back(numBelsPerTile);
-        tmp1.push_back(numPipsPerTile);
-      }
-      tileBelDimZ.push_back(tmp0);
-      tilePipDimZ.push_back(tmp1);
-    }
-
-    // WireInfo & BelInfo
-    IdString belInputType  = id("BEL_INPUT");
-    IdString belOutputType = id("BEL_OUTPUT");
-
-    for (int x = 0; x < gridDimX; x++) {
-      for (int y = 0; y < gridDimY; y++) {
-        for (int z = 0; z < numBelsPerTile; z++) {
-          if (z >= 0 && z < 8) {
-            // LUTs
-            std::string i0Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "I0";
-            std::string i1Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "I1";
-            std::string i2Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "I2";
-            std::string i3Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "I3";
-            std::string outName = "X" + std::to_string(x) +
-                                  "Y" + std::to_string(y) +
-                                  "Z" + std::to_string(z) + "_" + "O";
-            addWire(id(i0Name),  belInputType, x, y);
-            addWire(id(i1Name),  belInputType, x, y);
-            addWire(id(i2Name),  belInputType, x, y);
-            addWire(id(i3Name),  belInputType, x, y);
-            addWire(id(outName), belOutputType, x, y);
-
-            std::string belName = "X" + std::to_string(x) +
-                                  "Y" + std::to_string(y) +
-                                  "Z" + std::to_string(z) + "_" + "LUT4_BEL";
-            IdString belId = id(belName);
-            IdString belType = id("LUT4");
-            addBel(belId, belType, Loc(x, y, z), false);
-            addBelInput(belId, id("I0"), id(i0Name));
-            addBelInput(belId, id("I1"), id(i1Name));
-            addBelInput(belId, id("I2"), id(i2Name));
-            addBelInput(belId, id("I3"), id(i3Name));
-            addBelOutput(belId, id("O"), id(outName));
-          } else if (z >= 8 && z < 16) {
-            // DFFERs
-            std::string dName = "X" + std::to_string(x) +
-                                "Y" + std::to_string(y) +
-                                "Z" + std::to_string(z) + "_" + "D";
-            std::string qName = "X" + std::to_string(x) +
-                                "Y" + std::to_string(y) +
-                                "Z" + std::to_string(z) + "_" + "Q";
-            std::string clkName = "X" + std::to_string(x) +
-                                  "Y" + std::to_string(y) +
-                                  "Z" + std::to_string(z) + "_" + "CLK";
-            std::string ceName = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "CE";
-            std::string rstName = "X" + std::to_string(x) +
-                                  "Y" + std::to_string(y) +
-                                  "Z" + std::to_string(z) + "_" + "RST";
-            addWire(id(dName),   belInputType, x, y);
-            addWire(id(clkName), belInputType, x, y);
-            addWire(id(ceName),  belInputType, x, y);
-            addWire(id(rstName), belInputType, x, y);
-            addWire(id(qName),   belOutputType, x, y);
-
-            std::string belName = "X" + std::to_string(x) +
-                                  "Y" + std::to_string(y) +
-                                  "Z" + std::to_string(z) + "_" + "DFFER_BEL";
-            IdString belId = id(belName);
-            IdString belType = id("DFFER");
-            addBel(belId, belType, Loc(x, y, z), false);
-            addBelInput(belId, id("D"), id(dName));
-            addBelInput(belId, id("CLK"), id(clkName));
-            addBelInput(belId, id("CE"), id(ceName));
-            addBelInput(belId, id("RST"), id(rstName));
-            addBelOutput(belId, id("Q"), id(qName));
-          } else if (z >= 16 && z < 19) {
-            // MUXes
-            std::string i0Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "I0";
-            std::string i1Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "I1";
-            std::string selName = "X" + std::to_string(x) +
-                                  "Y" + std::to_string(y) +
-                                  "Z" + std::to_string(z) + "_" + "SEL";
-            std::string outName = "X" + std::to_string(x) +
-                                  "Y" + std::to_string(y) +
-                                  "Z" + std::to_string(z) + "_" + "O";
-            addWire(id(i0Name), belInputType, x, y);
-            addWire(id(i1Name), belInputType, x, y);
-            addWire(id(selName), belInputType, x, y);
-            addWire(id(outName), belOutputType, x, y);
-
-            std::string belName = "X" + std::to_string(x) +
-                                  "Y" + std::to_string(y) +
-                                  "Z" + std::to_string(z) + "_" + "MUX_BEL";
-            IdString belId = id(belName);
-            IdString belType = id("MUX");
-            addBel(belId, belType, Loc(x, y, z), false);
-            addBelInput(belId, id("I0"), id(i0Name));
-            addBelInput(belId, id("I1"), id(i1Name));
-            addBelOutput(belId, id("O"), id(outName));
-          } else {
-            // CARRY
-            std::string ciName = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "CI";
-            std::string coName = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "CO";
-
-            std::string g0Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "G[0]";
-            std::string g1Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "G[1]";
-            std::string g2Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "G[2]";
-            std::string g3Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "G[3]";
-
-            std::string p0Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "P[0]";
-            std::string p1Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "P[1]";
-            std::string p2Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "P[2]";
-            std::string p3Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "P[3]";
-
-            std::string s0Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "S[0]";
-            std::string s1Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "S[1]";
-            std::string s2Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "S[2]";
-            std::string s3Name = "X" + std::to_string(x) +
-                                 "Y" + std::to_string(y) +
-                                 "Z" + std::to_string(z) + "_" + "S[3]";
-            addWire(id(ciName), belInputType, x, y);
-            addWire(id(coName), belOutputType, x, y);
-
-            addWire(id(g0Name), belInputType, x, y);
-            addWire(id(g1Name), belInputType, x, y);
-            addWire(id(g2Name), belInputType, x, y);
-            addWire(id(g3Name), belInputType, x, y);
-
-            addWire(id(p0Name), belInputType, x, y);
-            addWire(id(p1Name), belInputType, x, y);
-            addWire(id(p2Name), belInputType, x, y);
-            addWire(id(p3Name), belInputType, x, y);
-
-            addWire(id(s0Name), belOutputType, x, y);
-            addWire(id(s1Name), belOutputType, x, y);
-            addWire(id(s2Name), belOutputType, x, y);
-            addWire(id(s3Name), belOutputType, x, y);
-
-            std::string belName = "X" + std::to_string(x) +
-                                  "Y" + std::to_string(y) +
-                                  "Z" + std::to_string(z) + "_" + "CARRY4_BEL";
-            IdString belId = id(belName);
-            IdString belType = id("CARRY4");
-            addBel(belId, belType, Loc(x, y, z), false);
-            addBelInput(belId, id("CI"), id(ciName));
-            addBelOutput(belId, id("CO"), id(coName));
-
-            addBelInput(belId, id("G[0]"), id(g0Name));
-            addBelInput(belId, id("G[1]"), id(g1Name));
-            addBelInput(belId, id("G[2]"), id(g2Name));
-            addBelInput(belId, id("G[3]"), id(g3Name));
-
-            addBelInput(belId, id("P[0]"), id(p0Name));
-            addBelInput(belId, id("P[1]"), id(p1Name));
-            addBelInput(belId, id("P[2]"), id(p2Name));
-            addBelInput(belId, id("P[3]"), id(p3Name));
-
-            addBelOutput(belId, id("S[0]"), id(s0Name));
-            addBelOutput(belId, id("S[1]"), id(s1Name));
-            addBelOutput(belId, id("S[2]"), id(s2Name));
-            addBelOutput(belId, id("S[3]"), id(s3Name));
-          }
-        }
-      }
-    }
-
-    int numSingleWires = 4;
-    int numDoubleWires = 8;
-    IdString cbWireType = id("CB_WIRE");
-    IdString sbWireType = id("SB_WIRE");
-
-    for (int x = 0; x < gridDimX; x++) {
-        for (int y = 0; y < gridDimY; y++) {
-            for (int k = 0; k < numSingleWires; k++) {
-                std::string cb0_single0_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB0_SINGLE0_IN" + std::to_string(k);
-
-                std::string cb0_single0_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB0_SINGLE0_OUT" + std::to_string(k);
-
-                std::string cb0_single1_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB0_SINGLE1_IN" + std::to_string(k);
-
-                std::string cb0_single1_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB0_SINGLE1_OUT" + std::to_string(k);
-
-                std::string cb1_single0_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB1_SINGLE0_IN" + std::to_string(k);
-
-                std::string cb1_single0_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB1_SINGLE0_OUT" + std::to_string(k);
-
-                std::string cb1_single1_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB1_SINGLE1_IN" + std::to_string(k);
-
-                std::string cb1_single1_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB1_SINGLE1_OUT" + std::to_string(k);
-
-                std::string sb_n_single_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_SB_N_SINGLE_IN" + std::to_string(k);
-
-                std::string sb_n_single_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_SB_N_SINGLE_OUT" + std::to_string(k);
-
-                std::string sb_s_single_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_SB_S_SINGLE_IN" + std::to_string(k);
-
-                std::string sb_s_single_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_SB_S_SINGLE_OUT" + std::to_string(k);
-
-                std::string sb_e_single_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_SB_E_SINGLE_IN" + std::to_string(k);
-
-                std::string sb_e_single_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_SB_E_SINGLE_OUT" + std::to_string(k);
+    packerGndName = id("$PACKER_GND");
+    packerVccName = id("$PACKER_VCC");
 
-                std::string sb_w_single_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_SB_W_SINGLE_IN" + std::to_string(k);
+    loadChipdb();
+    gridDimX = chip_info->width;
+    gridDimY = chip_info->height;
 
-                std::string sb_w_single_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_SB_W_SINGLE_OUT" + std::to_string(k);
-
-                addWire(id(cb0_single0_in_name), cbWireType, x, y);
-                addWire(id(cb0_single0_out_name), cbWireType, x, y);
-                addWire(id(cb0_single1_in_name), cbWireType, x, y);
-                addWire(id(cb0_single1_out_name), cbWireType, x, y);
-
-                addWire(id(cb1_single0_in_name), cbWireType, x, y);
-                addWire(id(cb1_single0_out_name), cbWireType, x, y);
-                addWire(id(cb1_single1_in_name), cbWireType, x, y);
-                addWire(id(cb1_single1_out_name), cbWireType, x, y);
-
-                addWire(id(sb_n_single_in_name), sbWireType, x, y);
-                addWire(id(sb_n_single_out_name), sbWireType, x, y);
-
-                addWire(id(sb_s_single_in_name), sbWireType, x, y);
-                addWire(id(sb_s_single_out_name), sbWireType, x, y);
-
-                addWire(id(sb_e_single_in_name), sbWireType, x, y);
-                addWire(id(sb_e_single_out_name), sbWireType, x, y);
-
-                addWire(id(sb_w_single_in_name), sbWireType, x, y);
-                addWire(id(sb_w_single_out_name), sbWireType, x, y);
-            }
-
-            for (int k = 0; k < numDoubleWires; k++) {
-                std::string cb0_double0_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB0_DOUBLE0_IN" + std::to_string(k);
-                std::string cb0_double0_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB0_DOUBLE0_OUT" + std::to_string(k);
-
-                std::string cb0_double1_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB0_DOUBLE1_IN" + std::to_string(k);
-                std::string cb0_double1_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB0_DOUBLE1_OUT" + std::to_string(k);
-
-                std::string cb1_double0_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB1_DOUBLE0_IN" + std::to_string(k);
-                std::string cb1_double0_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB1_DOUBLE0_OUT" + std::to_string(k);
-
-                std::string cb1_double1_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB1_DOUBLE1_IN" + std::to_string(k);
-                std::string cb1_double1_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB1_DOUBLE1_OUT" + std::to_string(k);
-
-                addWire(id(cb0_double0_in_name), cbWireType, x, y);
-                addWire(id(cb0_double0_out_name), cbWireType, x, y);
-                addWire(id(cb0_double1_in_name), cbWireType, x, y);
-                addWire(id(cb0_double1_out_name), cbWireType, x, y);
-
-                addWire(id(cb1_double0_in_name), cbWireType, x, y);
-                addWire(id(cb1_double0_out_name), cbWireType, x, y);
-                addWire(id(cb1_double1_in_name), cbWireType, x, y);
-                addWire(id(cb1_double1_out_name), cbWireType, x, y);
-            }
-
-            for (int k = 0; k < numDoubleWires / 2; k++) {
-                std::string sb_n_double_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_SB_N_DOUBLE_IN" + std::to_string(k);
-
-                std::string sb_n_double_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_SB_N_DOUBLE_OUT" + std::to_string(k);
-
-                std::string sb_s_double_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_SB_S_DOUBLE_IN" + std::to_string(k);
-
-                std::string sb_s_double_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_SB_S_DOUBLE_OUT" + std::to_string(k);
-
-                std::string sb_e_double_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_SB_E_DOUBLE_IN" + std::to_string(k);
-
-                std::string sb_e_double_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_SB_E_DOUBLE_OUT" + std::to_string(k);
-
-                std::string sb_w_double_in_name = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_SB_W_DOUBLE_IN" + std::to_string(k);
+    for (int32_t i = 0; i < chip_info->num_strings; i++) {
+        db_ids.push_back(id(chip_info->strings[i].get()));
+        db_string_index[chip_info->strings[i].get()] = i;
+    }
 
-                std::string sb_w_double_out_name = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_SB_W_DOUBLE_OUT" + std::to_string(k);
+    bel_to_cell.resize(chip_info->num_bels);
+    tile_status.resize(gridDimX * gridDimY);
+    wire_to_net.resize(chip_info->num_wires);
+    pip_to_net.resize(chip_info->num_pips);
+    auto unknown_names = [](int32_t count) {
+        std::unique_ptr<std::atomic<int>[]> ids(new std::atomic<int>[count]);
+        for (int32_t i = 0; i < count; i++)
+            ids[i].store(-1, std::memory_order_relaxed);
+        return ids;
+    };
+    bel_name_ids = unknown_names(chip_info->num_bels);
+    wire_name_ids = unknown_names(chip_info->num_wires);
+    pip_name_ids = unknown_names(chip_info->num_pips);
+
+    bels_by_tile.resize(gridDimX);
+    for (auto &col : bels_by_tile)
+        col.resize(gridDimY);
+    for (int32_t i = 0; i < chip_info->num_bels; i++) {
+        const LocPOD &loc = chip_info->bel_data[i].loc;
+        BelId bel;
+        bel.index = i;
+        bels_by_tile.at(loc.x).at(loc.y).push_back(bel);
+    }
 
-                addWire(id(sb_n_double_in_name), sbWireType, x, y);
-                addWire(id(sb_n_double_out_name), sbWireType, x, y);
+    loadTimingLibrary();
+}
 
-                addWire(id(sb_s_double_in_name), sbWireType, x, y);
-                addWire(id(sb_s_double_out_name), sbWireType, x, y);
+void Arch::loadChipdb()
+{
+    std::string filename = args.chipdb;
+    if (filename.empty())
+        filename = get_cache_path(stringf("borca-%dx%d.bin", args.width, args.height));
 
-                addWire(id(sb_e_double_in_name), sbWireType, x, y);
-                addWire(id(sb_e_double_out_name), sbWireType, x, y);
+    auto is_usable = [&](const char *data, size_t size) {
+        if (size < sizeof(ChipInfoPOD))
+            return false;
+        auto ci = reinterpret_cast<const ChipInfoPOD *>(data);
+        return ci->magic == BORCA_CHIPDB_MAGIC && ci->version == BORCA_CHIPDB_VERSION && size_t(ci->size) == size &&
+               ci->width == args.width && ci->height == args.height;
+    };
 
-                addWire(id(sb_w_double_in_name), sbWireType, x, y);
-                addWire(id(sb_w_double_out_name), sbWireType, x, y);
+    try {
+        if (boost::filesystem::exists(filename)) {
+            auto file = std::make_shared<boost::iostreams::mapped_file_source>(filename);
+            if (is_usable(file->data(), file->size())) {
+                chip_info = reinterpret_cast<const ChipInfoPOD *>(file->data());
+                chipdb_storage = file;
+                return;
             }
         }
+    } catch (std::exception &) {
+        // Unreadable files are treated the same as stale ones
     }
 
-    // PipInfo
-    IdString pipType = id("PIP");
-
-    // Intra-CLB connections
-    // LUT (O) -> CARRY (P/G)
-    // LUT (O) -> DFF (D)
-    // CARRY (S) -> DFF (D)
-    // LUT (O) -> CLB_COMB_O
-    // CARRY (S) -> CLB_COMB_O
-    // DFF (Q) -> CLB_SYNC_O
-
-    for (int x = 0; x < gridDimX; x++) {
-        for (int y = 0; y < gridDimY; y++) {
-            // LUT -> CLB outputs (COMB)
-            std::string lut0_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z0" + "_" + "O";
-            std::string lut1_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z1" + "_" + "O";
-            std::string lut2_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z2" + "_" + "O";
-            std::string lut3_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z3" + "_" + "O";
-            std::string lut4_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z4" + "_" + "O";
-            std::string lut5_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z5" + "_" + "O";
-            std::string lut6_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z6" + "_" + "O";
-            std::string lut7_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z7" + "_" + "O";
-
-            WireId lut0OutWire = getWireByName(id(lut0_output_name));
-            WireId lut1OutWire = getWireByName(id(lut1_output_name));
-            WireId lut2OutWire = getWireByName(id(lut2_output_name));
-            WireId lut3OutWire = getWireByName(id(lut3_output_name));
-            WireId lut4OutWire = getWireByName(id(lut4_output_name));
-            WireId lut5OutWire = getWireByName(id(lut5_output_name));
-            WireId lut6OutWire = getWireByName(id(lut6_output_name));
-            WireId lut7OutWire = getWireByName(id(lut7_output_name));
-
-            std::string clbCombOut0Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_COMB0";
-            std::string clbCombOut1Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_COMB1";
-            std::string clbCombOut2Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_COMB2";
-            std::string clbCombOut3Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_COMB3";
-            std::string clbCombOut4Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_COMB4";
-            std::string clbCombOut5Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_COMB5";
-            std::string clbCombOut6Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_COMB6";
-            std::string clbCombOut7Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_COMB7";
-
-            addWire(id(clbCombOut0Name), id("CLB"), x, y);
-            addWire(id(clbCombOut1Name), id("CLB"), x, y);
-            addWire(id(clbCombOut2Name), id("CLB"), x, y);
-            addWire(id(clbCombOut3Name), id("CLB"), x, y);
-            addWire(id(clbCombOut4Name), id("CLB"), x, y);
-            addWire(id(clbCombOut5Name), id("CLB"), x, y);
-            addWire(id(clbCombOut6Name), id("CLB"), x, y);
-            addWire(id(clbCombOut7Name), id("CLB"), x, y);
-
-            WireId clbCombOut0Wire = getWireByName(id(clbCombOut0Name));
-            WireId clbCombOut1Wire = getWireByName(id(clbCombOut1Name));
-            WireId clbCombOut2Wire = getWireByName(id(clbCombOut2Name));
-            WireId clbCombOut3Wire = getWireByName(id(clbCombOut3Name));
-            WireId clbCombOut4Wire = getWireByName(id(clbCombOut4Name));
-            WireId clbCombOut5Wire = getWireByName(id(clbCombOut5Name));
-            WireId clbCombOut6Wire = getWireByName(id(clbCombOut6Name));
-            WireId clbCombOut7Wire = getWireByName(id(clbCombOut7Name));
-
-            std::string pipLutToCLBOut0Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "LUT1->CLB_COMB0";
-            std::string pipLutToCLBOut1Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "LUT0->CLB_COMB1";
-            std::string pipLutToCLBOut2Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "LUT3->CLB_COMB2";
-            std::string pipLutToCLBOut3Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "LUT2->CLB_COMB3";
-            std::string pipLutToCLBOut4Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "LUT5->CLB_COMB4";
-            std::string pipLutToCLBOut5Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "LUT4->CLB_COMB5";
-            std::string pipLutToCLBOut6Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "LUT7->CLB_COMB6";
-            std::string pipLutToCLBOut7Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "LUT6->CLB_COMB7";
-
-            addPip(id(pipLutToCLBOut0Name), pipType,
-                   getWireName(lut1OutWire), getWireName(clbCombOut0Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLutToCLBOut1Name), pipType,
-                   getWireName(lut0OutWire), getWireName(clbCombOut1Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLutToCLBOut2Name), pipType,
-                   getWireName(lut3OutWire), getWireName(clbCombOut2Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLutToCLBOut3Name), pipType,
-                   getWireName(lut2OutWire), getWireName(clbCombOut3Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLutToCLBOut4Name), pipType,
-                   getWireName(lut5OutWire), getWireName(clbCombOut4Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLutToCLBOut5Name), pipType,
-                   getWireName(lut4OutWire), getWireName(clbCombOut5Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLutToCLBOut6Name), pipType,
-                   getWireName(lut7OutWire), getWireName(clbCombOut6Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLutToCLBOut7Name), pipType,
-                   getWireName(lut6OutWire), getWireName(clbCombOut7Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-
-            // DFF -> CLB outputs (SYNC)
-            std::string dff0_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z8" + "_" + "Q";
-            std::string dff1_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z9" + "_" + "Q";
-            std::string dff2_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z10" + "_" + "Q";
-            std::string dff3_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z11" + "_" + "Q";
-            std::string dff4_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z12" + "_" + "Q";
-            std::string dff5_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z13" + "_" + "Q";
-            std::string dff6_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z14" + "_" + "Q";
-            std::string dff7_output_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z15" + "_" + "Q";
-
-            WireId dff0OutWire = getWireByName(id(dff0_output_name));
-            WireId dff1OutWire = getWireByName(id(dff1_output_name));
-            WireId dff2OutWire = getWireByName(id(dff2_output_name));
-            WireId dff3OutWire = getWireByName(id(dff3_output_name));
-            WireId dff4OutWire = getWireByName(id(dff4_output_name));
-            WireId dff5OutWire = getWireByName(id(dff5_output_name));
-            WireId dff6OutWire = getWireByName(id(dff6_output_name));
-            WireId dff7OutWire = getWireByName(id(dff7_output_name));
-
-            std::string clbSyncOut0Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_SYNC0";
-            std::string clbSyncOut1Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_SYNC1";
-            std::string clbSyncOut2Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_SYNC2";
-            std::string clbSyncOut3Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_SYNC3";
-            std::string clbSyncOut4Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_SYNC4";
-            std::string clbSyncOut5Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_SYNC5";
-            std::string clbSyncOut6Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_SYNC6";
-            std::string clbSyncOut7Name = "X" + std::to_string(x) +
-                                          "Y" + std::to_string(y) +
-                                          "CLB_SYNC7";
-
-            addWire(id(clbSyncOut0Name), id("CLB"), x, y);
-            addWire(id(clbSyncOut1Name), id("CLB"), x, y);
-            addWire(id(clbSyncOut2Name), id("CLB"), x, y);
-            addWire(id(clbSyncOut3Name), id("CLB"), x, y);
-            addWire(id(clbSyncOut4Name), id("CLB"), x, y);
-            addWire(id(clbSyncOut5Name), id("CLB"), x, y);
-            addWire(id(clbSyncOut6Name), id("CLB"), x, y);
-            addWire(id(clbSyncOut7Name), id("CLB"), x, y);
-
-            WireId clbSyncOut0Wire = getWireByName(id(clbSyncOut0Name));
-            WireId clbSyncOut1Wire = getWireByName(id(clbSyncOut1Name));
-            WireId clbSyncOut2Wire = getWireByName(id(clbSyncOut2Name));
-            WireId clbSyncOut3Wire = getWireByName(id(clbSyncOut3Name));
-            WireId clbSyncOut4Wire = getWireByName(id(clbSyncOut4Name));
-            WireId clbSyncOut5Wire = getWireByName(id(clbSyncOut5Name));
-            WireId clbSyncOut6Wire = getWireByName(id(clbSyncOut6Name));
-            WireId clbSyncOut7Wire = getWireByName(id(clbSyncOut7Name));
-
-            std::string pipDffToCLBOut0Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "DFF1->CLB_SYNC0";
-            std::string pipDffToCLBOut1Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "DFF0->CLB_SYNC1";
-            std::string pipDffToCLBOut2Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "DFF3->CLB_SYNC2";
-            std::string pipDffToCLBOut3Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "DFF2->CLB_SYNC3";
-            std::string pipDffToCLBOut4Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "DFF5->CLB_SYNC4";
-            std::string pipDffToCLBOut5Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "DFF4->CLB_SYNC5";
-            std::string pipDffToCLBOut6Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "DFF7->CLB_SYNC6";
-            std::string pipDffToCLBOut7Name = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "DFF6->CLB_SYNC7";
-
-            addPip(id(pipDffToCLBOut0Name), pipType,
-                   getWireName(dff1OutWire), getWireName(clbSyncOut0Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipDffToCLBOut1Name), pipType,
-                   getWireName(dff0OutWire), getWireName(clbSyncOut1Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipDffToCLBOut2Name), pipType,
-                   getWireName(dff3OutWire), getWireName(clbSyncOut2Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipDffToCLBOut3Name), pipType,
-                   getWireName(dff2OutWire), getWireName(clbSyncOut3Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipDffToCLBOut4Name), pipType,
-                   getWireName(dff5OutWire), getWireName(clbSyncOut4Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipDffToCLBOut5Name), pipType,
-                   getWireName(dff4OutWire), getWireName(clbSyncOut5Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipDffToCLBOut6Name), pipType,
-                   getWireName(dff7OutWire), getWireName(clbSyncOut6Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipDffToCLBOut7Name), pipType,
-                   getWireName(dff6OutWire), getWireName(clbSyncOut7Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-
-            // CARRY4 -> CLB outputs (COMB)
-            std::string ccS0Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "S[0]";
-            std::string ccS1Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "S[1]";
-            std::string ccS2Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "S[2]";
-            std::string ccS3Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "S[3]";
-
-            WireId ccS0Wire = getWireByName(id(ccS0Name));
-            WireId ccS1Wire = getWireByName(id(ccS1Name));
-            WireId ccS2Wire = getWireByName(id(ccS2Name));
-            WireId ccS3Wire = getWireByName(id(ccS3Name));
-
-            std::string pipCarryToCLBOut0Name = "X" + std::to_string(x) +
-                                                "Y" + std::to_string(y) +
-                                                "CARRY4_S0->CLB_COMB0";
-            std::string pipCarryToCLBOut1Name = "X" + std::to_string(x) +
-                                                "Y" + std::to_string(y) +
-                                                "CARRY4_S1->CLB_COMB2";
-            std::string pipCarryToCLBOut2Name = "X" + std::to_string(x) +
-                                                "Y" + std::to_string(y) +
-                                                "CARRY4_S2->CLB_COMB4";
-            std::string pipCarryToCLBOut3Name = "X" + std::to_string(x) +
-                                                "Y" + std::to_string(y) +
-                                                "CARRY4_S3->CLB_COMB6";
-
-            addPip(id(pipCarryToCLBOut0Name), pipType,
-                   getWireName(ccS0Wire), getWireName(clbCombOut0Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCarryToCLBOut1Name), pipType,
-                   getWireName(ccS1Wire), getWireName(clbCombOut2Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCarryToCLBOut2Name), pipType,
-                   getWireName(ccS2Wire), getWireName(clbCombOut4Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCarryToCLBOut3Name), pipType,
-                   getWireName(ccS3Wire), getWireName(clbCombOut6Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-
-            // LUT -> CARRY4 (P)
-            std::string ccP0Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "P[0]";
-            std::string ccP1Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "P[1]";
-            std::string ccP2Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "P[2]";
-            std::string ccP3Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "P[3]";
-
-            WireId ccP0Wire = getWireByName(id(ccP0Name));
-            WireId ccP1Wire = getWireByName(id(ccP1Name));
-            WireId ccP2Wire = getWireByName(id(ccP2Name));
-            WireId ccP3Wire = getWireByName(id(ccP3Name));
-
-            std::string pipLut1ToCarryP0Name = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "LUT1->CARRY4_P0";
-            std::string pipLut3ToCarryP1Name = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "LUT3->CARRY4_P1";
-            std::string pipLut5ToCarryP2Name = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "LUT5->CARRY4_P2";
-            std::string pipLut7ToCarryP3Name = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "LUT7->CARRY4_P3";
-
-            addPip(id(pipLut1ToCarryP0Name), pipType,
-                   getWireName(lut1OutWire),
-                   getWireName(ccP0Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut3ToCarryP1Name), pipType,
-                   getWireName(lut3OutWire),
-                   getWireName(ccP1Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut5ToCarryP2Name), pipType,
-                   getWireName(lut5OutWire),
-                   getWireName(ccP2Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut7ToCarryP3Name), pipType,
-                   getWireName(lut7OutWire),
-                   getWireName(ccP3Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-
-            // LUT -> CARRY4 (G)
-            std::string ccG0Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "G[0]";
-            std::string ccG1Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "G[1]";
-            std::string ccG2Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "G[2]";
-            std::string ccG3Name = "X" + std::to_string(x) +
-                                   "Y" + std::to_string(y) +
-                                   "Z19" + "_" + "G[3]";
-
-            WireId ccG0Wire = getWireByName(id(ccG0Name));
-            WireId ccG1Wire = getWireByName(id(ccG1Name));
-            WireId ccG2Wire = getWireByName(id(ccG2Name));
-            WireId ccG3Wire = getWireByName(id(ccG3Name));
-
-            std::string pipLut0ToCarryG0Name = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "LUT0->CARRY4_G0";
-            std::string pipLut2ToCarryG1Name = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "LUT2->CARRY4_G1";
-            std::string pipLut4ToCarryG2Name = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "LUT4->CARRY4_G2";
-            std::string pipLut6ToCarryG3Name = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "LUT6->CARRY4_G3";
-
-            addPip(id(pipLut0ToCarryG0Name), pipType,
-                   getWireName(lut0OutWire),
-                   getWireName(ccG0Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut2ToCarryG1Name), pipType,
-                   getWireName(lut2OutWire),
-                   getWireName(ccG1Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut4ToCarryG2Name), pipType,
-                   getWireName(lut4OutWire),
-                   getWireName(ccG2Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut6ToCarryG3Name), pipType,
-                   getWireName(lut6OutWire),
-                   getWireName(ccG3Wire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-
-            // CARRY4 -> DFF inputs (D)
-            std::string dff0_input_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z8" + "_" + "D";
-            std::string dff1_input_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z9" + "_" + "D";
-            std::string dff2_input_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z10" + "_" + "D";
-            std::string dff3_input_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z11" + "_" + "D";
-            std::string dff4_input_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z12" + "_" + "D";
-            std::string dff5_input_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z13" + "_" + "D";
-            std::string dff6_input_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z14" + "_" + "D";
-            std::string dff7_input_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z15" + "_" + "D";
-
-            WireId dff0InWire = getWireByName(id(dff0_input_name));
-            WireId dff1InWire = getWireByName(id(dff1_input_name));
-            WireId dff2InWire = getWireByName(id(dff2_input_name));
-            WireId dff3InWire = getWireByName(id(dff3_input_name));
-            WireId dff4InWire = getWireByName(id(dff4_input_name));
-            WireId dff5InWire = getWireByName(id(dff5_input_name));
-            WireId dff6InWire = getWireByName(id(dff6_input_name));
-            WireId dff7InWire = getWireByName(id(dff7_input_name));
-
-            std::string pipCarryS0ToDffName = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "CARRY4_S0->DFF1";
-            std::string pipCarryS1ToDffName = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "CARRY4_S1->DFF3";
-            std::string pipCarryS2ToDffName = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "CARRY4_S2->DFF5";
-            std::string pipCarryS3ToDffName = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "CARRY4_S3->DFF7";
-
-            addPip(id(pipCarryS0ToDffName), pipType,
-                   getWireName(ccS0Wire), getWireName(dff1InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCarryS1ToDffName), pipType,
-                   getWireName(ccS1Wire), getWireName(dff3InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCarryS2ToDffName), pipType,
-                   getWireName(ccS2Wire), getWireName(dff5InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipCarryS3ToDffName), pipType,
-                   getWireName(ccS3Wire), getWireName(dff7InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-
-            // LUT -> DFF inputs (D)
-            std::string pipLut1ToDffName = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "LUT1->DFF1";
-            std::string pipLut0ToDffName = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "LUT0->DFF0";
-            std::string pipLut3ToDffName = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "LUT3->DFF3";
-            std::string pipLut2ToDffName = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "LUT2->DFF2";
-            std::string pipLut5ToDffName = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "LUT5->DFF5";
-            std::string pipLut4ToDffName = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "LUT4->DFF4";
-            std::string pipLut7ToDffName = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "LUT7->DFF7";
-            std::string pipLut6ToDffName = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "LUT6->DFF6";
-            addPip(id(pipLut1ToDffName), pipType,
-                   getWireName(lut1OutWire), getWireName(dff1InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut0ToDffName), pipType,
-                   getWireName(lut0OutWire), getWireName(dff0InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut3ToDffName), pipType,
-                   getWireName(lut3OutWire), getWireName(dff3InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut2ToDffName), pipType,
-                   getWireName(lut2OutWire), getWireName(dff2InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut5ToDffName), pipType,
-                   getWireName(lut5OutWire), getWireName(dff5InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut4ToDffName), pipType,
-                   getWireName(lut4OutWire), getWireName(dff4InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut7ToDffName), pipType,
-                   getWireName(lut7OutWire), getWireName(dff7InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipLut6ToDffName), pipType,
-                   getWireName(lut6OutWire), getWireName(dff6InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-
-            // LUT (By Pass) -> DFF inputs (D)
-            std::string lut1_in0_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z0" + "_" + "I0";
-            std::string lut0_in0_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z1" + "_" + "I0";
-            std::string lut3_in0_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z2" + "_" + "I0";
-            std::string lut2_in0_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z3" + "_" + "I0";
-            std::string lut5_in0_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z4" + "_" + "I0";
-            std::string lut4_in0_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z5" + "_" + "I0";
-            std::string lut7_in0_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z6" + "_" + "I0";
-            std::string lut6_in0_name = "X" + std::to_string(x) +
-                                           "Y" + std::to_string(y) +
-                                           "Z7" + "_" + "I0";
-
-            WireId lut1In0Wire = getWireByName(id(lut1_in0_name));
-            WireId lut0In0Wire = getWireByName(id(lut0_in0_name));
-            WireId lut3In0Wire = getWireByName(id(lut3_in0_name));
-            WireId lut2In0Wire = getWireByName(id(lut2_in0_name));
-            WireId lut5In0Wire = getWireByName(id(lut5_in0_name));
-            WireId lut4In0Wire = getWireByName(id(lut4_in0_name));
-            WireId lut7In0Wire = getWireByName(id(lut7_in0_name));
-            WireId lut6In0Wire = getWireByName(id(lut6_in0_name));
-
-            std::string pipBYLut1ToDffName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "BYLUT1->DFF1";
-            std::string pipBYLut0ToDffName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "BYLUT0->DFF0";
-            std::string pipBYLut3ToDffName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "BYLUT3->DFF3";
-            std::string pipBYLut2ToDffName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "BYLUT2->DFF2";
-            std::string pipBYLut5ToDffName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "BYLUT5->DFF5";
-            std::string pipBYLut4ToDffName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "BYLUT4->DFF4";
-            std::string pipBYLut7ToDffName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "BYLUT7->DFF7";
-            std::string pipBYLut6ToDffName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "BYLUT6->DFF6";
-
-            addPip(id(pipBYLut1ToDffName), pipType,
-                   getWireName(lut1In0Wire), getWireName(dff1InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipBYLut0ToDffName), pipType,
-                   getWireName(lut0In0Wire), getWireName(dff0InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipBYLut3ToDffName), pipType,
-                   getWireName(lut3In0Wire), getWireName(dff3InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipBYLut2ToDffName), pipType,
-                   getWireName(lut2In0Wire), getWireName(dff2InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipBYLut5ToDffName), pipType,
-                   getWireName(lut5In0Wire), getWireName(dff5InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipBYLut4ToDffName), pipType,
-                   getWireName(lut4In0Wire), getWireName(dff4InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipBYLut7ToDffName), pipType,
-                   getWireName(lut7In0Wire), getWireName(dff7InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
-            addPip(id(pipBYLut6ToDffName), pipType,
-                   getWireName(lut6In0Wire), getWireName(dff6InWire),
-                   getDelayFromNS(0.01), Loc(x, y, 0));
+    log_info("Generating %dx%d routing graph database '%s'...\n", args.width, args.height, filename.c_str());
+    auto blob = std::make_shared<std::vector<char>>();
+    buildChipdb(args.width, args.height, *blob);
+    chip_info = reinterpret_cast<const ChipInfoPOD *>(blob->data());
+    chipdb_storage = blob;
 
-        }
-    }
+    if (!write_file_atomic(filename, blob->data(), blob->size()))
+        log_warning("Failed to cache routing graph database as '%s'.\n", filename.c_str());
+}
 
-    // East:  LUT0 (1) ->LUT1 (0)
-    // South: LUT2 (3) ->LUT3 (2)
-    // West:  LUT4 (5) ->LUT5 (4)
-    // North: LUT6 (7) ->LUT7 (6)
-    for (int x = 0; x < gridDimX; x++) {
-        for (int y = 0; y < gridDimY; y++) {
-            setupPipsForCLB(x, y, numSingleWires, numDoubleWires, 0); // East CLB IOs
-            setupPipsForCLB(x, y, numSingleWires, numDoubleWires, 1); // North CLB IOs
-            setupPipsForCLB(x, y, numSingleWires, numDoubleWires, 2); // West CLB IOs
-            setupPipsForCLB(x, y, numSingleWires, numDoubleWires, 3); // South CLB IOs
-        }
-    }
+IdString Arch::archArgsToId(ArchArgs args) const { return id(stringf("%dx%d", args.width, args.height)); }
 
-    // SB {E, N, W, S}
-    // switchbox-element-two mapping
-    // N0E0, N0S0, N0W1, N1E1, N1S1, N1W0
-    // E0W0, E0N0, E0S1, E1W1, E1N1, E1S0
-    // S0W0, S0N0, S0E1, S1W1, S1N1, S1E0
-    // W0E0, W0S0, W0N1, W1E1, W1S1, W1N0
-    for (int x = 0; x < gridDimX; x++) {
-        for (int y = 0; y < gridDimY; y++) {
-            for (int s = 0; s < numSingleWires; s++) {
-                setupPipsForSB(x, y, s, 0, 1); // E->S
-                setupPipsForSB(x, y, s, 1, 0); // S->E
-                setupPipsForSB(x, y, s, 1, 3); // S->N
-                setupPipsForSB(x, y, s, 3, 1); // N->S
-                setupPipsForSB(x, y, s, 1, 2); // S->W
-                setupPipsForSB(x, y, s, 2, 1); // W->S
-                setupPipsForSB(x, y, s, 0, 2); // E->W
-                setupPipsForSB(x, y, s, 2, 0); // W->E
-            }
-        }
-    }
+void IdString::initialize_arch(const BaseCtx *ctx) {}
 
-    // CB <-> SB
-    for (int x = 0; x < gridDimX; x++) {
-        for (int y = 0; y < gridDimY; y++) {
-            bool isNorthAvail = (y + 1) < gridDimY;
-            bool isEastAvail  = (x + 1) < gridDimX;
-            bool isSouthAvail = (y - 1) >= 0;
-            bool isWestAvail  = (x - 1) >= 0;
-
-            // CBs and SB in the same tile
-            for (int s = 0; s < numSingleWires; s++) {
-                std::string cb0Wire1InName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "_CB0_SINGLE1_IN" + std::to_string(s);
-                std::string cb0Wire1OutName = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CB0_SINGLE1_OUT" + std::to_string(s);
-
-                std::string cb1Wire1InName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "_CB1_SINGLE1_IN" + std::to_string(s);
-                std::string cb1Wire1OutName = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CB1_SINGLE1_OUT" + std::to_string(s);
-
-                std::string sbSWireInName = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_SB_S_SINGLE_IN" + std::to_string(s);
-
-                std::string sbSWireOutName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "_SB_S_SINGLE_OUT" + std::to_string(s);
-
-                std::string sbWWireInName = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_SB_W_SINGLE_IN" + std::to_string(s);
-
-                std::string sbWWireOutName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "_SB_W_SINGLE_OUT" + std::to_string(s);
-
-                WireId cb0Wire1In  = getWireByName(id(cb0Wire1InName));
-                WireId cb0Wire1Out = getWireByName(id(cb0Wire1OutName));
-
-                WireId cb1Wire1In  = getWireByName(id(cb1Wire1InName));
-                WireId cb1Wire1Out = getWireByName(id(cb1Wire1OutName));
-
-                WireId sbSWireIn  = getWireByName(id(sbSWireInName));
-                WireId sbSWireOut = getWireByName(id(sbSWireOutName));
-
-                WireId sbWWireIn  = getWireByName(id(sbWWireInName));
-                WireId sbWWireOut = getWireByName(id(sbWWireOutName));
-
-                // CB->SB
-                std::string pipCB0_SBName = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_CB0->SB_S_SINGLE" + std::to_string(s);
-                std::string pipCB1_SBName = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_CB1->SB_W_SINGLE" + std::to_string(s);
-                // SB->CB
-                std::string pipSB_CB0Name = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_SB_S->CB0_SINGLE" + std::to_string(s);
-                std::string pipSB_CB1Name = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_SB_W->CB1_SINGLE" + std::to_string(s);
-
-                addPip(id(pipCB0_SBName), pipType,
-                       getWireName(cb0Wire1Out), getWireName(sbSWireIn),
-                       getDelayFromNS(0.01), Loc(x, y, 0));
-                addPip(id(pipCB1_SBName), pipType,
-                       getWireName(cb1Wire1Out), getWireName(sbWWireIn),
-                       getDelayFromNS(0.01), Loc(x, y, 0));
-
-                addPip(id(pipSB_CB0Name), pipType,
-                       getWireName(sbSWireOut), getWireName(cb0Wire1In),
-                       getDelayFromNS(0.01), Loc(x, y, 0));
-                addPip(id(pipSB_CB1Name), pipType,
-                       getWireName(sbWWireOut), getWireName(cb1Wire1In),
-                       getDelayFromNS(0.01), Loc(x, y, 0));
-            }
+// ---------------------------------------------------------------
 
-            // The second half of the double wires connect to the SB of the same tile
-            for (int s = 4; s < numDoubleWires; s++) {
-                std::string cb0Wire1InName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "_CB0_DOUBLE1_IN" + std::to_string(s);
-                std::string cb0Wire1OutName = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CB0_DOUBLE1_OUT" + std::to_string(s);
-
-                std::string cb1Wire1InName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "_CB1_DOUBLE1_IN" + std::to_string(s);
-                std::string cb1Wire1OutName = "X" + std::to_string(x) +
-                                              "Y" + std::to_string(y) +
-                                              "_CB1_DOUBLE1_OUT" + std::to_string(s);
-
-                std::string sbSWireInName = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_SB_S_DOUBLE_IN" + std::to_string(s - 4);
-
-                std::string sbSWireOutName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "_SB_S_DOUBLE_OUT" + std::to_string(s - 4);
-
-                std::string sbWWireInName = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_SB_W_DOUBLE_IN" + std::to_string(s - 4);
-
-                std::string sbWWireOutName = "X" + std::to_string(x) +
-                                             "Y" + std::to_string(y) +
-                                             "_SB_W_DOUBLE_OUT" + std::to_string(s - 4);
-
-                WireId cb0Wire1In  = getWireByName(id(cb0Wire1InName));
-                WireId cb0Wire1Out = getWireByName(id(cb0Wire1OutName));
-
-                WireId cb1Wire1In  = getWireByName(id(cb1Wire1InName));
-                WireId cb1Wire1Out = getWireByName(id(cb1Wire1OutName));
-
-                WireId sbSWireIn  = getWireByName(id(sbSWireInName));
-                WireId sbSWireOut = getWireByName(id(sbSWireOutName));
-
-                WireId sbWWireIn  = getWireByName(id(sbWWireInName));
-                WireId sbWWireOut = getWireByName(id(sbWWireOutName));
-
-                // CB->SB
-                std::string pipCB0_SBName = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_CB0->SB_S_DOUBLE" + std::to_string(s - 4);
-                std::string pipCB1_SBName = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_CB1->SB_W_DOUBLE" + std::to_string(s - 4);
-                // SB->CB
-                std::string pipSB_CB0Name = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_SB_S->CB0_DOUBLE" + std::to_string(s - 4);
-                std::string pipSB_CB1Name = "X" + std::to_string(x) +
-                                            "Y" + std::to_string(y) +
-                                            "_SB_W->CB1_DOUBLE" + std::to_string(s - 4);
-
-                addPip(id(pipCB0_SBName), pipType,
-                       getWireName(cb0Wire1Out), getWireName(sbSWireIn),
-                       getDelayFromNS(0.01), Loc(x, y, 0));
-                addPip(id(pipCB1_SBName), pipType,
-                       getWireName(cb1Wire1Out), getWireName(sbWWireIn),
-                       getDelayFromNS(0.01), Loc(x, y, 0));
-
-                addPip(id(pipSB_CB0Name), pipType,
-                       getWireName(sbSWireOut), getWireName(cb0Wire1In),
-                       getDelayFromNS(0.01), Loc(x, y, 0));
-                addPip(id(pipSB_CB1Name), pipType,
-                       getWireName(sbWWireOut), getWireName(cb1Wire1In),
-                       getDelayFromNS(0.01), Loc(x, y, 0));
-            }
+namespace {
+uint64_t name_key(int x, int y, int32_t suffix)
+{
+    return (uint64_t(uint16_t(x)) << 48) | (uint64_t(uint16_t(y)) << 32) | uint32_t(suffix);
+}
 
-            // CB0 and SB from the South tile
-            if (isSouthAvail) {
-                for (int s = 0; s < numSingleWires; s++) {
-                    std::string cb0Wire0InName = "X" + std::to_string(x) +
-                                                 "Y" + std::to_string(y) +
-                                                 "_CB0_SINGLE0_IN" + std::to_string(s);
-                    std::string cb0Wire0OutName = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB0_SINGLE0_OUT" + std::to_string(s);
-
-                    std::string sbWireInName = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y - 1) +
-                                               "_SB_N_SINGLE_IN" + std::to_string(s);
-                    std::string sbWireOutName = "X" + std::to_string(x) +
-                                                "Y" + std::to_string(y - 1) +
-                                                "_SB_N_SINGLE_OUT" + std::to_string(s);
-
-                    WireId cb0Wire0In = getWireByName(id(cb0Wire0InName));
-                    WireId cb0Wire0Out = getWireByName(id(cb0Wire0OutName));
-
-                    WireId sbWireIn  = getWireByName(id(sbWireInName));
-                    WireId sbWireOut = getWireByName(id(sbWireOutName));
-
-                    // CB->SB
-                    std::string pipCB_SBName = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "_CB0->SB_N_SINGLE" + std::to_string(s);
-                    // SB->CB
-                    std::string pipSB_CBName = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y - 1) +
-                                               "_SB_N->CB0_SINGLE" + std::to_string(s);
-
-                    addPip(id(pipCB_SBName), pipType,
-                           getWireName(cb0Wire0Out), getWireName(sbWireIn),
-                           getDelayFromNS(0.01), Loc(x, y, 0));
-                    addPip(id(pipSB_CBName), pipType,
-                           getWireName(sbWireOut), getWireName(cb0Wire0In),
-                           getDelayFromNS(0.01), Loc(x, y - 1, 0));
-                }
-
-                // The double wires of the South SB connect to the first-half
-                // double wires of the CB0
-                for (int s = 0; s < numDoubleWires / 2; s++) {
-                    std::string cb0Wire0InName = "X" + std::to_string(x) +
-                                                 "Y" + std::to_string(y) +
-                                                 "_CB0_DOUBLE0_IN" + std::to_string(s);
-                    std::string cb0Wire0OutName = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB0_DOUBLE0_OUT" + std::to_string(s);
-
-                    std::string sbWireInName = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y - 1) +
-                                               "_SB_N_DOUBLE_IN" + std::to_string(s);
-
-                    std::string sbWireOutName = "X" + std::to_string(x) +
-                                                "Y" + std::to_string(y - 1) +
-                                                "_SB_N_DOUBLE_OUT" + std::to_string(s);
-
-                    WireId cb0Wire0In  = getWireByName(id(cb0Wire0InName));
-                    WireId cb0Wire0Out = getWireByName(id(cb0Wire0OutName));
-
-                    WireId sbWireIn   = getWireByName(id(sbWireInName));
-                    WireId sbWireOut  = getWireByName(id(sbWireOutName));
-
-                    // CB->SB
-                    std::string pipCB_SBName = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "_CB0->SB_N_DOUBLE" + std::to_string(s);
-                    // SB->CB
-                    std::string pipSB_CBName = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y - 1) +
-                                               "_SB_N->CB0_DOUBLE" + std::to_string(s);
-
-                    addPip(id(pipCB_SBName), pipType,
-                           getWireName(cb0Wire0Out), getWireName(sbWireIn),
-                           getDelayFromNS(0.01), Loc(x, y, 0));
-                    addPip(id(pipSB_CBName), pipType,
-                           getWireName(sbWireOut), getWireName(cb0Wire0In),
-                           getDelayFromNS(0.01), Loc(x, y - 1, 0));
-                }
-            }
+uint64_t name_key(const NamePOD &name) { return name_key(name.x, name.y, name.suffix); }
 
-            // CB1 and SB from the West tile
-            if (isWestAvail) {
-                for (int s = 0; s < numSingleWires; s++) {
-                    std::string cb1Wire0InName = "X" + std::to_string(x) +
-                                                 "Y" + std::to_string(y) +
-                                                 "_CB1_SINGLE0_IN" + std::to_string(s);
-                    std::string cb1Wire0OutName = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB1_SINGLE0_OUT" + std::to_string(s);
-
-                    std::string sbWireInName = "X" + std::to_string(x - 1) +
-                                               "Y" + std::to_string(y) +
-                                               "_SB_E_SINGLE_IN" + std::to_string(s);
-
-                    std::string sbWireOutName = "X" + std::to_string(x - 1) +
-                                                "Y" + std::to_string(y) +
-                                                "_SB_E_SINGLE_OUT" + std::to_string(s);
-
-                    WireId cb1Wire0In  = getWireByName(id(cb1Wire0InName));
-                    WireId cb1Wire0Out = getWireByName(id(cb1Wire0OutName));
-
-                    WireId sbWireIn  = getWireByName(id(sbWireInName));
-                    WireId sbWireOut = getWireByName(id(sbWireOutName));
-
-                    // CB->SB
-                    std::string pipCB_SBName = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "_CB1->SB_E_SINGLE" + std::to_string(s);
-                    // SB->CB
-                    std::string pipSB_CBName = "X" + std::to_string(x - 1) +
-                                               "Y" + std::to_string(y) +
-                                               "_SB_E->CB1_SINGLE" + std::to_string(s);
-
-                    addPip(id(pipCB_SBName), pipType,
-                           getWireName(cb1Wire0Out), getWireName(sbWireIn),
-                           getDelayFromNS(0.01), Loc(x, y, 0));
-                    addPip(id(pipSB_CBName), pipType,
-                           getWireName(sbWireOut), getWireName(cb1Wire0In),
-                           getDelayFromNS(0.01), Loc(x - 1, y, 0));
-                }
-
-                // The double wires of the West SB connect to the first-half
-                // double wires of the CB1
-                for (int s = 0; s < numDoubleWires / 2; s++) {
-                    std::string cb1Wire0InName = "X" + std::to_string(x) +
-                                                 "Y" + std::to_string(y) +
-                                                 "_CB1_DOUBLE0_IN" + std::to_string(s);
-                    std::string cb1Wire0OutName = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB1_DOUBLE0_OUT" + std::to_string(s);
-
-                    std::string sbWireInName = "X" + std::to_string(x - 1) +
-                                               "Y" + std::to_string(y) +
-                                               "_SB_E_DOUBLE_IN" + std::to_string(s);
-
-                    std::string sbWireOutName = "X" + std::to_string(x - 1) +
-                                                "Y" + std::to_string(y) +
-                                                "_SB_E_DOUBLE_OUT" + std::to_string(s);
-
-                    WireId cb1Wire0In  = getWireByName(id(cb1Wire0InName));
-                    WireId cb1Wire0Out = getWireByName(id(cb1Wire0OutName));
-
-                    WireId sbWireIn  = getWireByName(id(sbWireInName));
-                    WireId sbWireOut = getWireByName(id(sbWireOutName));
-
-                    // CB->SB
-                    std::string pipCB_SBName = "X" + std::to_string(x) +
-                                               "Y" + std::to_string(y) +
-                                               "_CB1->SB_E_DOUBLE" + std::to_string(s);
-                    // SB->CB
-                    std::string pipSB_CBName = "X" + std::to_string(x - 1) +
-                                               "Y" + std::to_string(y) +
-                                               "_SB_E->CB1_DOUBLE" + std::to_string(s);
-
-                    addPip(id(pipCB_SBName), pipType,
-                           getWireName(cb1Wire0Out), getWireName(sbWireIn),
-                           getDelayFromNS(0.01), Loc(x, y, 0));
-                    addPip(id(pipSB_CBName), pipType,
-                           getWireName(sbWireOut), getWireName(cb1Wire0In),
-                           getDelayFromNS(0.01), Loc(x - 1, y, 0));
-                }
-            }
+const std::map<IdString, std::string> no_attrs;
+} // namespace
 
-            // The first-half of the double wires connect to the CB of the adjacent tile
-            // (skipping the SB of the same tile)
-            // CB0 and CB0 from the North tile
-            // CB1 and CB1 from the East tile
-            for (int s = 0; s < numDoubleWires / 2; s++) {
-                if (isNorthAvail) {
-                    std::string cb0Wire1InName  = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB0_DOUBLE1_IN" + std::to_string(s);
-                    std::string cb0Wire1OutName = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB0_DOUBLE1_OUT" + std::to_string(s);
-                    std::string cb0NWire0InName  = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y + 1) +
-                                                   "_CB0_DOUBLE0_IN" + std::to_string(s + 4);
-                    std::string cb0NWire0OutName = "X" + std::to_string(x) +
-                                                   "Y" + std::to_string(y + 1) +
-                                                   "_CB0_DOUBLE0_OUT" + std::to_string(s + 4);
-
-                    WireId cb0Wire1In   = getWireByName(id(cb0Wire1InName));
-                    WireId cb0Wire1Out  = getWireByName(id(cb0Wire1OutName));
-                    WireId cb0NWire0In  = getWireByName(id(cb0NWire0InName));
-                    WireId cb0NWire0Out = getWireByName(id(cb0NWire0OutName));
-
-                    std::string pip0CB_CBName = "X" + std::to_string(x) +
-                                                "Y" + std::to_string(y) +
-                                                "_CB0->CB0_DOUBLE" + std::to_string(s + 4);
-                    std::string pip1CB_CBName = "X" + std::to_string(x) +
-                                                "Y" + std::to_string(y + 1) +
-                                                "_CB0->CB0_DOUBLE" + std::to_string(s);
-                    addPip(id(pip0CB_CBName), pipType,
-                           getWireName(cb0Wire1Out), getWireName(cb0NWire0In),
-                           getDelayFromNS(0.01), Loc(x, y, 0));
-                    addPip(id(pip1CB_CBName), pipType,
-                           getWireName(cb0NWire0Out), getWireName(cb0Wire1In),
-                           getDelayFromNS(0.01), Loc(x, y + 1, 0));
-                }
-
-                if (isEastAvail) {
-                    std::string cb1Wire1InName = "X" + std::to_string(x) +
-                                                 "Y" + std::to_string(y) +
-                                                 "_CB1_DOUBLE1_IN" + std::to_string(s);
-                    std::string cb1Wire1OutName = "X" + std::to_string(x) +
-                                                  "Y" + std::to_string(y) +
-                                                  "_CB1_DOUBLE1_OUT" + std::to_string(s);
-
-                    std::string cb1EWire0InName  = "X" + std::to_string(x + 1) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB1_DOUBLE0_IN" + std::to_string(s + 4);
-                    std::string cb1EWire0OutName = "X" + std::to_string(x + 1) +
-                                                   "Y" + std::to_string(y) +
-                                                   "_CB1_DOUBLE0_OUT" + std::to_string(s + 4);
-
-                    WireId cb1Wire1In   = getWireByName(id(cb1Wire1InName));
-                    WireId cb1Wire1Out  = getWireByName(id(cb1Wire1OutName));
-                    WireId cb1EWire0In  = getWireByName(id(cb1EWire0InName));
-                    WireId cb1EWire0Out = getWireByName(id(cb1EWire0OutName));
-
-                    std::string pip0CB_CBName = "X" + std::to_string(x) +
-                                                "Y" + std::to_string(y) +
-                                                "_CB1->CB1_DOUBLE" + std::to_string(s + 4);
-                    std::string pip1CB_CBName = "X" + std::to_string(x + 1) +
-                                                "Y" + std::to_string(y) +
-                                                "_CB1->CB1_DOUBLE" + std::to_string(s);
-                    addPip(id(pip0CB_CBName), pipType,
-                           getWireName(cb1Wire1Out), getWireName(cb1EWire0In),
-                           getDelayFromNS(0.01), Loc(x, y, 0));
-                    addPip(id(pip1CB_CBName), pipType,
-                           getWireName(cb1EWire0Out), getWireName(cb1Wire1In),
-                           getDelayFromNS(0.01), Loc(x + 1, y, 0));
-                }
-            }
-        }
-    }
+IdString Arch::nameFromPOD(const NamePOD &name, std::atomic<int> &cached_id) const
+{
+    int index = cached_id.load(std::memory_order_acquire);
+    if (index >= 0)
+        return IdString(index);
+    // Racing threads intern the same string, so they all store the same index
+    IdString result = id(stringf("X%dY%d%s", name.x, name.y, chip_info->strings[name.suffix].get()));
+    cached_id.store(result.index, std::memory_order_release);
+    return result;
 }
 
-void IdString::initialize_arch(const BaseCtx *ctx) {}
+bool Arch::nameToKey(IdString name, uint64_t &key) const
+{
+    int x, y;
+    std::string suffix;
+    if (!splitName(name.str(this), x, y, suffix))
+        return false;
+    auto fnd = db_string_index.find(suffix);
+    if (fnd == db_string_index.end())
+        return false;
+    key = name_key(x, y, fnd->second);
+    return true;
+}
 
 // ---------------------------------------------------------------
 
 BelId Arch::getBelByName(IdString name) const
 {
-    if (bels.count(name))
-        return name;
+    uint64_t key;
+    if (!nameToKey(name, key))
+        return BelId();
+    std::call_once(bel_by_name_once, [&]() {
+        for (int32_t i = 0; i < chip_info->num_bels; i++)
+            bel_by_name[name_key(chip_info->bel_data[i].name)].index = i;
+    });
+    auto fnd = bel_by_name.find(key);
+    if (fnd != bel_by_name.end())
+        return fnd->second;
     return BelId();
 }
 
-IdString Arch::getBelName(BelId bel) const { return bel; }
+IdString Arch::getBelName(BelId bel) const
+{
+    return nameFromPOD(chip_info->bel_data[bel.index].name, bel_name_ids[bel.index]);
+}
 
 Loc Arch::getBelLocation(BelId bel) const
 {
-    auto &info = bels.at(bel);
-    return Loc(info.x, info.y, info.z);
+    const LocPOD &loc = chip_info->bel_data[bel.index].loc;
+    return Loc(loc.x, loc.y, loc.z);
 }
 
 BelId Arch::getBelByLocation(Loc loc) const
 {
-    auto it = bel_by_loc.find(loc);
-    if (it != bel_by_loc.end())
-        return it->second;
+    if (loc.x < 0 || loc.x >= gridDimX || loc.y < 0 || loc.y >= gridDimY)
+        return BelId();
+    for (auto bel : bels_by_tile[loc.x][loc.y])
+        if (chip_info->bel_data[bel.index].loc.z == loc.z)
+            return bel;
     return BelId();
 }
 
 const std::vector<BelId> &Arch::getBelsByTile(int x, int y) const { return bels_by_tile.at(x).at(y); }
 
-bool Arch::getBelGlobalBuf(BelId bel) const { return bels.at(bel).gb; }
+bool Arch::getBelGlobalBuf(BelId bel) const { return chip_info->bel_data[bel.index].gb; }
 
-uint32_t Arch::getBelChecksum(BelId bel) const
-{
-    // FIXME
-    return 0;
-}
+uint32_t Arch::getBelChecksum(BelId bel) const { return bel.index; }
 
 void Arch::bindBel(BelId bel, CellInfo *cell, PlaceStrength strength)
 {
-    bels.at(bel).bound_cell = cell;
+    bel_to_cell[bel.index] = cell;
+    updateTileStatus(bel, cell, 1);
     cell->bel = bel;
     cell->belStrength = strength;
     refreshUiBel(bel);
@@ -2314,39 +327,74 @@ void Arch::bindBel(BelId bel, CellInfo *cell, PlaceStrength strength)
 
 void Arch::unbindBel(BelId bel)
 {
-    bels.at(bel).bound_cell->bel = BelId();
-    bels.at(bel).bound_cell->belStrength = STRENGTH_NONE;
-    bels.at(bel).bound_cell = nullptr;
+    updateTileStatus(bel, bel_to_cell[bel.index], -1);
+    bel_to_cell[bel.index]->bel = BelId();
+    bel_to_cell[bel.index]->belStrength = STRENGTH_NONE;
+    bel_to_cell[bel.index] = nullptr;
     refreshUiBel(bel);
 }
 
-bool Arch::checkBelAvail(BelId bel) const { return bels.at(bel).bound_cell == nullptr; }
+bool Arch::checkBelAvail(BelId bel) const { return bel_to_cell[bel.index] == nullptr; }
 
-CellInfo *Arch::getBoundBelCell(BelId bel) const { return bels.at(bel).bound_cell; }
+CellInfo *Arch::getBoundBelCell(BelId bel) const { return bel_to_cell[bel.index]; }
 
-CellInfo *Arch::getConflictingBelCell(BelId bel) const { return bels.at(bel).bound_cell; }
+CellInfo *Arch::getConflictingBelCell(BelId bel) const { return bel_to_cell[bel.index]; }
 
-const std::vector<BelId> &Arch::getBels() const { return bel_ids; }
+BelRange Arch::getBels() const
+{
+    BelRange range;
+    range.b.cursor = 0;
+    range.e.cursor = chip_info->num_bels;
+    return range;
+}
 
-IdString Arch::getBelType(BelId bel) const { return bels.at(bel).type; }
+IdString Arch::getBelType(BelId bel) const { return db_ids[chip_info->bel_data[bel.index].type]; }
 
-const std::map<IdString, std::string> &Arch::getBelAttrs(BelId bel) const { return bels.at(bel).attrs; }
+const std::map<IdString, std::string> &Arch::getBelAttrs(BelId bel) const
+{
+    auto fnd = bel_attrs.find(bel);
+    return fnd != bel_attrs.end() ? fnd->second : no_attrs;
+}
 
 WireId Arch::getBelPinWire(BelId bel, IdString pin) const
 {
-    const auto &bdata = bels.at(bel);
-    if (!bdata.pins.count(pin))
-        log_error("bel '%s' has no pin '%s'\n", bel.c_str(this), pin.c_str(this));
-    return bdata.pins.at(pin).wire;
+    WireId wire = findBelPinWire(bel, pin);
+    if (wire == WireId())
+        log_error("bel '%s' has no pin '%s'\n", nameOfBel(bel), pin.c_str(this));
+    return wire;
 }
 
-PortType Arch::getBelPinType(BelId bel, IdString pin) const { return bels.at(bel).pins.at(pin).type; }
+WireId Arch::findBelPinWire(BelId bel, IdString pin) const
+{
+    const BelInfoPOD &bdata = chip_info->bel_data[bel.index];
+    for (int32_t i = bdata.bel_wires_begin; i < bdata.bel_wires_end; i++) {
+        const BelWirePOD &bw = chip_info->bel_wires[i];
+        if (db_ids[bw.port] == pin) {
+            WireId wire;
+            wire.index = bw.wire_index;
+            return wire;
+        }
+    }
+    return WireId();
+}
+
+PortType Arch::getBelPinType(BelId bel, IdString pin) const
+{
+    const BelInfoPOD &bdata = chip_info->bel_data[bel.index];
+    for (int32_t i = bdata.bel_wires_begin; i < bdata.bel_wires_end; i++) {
+        const BelWirePOD &bw = chip_info->bel_wires[i];
+        if (db_ids[bw.port] == pin)
+            return PortType(bw.type);
+    }
+    log_error("bel '%s' has no pin '%s'\n", nameOfBel(bel), pin.c_str(this));
+}
 
 std::vector<IdString> Arch::getBelPins(BelId bel) const
 {
     std::vector<IdString> ret;
-    for (auto &it : bels.at(bel).pins)
-        ret.push_back(it.first);
+    const BelInfoPOD &bdata = chip_info->bel_data[bel.index];
+    for (int32_t i = bdata.bel_wires_begin; i < bdata.bel_wires_end; i++)
+        ret.push_back(db_ids[chip_info->bel_wires[i].port]);
     return ret;
 }
 
@@ -2354,26 +402,37 @@ std::vector<IdString> Arch::getBelPins(BelId bel) const
 
 WireId Arch::getWireByName(IdString name) const
 {
-    if (wires.count(name))
-        return name;
+    uint64_t key;
+    if (!nameToKey(name, key))
+        return WireId();
+    std::call_once(wire_by_name_once, [&]() {
+        for (int32_t i = 0; i < chip_info->num_wires; i++)
+            wire_by_name[name_key(chip_info->wire_data[i].name)].index = i;
+    });
+    auto fnd = wire_by_name.find(key);
+    if (fnd != wire_by_name.end())
+        return fnd->second;
     return WireId();
 }
 
-IdString Arch::getWireName(WireId wire) const { return wire; }
-
-IdString Arch::getWireType(WireId wire) const { return wires.at(wire).type; }
+IdString Arch::getWireName(WireId wire) const
+{
+    return nameFromPOD(chip_info->wire_data[wire.index].name, wire_name_ids[wire.index]);
+}
 
-const std::map<IdString, std::string> &Arch::getWireAttrs(WireId wire) const { return wires.at(wire).attrs; }
+IdString Arch::getWireType(WireId wire) const { return db_ids[chip_info->wire_data[wire.index].type]; }
 
-uint32_t Arch::getWireChecksum(WireId wire) const
+const std::map<IdString, std::string> &Arch::getWireAttrs(WireId wire) const
 {
-    // FIXME
-    return 0;
+    auto fnd = wire_attrs.find(wire);
+    return fnd != wire_attrs.end() ? fnd->second : no_attrs;
 }
 
+uint32_t Arch::getWireChecksum(WireId wire) const { return wire.index; }
+
 void Arch::bindWire(WireId wire, NetInfo *net, PlaceStrength strength)
 {
-    wires.at(wire).bound_net = net;
+    wire_to_net[wire.index] = net;
     net->wires[wire].pip = PipId();
     net->wires[wire].strength = strength;
     refreshUiWire(wire);
@@ -2381,55 +440,81 @@ void Arch::bindWire(WireId wire, NetInfo *net, PlaceStrength strength)
 
 void Arch::unbindWire(WireId wire)
 {
-    auto &net_wires = wires.at(wire).bound_net->wires;
+    auto &net_wires = wire_to_net[wire.index]->wires;
 
     auto pip = net_wires.at(wire).pip;
     if (pip != PipId()) {
-        pips.at(pip).bound_net = nullptr;
+        pip_to_net[pip.index] = nullptr;
         refreshUiPip(pip);
     }
 
     net_wires.erase(wire);
-    wires.at(wire).bound_net = nullptr;
+    wire_to_net[wire.index] = nullptr;
     refreshUiWire(wire);
 }
 
-bool Arch::checkWireAvail(WireId wire) const { return wires.at(wire).bound_net == nullptr; }
+bool Arch::checkWireAvail(WireId wire) const { return wire_to_net[wire.index] == nullptr; }
 
-NetInfo *Arch::getBoundWireNet(WireId wire) const { return wires.at(wire).bound_net; }
+NetInfo *Arch::getBoundWireNet(WireId wire) const { return wire_to_net[wire.index]; }
 
-NetInfo *Arch::getConflictingWireNet(WireId wire) const { return wires.at(wire).bound_net; }
+NetInfo *Arch::getConflictingWireNet(WireId wire) const { return wire_to_net[wire.index]; }
 
-const std::vector<BelPin> &Arch::getWireBelPins(WireId wire) const { return wires.at(wire).bel_pins; }
+BelPinRange Arch::getWireBelPins(WireId wire) const
+{
+    const WireInfoPOD &wdata = chip_info->wire_data[wire.index];
+    BelPinRange range;
+    range.b.ptr = chip_info->wire_bel_pins.get() + wdata.bel_pins_begin;
+    range.b.ids = db_ids.data();
+    range.e.ptr = chip_info->wire_bel_pins.get() + wdata.bel_pins_end;
+    range.e.ids = db_ids.data();
+    return range;
+}
 
-const std::vector<WireId> &Arch::getWires() const { return wire_ids; }
+WireRange Arch::getWires() const
+{
+    WireRange range;
+    range.b.cursor = 0;
+    range.e.cursor = chip_info->num_wires;
+    return range;
+}
 
 // ---------------------------------------------------------------
 
 PipId Arch::getPipByName(IdString name) const
 {
-    if (pips.count(name))
-        return name;
+    uint64_t key;
+    if (!nameToKey(name, key))
+        return PipId();
+    std::call_once(pip_by_name_once, [&]() {
+        for (int32_t i = 0; i < chip_info->num_pips; i++)
+            pip_by_name[name_key(chip_info->pip_data[i].name)].index = i;
+    });
+    auto fnd = pip_by_name.find(key);
+    if (fnd != pip_by_name.end())
+        return fnd->second;
     return PipId();
 }
 
-IdString Arch::getPipName(PipId pip) const { return pip; }
-
-IdString Arch::getPipType(PipId pip) const { return pips.at(pip).type; }
+IdString Arch::getPipName(PipId pip) const
+{
+    return nameFromPOD(chip_info->pip_data[pip.index].name, pip_name_ids[pip.index]);
+}
 
-const std::map<IdString, std::string> &Arch::getPipAttrs(PipId pip) const { return pips.at(pip).attrs; }
+IdString Arch::getPipType(PipId pip) const { return db_ids[chip_info->pip_data[pip.index].type]; }
 
-uint32_t Arch::getPipChecksum(PipId wire) const
+const std::map<IdString, std::string> &Arch::getPipAttrs(PipId pip) const
 {
-    // FIXME
-    return 0;
+    auto fnd = pip_attrs.find(pip);
+    return fnd != pip_attrs.end() ? fnd->second : no_attrs;
 }
 
+uint32_t Arch::getPipChecksum(PipId pip) const { return pip.index; }
+
 void Arch::bindPip(PipId pip, NetInfo *net, PlaceStrength strength)
 {
-    WireId wire = pips.at(pip).dstWire;
-    pips.at(pip).bound_net = net;
-    wires.at(wire).bound_net = net;
+    WireId wire = getPipDstWire(pip);
+    pip_to_net[pip.index] = net;
+    wire_to_net[wire.index] = net;
     net->wires[wire].pip = pip;
     net->wires[wire].strength = strength;
     refreshUiPip(pip);
@@ -2438,37 +523,80 @@ void Arch::bindPip(PipId pip, NetInfo *net, PlaceStrength strength)
 
 void Arch::unbindPip(PipId pip)
 {
-    WireId wire = pips.at(pip).dstWire;
-    wires.at(wire).bound_net->wires.erase(wire);
-    pips.at(pip).bound_net = nullptr;
-    wires.at(wire).bound_net = nullptr;
+    WireId wire = getPipDstWire(pip);
+    wire_to_net[wire.index]->wires.erase(wire);
+    pip_to_net[pip.index] = nullptr;
+    wire_to_net[wire.index] = nullptr;
     refreshUiPip(pip);
     refreshUiWire(wire);
 }
 
-bool Arch::checkPipAvail(PipId pip) const { return pips.at(pip).bound_net == nullptr; }
+bool Arch::checkPipAvail(PipId pip) const { return pip_to_net[pip.index] == nullptr; }
 
-NetInfo *Arch::getBoundPipNet(PipId pip) const { return pips.at(pip).bound_net; }
+NetInfo *Arch::getBoundPipNet(PipId pip) const { return pip_to_net[pip.index]; }
 
-NetInfo *Arch::getConflictingPipNet(PipId pip) const { return pips.at(pip).bound_net; }
+NetInfo *Arch::getConflictingPipNet(PipId pip) const { return pip_to_net[pip.index]; }
 
-WireId Arch::getConflictingPipWire(PipId pip) const { return pips.at(pip).bound_net ? pips.at(pip).dstWire : WireId(); }
+WireId Arch::getConflictingPipWire(PipId pip) const { return pip_to_net[pip.index] ? getPipDstWire(pip) : WireId(); }
 
-const std::vector<PipId> &Arch::getPips() const { return pip_ids; }
+AllPipRange Arch::getPips() const
+{
+    AllPipRange range;
+    range.b.cursor = 0;
+    range.e.cursor = chip_info->num_pips;
+    return range;
+}
 
-Loc Arch::getPipLocation(PipId pip) const { return pips.at(pip).loc; }
+Loc Arch::getPipLocation(PipId pip) const
+{
+    const LocPOD &loc = chip_info->pip_loc[pip.index];
+    return Loc(loc.x, loc.y, loc.z);
+}
 
-WireId Arch::getPipSrcWire(PipId pip) const { return pips.at(pip).srcWire; }
+WireId Arch::getPipSrcWire(PipId pip) const
+{
+    WireId wire;
+    wire.index = chip_info->pip_src[pip.index];
+    return wire;
+}
 
-WireId Arch::getPipDstWire(PipId pip) const { return pips.at(pip).dstWire; }
+WireId Arch::getPipDstWire(PipId pip) const
+{
+    WireId wire;
+    wire.index = chip_info->pip_dst[pip.index];
+    return wire;
+}
 
-DelayInfo Arch::getPipDelay(PipId pip) const { return pips.at(pip).delay; }
+DelayInfo Arch::getPipDelay(PipId pip) const
+{
+    DelayInfo delay;
+    delay.delay = chip_info->pip_delay[pip.index];
+    return delay;
+}
 
-const std::vector<PipId> &Arch::getPipsDownhill(WireId wire) const { return wires.at(wire).downhill; }
+PipRange Arch::getPipsDownhill(WireId wire) const
+{
+    const WireInfoPOD &wdata = chip_info->wire_data[wire.index];
+    PipRange range;
+    range.b.cursor = chip_info->wire_pips.get() + wdata.downhill_begin;
+    range.e.cursor = chip_info->wire_pips.get() + wdata.downhill_end;
+    return range;
+}
 
-const std::vector<PipId> &Arch::getPipsUphill(WireId wire) const { return wires.at(wire).uphill; }
+PipRange Arch::getPipsUphill(WireId wire) const
+{
+    const WireInfoPOD &wdata = chip_info->wire_data[wire.index];
+    PipRange range;
+    range.b.cursor = chip_info->wire_pips.get() + wdata.uphill_begin;
+    range.e.cursor = chip_info->wire_pips.get() + wdata.uphill_end;
+    return range;
+}
 
-const std::vector<PipId> &Arch::getWireAliases(WireId wire) const { return wires.at(wire).aliases; }
+PipRange Arch::getWireAliases(WireId wire) const
+{
+    // The borca fabric has no wire aliases
+    return PipRange();
+}
 
 // ---------------------------------------------------------------
 
@@ -2494,18 +622,44 @@ const std::vector<GroupId> &Arch::getGroupGroups(GroupId group) const { return g
 
 // ---------------------------------------------------------------
 
+void Arch::setupLookahead()
+{
+    if (lookahead.ready())
+        return;
+    // The table only depends on the routing graph, which is determined by the database format and fabric size
+    uint64_t key = BORCA_CHIPDB_VERSION;
+    boost::hash_combine(key, chip_info->width);
+    boost::hash_combine(key, chip_info->height);
+    boost::hash_combine(key, chip_info->size);
+    lookahead.init(getCtx(), get_cache_path(stringf("borca-%dx%d.lookahead", chip_info->width, chip_info->height)),
+                   key, [&](WireId wire) {
+                       const LocPOD &loc = chip_info->wire_loc[wire.index];
+                       return Loc(loc.x, loc.y, 0);
+                   });
+}
+
 delay_t Arch::estimateDelay(WireId src, WireId dst) const
 {
-    const WireInfo &s = wires.at(src);
-    const WireInfo &d = wires.at(dst);
-    int dx = abs(s.x - d.x);
-    int dy = abs(s.y - d.y);
+    const LocPOD &src_loc = chip_info->wire_loc[src.index];
+    const LocPOD &dst_loc = chip_info->wire_loc[dst.index];
+    int dx = abs(src_loc.x - dst_loc.x);
+    int dy = abs(src_loc.y - dst_loc.y);
+    delay_t delay;
+    if (lookahead.lookup(getWireType(src), dx, dy, delay))
+        return delay;
     return (dx + dy) * args.delayScale + args.delayOffset;
 }
 
 delay_t Arch::predictDelay(const NetInfo *net_info, const PortRef &sink) const
 {
     const auto &driver = net_info->driver;
+    if (lookahead.ready()) {
+        WireId src = findBelPinWire(driver.cell->bel, driver.port);
+        WireId dst = findBelPinWire(sink.cell->bel, sink.port);
+        if (src != WireId() && dst != WireId())
+            return estimateDelay(src, dst);
+    }
+
     auto driver_loc = getBelLocation(driver.cell->bel);
     auto sink_loc = getBelLocation(sink.cell->bel);
 
@@ -2520,10 +674,10 @@ ArcBounds Arch::getRouteBoundingBox(WireId src, WireId dst) const
 {
     ArcBounds bb;
 
-    int src_x = wires.at(src).x;
-    int src_y = wires.at(src).y;
-    int dst_x = wires.at(dst).x;
-    int dst_y = wires.at(dst).y;
+    int src_x = chip_info->wire_loc[src.index].x;
+    int src_y = chip_info->wire_loc[src.index].y;
+    int dst_x = chip_info->wire_loc[dst.index].x;
+    int dst_y = chip_info->wire_loc[dst.index].y;
 
     bb.x0 = src_x;
     bb.y0 = src_y;
@@ -2544,6 +698,8 @@ ArcBounds Arch::getRouteBoundingBox(WireId src, WireId dst) const
 
 bool Arch::place()
 {
+    setupLookahead();
+    cellTimings.intern();
     std::string placer = str_or_default(settings, id("placer"), defaultPlacer);
     if (placer == "heap") {
 //        bool have_iobuf_or_constr = false;
@@ -2565,6 +721,8 @@ bool Arch::place()
 //            retVal = placer_heap(getCtx(), cfg);
 //        }
         PlacerHeapCfg cfg(getCtx());
+        // Carries bind their driving LUTs when legalised
+        cfg.serialLegaliseTypes.insert(id("CARRY4"));
         bool retVal = placer_heap(getCtx(), cfg);
         getCtx()->settings[getCtx()->id("place")] = 1;
         archInfoToAttributes();
@@ -2581,6 +739,8 @@ bool Arch::place()
 
 bool Arch::route()
 {
+    setupLookahead();
+    cellTimings.intern();
     std::string router = str_or_default(settings, id("router"), defaultRouter);
     bool result;
     if (router == "router1") {
@@ -2607,11 +767,11 @@ const std::vector<GraphicElement> &Arch::getDecalGraphics(DecalId decal) const
     return decal_graphics.at(decal);
 }
 
-DecalXY Arch::getBelDecal(BelId bel) const { return bels.at(bel).decalxy; }
+DecalXY Arch::getBelDecal(BelId bel) const { return get_or_default(bel_decals, bel, DecalXY()); }
 
-DecalXY Arch::getWireDecal(WireId wire) const { return wires.at(wire).decalxy; }
+DecalXY Arch::getWireDecal(WireId wire) const { return get_or_default(wire_decals, wire, DecalXY()); }
 
-DecalXY Arch::getPipDecal(PipId pip) const { return pips.at(pip).decalxy; }
+DecalXY Arch::getPipDecal(PipId pip) const { return get_or_default(pip_decals, pip, DecalXY()); }
 
 DecalXY Arch::getGroupDecal(GroupId group) const { return groups.at(group).decalxy; }
 
@@ -2619,11 +779,11 @@ DecalXY Arch::getGroupDecal(GroupId group) const { return groups.at(group).decal
 
 bool Arch::getCellDelay(const CellInfo *cell, IdString fromPort, IdString toPort, DelayInfo &delay) const
 {
-    if (!cellTiming.count(cell->name))
+    const CellTiming *tmg = getCellTiming(cell);
+    if (tmg == nullptr)
         return false;
-    const auto &tmg = cellTiming.at(cell->name);
-    auto fnd = tmg.combDelays.find(CellDelayKey{fromPort, toPort});
-    if (fnd != tmg.combDelays.end()) {
+    auto fnd = tmg->combDelays.find(CellDelayKey{fromPort, toPort});
+    if (fnd != tmg->combDelays.end()) {
         delay = fnd->second;
         return true;
     } else {
@@ -2634,50 +794,29 @@ bool Arch::getCellDelay(const CellInfo *cell, IdString fromPort, IdString toPort
 // Get the port class, also setting clockPort if applicable
 TimingPortClass Arch::getPortTimingClass(const CellInfo *cell, IdString port, int &clockInfoCount) const
 {
-    if (!cellTiming.count(cell->name))
+    const CellTiming *tmg = getCellTiming(cell);
+    if (tmg == nullptr)
         return TMG_IGNORE;
-    const auto &tmg = cellTiming.at(cell->name);
-    if (tmg.clockingInfo.count(port))
-        clockInfoCount = int(tmg.clockingInfo.at(port).size());
-    else
-        clockInfoCount = 0;
-    return get_or_default(tmg.portClasses, port, TMG_IGNORE);
+    auto fnd = tmg->clockingInfo.find(port);
+    clockInfoCount = fnd != tmg->clockingInfo.end() ? int(fnd->second.size()) : 0;
+    return tmg->port_class(port);
 }
 
 TimingClockingInfo Arch::getPortClockingInfo(const CellInfo *cell, IdString port, int index) const
 {
-    NPNR_ASSERT(cellTiming.count(cell->name));
-    const auto &tmg = cellTiming.at(cell->name);
-    NPNR_ASSERT(tmg.clockingInfo.count(port));
-    return tmg.clockingInfo.at(port).at(index);
+    const CellTiming *tmg = getCellTiming(cell);
+    NPNR_ASSERT(tmg != nullptr);
+    NPNR_ASSERT(tmg->clockingInfo.count(port));
+    return tmg->clockingInfo.at(port).at(index);
 }
 
 bool Arch::isValidBelForCell(CellInfo *cell, BelId bel) const
 {
-    std::vector<const CellInfo *> cells;
-    cells.push_back(cell);
-    Loc loc = getBelLocation(bel);
-    for (auto tbel : getBelsByTile(loc.x, loc.y)) {
-        if (tbel == bel)
-            continue;
-        CellInfo *bound = getBoundBelCell(tbel);
-        if (bound != nullptr)
-            cells.push_back(bound);
-    }
-    return cellsCompatible(cells.data(), int(cells.size()));
+    // Whatever is bound at the bel itself is replaced by cell
+    return tileCompatible(bel, getBoundBelCell(bel), cell);
 }
 
-bool Arch::isBelLocationValid(BelId bel) const
-{
-    std::vector<const CellInfo *> cells;
-    Loc loc = getBelLocation(bel);
-    for (auto tbel : getBelsByTile(loc.x, loc.y)) {
-        CellInfo *bound = getBoundBelCell(tbel);
-        if (bound != nullptr)
-            cells.push_back(bound);
-    }
-    return cellsCompatible(cells.data(), int(cells.size()));
-}
+bool Arch::isBelLocationValid(BelId bel) const { return tileCompatible(bel, nullptr, nullptr); }
 
 #ifdef WITH_HEAP
 const std::string Arch::defaultPlacer = "heap";
@@ -2706,28 +845,83 @@ void Arch::assignArchInfo()
         }
         ci->user_group = int_or_default(ci->attrs, id("PACK_GROUP"), -1);
     }
+    rebuildTileStatus();
 }
 
-bool Arch::cellsCompatible(const CellInfo **cells, int count) const
+namespace {
+
+template <typename T> void update_count(std::vector<std::pair<T, int>> &counts, T value, int delta)
 {
-    const NetInfo *clk = nullptr;
-    int group = -1;
-    for (int i = 0; i < count; i++) {
-        const CellInfo *ci = cells[i];
-        if (ci->is_slice && ci->slice_clk != nullptr) {
-            if (clk == nullptr)
-                clk = ci->slice_clk;
-            else if (clk != ci->slice_clk)
-                return false;
+    for (auto it = counts.begin(); it != counts.end(); ++it) {
+        if (it->first == value) {
+            it->second += delta;
+            if (it->second <= 0)
+                counts.erase(it);
+            return;
         }
-        if (ci->user_group != -1) {
-            if (group == -1)
-                group = ci->user_group;
-            else if (group != ci->user_group)
+    }
+    if (delta > 0)
+        counts.emplace_back(value, delta);
+}
+
+// Whether at most one distinct value is left after taking out one use of removed and adding one of added, where
+// none stands for no value
+template <typename T>
+bool single_value(const std::vector<std::pair<T, int>> &counts, T removed, T added, T none)
+{
+    bool found = false;
+    T value = none;
+    for (auto &c : counts) {
+        int count = c.second;
+        if (removed != none && c.first == removed)
+            --count;
+        if (count > 0) {
+            if (found)
                 return false;
+            found = true;
+            value = c.first;
         }
     }
-    return true;
+    return added == none || !found || value == added;
+}
+
+} // namespace
+
+void Arch::updateTileStatus(BelId bel, const CellInfo *cell, int delta)
+{
+    const LocPOD &loc = chip_info->bel_data[bel.index].loc;
+    TileStatus &ts = tile_status[loc.x * gridDimY + loc.y];
+    if (cell->is_slice && cell->slice_clk != nullptr)
+        update_count(ts.clocks, cell->slice_clk, delta);
+    if (cell->user_group != -1)
+        update_count(ts.groups, cell->user_group, delta);
+}
+
+void Arch::rebuildTileStatus()
+{
+    for (auto &ts : tile_status) {
+        ts.clocks.clear();
+        ts.groups.clear();
+    }
+    for (int i = 0; i < chip_info->num_bels; i++) {
+        if (bel_to_cell[i] != nullptr) {
+            BelId bel;
+            bel.index = i;
+            updateTileStatus(bel, bel_to_cell[i], 1);
+        }
+    }
+}
+
+bool Arch::tileCompatible(BelId bel, const CellInfo *removed, const CellInfo *added) const
+{
+    const LocPOD &loc = chip_info->bel_data[bel.index].loc;
+    const TileStatus &ts = tile_status[loc.x * gridDimY + loc.y];
+    auto clock_of = [](const CellInfo *ci) -> const NetInfo * {
+        return (ci != nullptr && ci->is_slice) ? ci->slice_clk : nullptr;
+    };
+    auto group_of = [](const CellInfo *ci) { return ci != nullptr ? ci->user_group : -1; };
+    return single_value(ts.clocks, clock_of(removed), clock_of(added), static_cast<const NetInfo *>(nullptr)) &&
+           single_value(ts.groups, group_of(removed), group_of(added), -1);
 }
 
 NEXTPNR_NAMESPACE_END
@@ -21,136 +21,316 @@
 #error Include "arch.h" via "nextpnr.h" only.
 #endif
 
+#include "cell_timing.h"
+#include "lookahead.h"
+
 NEXTPNR_NAMESPACE_BEGIN
 
-struct ArchArgs
+/**** Everything in this section must be kept in sync with the generator in chipdb.cc ****/
+
+template <typename T> struct RelPtr
 {
-    // Number of LUT inputs
-    int K = 4;
-    // y = mx + c relationship between distance and delay for interconnect
-    // delay estimates
-    double delayScale = 0.1, delayOffset = 0;
+    int32_t offset;
+
+    const T *get() const { return reinterpret_cast<const T *>(reinterpret_cast<const char *>(this) + offset); }
+
+    const T &operator[](size_t index) const { return get()[index]; }
+
+    const T &operator*() const { return *(get()); }
+
+    const T *operator->() const { return get(); }
 };
 
-struct WireInfo;
+// Every name in the fabric is "X<x>Y<y>" followed by a suffix from the string table,
+// so names are only built when asked for
+NPNR_PACKED_STRUCT(struct NamePOD {
+    int16_t x, y;
+    int32_t suffix;
+});
+
+NPNR_PACKED_STRUCT(struct LocPOD {
+    int16_t x, y, z;
+});
+
+NPNR_PACKED_STRUCT(struct BelWirePOD {
+    int32_t port;
+    int32_t type;
+    int32_t wire_index;
+});
+
+NPNR_PACKED_STRUCT(struct BelInfoPOD {
+    NamePOD name;
+    int32_t type;
+    LocPOD loc;
+    int8_t gb;
+    int8_t padding_0;
+    int32_t bel_wires_begin, bel_wires_end;
+});
+
+NPNR_PACKED_STRUCT(struct BelPortPOD {
+    int32_t bel_index;
+    int32_t port;
+});
+
+NPNR_PACKED_STRUCT(struct WireInfoPOD {
+    NamePOD name;
+    int32_t type;
+    int32_t uphill_begin, uphill_end;
+    int32_t downhill_begin, downhill_end;
+    int32_t bel_pins_begin, bel_pins_end;
+});
+
+NPNR_PACKED_STRUCT(struct PipInfoPOD {
+    NamePOD name;
+    int32_t type;
+});
+
+enum : int32_t
+{
+    BORCA_CHIPDB_MAGIC = 0x41435242, // "BRCA"
+    BORCA_CHIPDB_VERSION = 2
+};
 
-struct PipInfo
+NPNR_PACKED_STRUCT(struct ChipInfoPOD {
+    int32_t magic, version, size;
+    int32_t width, height;
+    int32_t num_strings, num_bels, num_wires, num_pips;
+    RelPtr<RelPtr<char>> strings;
+    // Indexed by x * height + y
+    RelPtr<int32_t> tile_bel_dimz, tile_pip_dimz;
+    RelPtr<BelInfoPOD> bel_data;
+    RelPtr<BelWirePOD> bel_wires;
+    RelPtr<WireInfoPOD> wire_data;
+    RelPtr<BelPortPOD> wire_bel_pins;
+    // Uphill and downhill pip lists of all wires, referenced by WireInfoPOD
+    RelPtr<int32_t> wire_pips;
+    RelPtr<PipInfoPOD> pip_data;
+    // Flat arrays of the data used by the placer and router inner loops
+    RelPtr<LocPOD> wire_loc;
+    RelPtr<int32_t> pip_src, pip_dst;
+    RelPtr<float> pip_delay;
+    RelPtr<LocPOD> pip_loc;
+});
+
+/************************ End of chipdb section. ************************/
+
+struct BelIterator
 {
-    IdString name, type;
-    std::map<IdString, std::string> attrs;
-    NetInfo *bound_net;
-    WireId srcWire, dstWire;
-    DelayInfo delay;
-    DecalXY decalxy;
-    Loc loc;
+    int cursor;
+
+    BelIterator operator++()
+    {
+        cursor++;
+        return *this;
+    }
+    BelIterator operator++(int)
+    {
+        BelIterator prior(*this);
+        cursor++;
+        return prior;
+    }
+
+    bool operator!=(const BelIterator &other) const { return cursor != other.cursor; }
+
+    bool operator==(const BelIterator &other) const { return cursor == other.cursor; }
+
+    BelId operator*() const
+    {
+        BelId ret;
+        ret.index = cursor;
+        return ret;
+    }
 };
 
-struct WireInfo
+struct BelRange
 {
-    IdString name, type;
-    std::map<IdString, std::string> attrs;
-    NetInfo *bound_net;
-    std::vector<PipId> downhill, uphill, aliases;
-    BelPin uphill_bel_pin;
-    std::vector<BelPin> downhill_bel_pins;
-    std::vector<BelPin> bel_pins;
-    DecalXY decalxy;
-    int x, y;
+    BelIterator b, e;
+    BelIterator begin() const { return b; }
+    BelIterator end() const { return e; }
 };
 
-struct PinInfo
+// -----------------------------------------------------------------------
+
+struct BelPinIterator
 {
-    IdString name;
-    WireId wire;
-    PortType type;
+    const BelPortPOD *ptr = nullptr;
+    const IdString *ids = nullptr;
+
+    void operator++() { ptr++; }
+    bool operator!=(const BelPinIterator &other) const { return ptr != other.ptr; }
+
+    BelPin operator*() const
+    {
+        BelPin ret;
+        ret.bel.index = ptr->bel_index;
+        ret.pin = ids[ptr->port];
+        return ret;
+    }
 };
 
-struct BelInfo
+struct BelPinRange
 {
-    IdString name, type;
-    std::map<IdString, std::string> attrs;
-    CellInfo *bound_cell;
-    std::unordered_map<IdString, PinInfo> pins;
-    DecalXY decalxy;
-    int x, y, z;
-    bool gb;
+    BelPinIterator b, e;
+    BelPinIterator begin() const { return b; }
+    BelPinIterator end() const { return e; }
 };
 
-struct GroupInfo
+// -----------------------------------------------------------------------
+
+struct WireIterator
 {
-    IdString name;
-    std::vector<BelId> bels;
-    std::vector<WireId> wires;
-    std::vector<PipId> pips;
-    std::vector<GroupId> groups;
-    DecalXY decalxy;
+    int cursor = -1;
+
+    void operator++() { cursor++; }
+    bool operator!=(const WireIterator &other) const { return cursor != other.cursor; }
+
+    WireId operator*() const
+    {
+        WireId ret;
+        ret.index = cursor;
+        return ret;
+    }
 };
 
-struct CellDelayKey
+struct WireRange
 {
-    IdString from, to;
-    inline bool operator==(const CellDelayKey &other) const { return from == other.from && to == other.to; }
+    WireIterator b, e;
+    WireIterator begin() const { return b; }
+    WireIterator end() const { return e; }
 };
 
-NEXTPNR_NAMESPACE_END
-namespace std {
-template <> struct hash<NEXTPNR_NAMESPACE_PREFIX CellDelayKey>
+// -----------------------------------------------------------------------
+
+struct AllPipIterator
 {
-    std::size_t operator()(const NEXTPNR_NAMESPACE_PREFIX CellDelayKey &dk) const noexcept
+    int cursor = -1;
+
+    void operator++() { cursor++; }
+    bool operator!=(const AllPipIterator &other) const { return cursor != other.cursor; }
+
+    PipId operator*() const
     {
-        std::size_t seed = std::hash<NEXTPNR_NAMESPACE_PREFIX IdString>()(dk.from);
-        seed ^= std::hash<NEXTPNR_NAMESPACE_PREFIX IdString>()(dk.to) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        return seed;
+        PipId ret;
+        ret.index = cursor;
+        return ret;
     }
 };
-} // namespace std
-NEXTPNR_NAMESPACE_BEGIN
 
-struct CellTiming
+struct AllPipRange
+{
+    AllPipIterator b, e;
+    AllPipIterator begin() const { return b; }
+    AllPipIterator end() const { return e; }
+};
+
+// -----------------------------------------------------------------------
+
+struct PipIterator
+{
+    const int *cursor = nullptr;
+
+    void operator++() { cursor++; }
+    bool operator!=(const PipIterator &other) const { return cursor != other.cursor; }
+
+    PipId operator*() const
+    {
+        PipId ret;
+        ret.index = *cursor;
+        return ret;
+    }
+};
+
+struct PipRange
+{
+    PipIterator b, e;
+    PipIterator begin() const { return b; }
+    PipIterator end() const { return e; }
+};
+
+struct ArchArgs
+{
+    // Fabric size in tiles
+    int width = 8, height = 8;
+    // Routing graph database; generated (and cached here) if missing or stale. If empty, a per-user cache
+    // directory is used
+    std::string chipdb;
+    // Number of LUT inputs
+    int K = 4;
+    // y = mx + c relationship between distance and delay for interconnect
+    // delay estimates
+    double delayScale = 0.1, delayOffset = 0;
+    // Cell timing library to use instead of the built-in one (borca/cell_timing.txt)
+    std::string timing_lib;
+};
+
+struct GroupInfo
 {
-    std::unordered_map<IdString, TimingPortClass> portClasses;
-    std::unordered_map<CellDelayKey, DelayInfo> combDelays;
-    std::unordered_map<IdString, std::vector<TimingClockingInfo>> clockingInfo;
+    IdString name;
+    std::vector<BelId> bels;
+    std::vector<WireId> wires;
+    std::vector<PipId> pips;
+    std::vector<GroupId> groups;
+    DecalXY decalxy;
 };
 
 struct Arch : BaseCtx
 {
     std::string chipName;
 
-    std::unordered_map<IdString, WireInfo> wires;
-    std::unordered_map<IdString, PipInfo> pips;
-    std::unordered_map<IdString, BelInfo> bels;
-    std::unordered_map<GroupId, GroupInfo> groups;
-
-    // These functions include useful errors if not found
-    WireInfo &wire_info(IdString wire);
-    PipInfo &pip_info(IdString wire);
-    BelInfo &bel_info(IdString wire);
+    const ChipInfoPOD *chip_info = nullptr;
+    // Keeps the mapped database file (or the in-memory copy, if it could not be cached) alive
+    std::shared_ptr<const void> chipdb_storage;
+    // The database string table, and the reverse mapping used to parse names
+    std::vector<IdString> db_ids;
+    std::unordered_map<std::string, int32_t> db_string_index;
+
+    std::vector<NetInfo *> wire_to_net, pip_to_net;
+    std::vector<CellInfo *> bel_to_cell;
+    // Clocks and pack groups of the cells bound in each tile (indexed as tile_bel_dimz), with the number of cells
+    // using each. Kept up to date by bindBel and unbindBel so that the validity checks do not have to look at every
+    // bel in the tile; a legal tile uses at most one of each.
+    struct TileStatus
+    {
+        std::vector<std::pair<const NetInfo *, int>> clocks;
+        std::vector<std::pair<int, int>> groups;
+    };
+    std::vector<TileStatus> tile_status;
+
+    // Name lookups are rare, so these are only built on first use, once even if several threads ask at the same
+    // time. Keyed by NamePOD
+    mutable std::unordered_map<uint64_t, BelId> bel_by_name;
+    mutable std::unordered_map<uint64_t, WireId> wire_by_name;
+    mutable std::unordered_map<uint64_t, PipId> pip_by_name;
+    mutable std::once_flag bel_by_name_once, wire_by_name_once, pip_by_name_once;
+
+    // IdString index of each bel, wire and pip name, or -1 until it is first asked for; interning every name up
+    // front would dominate startup for large fabrics
+    std::unique_ptr<std::atomic<int>[]> bel_name_ids, wire_name_ids, pip_name_ids;
+
+    IdString nameFromPOD(const NamePOD &name, std::atomic<int> &cached_id) const;
+    // Returns false if the name cannot belong to the fabric at all
+    bool nameToKey(IdString name, uint64_t &key) const;
+
+    std::unordered_map<BelId, std::map<IdString, std::string>> bel_attrs;
+    std::unordered_map<WireId, std::map<IdString, std::string>> wire_attrs;
+    std::unordered_map<PipId, std::map<IdString, std::string>> pip_attrs;
+
+    std::unordered_map<BelId, DecalXY> bel_decals;
+    std::unordered_map<WireId, DecalXY> wire_decals;
+    std::unordered_map<PipId, DecalXY> pip_decals;
 
-    std::vector<IdString> bel_ids, wire_ids, pip_ids;
+    std::unordered_map<GroupId, GroupInfo> groups;
 
-    std::unordered_map<Loc, BelId> bel_by_loc;
     std::vector<std::vector<std::vector<BelId>>> bels_by_tile;
 
     std::unordered_map<DecalId, std::vector<GraphicElement>> decal_graphics;
 
     int gridDimX, gridDimY;
-    std::vector<std::vector<int>> tileBelDimZ;
-    std::vector<std::vector<int>> tilePipDimZ;
 
-    std::unordered_map<IdString, CellTiming> cellTiming;
-
-    void setupPipsForCLB(int x, int y, int numSingleWires, int numDoubleWires, int side);
-    void setupPipsForSB(int x, int y, int s, int dir1, int dir2);
-
-    void addWire(IdString name, IdString type, int x, int y);
-    void addPip(IdString name, IdString type, IdString srcWire, IdString dstWire, DelayInfo delay, Loc loc);
-    void addAlias(IdString name, IdString type, IdString srcWire, IdString dstWire, DelayInfo delay);
-
-    void addBel(IdString name, IdString type, Loc loc, bool gb);
-    void addBelInput(IdString bel, IdString name, IdString wire);
-    void addBelOutput(IdString bel, IdString name, IdString wire);
-    void addBelInout(IdString bel, IdString name, IdString wire);
+    CellTimingStore cellTimings;
+    // Names of the constant drivers made by the packer
+    IdString packerGndName, packerVccName;
+    const CellTiming *getCellTiming(const CellInfo *cell) const;
 
     void addGroupBel(IdString group, IdString bel);
     void addGroupWire(IdString group, IdString wire);
@@ -175,6 +355,11 @@ struct Arch : BaseCtx
     void addCellTimingSetupHold(IdString cell, IdString port, IdString clock, DelayInfo setup, DelayInfo hold);
     void addCellTimingClockToOut(IdString cell, IdString port, IdString clock, DelayInfo clktoq);
 
+    void addCellTypeTimingClock(IdString type, IdString port);
+    void addCellTypeTimingDelay(IdString type, IdString fromPort, IdString toPort, DelayInfo delay);
+    void addCellTypeTimingSetupHold(IdString type, IdString port, IdString clock, DelayInfo setup, DelayInfo hold);
+    void addCellTypeTimingClockToOut(IdString type, IdString port, IdString clock, DelayInfo clktoq);
+
     // ---------------------------------------------------------------
     // Common Arch API. Every arch must provide the following methods.
 
@@ -185,12 +370,12 @@ struct Arch : BaseCtx
 
     IdString archId() const { return id("borca"); }
     ArchArgs archArgs() const { return args; }
-    IdString archArgsToId(ArchArgs args) const { return id("none"); }
+    IdString archArgsToId(ArchArgs args) const;
 
     int getGridDimX() const { return gridDimX; }
     int getGridDimY() const { return gridDimY; }
-    int getTileBelDimZ(int x, int y) const { return tileBelDimZ[x][y]; }
-    int getTilePipDimZ(int x, int y) const { return tilePipDimZ[x][y]; }
+    int getTileBelDimZ(int x, int y) const { return chip_info->tile_bel_dimz[x * gridDimY + y]; }
+    int getTilePipDimZ(int x, int y) const { return chip_info->tile_pip_dimz[x * gridDimY + y]; }
 
     BelId getBelByName(IdString name) const;
     IdString getBelName(BelId bel) const;
@@ -204,10 +389,12 @@ struct Arch : BaseCtx
     bool checkBelAvail(BelId bel) const;
     CellInfo *getBoundBelCell(BelId bel) const;
     CellInfo *getConflictingBelCell(BelId bel) const;
-    const std::vector<BelId> &getBels() const;
+    BelRange getBels() const;
     IdString getBelType(BelId bel) const;
     const std::map<IdString, std::string> &getBelAttrs(BelId bel) const;
     WireId getBelPinWire(BelId bel, IdString pin) const;
+    // As getBelPinWire, but returns WireId() if the bel has no such pin
+    WireId findBelPinWire(BelId bel, IdString pin) const;
     PortType getBelPinType(BelId bel, IdString pin) const;
     std::vector<IdString> getBelPins(BelId bel) const;
 
@@ -223,8 +410,10 @@ struct Arch : BaseCtx
     WireId getConflictingWireWire(WireId wire) const { return wire; }
     NetInfo *getConflictingWireNet(WireId wire) const;
     DelayInfo getWireDelay(WireId wire) const { return DelayInfo(); }
-    const std::vector<WireId> &getWires() const;
-    const std::vector<BelPin> &getWireBelPins(WireId wire) const;
+    WireRange getWires() const;
+    int getWireIndex(WireId wire) const { return wire.index; }
+    int getWireIndexCount() const { return chip_info->num_wires; }
+    BelPinRange getWireBelPins(WireId wire) const;
 
     PipId getPipByName(IdString name) const;
     IdString getPipName(PipId pip) const;
@@ -237,14 +426,14 @@ struct Arch : BaseCtx
     NetInfo *getBoundPipNet(PipId pip) const;
     WireId getConflictingPipWire(PipId pip) const;
     NetInfo *getConflictingPipNet(PipId pip) const;
-    const std::vector<PipId> &getPips() const;
+    AllPipRange getPips() const;
     Loc getPipLocation(PipId pip) const;
     WireId getPipSrcWire(PipId pip) const;
     WireId getPipDstWire(PipId pip) const;
     DelayInfo getPipDelay(PipId pip) const;
-    const std::vector<PipId> &getPipsDownhill(WireId wire) const;
-    const std::vector<PipId> &getPipsUphill(WireId wire) const;
-    const std::vector<PipId> &getWireAliases(WireId wire) const;
+    PipRange getPipsDownhill(WireId wire) const;
+    PipRange getPipsUphill(WireId wire) const;
+    PipRange getWireAliases(WireId wire) const;
 
     GroupId getGroupByName(IdString name) const;
     IdString getGroupName(GroupId group) const;
@@ -254,6 +443,10 @@ struct Arch : BaseCtx
     const std::vector<PipId> &getGroupPips(GroupId group) const;
     const std::vector<GroupId> &getGroupGroups(GroupId group) const;
 
+    // Routing delay table, built (or loaded from the cache) on the first place or route
+    DelayLookahead lookahead;
+    void setupLookahead();
+
     delay_t estimateDelay(WireId src, WireId dst) const;
     delay_t predictDelay(const NetInfo *net_info, const PortRef &sink) const;
     delay_t getDelayEpsilon() const { return 0.001; }
@@ -298,8 +491,17 @@ struct Arch : BaseCtx
 
     // ---------------------------------------------------------------
     // Internal usage
+    static void buildChipdb(int width, int height, std::vector<char> &blob);
+    static bool splitName(const std::string &name, int &x, int &y, std::string &suffix);
+    void loadChipdb();
+    // Set the timing of the cell types from the timing library (in timing_lib.cc)
+    void loadTimingLibrary();
     void assignArchInfo();
-    bool cellsCompatible(const CellInfo **cells, int count) const;
+    // Whether a tile stays legal if one cell is removed from it and another added (either may be nullptr)
+    bool tileCompatible(BelId bel, const CellInfo *removed, const CellInfo *added) const;
+    void updateTileStatus(BelId bel, const CellInfo *cell, int delta);
+    // Recompute the status of all tiles, after the clock or group of bound cells has changed
+    void rebuildTileStatus();
 };
 
 NEXTPNR_NAMESPACE_END
@@ -0,0 +1,2359 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2018  Clifford Wolf <clifford@symbioticeda.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <cctype>
+#include <cstddef>
+#include <limits>
+#include <string.h>
+#include "log.h"
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Generates the borca routing graph for a fabric of the given size, and flattens it into the
+// ChipInfoPOD blob described in arch.h. This only runs when the cached database is missing or
+// stale, so it is fine for it to work with strings.
+struct ChipdbBuilder
+{
+    int gridDimX, gridDimY;
+    std::vector<int32_t> tileBelDimZ, tilePipDimZ;
+
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, int32_t> string_index;
+
+    std::vector<BelInfoPOD> bel_data;
+    std::vector<std::pair<int32_t, BelWirePOD>> bel_wires;
+    std::unordered_map<std::string, int32_t> bel_by_name;
+
+    std::vector<NamePOD> wire_name;
+    std::vector<int32_t> wire_type;
+    std::vector<LocPOD> wire_loc;
+    std::vector<std::pair<int32_t, BelPortPOD>> wire_bel_pins;
+    std::unordered_map<std::string, WireId> wire_by_name;
+
+    std::vector<PipInfoPOD> pip_data;
+    std::vector<int32_t> pip_src, pip_dst;
+    std::vector<float> pip_delay;
+    std::vector<LocPOD> pip_loc;
+
+    ChipdbBuilder(int width, int height) : gridDimX(width), gridDimY(height){};
+
+    int32_t stringIndex(const std::string &str);
+    NamePOD splitName(const std::string &name);
+    LocPOD makeLoc(Loc loc);
+    float getDelayFromNS(float ns) const { return ns; }
+
+    WireId getWireByName(const std::string &name) const;
+    void addWire(const std::string &name, const std::string &type, int x, int y);
+    void addPip(const std::string &name, const std::string &type, WireId srcWire, WireId dstWire, float delay,
+                Loc loc);
+    void addBel(const std::string &name, const std::string &type, Loc loc, bool gb);
+    void addBelPin(const std::string &bel, const std::string &name, const std::string &wire, PortType type);
+    void addBelInput(const std::string &bel, const std::string &name, const std::string &wire)
+    {
+        addBelPin(bel, name, wire, PORT_IN);
+    }
+    void addBelOutput(const std::string &bel, const std::string &name, const std::string &wire)
+    {
+        addBelPin(bel, name, wire, PORT_OUT);
+    }
+
+    void setupPipsForCLB(int x, int y, int numSingleWires, int numDoubleWires, int side);
+    void setupPipsForSB(int x, int y, int s, int dir1, int dir2);
+    void build();
+    void write(std::vector<char> &blob) const;
+};
+
+bool Arch::splitName(const std::string &name, int &x, int &y, std::string &suffix)
+{
+    // "X<x>Y<y><suffix>"; the suffix may not start with a digit, so that the split is unambiguous
+    size_t pos = 0;
+    auto parse_int = [&](char prefix, int &value) {
+        if (pos >= name.size() || name[pos] != prefix)
+            return false;
+        size_t start = ++pos;
+        value = 0;
+        while (pos < name.size() && isdigit(name[pos]) && pos - start < 5)
+            value = value * 10 + (name[pos++] - '0');
+        return pos > start;
+    };
+    if (!parse_int('X', x) || !parse_int('Y', y))
+        return false;
+    if (pos < name.size() && isdigit(name[pos]))
+        return false;
+    suffix = name.substr(pos);
+    return true;
+}
+
+int32_t ChipdbBuilder::stringIndex(const std::string &str)
+{
+    auto fnd = string_index.find(str);
+    if (fnd != string_index.end())
+        return fnd->second;
+    int32_t index = int32_t(strings.size());
+    strings.push_back(str);
+    string_index[str] = index;
+    return index;
+}
+
+NamePOD ChipdbBuilder::splitName(const std::string &name)
+{
+    int x, y;
+    std::string suffix;
+    if (!Arch::splitName(name, x, y, suffix))
+        log_error("Borca fabric name '%s' is not of the form X<x>Y<y><suffix>.\n", name.c_str());
+    NamePOD pod;
+    pod.x = int16_t(x);
+    pod.y = int16_t(y);
+    pod.suffix = stringIndex(suffix);
+    return pod;
+}
+
+LocPOD ChipdbBuilder::makeLoc(Loc loc)
+{
+    LocPOD pod;
+    pod.x = int16_t(loc.x);
+    pod.y = int16_t(loc.y);
+    pod.z = int16_t(loc.z);
+    return pod;
+}
+
+WireId ChipdbBuilder::getWireByName(const std::string &name) const
+{
+    auto fnd = wire_by_name.find(name);
+    if (fnd != wire_by_name.end())
+        return fnd->second;
+    return WireId();
+}
+
+void ChipdbBuilder::addWire(const std::string &name, const std::string &type, int x, int y)
+{
+    NPNR_ASSERT(wire_by_name.count(name) == 0);
+    WireId wire;
+    wire.index = int32_t(wire_name.size());
+    wire_by_name[name] = wire;
+
+    wire_name.push_back(splitName(name));
+    wire_type.push_back(stringIndex(type));
+    wire_loc.push_back(makeLoc(Loc(x, y, 0)));
+}
+
+void ChipdbBuilder::addPip(const std::string &name, const std::string &type, WireId srcWire, WireId dstWire,
+                           float delay, Loc loc)
+{
+    NPNR_ASSERT(srcWire != WireId() && dstWire != WireId());
+    PipInfoPOD pi;
+    pi.name = splitName(name);
+    pi.type = stringIndex(type);
+    pip_data.push_back(pi);
+
+    pip_src.push_back(srcWire.index);
+    pip_dst.push_back(dstWire.index);
+    pip_delay.push_back(delay);
+    pip_loc.push_back(makeLoc(loc));
+
+    int32_t &dimz = tilePipDimZ.at(loc.x * gridDimY + loc.y);
+    dimz = std::max(dimz, loc.z + 1);
+}
+
+void ChipdbBuilder::addBel(const std::string &name, const std::string &type, Loc loc, bool gb)
+{
+    NPNR_ASSERT(bel_by_name.count(name) == 0);
+    bel_by_name[name] = int32_t(bel_data.size());
+
+    BelInfoPOD bi;
+    bi.name = splitName(name);
+    bi.type = stringIndex(type);
+    bi.loc = makeLoc(loc);
+    bi.gb = gb;
+    bi.padding_0 = 0;
+    bi.bel_wires_begin = 0;
+    bi.bel_wires_end = 0;
+    bel_data.push_back(bi);
+
+    int32_t &dimz = tileBelDimZ.at(loc.x * gridDimY + loc.y);
+    dimz = std::max(dimz, loc.z + 1);
+}
+
+void ChipdbBuilder::addBelPin(const std::string &bel, const std::string &name, const std::string &wire,
+                              PortType type)
+{
+    NPNR_ASSERT(bel_by_name.count(bel));
+    int32_t bel_index = bel_by_name.at(bel);
+    WireId wire_id = getWireByName(wire);
+    NPNR_ASSERT(wire_id != WireId());
+
+    int32_t port = stringIndex(name);
+    for (auto it = bel_wires.rbegin(); it != bel_wires.rend() && it->first == bel_index; ++it)
+        NPNR_ASSERT(it->second.port != port);
+
+    BelWirePOD bw;
+    bw.port = port;
+    bw.type = type;
+    bw.wire_index = wire_id.index;
+    bel_wires.emplace_back(bel_index, bw);
+
+    BelPortPOD bp;
+    bp.bel_index = bel_index;
+    bp.port = port;
+    wire_bel_pins.emplace_back(wire_id.index, bp);
+}
+
+// ---------------------------------------------------------------
+
+void ChipdbBuilder::setupPipsForCLB(int x, int y, int numSingleWires, int numDoubleWires, int side) {
+
+    std::string CBType = "";
+    int xWire = x;
+    int yWire = y;
+    int lut0Id = 1;
+    int lut1Id = 0;
+    int dff0Id = 1;
+    int dff1Id = 0;
+
+    if (side == 0) {
+        // East
+        CBType = "CB0";
+        xWire = x;
+        yWire = y;
+        lut0Id = 1;
+        lut1Id = 0;
+        dff0Id = 1 + 8;
+        dff1Id = 0 + 8;
+    } else if (side == 1) {
+        // South
+        CBType = "CB1";
+        xWire = x;
+        yWire = y - 1;
+        lut0Id = 3;
+        lut1Id = 2;
+        dff0Id = 3 + 8;
+        dff1Id = 2 + 8;
+    } else if (side == 2) {
+        // West
+        CBType = "CB0";
+        xWire = x - 1;
+        yWire = y;
+        lut0Id = 5;
+        lut1Id = 4;
+        dff0Id = 5 + 8;
+        dff1Id = 4 + 8;
+    } else if (side == 3) {
+        // North
+        CBType = "CB1";
+        xWire = x;
+        yWire = y;
+        lut0Id = 7;
+        lut1Id = 6;
+        dff0Id = 7 + 8;
+        dff1Id = 6 + 8;
+    }
+
+    NPNR_ASSERT(side < 4);
+
+    if (xWire < 0 || yWire < 0)
+        return;
+
+    // PipInfo
+    std::string pipType = "PIP";
+
+    // CLB inputs <- ConnectionBlock
+    for (int k = 0; k < 4; k++) {
+        std::string lut1_input_name = "X" + std::to_string(x) +
+                                      "Y" + std::to_string(y) +
+                                      "Z" + std::to_string(lut0Id) +
+                                      "_" + "I" + std::to_string(k);
+        WireId dst1Wire = getWireByName(lut1_input_name);
+        std::string lut0_input_name = "X" + std::to_string(x) +
+                                      "Y" + std::to_string(y) +
+                                      "Z" + std::to_string(lut1Id) +
+                                      "_" + "I" + std::to_string(k);
+        WireId dst0Wire = getWireByName(lut0_input_name);
+
+        for (int s = 0; s < numSingleWires; s++) {
+            std::string cb_single0_in_name = "X" + std::to_string(xWire) +
+                                             "Y" + std::to_string(yWire) + "_" +
+                                             CBType + "_SINGLE0_IN" + std::to_string(s);
+            std::string cb_single1_in_name = "X" + std::to_string(xWire) +
+                                             "Y" + std::to_string(yWire) + "_" +
+                                             CBType + "_SINGLE1_IN" + std::to_string(s);
+
+            WireId src0Wire = getWireByName(cb_single0_in_name);
+            WireId src1Wire = getWireByName(cb_single1_in_name);
+
+            std::string pip00Name = "X" + std::to_string(xWire) +
+                                    "Y" + std::to_string(yWire) + "_" +
+                                    CBType + "_SINGLE0_" + std::to_string(s) +
+                                    "->LUT" + std::to_string(lut1Id) + "_I" +
+                                   std::to_string(k);
+            std::string pip01Name = "X" + std::to_string(xWire) +
+                                    "Y" + std::to_string(yWire) + "_" +
+                                    CBType + "_SINGLE0_" + std::to_string(s) +
+                                    "->LUT" + std::to_string(lut0Id) + "_I" +
+                                   std::to_string(k);
+
+            std::string pip10Name = "X" + std::to_string(xWire) +
+                                    "Y" + std::to_string(yWire) + "_" +
+                                    CBType + "_SINGLE1_" + std::to_string(s) +
+                                    "->LUT" + std::to_string(lut1Id) + "_I" +
+                                    std::to_string(k);
+
+            std::string pip11Name = "X" + std::to_string(xWire) +
+                                    "Y" + std::to_string(yWire) + "_" +
+                                    CBType + "_SINGLE1_" + std::to_string(s) +
+                                    "->LUT" + std::to_string(lut0Id) + "_I" +
+                                    std::to_string(k);
+
+            addPip(pip00Name, pipType, src0Wire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pip01Name, pipType, src0Wire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+            addPip(pip10Name, pipType, src1Wire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pip11Name, pipType, src1Wire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        }
+
+        for (int s = 0; s < numDoubleWires; s++) {
+            std::string cb_double0_in_name = "X" + std::to_string(xWire) +
+                                             "Y" + std::to_string(yWire) + "_" +
+                                             CBType + "_DOUBLE0_IN" + std::to_string(s);
+            std::string cb_double1_in_name = "X" + std::to_string(xWire) +
+                                             "Y" + std::to_string(yWire) + "_" +
+                                             CBType + "_DOUBLE1_IN" + std::to_string(s);
+
+            WireId src0Wire = getWireByName(cb_double0_in_name);
+            WireId src1Wire = getWireByName(cb_double1_in_name);
+
+            std::string pip00Name = "X" + std::to_string(xWire) +
+                                    "Y" + std::to_string(yWire) + "_" +
+                                    CBType + "_DOUBLE0_" + std::to_string(s) +
+                                    "->LUT" + std::to_string(lut1Id) + "_I" +
+                                    std::to_string(k);
+
+            std::string pip01Name = "X" + std::to_string(xWire) +
+                                    "Y" + std::to_string(yWire) + "_" +
+                                    CBType + "_DOUBLE0_" + std::to_string(s) +
+                                    "->LUT" + std::to_string(lut0Id) + "_I" +
+                                    std::to_string(k);
+
+            std::string pip10Name = "X" + std::to_string(xWire) +
+                                    "Y" + std::to_string(yWire) + "_" +
+                                    CBType + "_DOUBLE1_" + std::to_string(s) +
+                                    "->LUT" + std::to_string(lut1Id) + "_I" +
+                                    std::to_string(k);
+
+            std::string pip11Name = "X" + std::to_string(xWire) +
+                                    "Y" + std::to_string(yWire) + "_" +
+                                    CBType + "_DOUBLE1_" + std::to_string(s) +
+                                    "->LUT" + std::to_string(lut0Id) + "_I" +
+                                    std::to_string(k);
+
+            addPip(pip00Name, pipType, src0Wire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pip01Name, pipType, src0Wire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pip10Name, pipType, src1Wire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pip11Name, pipType, src1Wire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        }
+    }
+
+    // CLB outputs -> ConnectionBlock
+    std::string clb_comb0_output_name = "X" + std::to_string(x) +
+                                        "Y" + std::to_string(y) +
+                                        "CLB_COMB" + std::to_string(lut1Id);
+    WireId src0CombWire = getWireByName(clb_comb0_output_name);
+
+    std::string clb_comb1_output_name = "X" + std::to_string(x) +
+                                        "Y" + std::to_string(y) +
+                                        "CLB_COMB" + std::to_string(lut0Id);
+    WireId src1CombWire = getWireByName(clb_comb1_output_name);
+
+    std::string clb_sync0_output_name = "X" + std::to_string(x) +
+                                        "Y" + std::to_string(y) +
+                                        "CLB_SYNC" + std::to_string(dff1Id - 8);
+    WireId src0SyncWire = getWireByName(clb_sync0_output_name);
+
+    std::string clb_sync1_output_name = "X" + std::to_string(x) +
+                                        "Y" + std::to_string(y) +
+                                        "CLB_SYNC" + std::to_string(dff0Id - 8);
+    WireId src1SyncWire = getWireByName(clb_sync1_output_name);
+
+    for (int s = 0; s < numSingleWires; s++) {
+        std::string cb_single0_out_name = "X" + std::to_string(xWire) +
+                                          "Y" + std::to_string(yWire) +
+                                          "_" + CBType + "_SINGLE0_OUT" + std::to_string(s);
+        std::string cb_single1_out_name = "X" + std::to_string(xWire) +
+                                          "Y" + std::to_string(yWire) +
+                                          "_" + CBType + "_SINGLE1_OUT" + std::to_string(s);
+
+        WireId dst0Wire = getWireByName(cb_single0_out_name);
+        WireId dst1Wire = getWireByName(cb_single1_out_name);
+
+        std::string pip00LutName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_COMB_O" + std::to_string(lut1Id) +
+                                   "->" + CBType + "_SINGLE0_" + std::to_string(s);
+        std::string pip01LutName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_COMB_O" + std::to_string(lut1Id) +
+                                   "->" + CBType + "_SINGLE1_" + std::to_string(s);
+
+        std::string pip10LutName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_COMB_O" + std::to_string(lut0Id) +
+                                   "->" + CBType + "_SINGLE0_" + std::to_string(s);
+        std::string pip11LutName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_COMB_O" + std::to_string(lut0Id) +
+                                   "->" + CBType + "_SINGLE1_" + std::to_string(s);
+
+        std::string pip00DffName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_SYNC_O" + std::to_string(dff1Id - 8) +
+                                   "->" + CBType + "_SINGLE0_" + std::to_string(s);
+        std::string pip01DffName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_SYNC_O" + std::to_string(dff1Id - 8) +
+                                   "->" + CBType + "_SINGLE1_" + std::to_string(s);
+
+        std::string pip10DffName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_SYNC_O" + std::to_string(dff0Id - 8) +
+                                   "->" + CBType + "_SINGLE0_" + std::to_string(s);
+        std::string pip11DffName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_SYNC_O" + std::to_string(dff0Id - 8) +
+                                   "->" + CBType + "_SINGLE1_" + std::to_string(s);
+
+        addPip(pip00LutName, pipType, src0CombWire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        addPip(pip01LutName, pipType, src0CombWire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+        addPip(pip10LutName, pipType, src1CombWire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        addPip(pip11LutName, pipType, src1CombWire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+        addPip(pip00DffName, pipType, src0SyncWire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        addPip(pip01DffName, pipType, src0SyncWire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+        addPip(pip10DffName, pipType, src1SyncWire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        addPip(pip11DffName, pipType, src1SyncWire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+    }
+
+    for (int s = 0; s < numDoubleWires / 2; s++) {
+        std::string cb_double0_out_name = "X" + std::to_string(xWire) +
+                                          "Y" + std::to_string(yWire) +
+                                          "_" + CBType + "_DOUBLE0_OUT" + std::to_string(s);
+        std::string cb_double1_out_name = "X" + std::to_string(xWire) +
+                                          "Y" + std::to_string(yWire) +
+                                          "_" + CBType + "_DOUBLE1_OUT" + std::to_string(s);
+
+        WireId dst0Wire = getWireByName(cb_double0_out_name);
+        WireId dst1Wire = getWireByName(cb_double1_out_name);
+
+        std::string pip00LutName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_COMB_O" + std::to_string(lut1Id) +
+                                   "->" + CBType + "_DOUBLE0_" + std::to_string(s);
+        std::string pip01LutName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_COMB_O" + std::to_string(lut1Id) +
+                                   "->" + CBType + "_DOUBLE1_" + std::to_string(s);
+
+        std::string pip10LutName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_COMB_O" + std::to_string(lut0Id) +
+                                   "->" + CBType + "_DOUBLE0_" + std::to_string(s);
+        std::string pip11LutName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_COMB_O" + std::to_string(lut0Id) +
+                                   "->" + CBType + "_DOUBLE1_" + std::to_string(s);
+
+        std::string pip00DffName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_SYNC_O" + std::to_string(dff1Id) +
+                                   "->" + CBType + "_DOUBLE0_" + std::to_string(s);
+        std::string pip01DffName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_SYNC_O" + std::to_string(dff1Id) +
+                                   "->" + CBType + "_DOUBLE1_" + std::to_string(s);
+
+        std::string pip10DffName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_SYNC_O" + std::to_string(dff0Id) +
+                                   "->" + CBType + "_DOUBLE0_" + std::to_string(s);
+        std::string pip11DffName = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "_CLB_SYNC_O" + std::to_string(dff0Id) +
+                                   "->" + CBType + "_DOUBLE1_" + std::to_string(s);
+
+        addPip(pip00LutName, pipType, src0CombWire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        addPip(pip01LutName, pipType, src0CombWire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+        addPip(pip10LutName, pipType, src1CombWire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        addPip(pip11LutName, pipType, src1CombWire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+        addPip(pip00DffName, pipType, src0SyncWire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        addPip(pip01DffName, pipType, src0SyncWire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+        addPip(pip10DffName, pipType, src1SyncWire, dst0Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+        addPip(pip11DffName, pipType, src1SyncWire, dst1Wire, getDelayFromNS(0.01), Loc(x, y, 0));
+    }
+
+    // Direct connections between the CLBs
+    // CLB0 -> CLB1
+    for (int i = 0; i < 4; i++) {
+        std::string pipCLB0Comb0_CLB1LUT1In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB0_COMB_O" + std::to_string(lut1Id) +
+                                              "->" + "CLB1_LUT1_I" + std::to_string(i);
+        std::string pipCLB0Comb0_CLB1LUT0In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB0_COMB_O" + std::to_string(lut1Id) +
+                                              "->" + "CLB1_LUT0_I" + std::to_string(i);
+
+        std::string pipCLB0Comb1_CLB1LUT1In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB0_COMB_O" + std::to_string(lut0Id) +
+                                              "->" + "CLB1_LUT1_I" + std::to_string(i);
+        std::string pipCLB0Comb1_CLB1LUT0In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB0_COMB_O" + std::to_string(lut0Id) +
+                                              "->" + "CLB1_LUT0_I" + std::to_string(i);
+
+        std::string pipCLB0Sync0_CLB1LUT1In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB0_SYNC_O" + std::to_string(lut1Id) +
+                                              "->" + "CLB1_LUT1_I" + std::to_string(i);
+        std::string pipCLB0Sync0_CLB1LUT0In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB0_SYNC_O" + std::to_string(lut1Id) +
+                                              "->" + "CLB1_LUT0_I" + std::to_string(i);
+
+        std::string pipCLB0Sync1_CLB1LUT1In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB0_SYNC_O" + std::to_string(lut0Id) +
+                                              "->" + "CLB1_LUT1_I" + std::to_string(i);
+        std::string pipCLB0Sync1_CLB1LUT0In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB0_SYNC_O" + std::to_string(lut0Id) +
+                                              "->" + "CLB1_LUT0_I" + std::to_string(i);
+
+        if (side == 0 && x + 1 < gridDimX) {
+            // East side
+            std::string lut1_in_name = "X" + std::to_string(x + 1) +
+                                       "Y" + std::to_string(y) +
+                                       "Z5_" + 
+                                       "I" + std::to_string(i);
+
+            std::string lut0_in_name = "X" + std::to_string(x + 1) +
+                                       "Y" + std::to_string(y) +
+                                       "Z4_" +
+                                       "I" + std::to_string(i);
+
+            WireId lut1InWire = getWireByName(lut1_in_name);
+            WireId lut0InWire = getWireByName(lut0_in_name);
+
+            addPip(pipCLB0Comb0_CLB1LUT1In, pipType, src0CombWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Comb0_CLB1LUT0In, pipType, src0CombWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Comb1_CLB1LUT1In, pipType, src1CombWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Comb1_CLB1LUT0In, pipType, src1CombWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+            addPip(pipCLB0Sync0_CLB1LUT1In, pipType, src0SyncWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Sync0_CLB1LUT0In, pipType, src0SyncWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Sync1_CLB1LUT1In, pipType, src1SyncWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Sync1_CLB1LUT0In, pipType, src1SyncWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+        } else if (side == 3 && y + 1 < gridDimY) {
+            // North side
+            std::string lut1_in_name = "X" + std::to_string(x) +
+                                       "Y" + std::to_string(y + 1) +
+                                       "Z3_" +
+                                       "I" + std::to_string(i);
+
+            std::string lut0_in_name = "X" + std::to_string(x) +
+                                       "Y" + std::to_string(y + 1) +
+                                       "Z2_" +
+                                       "I" + std::to_string(i);
+
+            WireId lut1InWire = getWireByName(lut1_in_name);
+            WireId lut0InWire = getWireByName(lut0_in_name);
+
+            addPip(pipCLB0Comb0_CLB1LUT1In, pipType, src0CombWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Comb0_CLB1LUT0In, pipType, src0CombWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Comb1_CLB1LUT1In, pipType, src1CombWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Comb1_CLB1LUT0In, pipType, src1CombWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+            addPip(pipCLB0Sync0_CLB1LUT1In, pipType, src0SyncWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Sync0_CLB1LUT0In, pipType, src0SyncWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Sync1_CLB1LUT1In, pipType, src1SyncWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB0Sync1_CLB1LUT0In, pipType, src1SyncWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+        }
+    }
+
+    // CLB1 -> CLB0
+    for (int i = 0; i < 4; i++) {
+        std::string pipCLB1Comb0_CLB0LUT1In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB1_COMB_O" + std::to_string(lut1Id) +
+                                              "->" + "CLB0_LUT1_I" + std::to_string(i);
+        std::string pipCLB1Comb0_CLB0LUT0In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB1_COMB_O" + std::to_string(lut1Id) +
+                                              "->" + "CLB0_LUT0_I" + std::to_string(i);
+
+        std::string pipCLB1Comb1_CLB0LUT1In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB1_COMB_O" + std::to_string(lut0Id) +
+                                              "->" + "CLB0_LUT1_I" + std::to_string(i);
+        std::string pipCLB1Comb1_CLB0LUT0In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB1_COMB_O" + std::to_string(lut0Id) +
+                                              "->" + "CLB0_LUT0_I" + std::to_string(i);
+
+        std::string pipCLB1Sync0_CLB0LUT1In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB1_SYNC_O" + std::to_string(lut1Id) +
+                                              "->" + "CLB0_LUT1_I" + std::to_string(i);
+        std::string pipCLB1Sync0_CLB0LUT0In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB1_SYNC_O" + std::to_string(lut1Id) +
+                                              "->" + "CLB0_LUT0_I" + std::to_string(i);
+
+        std::string pipCLB1Sync1_CLB0LUT1In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB1_SYNC_O" + std::to_string(lut0Id) +
+                                              "->" + "CLB0_LUT1_I" + std::to_string(i);
+        std::string pipCLB1Sync1_CLB0LUT0In = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CLB1_SYNC_O" + std::to_string(lut0Id) +
+                                              "->" + "CLB0_LUT0_I" + std::to_string(i);
+
+        if (side == 2 && x - 1 >= 0) {
+            // West side
+            std::string lut1_in_name = "X" + std::to_string(x - 1) +
+                                       "Y" + std::to_string(y) +
+                                       "Z1_" +
+                                       "I" + std::to_string(i);
+
+            std::string lut0_in_name = "X" + std::to_string(x - 1) +
+                                       "Y" + std::to_string(y) +
+                                       "Z0_" +
+                                       "I" + std::to_string(i);
+
+            WireId lut1InWire = getWireByName(lut1_in_name);
+            WireId lut0InWire = getWireByName(lut0_in_name);
+
+            addPip(pipCLB1Comb0_CLB0LUT1In, pipType, src0CombWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Comb0_CLB0LUT0In, pipType, src0CombWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Comb1_CLB0LUT1In, pipType, src1CombWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Comb1_CLB0LUT0In, pipType, src1CombWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+            addPip(pipCLB1Sync0_CLB0LUT1In, pipType, src0SyncWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Sync0_CLB0LUT0In, pipType, src0SyncWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Sync1_CLB0LUT1In, pipType, src1SyncWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Sync1_CLB0LUT0In, pipType, src1SyncWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+        } else if (side == 1 && y - 1 >= 0) {
+            // South side
+            std::string lut1_in_name = "X" + std::to_string(x) +
+                                       "Y" + std::to_string(y - 1) +
+                                       "Z7_" +
+                                       "I" + std::to_string(i);
+
+            std::string lut0_in_name = "X" + std::to_string(x) +
+                                       "Y" + std::to_string(y - 1) +
+                                       "Z6_" +
+                                       "I" + std::to_string(i);
+
+            WireId lut1InWire = getWireByName(lut1_in_name);
+            WireId lut0InWire = getWireByName(lut0_in_name);
+
+            addPip(pipCLB1Comb0_CLB0LUT1In, pipType, src0CombWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Comb0_CLB0LUT0In, pipType, src0CombWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Comb1_CLB0LUT1In, pipType, src1CombWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Comb1_CLB0LUT0In, pipType, src1CombWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+
+            addPip(pipCLB1Sync0_CLB0LUT1In, pipType, src0SyncWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Sync0_CLB0LUT0In, pipType, src0SyncWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Sync1_CLB0LUT1In, pipType, src1SyncWire, lut1InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCLB1Sync1_CLB0LUT0In, pipType, src1SyncWire, lut0InWire, getDelayFromNS(0.01), Loc(x, y, 0));
+        }
+    }
+}
+
+void ChipdbBuilder::setupPipsForSB(int x, int y, int s, int dir1, int dir2) {
+
+    std::string pipType = "PIP";
+
+    std::string dir1Name = "";
+    std::string dir2Name = "";
+
+    // E:0, S:1, W:2, N:3
+
+    if (dir1 == 0) {
+        dir1Name = "E";
+    } else if (dir1 == 1) {
+        dir1Name = "S";
+    } else if (dir1 == 2) {
+        dir1Name = "W";
+    } else if (dir1 == 3) {
+        dir1Name = "N";
+    }
+
+    if (dir2 == 0) {
+        dir2Name = "E";
+    } else if (dir2 == 1) {
+        dir2Name = "S";
+    } else if (dir2 == 2) {
+        dir2Name = "W";
+    } else if (dir2 == 3) {
+        dir2Name = "N";
+    }
+
+    bool switch_wire = false;
+    if ((dir1Name == "N" && dir2Name == "W") ||
+        (dir1Name == "W" && dir2Name == "N") ||
+        (dir1Name == "E" && dir2Name == "S") ||
+        (dir1Name == "S" && dir2Name == "E"))
+        switch_wire = true;
+
+    int s1 = s;
+    int s2 = s;
+
+    if (switch_wire) {
+        if (s1 % 2 == 0)
+            s2 = s1 + 1;
+        else
+            s2 = s1 - 1;   
+    }
+
+    std::string sbDir1SingleWireOutName = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "_SB_" + dir1Name + "_SINGLE_OUT" +
+                                          std::to_string(s1);
+
+    std::string sbDir2SingleWireInName = "X" + std::to_string(x) +
+                                         "Y" + std::to_string(y) +
+                                         "_SB_" + dir2Name + "_SINGLE_IN" +
+                                         std::to_string(s2);
+
+    std::string pipDir1toDir2SingleName = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "_SB_" + dir1Name + std::to_string(s1) +
+                                          dir2Name + std::to_string(s2) + "_SINGLE";
+
+    WireId sbDir1SingleWireOut = getWireByName(sbDir1SingleWireOutName);
+    WireId sbDir2SingleWireIn  = getWireByName(sbDir2SingleWireInName);
+
+    addPip(pipDir1toDir2SingleName, pipType, sbDir1SingleWireOut,
+           sbDir2SingleWireIn, getDelayFromNS(0.01), Loc(x, y, 0));
+
+    std::string sbDir1DoubleWireOutName = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "_SB_" + dir1Name + "_DOUBLE_OUT" +
+                                          std::to_string(s1);
+    std::string sbDir2DoubleWireInName = "X" + std::to_string(x) +
+                                         "Y" + std::to_string(y) +
+                                         "_SB_" + dir2Name + "_DOUBLE_IN" +
+                                         std::to_string(s2);
+    std::string pipDir1toDir2DoubleName = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "_SB_" + dir1Name + std::to_string(s1) +
+                                          dir2Name + std::to_string(s2) + "_DOUBLE";
+    WireId sbDir1DoubleWireOut = getWireByName(sbDir1DoubleWireOutName);
+    WireId sbDir2DoubleWireIn  = getWireByName(sbDir2DoubleWireInName);
+
+    addPip(pipDir1toDir2DoubleName, pipType, sbDir1DoubleWireOut,
+           sbDir2DoubleWireIn, getDelayFromNS(0.01), Loc(x, y, 0));
+
+}
+
+void ChipdbBuilder::build()
+{
+    // Number of cells per Tile
+    // 8 4-LUTs, 8 FFs, 1 CARRY4, 3 MUXES
+    int numBelsPerTile = 8 + 8 + 1 + 3;
+    // Number of PIPs per Tile
+    // 2 x CB + SB
+    int numPipsPerTile = 415 * 2 + 48;
+
+    tileBelDimZ.assign(gridDimX * gridDimY, numBelsPerTile);
+    tilePipDimZ.assign(gridDimX * gridDimY, numPipsPerTile);
+
+    // WireInfo & BelInfo
+    std::string belInputType  = "BEL_INPUT";
+    std::string belOutputType = "BEL_OUTPUT";
+
+    for (int x = 0; x < gridDimX; x++) {
+      for (int y = 0; y < gridDimY; y++) {
+        for (int z = 0; z < numBelsPerTile; z++) {
+          if (z >= 0 && z < 8) {
+            // LUTs
+            std::string i0Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "I0";
+            std::string i1Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "I1";
+            std::string i2Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "I2";
+            std::string i3Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "I3";
+            std::string outName = "X" + std::to_string(x) +
+                                  "Y" + std::to_string(y) +
+                                  "Z" + std::to_string(z) + "_" + "O";
+            addWire(i0Name,  belInputType, x, y);
+            addWire(i1Name,  belInputType, x, y);
+            addWire(i2Name,  belInputType, x, y);
+            addWire(i3Name,  belInputType, x, y);
+            addWire(outName, belOutputType, x, y);
+
+            std::string belName = "X" + std::to_string(x) +
+                                  "Y" + std::to_string(y) +
+                                  "Z" + std::to_string(z) + "_" + "LUT4_BEL";
+            std::string belId = belName;
+            std::string belType = "LUT4";
+            addBel(belId, belType, Loc(x, y, z), false);
+            addBelInput(belId, "I0", i0Name);
+            addBelInput(belId, "I1", i1Name);
+            addBelInput(belId, "I2", i2Name);
+            addBelInput(belId, "I3", i3Name);
+            addBelOutput(belId, "O", outName);
+          } else if (z >= 8 && z < 16) {
+            // DFFERs
+            std::string dName = "X" + std::to_string(x) +
+                                "Y" + std::to_string(y) +
+                                "Z" + std::to_string(z) + "_" + "D";
+            std::string qName = "X" + std::to_string(x) +
+                                "Y" + std::to_string(y) +
+                                "Z" + std::to_string(z) + "_" + "Q";
+            std::string clkName = "X" + std::to_string(x) +
+                                  "Y" + std::to_string(y) +
+                                  "Z" + std::to_string(z) + "_" + "CLK";
+            std::string ceName = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "CE";
+            std::string rstName = "X" + std::to_string(x) +
+                                  "Y" + std::to_string(y) +
+                                  "Z" + std::to_string(z) + "_" + "RST";
+            addWire(dName,   belInputType, x, y);
+            addWire(clkName, belInputType, x, y);
+            addWire(ceName,  belInputType, x, y);
+            addWire(rstName, belInputType, x, y);
+            addWire(qName,   belOutputType, x, y);
+
+            std::string belName = "X" + std::to_string(x) +
+                                  "Y" + std::to_string(y) +
+                                  "Z" + std::to_string(z) + "_" + "DFFER_BEL";
+            std::string belId = belName;
+            std::string belType = "DFFER";
+            addBel(belId, belType, Loc(x, y, z), false);
+            addBelInput(belId, "D", dName);
+            addBelInput(belId, "CLK", clkName);
+            addBelInput(belId, "CE", ceName);
+            addBelInput(belId, "RST", rstName);
+            addBelOutput(belId, "Q", qName);
+          } else if (z >= 16 && z < 19) {
+            // MUXes
+            std::string i0Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "I0";
+            std::string i1Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "I1";
+            std::string selName = "X" + std::to_string(x) +
+                                  "Y" + std::to_string(y) +
+                                  "Z" + std::to_string(z) + "_" + "SEL";
+            std::string outName = "X" + std::to_string(x) +
+                                  "Y" + std::to_string(y) +
+                                  "Z" + std::to_string(z) + "_" + "O";
+            addWire(i0Name, belInputType, x, y);
+            addWire(i1Name, belInputType, x, y);
+            addWire(selName, belInputType, x, y);
+            addWire(outName, belOutputType, x, y);
+
+            std::string belName = "X" + std::to_string(x) +
+                                  "Y" + std::to_string(y) +
+                                  "Z" + std::to_string(z) + "_" + "MUX_BEL";
+            std::string belId = belName;
+            std::string belType = "MUX";
+            addBel(belId, belType, Loc(x, y, z), false);
+            addBelInput(belId, "I0", i0Name);
+            addBelInput(belId, "I1", i1Name);
+            addBelInput(belId, "SEL", selName);
+            addBelOutput(belId, "O", outName);
+          } else {
+            // CARRY
+            std::string ciName = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "CI";
+            std::string coName = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "CO";
+
+            std::string g0Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "G[0]";
+            std::string g1Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "G[1]";
+            std::string g2Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "G[2]";
+            std::string g3Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "G[3]";
+
+            std::string p0Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "P[0]";
+            std::string p1Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "P[1]";
+            std::string p2Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "P[2]";
+            std::string p3Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "P[3]";
+
+            std::string s0Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "S[0]";
+            std::string s1Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "S[1]";
+            std::string s2Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "S[2]";
+            std::string s3Name = "X" + std::to_string(x) +
+                                 "Y" + std::to_string(y) +
+                                 "Z" + std::to_string(z) + "_" + "S[3]";
+            addWire(ciName, belInputType, x, y);
+            addWire(coName, belOutputType, x, y);
+
+            addWire(g0Name, belInputType, x, y);
+            addWire(g1Name, belInputType, x, y);
+            addWire(g2Name, belInputType, x, y);
+            addWire(g3Name, belInputType, x, y);
+
+            addWire(p0Name, belInputType, x, y);
+            addWire(p1Name, belInputType, x, y);
+            addWire(p2Name, belInputType, x, y);
+            addWire(p3Name, belInputType, x, y);
+
+            addWire(s0Name, belOutputType, x, y);
+            addWire(s1Name, belOutputType, x, y);
+            addWire(s2Name, belOutputType, x, y);
+            addWire(s3Name, belOutputType, x, y);
+
+            std::string belName = "X" + std::to_string(x) +
+                                  "Y" + std::to_string(y) +
+                                  "Z" + std::to_string(z) + "_" + "CARRY4_BEL";
+            std::string belId = belName;
+            std::string belType = "CARRY4";
+            addBel(belId, belType, Loc(x, y, z), false);
+            addBelInput(belId, "CI", ciName);
+            addBelOutput(belId, "CO", coName);
+
+            addBelInput(belId, "G[0]", g0Name);
+            addBelInput(belId, "G[1]", g1Name);
+            addBelInput(belId, "G[2]", g2Name);
+            addBelInput(belId, "G[3]", g3Name);
+
+            addBelInput(belId, "P[0]", p0Name);
+            addBelInput(belId, "P[1]", p1Name);
+            addBelInput(belId, "P[2]", p2Name);
+            addBelInput(belId, "P[3]", p3Name);
+
+            addBelOutput(belId, "S[0]", s0Name);
+            addBelOutput(belId, "S[1]", s1Name);
+            addBelOutput(belId, "S[2]", s2Name);
+            addBelOutput(belId, "S[3]", s3Name);
+          }
+        }
+      }
+    }
+
+    int numSingleWires = 4;
+    int numDoubleWires = 8;
+    std::string cbWireType = "CB_WIRE";
+    std::string sbWireType = "SB_WIRE";
+
+    for (int x = 0; x < gridDimX; x++) {
+        for (int y = 0; y < gridDimY; y++) {
+            for (int k = 0; k < numSingleWires; k++) {
+                std::string cb0_single0_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB0_SINGLE0_IN" + std::to_string(k);
+
+                std::string cb0_single0_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB0_SINGLE0_OUT" + std::to_string(k);
+
+                std::string cb0_single1_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB0_SINGLE1_IN" + std::to_string(k);
+
+                std::string cb0_single1_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB0_SINGLE1_OUT" + std::to_string(k);
+
+                std::string cb1_single0_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB1_SINGLE0_IN" + std::to_string(k);
+
+                std::string cb1_single0_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB1_SINGLE0_OUT" + std::to_string(k);
+
+                std::string cb1_single1_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB1_SINGLE1_IN" + std::to_string(k);
+
+                std::string cb1_single1_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB1_SINGLE1_OUT" + std::to_string(k);
+
+                std::string sb_n_single_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_SB_N_SINGLE_IN" + std::to_string(k);
+
+                std::string sb_n_single_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_SB_N_SINGLE_OUT" + std::to_string(k);
+
+                std::string sb_s_single_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_SB_S_SINGLE_IN" + std::to_string(k);
+
+                std::string sb_s_single_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_SB_S_SINGLE_OUT" + std::to_string(k);
+
+                std::string sb_e_single_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_SB_E_SINGLE_IN" + std::to_string(k);
+
+                std::string sb_e_single_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_SB_E_SINGLE_OUT" + std::to_string(k);
+
+                std::string sb_w_single_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_SB_W_SINGLE_IN" + std::to_string(k);
+
+                std::string sb_w_single_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_SB_W_SINGLE_OUT" + std::to_string(k);
+
+                addWire(cb0_single0_in_name, cbWireType, x, y);
+                addWire(cb0_single0_out_name, cbWireType, x, y);
+                addWire(cb0_single1_in_name, cbWireType, x, y);
+                addWire(cb0_single1_out_name, cbWireType, x, y);
+
+                addWire(cb1_single0_in_name, cbWireType, x, y);
+                addWire(cb1_single0_out_name, cbWireType, x, y);
+                addWire(cb1_single1_in_name, cbWireType, x, y);
+                addWire(cb1_single1_out_name, cbWireType, x, y);
+
+                addWire(sb_n_single_in_name, sbWireType, x, y);
+                addWire(sb_n_single_out_name, sbWireType, x, y);
+
+                addWire(sb_s_single_in_name, sbWireType, x, y);
+                addWire(sb_s_single_out_name, sbWireType, x, y);
+
+                addWire(sb_e_single_in_name, sbWireType, x, y);
+                addWire(sb_e_single_out_name, sbWireType, x, y);
+
+                addWire(sb_w_single_in_name, sbWireType, x, y);
+                addWire(sb_w_single_out_name, sbWireType, x, y);
+            }
+
+            for (int k = 0; k < numDoubleWires; k++) {
+                std::string cb0_double0_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB0_DOUBLE0_IN" + std::to_string(k);
+                std::string cb0_double0_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB0_DOUBLE0_OUT" + std::to_string(k);
+
+                std::string cb0_double1_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB0_DOUBLE1_IN" + std::to_string(k);
+                std::string cb0_double1_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB0_DOUBLE1_OUT" + std::to_string(k);
+
+                std::string cb1_double0_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB1_DOUBLE0_IN" + std::to_string(k);
+                std::string cb1_double0_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB1_DOUBLE0_OUT" + std::to_string(k);
+
+                std::string cb1_double1_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB1_DOUBLE1_IN" + std::to_string(k);
+                std::string cb1_double1_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB1_DOUBLE1_OUT" + std::to_string(k);
+
+                addWire(cb0_double0_in_name, cbWireType, x, y);
+                addWire(cb0_double0_out_name, cbWireType, x, y);
+                addWire(cb0_double1_in_name, cbWireType, x, y);
+                addWire(cb0_double1_out_name, cbWireType, x, y);
+
+                addWire(cb1_double0_in_name, cbWireType, x, y);
+                addWire(cb1_double0_out_name, cbWireType, x, y);
+                addWire(cb1_double1_in_name, cbWireType, x, y);
+                addWire(cb1_double1_out_name, cbWireType, x, y);
+            }
+
+            for (int k = 0; k < numDoubleWires / 2; k++) {
+                std::string sb_n_double_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_SB_N_DOUBLE_IN" + std::to_string(k);
+
+                std::string sb_n_double_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_SB_N_DOUBLE_OUT" + std::to_string(k);
+
+                std::string sb_s_double_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_SB_S_DOUBLE_IN" + std::to_string(k);
+
+                std::string sb_s_double_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_SB_S_DOUBLE_OUT" + std::to_string(k);
+
+                std::string sb_e_double_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_SB_E_DOUBLE_IN" + std::to_string(k);
+
+                std::string sb_e_double_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_SB_E_DOUBLE_OUT" + std::to_string(k);
+
+                std::string sb_w_double_in_name = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_SB_W_DOUBLE_IN" + std::to_string(k);
+
+                std::string sb_w_double_out_name = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_SB_W_DOUBLE_OUT" + std::to_string(k);
+
+                addWire(sb_n_double_in_name, sbWireType, x, y);
+                addWire(sb_n_double_out_name, sbWireType, x, y);
+
+                addWire(sb_s_double_in_name, sbWireType, x, y);
+                addWire(sb_s_double_out_name, sbWireType, x, y);
+
+                addWire(sb_e_double_in_name, sbWireType, x, y);
+                addWire(sb_e_double_out_name, sbWireType, x, y);
+
+                addWire(sb_w_double_in_name, sbWireType, x, y);
+                addWire(sb_w_double_out_name, sbWireType, x, y);
+            }
+        }
+    }
+
+    // PipInfo
+    std::string pipType = "PIP";
+
+    // Intra-CLB connections
+    // LUT (O) -> CARRY (P/G)
+    // LUT (O) -> DFF (D)
+    // CARRY (S) -> DFF (D)
+    // LUT (O) -> CLB_COMB_O
+    // CARRY (S) -> CLB_COMB_O
+    // DFF (Q) -> CLB_SYNC_O
+
+    for (int x = 0; x < gridDimX; x++) {
+        for (int y = 0; y < gridDimY; y++) {
+            // LUT -> CLB outputs (COMB)
+            std::string lut0_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z0" + "_" + "O";
+            std::string lut1_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z1" + "_" + "O";
+            std::string lut2_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z2" + "_" + "O";
+            std::string lut3_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z3" + "_" + "O";
+            std::string lut4_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z4" + "_" + "O";
+            std::string lut5_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z5" + "_" + "O";
+            std::string lut6_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z6" + "_" + "O";
+            std::string lut7_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z7" + "_" + "O";
+
+            WireId lut0OutWire = getWireByName(lut0_output_name);
+            WireId lut1OutWire = getWireByName(lut1_output_name);
+            WireId lut2OutWire = getWireByName(lut2_output_name);
+            WireId lut3OutWire = getWireByName(lut3_output_name);
+            WireId lut4OutWire = getWireByName(lut4_output_name);
+            WireId lut5OutWire = getWireByName(lut5_output_name);
+            WireId lut6OutWire = getWireByName(lut6_output_name);
+            WireId lut7OutWire = getWireByName(lut7_output_name);
+
+            std::string clbCombOut0Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_COMB0";
+            std::string clbCombOut1Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_COMB1";
+            std::string clbCombOut2Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_COMB2";
+            std::string clbCombOut3Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_COMB3";
+            std::string clbCombOut4Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_COMB4";
+            std::string clbCombOut5Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_COMB5";
+            std::string clbCombOut6Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_COMB6";
+            std::string clbCombOut7Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_COMB7";
+
+            addWire(clbCombOut0Name, "CLB", x, y);
+            addWire(clbCombOut1Name, "CLB", x, y);
+            addWire(clbCombOut2Name, "CLB", x, y);
+            addWire(clbCombOut3Name, "CLB", x, y);
+            addWire(clbCombOut4Name, "CLB", x, y);
+            addWire(clbCombOut5Name, "CLB", x, y);
+            addWire(clbCombOut6Name, "CLB", x, y);
+            addWire(clbCombOut7Name, "CLB", x, y);
+
+            WireId clbCombOut0Wire = getWireByName(clbCombOut0Name);
+            WireId clbCombOut1Wire = getWireByName(clbCombOut1Name);
+            WireId clbCombOut2Wire = getWireByName(clbCombOut2Name);
+            WireId clbCombOut3Wire = getWireByName(clbCombOut3Name);
+            WireId clbCombOut4Wire = getWireByName(clbCombOut4Name);
+            WireId clbCombOut5Wire = getWireByName(clbCombOut5Name);
+            WireId clbCombOut6Wire = getWireByName(clbCombOut6Name);
+            WireId clbCombOut7Wire = getWireByName(clbCombOut7Name);
+
+            std::string pipLutToCLBOut0Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "LUT1->CLB_COMB0";
+            std::string pipLutToCLBOut1Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "LUT0->CLB_COMB1";
+            std::string pipLutToCLBOut2Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "LUT3->CLB_COMB2";
+            std::string pipLutToCLBOut3Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "LUT2->CLB_COMB3";
+            std::string pipLutToCLBOut4Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "LUT5->CLB_COMB4";
+            std::string pipLutToCLBOut5Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "LUT4->CLB_COMB5";
+            std::string pipLutToCLBOut6Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "LUT7->CLB_COMB6";
+            std::string pipLutToCLBOut7Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "LUT6->CLB_COMB7";
+
+            addPip(pipLutToCLBOut0Name, pipType,
+                   lut1OutWire, clbCombOut0Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLutToCLBOut1Name, pipType,
+                   lut0OutWire, clbCombOut1Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLutToCLBOut2Name, pipType,
+                   lut3OutWire, clbCombOut2Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLutToCLBOut3Name, pipType,
+                   lut2OutWire, clbCombOut3Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLutToCLBOut4Name, pipType,
+                   lut5OutWire, clbCombOut4Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLutToCLBOut5Name, pipType,
+                   lut4OutWire, clbCombOut5Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLutToCLBOut6Name, pipType,
+                   lut7OutWire, clbCombOut6Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLutToCLBOut7Name, pipType,
+                   lut6OutWire, clbCombOut7Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+
+            // DFF -> CLB outputs (SYNC)
+            std::string dff0_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z8" + "_" + "Q";
+            std::string dff1_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z9" + "_" + "Q";
+            std::string dff2_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z10" + "_" + "Q";
+            std::string dff3_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z11" + "_" + "Q";
+            std::string dff4_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z12" + "_" + "Q";
+            std::string dff5_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z13" + "_" + "Q";
+            std::string dff6_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z14" + "_" + "Q";
+            std::string dff7_output_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z15" + "_" + "Q";
+
+            WireId dff0OutWire = getWireByName(dff0_output_name);
+            WireId dff1OutWire = getWireByName(dff1_output_name);
+            WireId dff2OutWire = getWireByName(dff2_output_name);
+            WireId dff3OutWire = getWireByName(dff3_output_name);
+            WireId dff4OutWire = getWireByName(dff4_output_name);
+            WireId dff5OutWire = getWireByName(dff5_output_name);
+            WireId dff6OutWire = getWireByName(dff6_output_name);
+            WireId dff7OutWire = getWireByName(dff7_output_name);
+
+            std::string clbSyncOut0Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_SYNC0";
+            std::string clbSyncOut1Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_SYNC1";
+            std::string clbSyncOut2Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_SYNC2";
+            std::string clbSyncOut3Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_SYNC3";
+            std::string clbSyncOut4Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_SYNC4";
+            std::string clbSyncOut5Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_SYNC5";
+            std::string clbSyncOut6Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_SYNC6";
+            std::string clbSyncOut7Name = "X" + std::to_string(x) +
+                                          "Y" + std::to_string(y) +
+                                          "CLB_SYNC7";
+
+            addWire(clbSyncOut0Name, "CLB", x, y);
+            addWire(clbSyncOut1Name, "CLB", x, y);
+            addWire(clbSyncOut2Name, "CLB", x, y);
+            addWire(clbSyncOut3Name, "CLB", x, y);
+            addWire(clbSyncOut4Name, "CLB", x, y);
+            addWire(clbSyncOut5Name, "CLB", x, y);
+            addWire(clbSyncOut6Name, "CLB", x, y);
+            addWire(clbSyncOut7Name, "CLB", x, y);
+
+            WireId clbSyncOut0Wire = getWireByName(clbSyncOut0Name);
+            WireId clbSyncOut1Wire = getWireByName(clbSyncOut1Name);
+            WireId clbSyncOut2Wire = getWireByName(clbSyncOut2Name);
+            WireId clbSyncOut3Wire = getWireByName(clbSyncOut3Name);
+            WireId clbSyncOut4Wire = getWireByName(clbSyncOut4Name);
+            WireId clbSyncOut5Wire = getWireByName(clbSyncOut5Name);
+            WireId clbSyncOut6Wire = getWireByName(clbSyncOut6Name);
+            WireId clbSyncOut7Wire = getWireByName(clbSyncOut7Name);
+
+            std::string pipDffToCLBOut0Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "DFF1->CLB_SYNC0";
+            std::string pipDffToCLBOut1Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "DFF0->CLB_SYNC1";
+            std::string pipDffToCLBOut2Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "DFF3->CLB_SYNC2";
+            std::string pipDffToCLBOut3Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "DFF2->CLB_SYNC3";
+            std::string pipDffToCLBOut4Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "DFF5->CLB_SYNC4";
+            std::string pipDffToCLBOut5Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "DFF4->CLB_SYNC5";
+            std::string pipDffToCLBOut6Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "DFF7->CLB_SYNC6";
+            std::string pipDffToCLBOut7Name = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "DFF6->CLB_SYNC7";
+
+            addPip(pipDffToCLBOut0Name, pipType,
+                   dff1OutWire, clbSyncOut0Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipDffToCLBOut1Name, pipType,
+                   dff0OutWire, clbSyncOut1Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipDffToCLBOut2Name, pipType,
+                   dff3OutWire, clbSyncOut2Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipDffToCLBOut3Name, pipType,
+                   dff2OutWire, clbSyncOut3Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipDffToCLBOut4Name, pipType,
+                   dff5OutWire, clbSyncOut4Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipDffToCLBOut5Name, pipType,
+                   dff4OutWire, clbSyncOut5Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipDffToCLBOut6Name, pipType,
+                   dff7OutWire, clbSyncOut6Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipDffToCLBOut7Name, pipType,
+                   dff6OutWire, clbSyncOut7Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+
+            // CARRY4 -> CLB outputs (COMB)
+            std::string ccS0Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "S[0]";
+            std::string ccS1Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "S[1]";
+            std::string ccS2Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "S[2]";
+            std::string ccS3Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "S[3]";
+
+            WireId ccS0Wire = getWireByName(ccS0Name);
+            WireId ccS1Wire = getWireByName(ccS1Name);
+            WireId ccS2Wire = getWireByName(ccS2Name);
+            WireId ccS3Wire = getWireByName(ccS3Name);
+
+            std::string pipCarryToCLBOut0Name = "X" + std::to_string(x) +
+                                                "Y" + std::to_string(y) +
+                                                "CARRY4_S0->CLB_COMB0";
+            std::string pipCarryToCLBOut1Name = "X" + std::to_string(x) +
+                                                "Y" + std::to_string(y) +
+                                                "CARRY4_S1->CLB_COMB2";
+            std::string pipCarryToCLBOut2Name = "X" + std::to_string(x) +
+                                                "Y" + std::to_string(y) +
+                                                "CARRY4_S2->CLB_COMB4";
+            std::string pipCarryToCLBOut3Name = "X" + std::to_string(x) +
+                                                "Y" + std::to_string(y) +
+                                                "CARRY4_S3->CLB_COMB6";
+
+            addPip(pipCarryToCLBOut0Name, pipType,
+                   ccS0Wire, clbCombOut0Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCarryToCLBOut1Name, pipType,
+                   ccS1Wire, clbCombOut2Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCarryToCLBOut2Name, pipType,
+                   ccS2Wire, clbCombOut4Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCarryToCLBOut3Name, pipType,
+                   ccS3Wire, clbCombOut6Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+
+            // LUT -> CARRY4 (P)
+            std::string ccP0Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "P[0]";
+            std::string ccP1Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "P[1]";
+            std::string ccP2Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "P[2]";
+            std::string ccP3Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "P[3]";
+
+            WireId ccP0Wire = getWireByName(ccP0Name);
+            WireId ccP1Wire = getWireByName(ccP1Name);
+            WireId ccP2Wire = getWireByName(ccP2Name);
+            WireId ccP3Wire = getWireByName(ccP3Name);
+
+            std::string pipLut1ToCarryP0Name = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "LUT1->CARRY4_P0";
+            std::string pipLut3ToCarryP1Name = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "LUT3->CARRY4_P1";
+            std::string pipLut5ToCarryP2Name = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "LUT5->CARRY4_P2";
+            std::string pipLut7ToCarryP3Name = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "LUT7->CARRY4_P3";
+
+            addPip(pipLut1ToCarryP0Name, pipType,
+                   lut1OutWire,
+                   ccP0Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut3ToCarryP1Name, pipType,
+                   lut3OutWire,
+                   ccP1Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut5ToCarryP2Name, pipType,
+                   lut5OutWire,
+                   ccP2Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut7ToCarryP3Name, pipType,
+                   lut7OutWire,
+                   ccP3Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+
+            // LUT -> CARRY4 (G)
+            std::string ccG0Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "G[0]";
+            std::string ccG1Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "G[1]";
+            std::string ccG2Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "G[2]";
+            std::string ccG3Name = "X" + std::to_string(x) +
+                                   "Y" + std::to_string(y) +
+                                   "Z19" + "_" + "G[3]";
+
+            WireId ccG0Wire = getWireByName(ccG0Name);
+            WireId ccG1Wire = getWireByName(ccG1Name);
+            WireId ccG2Wire = getWireByName(ccG2Name);
+            WireId ccG3Wire = getWireByName(ccG3Name);
+
+            std::string pipLut0ToCarryG0Name = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "LUT0->CARRY4_G0";
+            std::string pipLut2ToCarryG1Name = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "LUT2->CARRY4_G1";
+            std::string pipLut4ToCarryG2Name = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "LUT4->CARRY4_G2";
+            std::string pipLut6ToCarryG3Name = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "LUT6->CARRY4_G3";
+
+            addPip(pipLut0ToCarryG0Name, pipType,
+                   lut0OutWire,
+                   ccG0Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut2ToCarryG1Name, pipType,
+                   lut2OutWire,
+                   ccG1Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut4ToCarryG2Name, pipType,
+                   lut4OutWire,
+                   ccG2Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut6ToCarryG3Name, pipType,
+                   lut6OutWire,
+                   ccG3Wire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+
+            // CARRY4 -> DFF inputs (D)
+            std::string dff0_input_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z8" + "_" + "D";
+            std::string dff1_input_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z9" + "_" + "D";
+            std::string dff2_input_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z10" + "_" + "D";
+            std::string dff3_input_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z11" + "_" + "D";
+            std::string dff4_input_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z12" + "_" + "D";
+            std::string dff5_input_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z13" + "_" + "D";
+            std::string dff6_input_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z14" + "_" + "D";
+            std::string dff7_input_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z15" + "_" + "D";
+
+            WireId dff0InWire = getWireByName(dff0_input_name);
+            WireId dff1InWire = getWireByName(dff1_input_name);
+            WireId dff2InWire = getWireByName(dff2_input_name);
+            WireId dff3InWire = getWireByName(dff3_input_name);
+            WireId dff4InWire = getWireByName(dff4_input_name);
+            WireId dff5InWire = getWireByName(dff5_input_name);
+            WireId dff6InWire = getWireByName(dff6_input_name);
+            WireId dff7InWire = getWireByName(dff7_input_name);
+
+            std::string pipCarryS0ToDffName = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "CARRY4_S0->DFF1";
+            std::string pipCarryS1ToDffName = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "CARRY4_S1->DFF3";
+            std::string pipCarryS2ToDffName = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "CARRY4_S2->DFF5";
+            std::string pipCarryS3ToDffName = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "CARRY4_S3->DFF7";
+
+            addPip(pipCarryS0ToDffName, pipType,
+                   ccS0Wire, dff1InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCarryS1ToDffName, pipType,
+                   ccS1Wire, dff3InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCarryS2ToDffName, pipType,
+                   ccS2Wire, dff5InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipCarryS3ToDffName, pipType,
+                   ccS3Wire, dff7InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+
+            // LUT -> DFF inputs (D)
+            std::string pipLut1ToDffName = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "LUT1->DFF1";
+            std::string pipLut0ToDffName = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "LUT0->DFF0";
+            std::string pipLut3ToDffName = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "LUT3->DFF3";
+            std::string pipLut2ToDffName = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "LUT2->DFF2";
+            std::string pipLut5ToDffName = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "LUT5->DFF5";
+            std::string pipLut4ToDffName = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "LUT4->DFF4";
+            std::string pipLut7ToDffName = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "LUT7->DFF7";
+            std::string pipLut6ToDffName = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "LUT6->DFF6";
+            addPip(pipLut1ToDffName, pipType,
+                   lut1OutWire, dff1InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut0ToDffName, pipType,
+                   lut0OutWire, dff0InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut3ToDffName, pipType,
+                   lut3OutWire, dff3InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut2ToDffName, pipType,
+                   lut2OutWire, dff2InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut5ToDffName, pipType,
+                   lut5OutWire, dff5InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut4ToDffName, pipType,
+                   lut4OutWire, dff4InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut7ToDffName, pipType,
+                   lut7OutWire, dff7InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipLut6ToDffName, pipType,
+                   lut6OutWire, dff6InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+
+            // LUT (By Pass) -> DFF inputs (D)
+            std::string lut1_in0_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z0" + "_" + "I0";
+            std::string lut0_in0_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z1" + "_" + "I0";
+            std::string lut3_in0_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z2" + "_" + "I0";
+            std::string lut2_in0_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z3" + "_" + "I0";
+            std::string lut5_in0_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z4" + "_" + "I0";
+            std::string lut4_in0_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z5" + "_" + "I0";
+            std::string lut7_in0_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z6" + "_" + "I0";
+            std::string lut6_in0_name = "X" + std::to_string(x) +
+                                           "Y" + std::to_string(y) +
+                                           "Z7" + "_" + "I0";
+
+            WireId lut1In0Wire = getWireByName(lut1_in0_name);
+            WireId lut0In0Wire = getWireByName(lut0_in0_name);
+            WireId lut3In0Wire = getWireByName(lut3_in0_name);
+            WireId lut2In0Wire = getWireByName(lut2_in0_name);
+            WireId lut5In0Wire = getWireByName(lut5_in0_name);
+            WireId lut4In0Wire = getWireByName(lut4_in0_name);
+            WireId lut7In0Wire = getWireByName(lut7_in0_name);
+            WireId lut6In0Wire = getWireByName(lut6_in0_name);
+
+            std::string pipBYLut1ToDffName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "BYLUT1->DFF1";
+            std::string pipBYLut0ToDffName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "BYLUT0->DFF0";
+            std::string pipBYLut3ToDffName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "BYLUT3->DFF3";
+            std::string pipBYLut2ToDffName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "BYLUT2->DFF2";
+            std::string pipBYLut5ToDffName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "BYLUT5->DFF5";
+            std::string pipBYLut4ToDffName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "BYLUT4->DFF4";
+            std::string pipBYLut7ToDffName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "BYLUT7->DFF7";
+            std::string pipBYLut6ToDffName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "BYLUT6->DFF6";
+
+            addPip(pipBYLut1ToDffName, pipType,
+                   lut1In0Wire, dff1InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipBYLut0ToDffName, pipType,
+                   lut0In0Wire, dff0InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipBYLut3ToDffName, pipType,
+                   lut3In0Wire, dff3InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipBYLut2ToDffName, pipType,
+                   lut2In0Wire, dff2InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipBYLut5ToDffName, pipType,
+                   lut5In0Wire, dff5InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipBYLut4ToDffName, pipType,
+                   lut4In0Wire, dff4InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipBYLut7ToDffName, pipType,
+                   lut7In0Wire, dff7InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+            addPip(pipBYLut6ToDffName, pipType,
+                   lut6In0Wire, dff6InWire,
+                   getDelayFromNS(0.01), Loc(x, y, 0));
+
+        }
+    }
+
+    // East:  LUT0 (1) ->LUT1 (0)
+    // South: LUT2 (3) ->LUT3 (2)
+    // West:  LUT4 (5) ->LUT5 (4)
+    // North: LUT6 (7) ->LUT7 (6)
+    for (int x = 0; x < gridDimX; x++) {
+        for (int y = 0; y < gridDimY; y++) {
+            setupPipsForCLB(x, y, numSingleWires, numDoubleWires, 0); // East CLB IOs
+            setupPipsForCLB(x, y, numSingleWires, numDoubleWires, 1); // North CLB IOs
+            setupPipsForCLB(x, y, numSingleWires, numDoubleWires, 2); // West CLB IOs
+            setupPipsForCLB(x, y, numSingleWires, numDoubleWires, 3); // South CLB IOs
+        }
+    }
+
+    // SB {E, N, W, S}
+    // switchbox-element-two mapping
+    // N0E0, N0S0, N0W1, N1E1, N1S1, N1W0
+    // E0W0, E0N0, E0S1, E1W1, E1N1, E1S0
+    // S0W0, S0N0, S0E1, S1W1, S1N1, S1E0
+    // W0E0, W0S0, W0N1, W1E1, W1S1, W1N0
+    for (int x = 0; x < gridDimX; x++) {
+        for (int y = 0; y < gridDimY; y++) {
+            for (int s = 0; s < numSingleWires; s++) {
+                setupPipsForSB(x, y, s, 0, 1); // E->S
+                setupPipsForSB(x, y, s, 1, 0); // S->E
+                setupPipsForSB(x, y, s, 1, 3); // S->N
+                setupPipsForSB(x, y, s, 3, 1); // N->S
+                setupPipsForSB(x, y, s, 1, 2); // S->W
+                setupPipsForSB(x, y, s, 2, 1); // W->S
+                setupPipsForSB(x, y, s, 0, 2); // E->W
+                setupPipsForSB(x, y, s, 2, 0); // W->E
+            }
+        }
+    }
+
+    // CB <-> SB
+    for (int x = 0; x < gridDimX; x++) {
+        for (int y = 0; y < gridDimY; y++) {
+            bool isNorthAvail = (y + 1) < gridDimY;
+            bool isEastAvail  = (x + 1) < gridDimX;
+            bool isSouthAvail = (y - 1) >= 0;
+            bool isWestAvail  = (x - 1) >= 0;
+
+            // CBs and SB in the same tile
+            for (int s = 0; s < numSingleWires; s++) {
+                std::string cb0Wire1InName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "_CB0_SINGLE1_IN" + std::to_string(s);
+                std::string cb0Wire1OutName = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CB0_SINGLE1_OUT" + std::to_string(s);
+
+                std::string cb1Wire1InName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "_CB1_SINGLE1_IN" + std::to_string(s);
+                std::string cb1Wire1OutName = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CB1_SINGLE1_OUT" + std::to_string(s);
+
+                std::string sbSWireInName = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_SB_S_SINGLE_IN" + std::to_string(s);
+
+                std::string sbSWireOutName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "_SB_S_SINGLE_OUT" + std::to_string(s);
+
+                std::string sbWWireInName = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_SB_W_SINGLE_IN" + std::to_string(s);
+
+                std::string sbWWireOutName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "_SB_W_SINGLE_OUT" + std::to_string(s);
+
+                WireId cb0Wire1In  = getWireByName(cb0Wire1InName);
+                WireId cb0Wire1Out = getWireByName(cb0Wire1OutName);
+
+                WireId cb1Wire1In  = getWireByName(cb1Wire1InName);
+                WireId cb1Wire1Out = getWireByName(cb1Wire1OutName);
+
+                WireId sbSWireIn  = getWireByName(sbSWireInName);
+                WireId sbSWireOut = getWireByName(sbSWireOutName);
+
+                WireId sbWWireIn  = getWireByName(sbWWireInName);
+                WireId sbWWireOut = getWireByName(sbWWireOutName);
+
+                // CB->SB
+                std::string pipCB0_SBName = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_CB0->SB_S_SINGLE" + std::to_string(s);
+                std::string pipCB1_SBName = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_CB1->SB_W_SINGLE" + std::to_string(s);
+                // SB->CB
+                std::string pipSB_CB0Name = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_SB_S->CB0_SINGLE" + std::to_string(s);
+                std::string pipSB_CB1Name = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_SB_W->CB1_SINGLE" + std::to_string(s);
+
+                addPip(pipCB0_SBName, pipType,
+                       cb0Wire1Out, sbSWireIn,
+                       getDelayFromNS(0.01), Loc(x, y, 0));
+                addPip(pipCB1_SBName, pipType,
+                       cb1Wire1Out, sbWWireIn,
+                       getDelayFromNS(0.01), Loc(x, y, 0));
+
+                addPip(pipSB_CB0Name, pipType,
+                       sbSWireOut, cb0Wire1In,
+                       getDelayFromNS(0.01), Loc(x, y, 0));
+                addPip(pipSB_CB1Name, pipType,
+                       sbWWireOut, cb1Wire1In,
+                       getDelayFromNS(0.01), Loc(x, y, 0));
+            }
+
+            // The second half of the double wires connect to the SB of the same tile
+            for (int s = 4; s < numDoubleWires; s++) {
+                std::string cb0Wire1InName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "_CB0_DOUBLE1_IN" + std::to_string(s);
+                std::string cb0Wire1OutName = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CB0_DOUBLE1_OUT" + std::to_string(s);
+
+                std::string cb1Wire1InName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "_CB1_DOUBLE1_IN" + std::to_string(s);
+                std::string cb1Wire1OutName = "X" + std::to_string(x) +
+                                              "Y" + std::to_string(y) +
+                                              "_CB1_DOUBLE1_OUT" + std::to_string(s);
+
+                std::string sbSWireInName = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_SB_S_DOUBLE_IN" + std::to_string(s - 4);
+
+                std::string sbSWireOutName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "_SB_S_DOUBLE_OUT" + std::to_string(s - 4);
+
+                std::string sbWWireInName = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_SB_W_DOUBLE_IN" + std::to_string(s - 4);
+
+                std::string sbWWireOutName = "X" + std::to_string(x) +
+                                             "Y" + std::to_string(y) +
+                                             "_SB_W_DOUBLE_OUT" + std::to_string(s - 4);
+
+                WireId cb0Wire1In  = getWireByName(cb0Wire1InName);
+                WireId cb0Wire1Out = getWireByName(cb0Wire1OutName);
+
+                WireId cb1Wire1In  = getWireByName(cb1Wire1InName);
+                WireId cb1Wire1Out = getWireByName(cb1Wire1OutName);
+
+                WireId sbSWireIn  = getWireByName(sbSWireInName);
+                WireId sbSWireOut = getWireByName(sbSWireOutName);
+
+                WireId sbWWireIn  = getWireByName(sbWWireInName);
+                WireId sbWWireOut = getWireByName(sbWWireOutName);
+
+                // CB->SB
+                std::string pipCB0_SBName = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_CB0->SB_S_DOUBLE" + std::to_string(s - 4);
+                std::string pipCB1_SBName = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_CB1->SB_W_DOUBLE" + std::to_string(s - 4);
+                // SB->CB
+                std::string pipSB_CB0Name = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_SB_S->CB0_DOUBLE" + std::to_string(s - 4);
+                std::string pipSB_CB1Name = "X" + std::to_string(x) +
+                                            "Y" + std::to_string(y) +
+                                            "_SB_W->CB1_DOUBLE" + std::to_string(s - 4);
+
+                addPip(pipCB0_SBName, pipType,
+                       cb0Wire1Out, sbSWireIn,
+                       getDelayFromNS(0.01), Loc(x, y, 0));
+                addPip(pipCB1_SBName, pipType,
+                       cb1Wire1Out, sbWWireIn,
+                       getDelayFromNS(0.01), Loc(x, y, 0));
+
+                addPip(pipSB_CB0Name, pipType,
+                       sbSWireOut, cb0Wire1In,
+                       getDelayFromNS(0.01), Loc(x, y, 0));
+                addPip(pipSB_CB1Name, pipType,
+                       sbWWireOut, cb1Wire1In,
+                       getDelayFromNS(0.01), Loc(x, y, 0));
+            }
+
+            // CB0 and SB from the South tile
+            if (isSouthAvail) {
+                for (int s = 0; s < numSingleWires; s++) {
+                    std::string cb0Wire0InName = "X" + std::to_string(x) +
+                                                 "Y" + std::to_string(y) +
+                                                 "_CB0_SINGLE0_IN" + std::to_string(s);
+                    std::string cb0Wire0OutName = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB0_SINGLE0_OUT" + std::to_string(s);
+
+                    std::string sbWireInName = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y - 1) +
+                                               "_SB_N_SINGLE_IN" + std::to_string(s);
+                    std::string sbWireOutName = "X" + std::to_string(x) +
+                                                "Y" + std::to_string(y - 1) +
+                                                "_SB_N_SINGLE_OUT" + std::to_string(s);
+
+                    WireId cb0Wire0In = getWireByName(cb0Wire0InName);
+                    WireId cb0Wire0Out = getWireByName(cb0Wire0OutName);
+
+                    WireId sbWireIn  = getWireByName(sbWireInName);
+                    WireId sbWireOut = getWireByName(sbWireOutName);
+
+                    // CB->SB
+                    std::string pipCB_SBName = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "_CB0->SB_N_SINGLE" + std::to_string(s);
+                    // SB->CB
+                    std::string pipSB_CBName = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y - 1) +
+                                               "_SB_N->CB0_SINGLE" + std::to_string(s);
+
+                    addPip(pipCB_SBName, pipType,
+                           cb0Wire0Out, sbWireIn,
+                           getDelayFromNS(0.01), Loc(x, y, 0));
+                    addPip(pipSB_CBName, pipType,
+                           sbWireOut, cb0Wire0In,
+                           getDelayFromNS(0.01), Loc(x, y - 1, 0));
+                }
+
+                // The double wires of the South SB connect to the first-half
+                // double wires of the CB0
+                for (int s = 0; s < numDoubleWires / 2; s++) {
+                    std::string cb0Wire0InName = "X" + std::to_string(x) +
+                                                 "Y" + std::to_string(y) +
+                                                 "_CB0_DOUBLE0_IN" + std::to_string(s);
+                    std::string cb0Wire0OutName = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB0_DOUBLE0_OUT" + std::to_string(s);
+
+                    std::string sbWireInName = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y - 1) +
+                                               "_SB_N_DOUBLE_IN" + std::to_string(s);
+
+                    std::string sbWireOutName = "X" + std::to_string(x) +
+                                                "Y" + std::to_string(y - 1) +
+                                                "_SB_N_DOUBLE_OUT" + std::to_string(s);
+
+                    WireId cb0Wire0In  = getWireByName(cb0Wire0InName);
+                    WireId cb0Wire0Out = getWireByName(cb0Wire0OutName);
+
+                    WireId sbWireIn   = getWireByName(sbWireInName);
+                    WireId sbWireOut  = getWireByName(sbWireOutName);
+
+                    // CB->SB
+                    std::string pipCB_SBName = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "_CB0->SB_N_DOUBLE" + std::to_string(s);
+                    // SB->CB
+                    std::string pipSB_CBName = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y - 1) +
+                                               "_SB_N->CB0_DOUBLE" + std::to_string(s);
+
+                    addPip(pipCB_SBName, pipType,
+                           cb0Wire0Out, sbWireIn,
+                           getDelayFromNS(0.01), Loc(x, y, 0));
+                    addPip(pipSB_CBName, pipType,
+                           sbWireOut, cb0Wire0In,
+                           getDelayFromNS(0.01), Loc(x, y - 1, 0));
+                }
+            }
+
+            // CB1 and SB from the West tile
+            if (isWestAvail) {
+                for (int s = 0; s < numSingleWires; s++) {
+                    std::string cb1Wire0InName = "X" + std::to_string(x) +
+                                                 "Y" + std::to_string(y) +
+                                                 "_CB1_SINGLE0_IN" + std::to_string(s);
+                    std::string cb1Wire0OutName = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB1_SINGLE0_OUT" + std::to_string(s);
+
+                    std::string sbWireInName = "X" + std::to_string(x - 1) +
+                                               "Y" + std::to_string(y) +
+                                               "_SB_E_SINGLE_IN" + std::to_string(s);
+
+                    std::string sbWireOutName = "X" + std::to_string(x - 1) +
+                                                "Y" + std::to_string(y) +
+                                                "_SB_E_SINGLE_OUT" + std::to_string(s);
+
+                    WireId cb1Wire0In  = getWireByName(cb1Wire0InName);
+                    WireId cb1Wire0Out = getWireByName(cb1Wire0OutName);
+
+                    WireId sbWireIn  = getWireByName(sbWireInName);
+                    WireId sbWireOut = getWireByName(sbWireOutName);
+
+                    // CB->SB
+                    std::string pipCB_SBName = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "_CB1->SB_E_SINGLE" + std::to_string(s);
+                    // SB->CB
+                    std::string pipSB_CBName = "X" + std::to_string(x - 1) +
+                                               "Y" + std::to_string(y) +
+                                               "_SB_E->CB1_SINGLE" + std::to_string(s);
+
+                    addPip(pipCB_SBName, pipType,
+                           cb1Wire0Out, sbWireIn,
+                           getDelayFromNS(0.01), Loc(x, y, 0));
+                    addPip(pipSB_CBName, pipType,
+                           sbWireOut, cb1Wire0In,
+                           getDelayFromNS(0.01), Loc(x - 1, y, 0));
+                }
+
+                // The double wires of the West SB connect to the first-half
+                // double wires of the CB1
+                for (int s = 0; s < numDoubleWires / 2; s++) {
+                    std::string cb1Wire0InName = "X" + std::to_string(x) +
+                                                 "Y" + std::to_string(y) +
+                                                 "_CB1_DOUBLE0_IN" + std::to_string(s);
+                    std::string cb1Wire0OutName = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB1_DOUBLE0_OUT" + std::to_string(s);
+
+                    std::string sbWireInName = "X" + std::to_string(x - 1) +
+                                               "Y" + std::to_string(y) +
+                                               "_SB_E_DOUBLE_IN" + std::to_string(s);
+
+                    std::string sbWireOutName = "X" + std::to_string(x - 1) +
+                                                "Y" + std::to_string(y) +
+                                                "_SB_E_DOUBLE_OUT" + std::to_string(s);
+
+                    WireId cb1Wire0In  = getWireByName(cb1Wire0InName);
+                    WireId cb1Wire0Out = getWireByName(cb1Wire0OutName);
+
+                    WireId sbWireIn  = getWireByName(sbWireInName);
+                    WireId sbWireOut = getWireByName(sbWireOutName);
+
+                    // CB->SB
+                    std::string pipCB_SBName = "X" + std::to_string(x) +
+                                               "Y" + std::to_string(y) +
+                                               "_CB1->SB_E_DOUBLE" + std::to_string(s);
+                    // SB->CB
+                    std::string pipSB_CBName = "X" + std::to_string(x - 1) +
+                                               "Y" + std::to_string(y) +
+                                               "_SB_E->CB1_DOUBLE" + std::to_string(s);
+
+                    addPip(pipCB_SBName, pipType,
+                           cb1Wire0Out, sbWireIn,
+                           getDelayFromNS(0.01), Loc(x, y, 0));
+                    addPip(pipSB_CBName, pipType,
+                           sbWireOut, cb1Wire0In,
+                           getDelayFromNS(0.01), Loc(x - 1, y, 0));
+                }
+            }
+
+            // The first-half of the double wires connect to the CB of the adjacent tile
+            // (skipping the SB of the same tile)
+            // CB0 and CB0 from the North tile
+            // CB1 and CB1 from the East tile
+            for (int s = 0; s < numDoubleWires / 2; s++) {
+                if (isNorthAvail) {
+                    std::string cb0Wire1InName  = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB0_DOUBLE1_IN" + std::to_string(s);
+                    std::string cb0Wire1OutName = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB0_DOUBLE1_OUT" + std::to_string(s);
+                    std::string cb0NWire0InName  = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y + 1) +
+                                                   "_CB0_DOUBLE0_IN" + std::to_string(s + 4);
+                    std::string cb0NWire0OutName = "X" + std::to_string(x) +
+                                                   "Y" + std::to_string(y + 1) +
+                                                   "_CB0_DOUBLE0_OUT" + std::to_string(s + 4);
+
+                    WireId cb0Wire1In   = getWireByName(cb0Wire1InName);
+                    WireId cb0Wire1Out  = getWireByName(cb0Wire1OutName);
+                    WireId cb0NWire0In  = getWireByName(cb0NWire0InName);
+                    WireId cb0NWire0Out = getWireByName(cb0NWire0OutName);
+
+                    std::string pip0CB_CBName = "X" + std::to_string(x) +
+                                                "Y" + std::to_string(y) +
+                                                "_CB0->CB0_DOUBLE" + std::to_string(s + 4);
+                    std::string pip1CB_CBName = "X" + std::to_string(x) +
+                                                "Y" + std::to_string(y + 1) +
+                                                "_CB0->CB0_DOUBLE" + std::to_string(s);
+                    addPip(pip0CB_CBName, pipType,
+                           cb0Wire1Out, cb0NWire0In,
+                           getDelayFromNS(0.01), Loc(x, y, 0));
+                    addPip(pip1CB_CBName, pipType,
+                           cb0NWire0Out, cb0Wire1In,
+                           getDelayFromNS(0.01), Loc(x, y + 1, 0));
+                }
+
+                if (isEastAvail) {
+                    std::string cb1Wire1InName = "X" + std::to_string(x) +
+                                                 "Y" + std::to_string(y) +
+                                                 "_CB1_DOUBLE1_IN" + std::to_string(s);
+                    std::string cb1Wire1OutName = "X" + std::to_string(x) +
+                                                  "Y" + std::to_string(y) +
+                                                  "_CB1_DOUBLE1_OUT" + std::to_string(s);
+
+                    std::string cb1EWire0InName  = "X" + std::to_string(x + 1) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB1_DOUBLE0_IN" + std::to_string(s + 4);
+                    std::string cb1EWire0OutName = "X" + std::to_string(x + 1) +
+                                                   "Y" + std::to_string(y) +
+                                                   "_CB1_DOUBLE0_OUT" + std::to_string(s + 4);
+
+                    WireId cb1Wire1In   = getWireByName(cb1Wire1InName);
+                    WireId cb1Wire1Out  = getWireByName(cb1Wire1OutName);
+                    WireId cb1EWire0In  = getWireByName(cb1EWire0InName);
+                    WireId cb1EWire0Out = getWireByName(cb1EWire0OutName);
+
+                    std::string pip0CB_CBName = "X" + std::to_string(x) +
+                                                "Y" + std::to_string(y) +
+                                                "_CB1->CB1_DOUBLE" + std::to_string(s + 4);
+                    std::string pip1CB_CBName = "X" + std::to_string(x + 1) +
+                                                "Y" + std::to_string(y) +
+                                                "_CB1->CB1_DOUBLE" + std::to_string(s);
+                    addPip(pip0CB_CBName, pipType,
+                           cb1Wire1Out, cb1EWire0In,
+                           getDelayFromNS(0.01), Loc(x, y, 0));
+                    addPip(pip1CB_CBName, pipType,
+                           cb1EWire0Out, cb1Wire1In,
+                           getDelayFromNS(0.01), Loc(x + 1, y, 0));
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------
+
+namespace {
+
+// Stable counting sort of (key, value) pairs into a flat array, recording the [begin, end) range of each key
+template <typename T>
+std::vector<T> group_by_key(const std::vector<std::pair<int32_t, T>> &items, int32_t num_keys,
+                            std::vector<int32_t> &begin)
+{
+    begin.assign(num_keys + 1, 0);
+    for (auto &item : items)
+        ++begin.at(item.first + 1);
+    for (int32_t i = 0; i < num_keys; i++)
+        begin[i + 1] += begin[i];
+    std::vector<int32_t> cursor(begin.begin(), begin.end() - 1);
+    std::vector<T> result(items.size());
+    for (auto &item : items)
+        result[cursor[item.first]++] = item.second;
+    return result;
+}
+
+struct BlobWriter
+{
+    std::vector<char> &blob;
+
+    explicit BlobWriter(std::vector<char> &blob) : blob(blob) {}
+
+    size_t reserve(size_t size)
+    {
+        size_t offset = (blob.size() + 3) & ~size_t(3);
+        blob.resize(offset + size);
+        return offset;
+    }
+
+    template <typename T> size_t add(const std::vector<T> &data)
+    {
+        size_t offset = reserve(sizeof(T) * data.size());
+        if (!data.empty())
+            memcpy(blob.data() + offset, data.data(), sizeof(T) * data.size());
+        return offset;
+    }
+};
+
+// The header is written at the start of the blob, so a field's offset in the header is also its offset in the blob
+void link(ChipInfoPOD &hdr, size_t field_offset, size_t target)
+{
+    int32_t rel = int32_t(target - field_offset);
+    memcpy(reinterpret_cast<char *>(&hdr) + field_offset, &rel, sizeof(rel));
+}
+
+} // namespace
+
+void ChipdbBuilder::write(std::vector<char> &blob) const
+{
+    int32_t num_bels = int32_t(bel_data.size()), num_wires = int32_t(wire_name.size()),
+            num_pips = int32_t(pip_data.size());
+
+    std::vector<int32_t> bel_wires_begin;
+    std::vector<BelWirePOD> flat_bel_wires = group_by_key(bel_wires, num_bels, bel_wires_begin);
+    std::vector<BelInfoPOD> flat_bel_data = bel_data;
+    for (int32_t i = 0; i < num_bels; i++) {
+        flat_bel_data[i].bel_wires_begin = bel_wires_begin[i];
+        flat_bel_data[i].bel_wires_end = bel_wires_begin[i + 1];
+    }
+
+    std::vector<int32_t> bel_pins_begin;
+    std::vector<BelPortPOD> flat_wire_bel_pins = group_by_key(wire_bel_pins, num_wires, bel_pins_begin);
+
+    // Uphill pips of each wire followed by its downhill pips, both in pip order
+    std::vector<std::pair<int32_t, int32_t>> wire_pip_items;
+    wire_pip_items.reserve(2 * num_pips);
+    for (int32_t i = 0; i < num_pips; i++) {
+        wire_pip_items.emplace_back(2 * pip_dst[i], i);
+        wire_pip_items.emplace_back(2 * pip_src[i] + 1, i);
+    }
+    std::vector<int32_t> wire_pips_begin;
+    std::vector<int32_t> flat_wire_pips = group_by_key(wire_pip_items, 2 * num_wires, wire_pips_begin);
+
+    std::vector<WireInfoPOD> flat_wire_data(num_wires);
+    for (int32_t i = 0; i < num_wires; i++) {
+        WireInfoPOD &wi = flat_wire_data[i];
+        wi.name = wire_name[i];
+        wi.type = wire_type[i];
+        wi.uphill_begin = wire_pips_begin[2 * i];
+        wi.uphill_end = wire_pips_begin[2 * i + 1];
+        wi.downhill_begin = wire_pips_begin[2 * i + 1];
+        wi.downhill_end = wire_pips_begin[2 * i + 2];
+        wi.bel_pins_begin = bel_pins_begin[i];
+        wi.bel_pins_end = bel_pins_begin[i + 1];
+    }
+
+    blob.clear();
+    BlobWriter out(blob);
+    ChipInfoPOD hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    out.reserve(sizeof(ChipInfoPOD));
+
+    size_t strings_offset = out.reserve(sizeof(RelPtr<char>) * strings.size());
+    for (size_t i = 0; i < strings.size(); i++) {
+        size_t str_offset = out.reserve(strings[i].size() + 1);
+        memcpy(blob.data() + str_offset, strings[i].c_str(), strings[i].size() + 1);
+        int32_t rel = int32_t(str_offset - (strings_offset + sizeof(RelPtr<char>) * i));
+        memcpy(blob.data() + strings_offset + sizeof(RelPtr<char>) * i, &rel, sizeof(rel));
+    }
+    link(hdr, offsetof(ChipInfoPOD, strings), strings_offset);
+
+    link(hdr, offsetof(ChipInfoPOD, tile_bel_dimz), out.add(tileBelDimZ));
+    link(hdr, offsetof(ChipInfoPOD, tile_pip_dimz), out.add(tilePipDimZ));
+    link(hdr, offsetof(ChipInfoPOD, bel_data), out.add(flat_bel_data));
+    link(hdr, offsetof(ChipInfoPOD, bel_wires), out.add(flat_bel_wires));
+    link(hdr, offsetof(ChipInfoPOD, wire_data), out.add(flat_wire_data));
+    link(hdr, offsetof(ChipInfoPOD, wire_bel_pins), out.add(flat_wire_bel_pins));
+    link(hdr, offsetof(ChipInfoPOD, wire_pips), out.add(flat_wire_pips));
+    link(hdr, offsetof(ChipInfoPOD, pip_data), out.add(pip_data));
+    link(hdr, offsetof(ChipInfoPOD, wire_loc), out.add(wire_loc));
+    link(hdr, offsetof(ChipInfoPOD, pip_src), out.add(pip_src));
+    link(hdr, offsetof(ChipInfoPOD, pip_dst), out.add(pip_dst));
+    link(hdr, offsetof(ChipInfoPOD, pip_delay), out.add(pip_delay));
+    link(hdr, offsetof(ChipInfoPOD, pip_loc), out.add(pip_loc));
+
+    if (blob.size() > size_t(std::numeric_limits<int32_t>::max()))
+        log_error("Routing graph database for a %dx%d fabric is too large.\n", gridDimX, gridDimY);
+
+    hdr.magic = BORCA_CHIPDB_MAGIC;
+    hdr.version = BORCA_CHIPDB_VERSION;
+    hdr.size = int32_t(blob.size());
+    hdr.width = gridDimX;
+    hdr.height = gridDimY;
+    hdr.num_strings = int32_t(strings.size());
+    hdr.num_bels = num_bels;
+    hdr.num_wires = num_wires;
+    hdr.num_pips = num_pips;
+    memcpy(blob.data(), &hdr, sizeof(hdr));
+}
+
+void Arch::buildChipdb(int width, int height, std::vector<char> &blob)
+{
+    if (width < 1 || height < 1 || width > std::numeric_limits<int16_t>::max() ||
+        height > std::numeric_limits<int16_t>::max())
+        log_error("Invalid borca fabric size %dx%d.\n", width, height);
+    ChipdbBuilder builder(width, height);
+    builder.build();
+    builder.write(blob);
+}
+
+NEXTPNR_NAMESPACE_END
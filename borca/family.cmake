@@ -0,0 +1,7 @@
+# The cell timing library is compiled in, so that nextpnr-borca does not need to find it at run time. configure_file
+# only touches the output when it changes, so that reconfiguring does not force a rebuild
+set(borca_timing_inc ${CMAKE_CURRENT_BINARY_DIR}/generated/borca_cell_timing.inc)
+file(READ ${CMAKE_CURRENT_SOURCE_DIR}/borca/cell_timing.txt BORCA_CELL_TIMING)
+file(WRITE ${borca_timing_inc}.tmp "R\"timing_lib(${BORCA_CELL_TIMING})timing_lib\"\n")
+configure_file(${borca_timing_inc}.tmp ${borca_timing_inc} COPYONLY)
+set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${CMAKE_CURRENT_SOURCE_DIR}/borca/cell_timing.txt)
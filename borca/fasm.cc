@@ -0,0 +1,214 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "fasm.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include "log.h"
+#include "nextpnr.h"
+#include "util.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+// How a cell parameter is written, see examples/write_fasm.py
+struct ParamConfig
+{
+    // Numeric parameters are written as a bit array (width > 1) or a single bit (width == 1) named after the
+    // parameter; others as `name.value`
+    bool numeric;
+    int width;
+};
+
+struct FasmWriter
+{
+    const Context *ctx;
+    std::map<std::pair<IdString, IdString>, ParamConfig> param_cfg;
+    // Nets and cells, sorted by name; the output is made of blocks of these
+    std::vector<const NetInfo *> nets;
+    std::vector<const CellInfo *> cells;
+
+    static const int items_per_block = 1024;
+
+    FasmWriter(const Context *ctx) : ctx(ctx)
+    {
+        std::string default_params = stringf("LUT4.INIT[%d] DFFER.INIT[1]", 1 << ctx->args.K);
+        parse_param_cfg(str_or_default(ctx->settings, ctx->id("fasm/params"), default_params));
+
+        for (auto &net : ctx->nets)
+            nets.push_back(net.second.get());
+        std::sort(nets.begin(), nets.end(),
+                  [&](const NetInfo *a, const NetInfo *b) { return a->name.str(ctx) < b->name.str(ctx); });
+        for (auto &cell : ctx->cells)
+            cells.push_back(cell.second.get());
+        std::sort(cells.begin(), cells.end(),
+                  [&](const CellInfo *a, const CellInfo *b) { return a->name.str(ctx) < b->name.str(ctx); });
+    }
+
+    // The parameters to write, as space-separated `<cell type>.<parameter>[<width>]` for numeric parameters and
+    // `<cell type>.<parameter>` for others
+    void parse_param_cfg(const std::string &spec)
+    {
+        std::istringstream entries(spec);
+        std::string entry;
+        while (entries >> entry) {
+            size_t dot = entry.find('.'), bracket = entry.find('[');
+            size_t name_end = std::min(bracket, entry.size());
+            ParamConfig cfg{bracket != std::string::npos, 1};
+            bool valid = dot != std::string::npos && dot > 0 && dot + 1 < name_end;
+            if (cfg.numeric) {
+                char *end = nullptr;
+                cfg.width = int(strtol(entry.c_str() + bracket + 1, &end, 10));
+                valid = valid && cfg.width > 0 && std::string(end) == "]";
+            }
+            if (!valid)
+                log_error("Invalid FASM parameter '%s', expected <cell type>.<parameter>[<width>] or "
+                          "<cell type>.<parameter>.\n",
+                          entry.c_str());
+            IdString type = ctx->id(entry.substr(0, dot)), param = ctx->id(entry.substr(dot + 1, name_end - dot - 1));
+            param_cfg[std::make_pair(type, param)] = cfg;
+        }
+    }
+
+    // Fabric names are formatted straight from the database, rather than creating an IdString for each
+    void append_name(std::string &out, const NamePOD &name) const
+    {
+        char xy[32];
+        snprintf(xy, sizeof(xy), "X%dY%d", name.x, name.y);
+        out += xy;
+        out += ctx->chip_info->strings[name.suffix].get();
+    }
+
+    void write_net(std::string &out, const NetInfo *net) const
+    {
+        out += "# Net ";
+        out += net->name.str(ctx);
+        out += '\n';
+        std::vector<std::string> pips;
+        for (auto &wire : net->wires) {
+            if (wire.second.pip == PipId())
+                continue;
+            pips.emplace_back();
+            append_name(pips.back(), ctx->chip_info->pip_data[wire.second.pip.index].name);
+        }
+        std::sort(pips.begin(), pips.end());
+        for (auto &pip : pips) {
+            out += pip;
+            out += '\n';
+        }
+        out += '\n';
+    }
+
+    void write_cell(std::string &out, const CellInfo *cell) const
+    {
+        std::string bel;
+        if (cell->bel != BelId())
+            append_name(bel, ctx->chip_info->bel_data[cell->bel.index].name);
+        out += "# Cell ";
+        out += cell->name.str(ctx);
+        out += " at ";
+        out += bel;
+        out += '\n';
+
+        std::vector<std::pair<IdString, const Property *>> params;
+        for (auto &param : cell->params)
+            params.emplace_back(param.first, &param.second);
+        std::sort(params.begin(), params.end(),
+                  [&](const std::pair<IdString, const Property *> &a, const std::pair<IdString, const Property *> &b) {
+                      return a.first.str(ctx) < b.first.str(ctx);
+                  });
+        for (auto &param : params) {
+            auto cfg = param_cfg.find(std::make_pair(cell->type, param.first));
+            if (cfg == param_cfg.end())
+                continue;
+            const char *name = param.first.c_str(ctx);
+            const Property &val = *param.second;
+            if (!cfg->second.numeric) {
+                out += stringf("%s.%s.%s\n", bel.c_str(), name, val.to_string().c_str());
+            } else if (cfg->second.width == 1) {
+                if (val.is_string ? (val.str != "0") : val.extract(0, 1).as_bool())
+                    out += stringf("%s.%s\n", bel.c_str(), name);
+            } else {
+                int width = cfg->second.width;
+                out += stringf("%s.%s[%d:0] = %d'b%s\n", bel.c_str(), name, width - 1, width,
+                               val.extract(0, width).to_string().c_str());
+            }
+        }
+        out += '\n';
+    }
+
+    int num_blocks() const
+    {
+        return int((nets.size() + items_per_block - 1) / items_per_block +
+                   (cells.size() + items_per_block - 1) / items_per_block);
+    }
+
+    // Blocks of nets come first, then blocks of cells
+    void write_block(std::string &out, int block) const
+    {
+        int net_blocks = int((nets.size() + items_per_block - 1) / items_per_block);
+        if (block < net_blocks) {
+            size_t end = std::min(nets.size(), size_t(block + 1) * items_per_block);
+            for (size_t i = size_t(block) * items_per_block; i < end; i++)
+                write_net(out, nets.at(i));
+        } else {
+            block -= net_blocks;
+            size_t end = std::min(cells.size(), size_t(block + 1) * items_per_block);
+            for (size_t i = size_t(block) * items_per_block; i < end; i++)
+                write_cell(out, cells.at(i));
+        }
+    }
+};
+
+} // namespace
+
+void write_fasm(Context *ctx, std::ostream &out)
+{
+    FasmWriter writer(ctx);
+#ifdef NPNR_DISABLE_THREADS
+    int threads = 1;
+#else
+    int threads = std::max(1, ctx->setting<int>("fasm/threads", int(boost::thread::hardware_concurrency())));
+#endif
+    // Format up to one block per thread at a time, then write them out in order, so the output is identical
+    // whatever the thread count and only a few blocks are ever held in memory
+    int num_blocks = writer.num_blocks();
+    std::vector<std::string> buffers(threads);
+    for (int first = 0; first < num_blocks; first += threads) {
+        int count = std::min(threads, num_blocks - first);
+        for (auto &buf : buffers)
+            buf.clear();
+#ifdef NPNR_DISABLE_THREADS
+        writer.write_block(buffers.at(0), first);
+#else
+        std::vector<boost::thread> workers;
+        for (int i = 1; i < count; i++)
+            workers.emplace_back([&writer, &buffers, first, i]() { writer.write_block(buffers.at(i), first + i); });
+        writer.write_block(buffers.at(0), first);
+        for (auto &w : workers)
+            w.join();
+#endif
+        for (int i = 0; i < count; i++)
+            out.write(buffers.at(i).data(), buffers.at(i).size());
+    }
+}
+
+NEXTPNR_NAMESPACE_END
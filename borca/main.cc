@@ -22,6 +22,7 @@
 #include <fstream>
 #include "command.h"
 #include "design_utils.h"
+#include "fasm.h"
 #include "log.h"
 #include "timing.h"
 
@@ -47,10 +48,29 @@ po::options_description BorcaCommandHandler::getArchOptions()
     po::options_description specific("Architecture specific options");
     specific.add_options()("borca", "set device type to borca");
     specific.add_options()("no-iobs", "disable automatic IO buffer insertion");
+    specific.add_options()("width", po::value<int>(), "fabric width in tiles (default 8)");
+    specific.add_options()("height", po::value<int>(), "fabric height in tiles (default 8)");
+    specific.add_options()("chipdb", po::value<std::string>(),
+                           "routing graph database file, generated if missing or stale (default: per-user cache)");
+    specific.add_options()("fasm", po::value<std::string>(), "FASM file to write");
+    specific.add_options()("fasm-params", po::value<std::string>(),
+                           "cell parameters to write to FASM, as space-separated <cell type>.<parameter>[<width>] "
+                           "(numeric) or <cell type>.<parameter> (default: LUT4.INIT[2^K] DFFER.INIT[1])");
+    specific.add_options()("timing-lib", po::value<std::string>(),
+                           "cell timing library to use instead of the built-in one");
     return specific;
 }
 
-void BorcaCommandHandler::customBitstream(Context *ctx) {}
+void BorcaCommandHandler::customBitstream(Context *ctx)
+{
+    if (vm.count("fasm")) {
+        std::string filename = vm["fasm"].as<std::string>();
+        std::ofstream f(filename);
+        if (!f)
+            log_error("Failed to open FASM file '%s' for writing.\n", filename.c_str());
+        write_fasm(ctx, f);
+    }
+}
 
 std::unique_ptr<Context> BorcaCommandHandler::createContext(std::unordered_map<std::string, Property> &values)
 {
@@ -60,9 +80,25 @@ std::unique_ptr<Context> BorcaCommandHandler::createContext(std::unordered_map<s
         if (arch_name != "borca")
             log_error("Unsupported architecture '%s'.\n", arch_name.c_str());
     }
+    if (values.find("arch.type") != values.end()) {
+        std::string arch_type = values["arch.type"].as_string();
+        // Designs saved before the fabric size was configurable use "none"
+        if (arch_type != "none" && sscanf(arch_type.c_str(), "%dx%d", &chipArgs.width, &chipArgs.height) != 2)
+            log_error("Unsupported borca fabric size '%s'.\n", arch_type.c_str());
+    }
+    if (vm.count("width"))
+        chipArgs.width = vm["width"].as<int>();
+    if (vm.count("height"))
+        chipArgs.height = vm["height"].as<int>();
+    if (vm.count("chipdb"))
+        chipArgs.chipdb = vm["chipdb"].as<std::string>();
+    if (vm.count("timing-lib"))
+        chipArgs.timing_lib = vm["timing-lib"].as<std::string>();
     auto ctx = std::unique_ptr<Context>(new Context(chipArgs));
     if (vm.count("no-iobs"))
         ctx->settings[ctx->id("disable_iobs")] = Property::State::S1;
+    if (vm.count("fasm-params"))
+        ctx->settings[ctx->id("fasm/params")] = vm["fasm-params"].as<std::string>();
     return ctx;
 }
 
@@ -0,0 +1,118 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include "log.h"
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+// borca/cell_timing.txt, embedded by family.cmake
+const char *builtin_cell_timing =
+#include "borca_cell_timing.inc"
+        ;
+
+} // namespace
+
+void Arch::loadTimingLibrary()
+{
+    std::string source = "built-in timing library";
+    std::string text = builtin_cell_timing;
+    if (!args.timing_lib.empty()) {
+        source = args.timing_lib;
+        std::ifstream in(args.timing_lib);
+        if (!in)
+            log_error("Failed to open timing library '%s'.\n", args.timing_lib.c_str());
+        std::stringstream buf;
+        buf << in.rdbuf();
+        text = buf.str();
+    }
+
+    // Pins of each bel type, for checking the library against
+    std::unordered_map<IdString, std::unordered_set<IdString>> bel_pins;
+    for (BelId bel : getBels()) {
+        IdString type = getBelType(bel);
+        if (bel_pins.count(type))
+            continue;
+        auto &pins = bel_pins[type];
+        for (IdString pin : getBelPins(bel))
+            pins.insert(pin);
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    int line_no = 0;
+    while (std::getline(lines, line)) {
+        ++line_no;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string type, kind;
+        if (!(fields >> type))
+            continue;
+        fields >> kind;
+        auto bad_line = [&]() {
+            log_error("%s:%d: expected '<cell type> comb|clock|setup_hold|clock_to_out ...'.\n", source.c_str(),
+                      line_no);
+        };
+        auto fnd_pins = bel_pins.find(id(type));
+        if (fnd_pins == bel_pins.end())
+            log_error("%s:%d: '%s' is not a bel type.\n", source.c_str(), line_no, type.c_str());
+        auto check_pin = [&](const std::string &pin) {
+            if (!fnd_pins->second.count(id(pin)))
+                log_error("%s:%d: bel type '%s' has no pin '%s'.\n", source.c_str(), line_no, type.c_str(),
+                          pin.c_str());
+        };
+        std::string port, other_port;
+        float a = 0, b = 0;
+        if (kind == "comb") {
+            if (!(fields >> port >> other_port >> a))
+                bad_line();
+            check_pin(port);
+            check_pin(other_port);
+            addCellTypeTimingDelay(id(type), id(port), id(other_port), getDelayFromNS(a));
+        } else if (kind == "clock") {
+            if (!(fields >> port))
+                bad_line();
+            check_pin(port);
+            addCellTypeTimingClock(id(type), id(port));
+        } else if (kind == "setup_hold") {
+            if (!(fields >> port >> other_port >> a >> b))
+                bad_line();
+            check_pin(port);
+            check_pin(other_port);
+            addCellTypeTimingSetupHold(id(type), id(port), id(other_port), getDelayFromNS(a), getDelayFromNS(b));
+        } else if (kind == "clock_to_out") {
+            if (!(fields >> port >> other_port >> a))
+                bad_line();
+            check_pin(port);
+            check_pin(other_port);
+            addCellTypeTimingClockToOut(id(type), id(port), id(other_port), getDelayFromNS(a));
+        } else {
+            bad_line();
+        }
+        std::string extra;
+        if (fields >> extra)
+            bad_line();
+    }
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,230 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include "log.h"
+#include "timing.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+double cpu_seconds()
+{
+#ifndef _WIN32
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+        return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1e-6;
+#endif
+    return double(std::clock()) / CLOCKS_PER_SEC;
+}
+
+int64_t peak_rss_kb()
+{
+#ifdef __linux__
+    // Unlike ru_maxrss, VmHWM is reset by clear_refs, and is not raised by the peak of threads that have exited
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        long long kb;
+        if (sscanf(line.c_str(), "VmHWM: %lld kB", &kb) == 1)
+            return kb;
+    }
+#endif
+#ifndef _WIN32
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0) {
+#ifdef __APPLE__
+        return int64_t(ru.ru_maxrss) / 1024;
+#else
+        return int64_t(ru.ru_maxrss);
+#endif
+    }
+#endif
+    return -1;
+}
+
+// Reset the peak RSS (VmHWM) to the current RSS, which Linux allows via clear_refs
+bool reset_peak_rss()
+{
+#ifdef __linux__
+    std::ofstream f("/proc/self/clear_refs");
+    if (!f)
+        return false;
+    f << "5";
+    f.flush();
+    return bool(f);
+#else
+    return false;
+#endif
+}
+
+void add_qor(Context *ctx, BenchStage &stage)
+{
+    stage.qor["cells"] = double(ctx->cells.size());
+    stage.qor["nets"] = double(ctx->nets.size());
+    if (stage.name != "place" && stage.name != "route")
+        return;
+
+    int64_t hpwl = 0, pips = 0;
+    for (auto &net : ctx->nets) {
+        NetInfo *ni = net.second.get();
+        for (auto &wire : ni->wires)
+            if (wire.second.pip != PipId())
+                ++pips;
+        if (ni->driver.cell == nullptr || ni->driver.cell->bel == BelId())
+            continue;
+        Loc drv = ctx->getBelLocation(ni->driver.cell->bel);
+        int x0 = drv.x, x1 = drv.x, y0 = drv.y, y1 = drv.y;
+        for (auto &usr : ni->users) {
+            if (usr.cell->bel == BelId())
+                continue;
+            Loc l = ctx->getBelLocation(usr.cell->bel);
+            x0 = std::min(x0, l.x);
+            x1 = std::max(x1, l.x);
+            y0 = std::min(y0, l.y);
+            y1 = std::max(y1, l.y);
+        }
+        hpwl += (x1 - x0) + (y1 - y0);
+    }
+    stage.qor["hpwl"] = double(hpwl);
+    if (stage.name == "route")
+        stage.qor["routed_pips"] = double(pips);
+}
+
+std::string json_string(const std::string &str)
+{
+    std::string out = "\"";
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (uint8_t(c) < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", unsigned(uint8_t(c)));
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+std::string json_number(double value) { return stringf("%.9g", value); }
+
+} // namespace
+
+void add_timing_qor(Context *ctx, BenchStage &stage)
+{
+    NetCriticalityMap net_crit;
+    setup_timing_analyser(ctx);
+    get_criticalities(ctx, &net_crit);
+    delay_t worst = std::numeric_limits<delay_t>::max();
+    for (auto &nc : net_crit)
+        for (auto slack : nc.second.slack)
+            worst = std::min(worst, slack);
+    if (worst != std::numeric_limits<delay_t>::max())
+        stage.qor["worst_slack_ns"] = ctx->getDelayNS(worst);
+}
+
+BenchTimer::BenchTimer(Context *ctx) : start_counters(ctx->work_counters)
+{
+    rss_reset = reset_peak_rss();
+    start_cpu = cpu_seconds();
+    start_wall = std::chrono::steady_clock::now();
+}
+
+BenchStage BenchTimer::finish(Context *ctx, const std::string &name, bool ok)
+{
+    BenchStage stage;
+    stage.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_wall).count();
+    stage.cpu_time = cpu_seconds() - start_cpu;
+    stage.peak_rss_kb = peak_rss_kb();
+    stage.peak_rss_per_stage = rss_reset;
+    stage.name = name;
+    stage.ok = ok;
+    for (auto &counter : ctx->work_counters) {
+        auto fnd = start_counters.find(counter.first);
+        int64_t delta = counter.second - (fnd == start_counters.end() ? 0 : fnd->second);
+        if (delta != 0)
+            stage.counters[counter.first] = delta;
+    }
+    // Quality of result is measured after the timer has stopped, from the design state alone
+    if (ok)
+        add_qor(ctx, stage);
+    return stage;
+}
+
+void write_bench_json(std::ostream &out, const std::vector<BenchDesign> &designs)
+{
+    out << "{\n  \"version\": 1,\n  \"designs\": [";
+    for (size_t i = 0; i < designs.size(); i++) {
+        auto &d = designs.at(i);
+        bool ok = std::all_of(d.stages.begin(), d.stages.end(), [](const BenchStage &s) { return s.ok; });
+        out << (i > 0 ? ",\n" : "\n") << "    {\n";
+        out << "      \"name\": " << json_string(d.name) << ",\n";
+        out << "      \"arch\": " << json_string(d.arch) << ",\n";
+        out << "      \"seed\": " << d.seed << ",\n";
+        out << "      \"ok\": " << (ok ? "true" : "false") << ",\n";
+        out << "      \"stages\": [";
+        for (size_t j = 0; j < d.stages.size(); j++) {
+            auto &s = d.stages.at(j);
+            out << (j > 0 ? ",\n" : "\n") << "        {\n";
+            out << "          \"stage\": " << json_string(s.name) << ",\n";
+            out << "          \"ok\": " << (s.ok ? "true" : "false") << ",\n";
+            out << "          \"wall_time\": " << json_number(s.wall_time) << ",\n";
+            out << "          \"cpu_time\": " << json_number(s.cpu_time) << ",\n";
+            out << "          \"peak_rss_kb\": " << s.peak_rss_kb << ",\n";
+            out << "          \"peak_rss_scope\": " << (s.peak_rss_per_stage ? "\"stage\"" : "\"process\"") << ",\n";
+            out << "          \"counters\": {";
+            bool first = true;
+            for (auto &c : s.counters) {
+                out << (first ? "" : ", ") << json_string(c.first) << ": " << c.second;
+                first = false;
+            }
+            out << "},\n";
+            out << "          \"rates\": {";
+            first = true;
+            for (auto &c : s.counters) {
+                double rate = s.wall_time > 0 ? c.second / s.wall_time : 0;
+                out << (first ? "" : ", ") << json_string(c.first + "_per_s") << ": " << json_number(rate);
+                first = false;
+            }
+            out << "},\n";
+            out << "          \"qor\": {";
+            first = true;
+            for (auto &q : s.qor) {
+                out << (first ? "" : ", ") << json_string(q.first) << ": " << json_number(q.second);
+                first = false;
+            }
+            out << "}\n        }";
+        }
+        out << "\n      ]\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,77 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Metrics of one stage of the flow (load, pack, place or route) for the benchmark mode (--bench)
+struct BenchStage
+{
+    std::string name;
+    bool ok = true;
+    // Seconds; CPU time is summed over all threads
+    double wall_time = 0, cpu_time = 0;
+    // Peak resident set size in KiB, over the stage alone if peak_rss_per_stage and otherwise since process start,
+    // or -1 if unknown
+    int64_t peak_rss_kb = -1;
+    bool peak_rss_per_stage = false;
+    // Increase of Context::work_counters during the stage
+    std::map<std::string, int64_t> counters;
+    // Quality of result after the stage, e.g. wirelength, and for the last stage worst slack
+    std::map<std::string, double> qor;
+};
+
+struct BenchDesign
+{
+    std::string name, arch;
+    uint64_t seed;
+    std::vector<BenchStage> stages;
+};
+
+// Measures a stage from construction until finish()
+class BenchTimer
+{
+  public:
+    explicit BenchTimer(Context *ctx);
+    BenchStage finish(Context *ctx, const std::string &name, bool ok);
+
+  private:
+    std::chrono::steady_clock::time_point start_wall;
+    double start_cpu;
+    bool rss_reset;
+    std::unordered_map<std::string, int64_t> start_counters;
+};
+
+// Add the worst slack to the quality of result of a stage. This sets up the timing analyser, which would change
+// the flow if done between stages, so it is only used once the flow has finished.
+void add_timing_qor(Context *ctx, BenchStage &stage);
+
+// Write the results as JSON, with per-second rates derived from the work counters
+void write_bench_json(std::ostream &out, const std::vector<BenchDesign> &designs);
+
+NEXTPNR_NAMESPACE_END
+
+#endif
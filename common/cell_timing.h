@@ -0,0 +1,245 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// Included by arch.h, which is in turn included part-way through nextpnr.h; so pull in nextpnr.h first, letting it
+// reach this header through arch.h with everything CellTimingStore needs already declared
+#include "nextpnr.h"
+
+#ifndef CELL_TIMING_H
+#define CELL_TIMING_H
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+NEXTPNR_NAMESPACE_BEGIN
+
+struct CellDelayKey
+{
+    IdString from, to;
+    inline bool operator==(const CellDelayKey &other) const { return from == other.from && to == other.to; }
+};
+
+NEXTPNR_NAMESPACE_END
+namespace std {
+template <> struct hash<NEXTPNR_NAMESPACE_PREFIX CellDelayKey>
+{
+    std::size_t operator()(const NEXTPNR_NAMESPACE_PREFIX CellDelayKey &dk) const noexcept
+    {
+        std::size_t seed = std::hash<NEXTPNR_NAMESPACE_PREFIX IdString>()(dk.from);
+        seed ^= std::hash<NEXTPNR_NAMESPACE_PREFIX IdString>()(dk.to) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+};
+} // namespace std
+NEXTPNR_NAMESPACE_BEGIN
+
+struct CellTiming
+{
+    std::unordered_map<IdString, TimingPortClass> portClasses;
+    std::unordered_map<CellDelayKey, DelayInfo> combDelays;
+    std::unordered_map<IdString, std::vector<TimingClockingInfo>> clockingInfo;
+
+    void add_clock(IdString port) { portClasses[port] = TMG_CLOCK_INPUT; }
+
+    void add_delay(IdString fromPort, IdString toPort, DelayInfo delay)
+    {
+        if (port_class(fromPort) == TMG_IGNORE)
+            portClasses[fromPort] = TMG_COMB_INPUT;
+        if (port_class(toPort) == TMG_IGNORE)
+            portClasses[toPort] = TMG_COMB_OUTPUT;
+        combDelays[CellDelayKey{fromPort, toPort}] = delay;
+    }
+
+    void add_setup_hold(IdString port, IdString clock, DelayInfo setup, DelayInfo hold)
+    {
+        TimingClockingInfo ci;
+        ci.clock_port = clock;
+        ci.edge = RISING_EDGE;
+        ci.setup = setup;
+        ci.hold = hold;
+        clockingInfo[port].push_back(ci);
+        portClasses[port] = TMG_REGISTER_INPUT;
+    }
+
+    void add_clock_to_out(IdString port, IdString clock, DelayInfo clktoq)
+    {
+        TimingClockingInfo ci;
+        ci.clock_port = clock;
+        ci.edge = RISING_EDGE;
+        ci.clockToQ = clktoq;
+        clockingInfo[port].push_back(ci);
+        portClasses[port] = TMG_REGISTER_OUTPUT;
+    }
+
+    TimingPortClass port_class(IdString port) const
+    {
+        auto fnd = portClasses.find(port);
+        return fnd == portClasses.end() ? TMG_IGNORE : fnd->second;
+    }
+
+    // The contents of the model in a canonical order, so that identical models have identical keys
+    std::string key() const
+    {
+        std::vector<std::pair<int, int>> classes;
+        for (auto &pc : portClasses)
+            classes.emplace_back(pc.first.index, int(pc.second));
+        std::sort(classes.begin(), classes.end());
+        std::vector<std::tuple<int, int, delay_t>> delays;
+        for (auto &cd : combDelays)
+            delays.emplace_back(cd.first.from.index, cd.first.to.index, cd.second.delay);
+        std::sort(delays.begin(), delays.end());
+        std::vector<int> clocked_ports;
+        for (auto &ci : clockingInfo)
+            clocked_ports.push_back(ci.first.index);
+        std::sort(clocked_ports.begin(), clocked_ports.end());
+
+        std::string key;
+        append_key(key, classes.size());
+        for (auto &c : classes)
+            append_key(key, c);
+        append_key(key, delays.size());
+        for (auto &d : delays) {
+            append_key(key, std::get<0>(d));
+            append_key(key, std::get<1>(d));
+            append_key(key, std::get<2>(d));
+        }
+        append_key(key, clocked_ports.size());
+        for (int port : clocked_ports) {
+            auto &infos = clockingInfo.at(IdString(port));
+            append_key(key, port);
+            append_key(key, infos.size());
+            for (auto &ci : infos) {
+                append_key(key, ci.clock_port.index);
+                append_key(key, int(ci.edge));
+                append_key(key, ci.setup.delay);
+                append_key(key, ci.hold.delay);
+                append_key(key, ci.clockToQ.delay);
+            }
+        }
+        return key;
+    }
+
+  private:
+    template <typename T> static void append_key(std::string &key, const T &value)
+    {
+        key.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+};
+
+// Timing models for archs where they are set at runtime, as generic and borca do from Python or a timing library.
+//
+// Models are normally set per cell type, and can be overridden for individual cells. Identical per-cell models are
+// merged by intern(), so memory scales with the number of distinct models rather than with the number of cells; a
+// merged model is copied before it is changed for one cell.
+struct CellTimingStore
+{
+    CellTiming &type_for_update(IdString type)
+    {
+        auto fnd = by_type.find(type);
+        if (fnd != by_type.end())
+            return models.at(fnd->second);
+        by_type[type] = int(models.size());
+        models.emplace_back();
+        shared.push_back(false);
+        return models.back();
+    }
+
+    CellTiming &cell_for_update(IdString cell)
+    {
+        auto fnd = by_cell.find(cell);
+        if (fnd == by_cell.end()) {
+            by_cell[cell] = int(models.size());
+            models.emplace_back();
+            shared.push_back(false);
+            return models.back();
+        }
+        if (shared.at(fnd->second)) {
+            // Copy on write
+            CellTiming copy = models.at(fnd->second);
+            fnd->second = int(models.size());
+            models.push_back(std::move(copy));
+            shared.push_back(false);
+        }
+        return models.at(fnd->second);
+    }
+
+    // A cell's own model, or else that of its type; nullptr if it has neither
+    const CellTiming *get(const CellInfo *cell) const
+    {
+        if (!by_cell.empty()) {
+            auto fnd = by_cell.find(cell->name);
+            if (fnd != by_cell.end())
+                return &models[fnd->second];
+        }
+        auto fnd = by_type.find(cell->type);
+        return fnd != by_type.end() ? &models[fnd->second] : nullptr;
+    }
+
+    void intern()
+    {
+        if (by_cell.empty())
+            return;
+        std::vector<CellTiming> new_models;
+        for (auto &type : by_type) {
+            int index = int(new_models.size());
+            new_models.push_back(std::move(models.at(type.second)));
+            type.second = index;
+        }
+        // Models may already be shared from an earlier call, so map each old model only once
+        std::unordered_map<std::string, int> index_by_key;
+        std::unordered_map<int, int> new_index;
+        std::vector<int> cell_refs(new_models.size(), 0);
+        for (auto &cell : by_cell) {
+            auto mapped = new_index.find(cell.second);
+            if (mapped == new_index.end()) {
+                CellTiming &tmg = models.at(cell.second);
+                std::string key = tmg.key();
+                auto fnd = index_by_key.find(key);
+                int index;
+                if (fnd != index_by_key.end()) {
+                    index = fnd->second;
+                } else {
+                    index = int(new_models.size());
+                    index_by_key[key] = index;
+                    new_models.push_back(std::move(tmg));
+                    cell_refs.push_back(0);
+                }
+                mapped = new_index.emplace(cell.second, index).first;
+            }
+            cell.second = mapped->second;
+            ++cell_refs.at(cell.second);
+        }
+        // Only models used by more than one cell need copying on write
+        models = std::move(new_models);
+        shared.clear();
+        for (int refs : cell_refs)
+            shared.push_back(refs > 1);
+    }
+
+  private:
+    std::vector<CellTiming> models;
+    std::unordered_map<IdString, int> by_type, by_cell;
+    // Set for merged models, which must be copied before they are changed for one cell
+    std::vector<bool> shared;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
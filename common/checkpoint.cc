@@ -0,0 +1,712 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "checkpoint.h"
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstring>
+#include <ios>
+#include "diskcache.h"
+#include "log.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+const uint32_t checkpoint_magic = 0x4b435050; // "PPCK"
+const uint32_t checkpoint_version = 2;
+
+class CheckpointWriter
+{
+  public:
+    explicit CheckpointWriter(Context *ctx) : ctx(ctx), string_index(ctx->idstring_db->size(), -1) {}
+
+    void write_design()
+    {
+        put_u32(checkpoint_magic);
+        put_u32(checkpoint_version);
+        // The settings come first, and use plain strings, so they can be read before there is a context
+        put_i32(int(ctx->settings.size()));
+        for (auto &setting : ctx->settings) {
+            put_string(setting.first.str(ctx));
+            put_property(setting.second, true);
+        }
+        put_string(ctx->archId().str(ctx));
+        put_string(ctx->archArgsToId(ctx->archArgs()).str(ctx));
+        put_i32(ctx->getWireIndexCount());
+
+        // Number the cells and nets, and collect every string used by the design
+        std::vector<CellInfo *> cells;
+        for (auto &cell : ctx->cells) {
+            cell.second->udata = int(cells.size());
+            cells.push_back(cell.second.get());
+        }
+        std::vector<NetInfo *> nets;
+        for (auto &net : ctx->nets) {
+            net.second->udata = int(nets.size());
+            nets.push_back(net.second.get());
+        }
+        std::string body;
+        body.swap(out);
+        write_netlist(cells, nets);
+        body.swap(out);
+
+        put_i32(int(strings.size()));
+        for (int idx : strings)
+            put_string(IdString(idx).str(ctx));
+        out += body;
+    }
+
+    std::string out;
+
+  private:
+    Context *ctx;
+    // IdString index -> string table index, or -1 if not in the table yet
+    std::vector<int> string_index;
+    std::vector<int> strings;
+    std::unordered_map<const Region *, int> region_index;
+
+    void put_bytes(const void *data, size_t size) { out.append(reinterpret_cast<const char *>(data), size); }
+    void put_u32(uint32_t value) { put_bytes(&value, sizeof(value)); }
+    void put_i32(int32_t value) { put_bytes(&value, sizeof(value)); }
+    void put_float(float value) { put_bytes(&value, sizeof(value)); }
+
+    void put_string(const std::string &s)
+    {
+        put_i32(int(s.size()));
+        out += s;
+    }
+
+    void put_id(IdString id)
+    {
+        if (id.index >= int(string_index.size()))
+            string_index.resize(ctx->idstring_db->size(), -1);
+        int &idx = string_index.at(id.index);
+        if (idx == -1) {
+            idx = int(strings.size());
+            strings.push_back(id.index);
+        }
+        put_i32(idx);
+    }
+
+    void put_property(const Property &prop, bool plain = false)
+    {
+        out += char(prop.is_string);
+        if (prop.is_string && !plain) {
+            put_id(ctx->id(prop.str));
+        } else {
+            put_string(prop.str);
+        }
+    }
+
+    void put_properties(const std::unordered_map<IdString, Property> &props)
+    {
+        put_i32(int(props.size()));
+        for (auto &prop : props) {
+            put_id(prop.first);
+            put_property(prop.second);
+        }
+    }
+
+    void put_id_map(const std::unordered_map<IdString, IdString> &map)
+    {
+        put_i32(int(map.size()));
+        for (auto &entry : map) {
+            put_id(entry.first);
+            put_id(entry.second);
+        }
+    }
+
+    void put_loc(Loc loc)
+    {
+        put_i32(loc.x);
+        put_i32(loc.y);
+        put_i32(loc.z);
+    }
+
+    void put_cell(const CellInfo *cell) { put_i32(cell != nullptr ? cell->udata : -1); }
+    void put_net(const NetInfo *net) { put_i32(net != nullptr ? net->udata : -1); }
+    void put_region(const Region *region) { put_i32(region != nullptr ? region_index.at(region) : -1); }
+
+    void put_port_ref(const PortRef &ref)
+    {
+        put_cell(ref.cell);
+        put_id(ref.port);
+        put_float(ctx->getDelayNS(ref.budget));
+    }
+
+    void write_netlist(const std::vector<CellInfo *> &cells, const std::vector<NetInfo *> &nets)
+    {
+        put_properties(ctx->attrs);
+        put_i32(int(cells.size()));
+        for (auto cell : cells) {
+            put_id(cell->name);
+            put_id(cell->type);
+        }
+        put_i32(int(nets.size()));
+        for (auto net : nets)
+            put_id(net->name);
+
+        // Floorplanning regions, with bels by location and wires by index like placement and routing
+        put_i32(int(ctx->region.size()));
+        for (auto &region : ctx->region) {
+            const Region *r = region.second.get();
+            region_index[r] = int(region_index.size());
+            put_id(region.first);
+            out += char(r->constr_bels);
+            out += char(r->constr_wires);
+            out += char(r->constr_pips);
+            put_i32(int(r->bels.size()));
+            for (auto bel : r->bels)
+                put_loc(ctx->getBelLocation(bel));
+            put_i32(int(r->wires.size()));
+            for (auto wire : r->wires)
+                put_i32(ctx->getWireIndex(wire));
+            put_i32(int(r->piplocs.size()));
+            for (auto loc : r->piplocs)
+                put_loc(loc);
+        }
+
+        for (auto cell : cells) {
+            put_id(cell->hierpath);
+            put_region(cell->region);
+            put_properties(cell->params);
+            put_properties(cell->attrs);
+            put_i32(int(cell->ports.size()));
+            for (auto &port : cell->ports) {
+                put_id(port.first);
+                put_i32(int(port.second.type));
+                put_net(port.second.net);
+            }
+            put_i32(int(cell->pins.size()));
+            for (auto &pin : cell->pins) {
+                put_id(pin.first);
+                put_id(pin.second);
+            }
+            if (cell->bel != BelId()) {
+                put_loc(ctx->getBelLocation(cell->bel));
+            } else {
+                put_i32(-1);
+            }
+            put_i32(int(cell->belStrength));
+            put_cell(cell->constr_parent);
+            put_i32(int(cell->constr_children.size()));
+            for (auto child : cell->constr_children)
+                put_cell(child);
+            put_i32(cell->constr_x);
+            put_i32(cell->constr_y);
+            put_i32(cell->constr_z);
+            out += char(cell->constr_abs_z);
+        }
+
+        for (auto net : nets) {
+            put_id(net->hierpath);
+            put_region(net->region);
+            put_properties(net->attrs);
+            put_port_ref(net->driver);
+            put_i32(int(net->users.size()));
+            for (auto &user : net->users)
+                put_port_ref(user);
+            if (net->clkconstr != nullptr) {
+                out += char(1);
+                put_float(ctx->getDelayNS(net->clkconstr->high.maxDelay()));
+                put_float(ctx->getDelayNS(net->clkconstr->low.maxDelay()));
+                put_float(ctx->getDelayNS(net->clkconstr->period.maxDelay()));
+            } else {
+                out += char(0);
+            }
+            // Routing, as the dense wire index and the position of the driving pip among the wire's uphill pips
+            put_i32(int(net->wires.size()));
+            for (auto &wire : net->wires) {
+                put_i32(ctx->getWireIndex(wire.first));
+                int pip_pos = -1;
+                if (wire.second.pip != PipId()) {
+                    int pos = 0;
+                    for (auto pip : ctx->getPipsUphill(wire.first)) {
+                        if (pip == wire.second.pip) {
+                            pip_pos = pos;
+                            break;
+                        }
+                        pos++;
+                    }
+                    NPNR_ASSERT(pip_pos != -1);
+                }
+                put_i32(pip_pos);
+                put_i32(int(wire.second.strength));
+            }
+        }
+
+        put_i32(int(ctx->ports.size()));
+        for (auto &port : ctx->ports) {
+            put_id(port.first);
+            put_i32(int(port.second.type));
+            put_net(port.second.net);
+        }
+        put_id_map(ctx->net_aliases);
+
+        put_i32(int(ctx->hierarchy.size()));
+        for (auto &hier : ctx->hierarchy) {
+            auto &hc = hier.second;
+            put_id(hier.first);
+            put_id(hc.name);
+            put_id(hc.type);
+            put_id(hc.parent);
+            put_id(hc.fullpath);
+            put_id_map(hc.leaf_cells);
+            put_id_map(hc.nets);
+            put_id_map(hc.leaf_cells_by_gname);
+            put_id_map(hc.nets_by_gname);
+            put_id_map(hc.hier_cells);
+            put_i32(int(hc.ports.size()));
+            for (auto &port : hc.ports) {
+                put_id(port.first);
+                put_id(port.second.name);
+                put_i32(int(port.second.dir));
+                put_i32(int(port.second.nets.size()));
+                for (auto net : port.second.nets)
+                    put_id(net);
+                put_i32(port.second.offset);
+                out += char(port.second.upto);
+            }
+        }
+    }
+};
+
+struct CheckpointFormatError
+{
+};
+
+class CheckpointReader
+{
+  public:
+    CheckpointReader(const char *data, size_t size) : data(data), size(size) {}
+
+    void read_settings(std::unordered_map<std::string, Property> &settings)
+    {
+        if (get_u32() != checkpoint_magic || get_u32() != checkpoint_version)
+            throw CheckpointFormatError();
+        int count = get_count();
+        for (int i = 0; i < count; i++) {
+            std::string key = get_string();
+            settings[key] = get_plain_property();
+        }
+    }
+
+    void read_design(Context *ctx)
+    {
+        this->ctx = ctx;
+        std::unordered_map<std::string, Property> settings;
+        read_settings(settings);
+        for (auto &setting : settings)
+            ctx->settings[ctx->id(setting.first)] = setting.second;
+
+        std::string arch = get_string(), device = get_string();
+        int wire_count = get_i32();
+        if (arch != ctx->archId().str(ctx) || device != ctx->archArgsToId(ctx->archArgs()).str(ctx) ||
+            wire_count != ctx->getWireIndexCount())
+            log_error("Checkpoint was saved for %s device '%s', not %s device '%s'.\n", arch.c_str(), device.c_str(),
+                      ctx->archId().c_str(ctx), ctx->archArgsToId(ctx->archArgs()).c_str(ctx));
+
+        int num_strings = get_count();
+        ids.reserve(num_strings);
+        for (int i = 0; i < num_strings; i++) {
+            int len = get_count();
+            ids.push_back(ctx->id(std::string(get_bytes(len), len)));
+        }
+        read_netlist();
+    }
+
+  private:
+    const char *data;
+    size_t size;
+    size_t cursor = 0;
+    Context *ctx = nullptr;
+    std::vector<IdString> ids;
+    std::vector<CellInfo *> cells;
+    std::vector<NetInfo *> nets;
+    std::vector<Region *> regions;
+    // Wires by index, filled the first time one is needed
+    std::vector<WireId> wire_by_index;
+
+    const char *get_bytes(size_t len)
+    {
+        if (len > size - cursor)
+            throw CheckpointFormatError();
+        const char *ptr = data + cursor;
+        cursor += len;
+        return ptr;
+    }
+
+    template <typename T> T get_value()
+    {
+        T value;
+        memcpy(&value, get_bytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    uint32_t get_u32() { return get_value<uint32_t>(); }
+    int32_t get_i32() { return get_value<int32_t>(); }
+    float get_float() { return get_value<float>(); }
+    bool get_bool() { return get_value<char>() != 0; }
+
+    int get_count()
+    {
+        int count = get_i32();
+        if (count < 0)
+            throw CheckpointFormatError();
+        return count;
+    }
+
+    std::string get_string()
+    {
+        int len = get_count();
+        return std::string(get_bytes(len), len);
+    }
+
+    IdString get_id() { return get_indexed(ids, get_i32()); }
+
+    template <typename T> T get_indexed(const std::vector<T> &items, int index)
+    {
+        if (index < 0 || index >= int(items.size()))
+            throw CheckpointFormatError();
+        return items.at(index);
+    }
+
+    CellInfo *get_cell()
+    {
+        int index = get_i32();
+        return index == -1 ? nullptr : get_indexed(cells, index);
+    }
+
+    NetInfo *get_net()
+    {
+        int index = get_i32();
+        return index == -1 ? nullptr : get_indexed(nets, index);
+    }
+
+    Region *get_region()
+    {
+        int index = get_i32();
+        return index == -1 ? nullptr : get_indexed(regions, index);
+    }
+
+    Loc get_loc()
+    {
+        Loc loc;
+        loc.x = get_i32();
+        loc.y = get_i32();
+        loc.z = get_i32();
+        return loc;
+    }
+
+    BelId get_bel_at(Loc loc)
+    {
+        BelId bel = ctx->getBelByLocation(loc);
+        if (bel == BelId())
+            throw CheckpointFormatError();
+        return bel;
+    }
+
+    WireId get_wire()
+    {
+        if (wire_by_index.empty()) {
+            wire_by_index.resize(ctx->getWireIndexCount());
+            for (auto wire : ctx->getWires())
+                wire_by_index.at(ctx->getWireIndex(wire)) = wire;
+        }
+        WireId wire = get_indexed(wire_by_index, get_i32());
+        if (wire == WireId())
+            throw CheckpointFormatError();
+        return wire;
+    }
+
+    void get_id_map(std::unordered_map<IdString, IdString> &map)
+    {
+        int count = get_count();
+        for (int i = 0; i < count; i++) {
+            IdString key = get_id();
+            map[key] = get_id();
+        }
+    }
+
+    static Property make_property(bool is_string, std::string str)
+    {
+        Property prop;
+        prop.is_string = is_string;
+        prop.str = std::move(str);
+        if (!is_string)
+            prop.update_intval();
+        return prop;
+    }
+
+    Property get_plain_property()
+    {
+        bool is_string = get_bool();
+        return make_property(is_string, get_string());
+    }
+
+    Property get_property()
+    {
+        bool is_string = get_bool();
+        return make_property(is_string, is_string ? get_id().str(ctx) : get_string());
+    }
+
+    void get_properties(std::unordered_map<IdString, Property> &props)
+    {
+        int count = get_count();
+        for (int i = 0; i < count; i++) {
+            IdString key = get_id();
+            props[key] = get_property();
+        }
+    }
+
+    PortType get_port_type()
+    {
+        int type = get_i32();
+        if (type != PORT_IN && type != PORT_OUT && type != PORT_INOUT)
+            throw CheckpointFormatError();
+        return PortType(type);
+    }
+
+    PlaceStrength get_strength()
+    {
+        int strength = get_i32();
+        if (strength < STRENGTH_NONE || strength > STRENGTH_USER)
+            throw CheckpointFormatError();
+        return PlaceStrength(strength);
+    }
+
+    void get_port_ref(PortRef &ref)
+    {
+        ref.cell = get_cell();
+        ref.port = get_id();
+        ref.budget = ctx->getDelayFromNS(get_float()).maxDelay();
+    }
+
+    void read_netlist()
+    {
+        get_properties(ctx->attrs);
+        int num_cells = get_count();
+        for (int i = 0; i < num_cells; i++) {
+            IdString name = get_id();
+            IdString type = get_id();
+            if (ctx->cells.count(name))
+                throw CheckpointFormatError();
+            CellInfo *cell = ctx->createCell(name, type);
+            cells.push_back(cell);
+        }
+        int num_nets = get_count();
+        for (int i = 0; i < num_nets; i++) {
+            IdString name = get_id();
+            if (ctx->nets.count(name))
+                throw CheckpointFormatError();
+            nets.push_back(ctx->createNet(name));
+        }
+
+        int num_regions = get_count();
+        for (int i = 0; i < num_regions; i++) {
+            IdString name = get_id();
+            if (ctx->region.count(name))
+                throw CheckpointFormatError();
+            Region *r = new Region();
+            ctx->region[name].reset(r);
+            regions.push_back(r);
+            r->name = name;
+            r->constr_bels = get_bool();
+            r->constr_wires = get_bool();
+            r->constr_pips = get_bool();
+            int num_bels = get_count();
+            for (int j = 0; j < num_bels; j++)
+                r->bels.insert(get_bel_at(get_loc()));
+            int num_wires = get_count();
+            for (int j = 0; j < num_wires; j++)
+                r->wires.insert(get_wire());
+            int num_piplocs = get_count();
+            for (int j = 0; j < num_piplocs; j++)
+                r->piplocs.insert(get_loc());
+        }
+
+        for (auto cell : cells) {
+            cell->hierpath = get_id();
+            cell->region = get_region();
+            get_properties(cell->params);
+            get_properties(cell->attrs);
+            int num_ports = get_count();
+            for (int i = 0; i < num_ports; i++) {
+                IdString port = get_id();
+                auto &pi = cell->ports[port];
+                pi.name = port;
+                pi.type = get_port_type();
+                pi.net = get_net();
+            }
+            int num_pins = get_count();
+            for (int i = 0; i < num_pins; i++) {
+                IdString pin = get_id();
+                cell->pins[pin] = get_id();
+            }
+            int x = get_i32();
+            if (x != -1) {
+                int y = get_i32(), z = get_i32();
+                BelId bel = get_bel_at(Loc(x, y, z));
+                PlaceStrength strength = get_strength();
+                ctx->bindBel(bel, cell, strength);
+            } else {
+                cell->belStrength = get_strength();
+            }
+            cell->constr_parent = get_cell();
+            int num_children = get_count();
+            for (int i = 0; i < num_children; i++)
+                cell->constr_children.push_back(get_cell());
+            cell->constr_x = get_i32();
+            cell->constr_y = get_i32();
+            cell->constr_z = get_i32();
+            cell->constr_abs_z = get_bool();
+        }
+
+        for (auto net : nets) {
+            net->hierpath = get_id();
+            net->region = get_region();
+            get_properties(net->attrs);
+            get_port_ref(net->driver);
+            int num_users = get_count();
+            net->users.resize(num_users);
+            for (auto &user : net->users)
+                get_port_ref(user);
+            if (get_bool()) {
+                net->clkconstr = std::unique_ptr<ClockConstraint>(new ClockConstraint());
+                net->clkconstr->high = ctx->getDelayFromNS(get_float());
+                net->clkconstr->low = ctx->getDelayFromNS(get_float());
+                net->clkconstr->period = ctx->getDelayFromNS(get_float());
+            }
+            int num_wires = get_count();
+            for (int i = 0; i < num_wires; i++) {
+                WireId wire = get_wire();
+                int pip_pos = get_i32();
+                PlaceStrength strength = get_strength();
+                if (pip_pos == -1) {
+                    ctx->bindWire(wire, net, strength);
+                    continue;
+                }
+                PipId pip;
+                for (auto uphill : ctx->getPipsUphill(wire)) {
+                    if (pip_pos-- == 0) {
+                        pip = uphill;
+                        break;
+                    }
+                }
+                if (pip == PipId())
+                    throw CheckpointFormatError();
+                ctx->bindPip(pip, net, strength);
+            }
+        }
+
+        int num_ports = get_count();
+        for (int i = 0; i < num_ports; i++) {
+            IdString port = get_id();
+            auto &pi = ctx->ports[port];
+            pi.name = port;
+            pi.type = get_port_type();
+            pi.net = get_net();
+        }
+        get_id_map(ctx->net_aliases);
+        for (auto &alias : ctx->net_aliases)
+            if (ctx->nets.count(alias.second))
+                ctx->nets.at(alias.second)->aliases.push_back(alias.first);
+
+        int num_hier = get_count();
+        for (int i = 0; i < num_hier; i++) {
+            auto &hc = ctx->hierarchy[get_id()];
+            hc.name = get_id();
+            hc.type = get_id();
+            hc.parent = get_id();
+            hc.fullpath = get_id();
+            get_id_map(hc.leaf_cells);
+            get_id_map(hc.nets);
+            get_id_map(hc.leaf_cells_by_gname);
+            get_id_map(hc.nets_by_gname);
+            get_id_map(hc.hier_cells);
+            int num_hier_ports = get_count();
+            for (int j = 0; j < num_hier_ports; j++) {
+                auto &port = hc.ports[get_id()];
+                port.name = get_id();
+                port.dir = get_port_type();
+                int num_port_nets = get_count();
+                for (int k = 0; k < num_port_nets; k++)
+                    port.nets.push_back(get_id());
+                port.offset = get_i32();
+                port.upto = get_bool();
+            }
+        }
+        if (cursor != size)
+            throw CheckpointFormatError();
+    }
+};
+
+// Only I/O errors are caught here; errors found while loading, like a device mismatch, are reported by the reader
+void open_checkpoint(boost::iostreams::mapped_file_source &file, const std::string &filename)
+{
+    try {
+        file.open(filename);
+    } catch (std::ios_base::failure &) {
+        log_error("Failed to open checkpoint '%s'.\n", filename.c_str());
+    }
+}
+
+} // namespace
+
+bool write_checkpoint(Context *ctx, const std::string &filename)
+{
+    CheckpointWriter writer(ctx);
+    writer.write_design();
+    if (!write_file_atomic(filename, writer.out.data(), writer.out.size())) {
+        log_error("Failed to write checkpoint '%s'.\n", filename.c_str());
+        return false;
+    }
+    log_info("Saved checkpoint '%s' (%d cells, %d nets).\n", filename.c_str(), int(ctx->cells.size()),
+             int(ctx->nets.size()));
+    return true;
+}
+
+bool read_checkpoint_settings(const std::string &filename, std::unordered_map<std::string, Property> &values)
+{
+    boost::iostreams::mapped_file_source file;
+    open_checkpoint(file, filename);
+    try {
+        CheckpointReader reader(file.data(), file.size());
+        reader.read_settings(values);
+    } catch (CheckpointFormatError &) {
+        log_error("'%s' is not a valid checkpoint.\n", filename.c_str());
+    }
+    return true;
+}
+
+bool read_checkpoint(Context *ctx, const std::string &filename)
+{
+    boost::iostreams::mapped_file_source file;
+    open_checkpoint(file, filename);
+    try {
+        CheckpointReader reader(file.data(), file.size());
+        reader.read_design(ctx);
+    } catch (CheckpointFormatError &) {
+        log_error("'%s' is not a valid checkpoint.\n", filename.c_str());
+    }
+    // As after loading a JSON design, derive the arch-specific cell and net info, which bound cells rely on
+    ctx->assignArchInfo();
+    log_info("Loaded checkpoint '%s' (%d cells, %d nets).\n", filename.c_str(), int(ctx->cells.size()),
+             int(ctx->nets.size()));
+    return true;
+}
+
+NEXTPNR_NAMESPACE_END
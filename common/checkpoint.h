@@ -0,0 +1,43 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <unordered_map>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Binary checkpoints of the design state: settings, the netlist, placement and routing.
+//
+// Every string is stored once in a string table, bels are stored by location, wires by getWireIndex() and pips by
+// their position in getPipsUphill() of their destination wire, so loading never parses an object name. A checkpoint
+// can only be loaded into a context for the same architecture and device as it was saved from.
+
+bool write_checkpoint(Context *ctx, const std::string &filename);
+
+// Read only the settings, which are needed to create the context for the device the checkpoint was saved from
+bool read_checkpoint_settings(const std::string &filename, std::unordered_map<std::string, Property> &values);
+
+// Load a checkpoint into a context without a design
+bool read_checkpoint(Context *ctx, const std::string &filename);
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -33,12 +33,16 @@
 #include <boost/program_options.hpp>
 #include <fstream>
 #include <iostream>
+#include "bench.h"
+#include "checkpoint.h"
 #include "command.h"
 #include "design_utils.h"
+#include "eco.h"
 #include "json_frontend.h"
 #include "jsonwrite.h"
 #include "log.h"
 #include "timing.h"
+#include "trace.h"
 #include "util.h"
 #include "version.h"
 
@@ -122,7 +126,20 @@ po::options_description CommandHandler::getGeneralOptions()
 
 #endif
     general.add_options()("json", po::value<std::string>(), "JSON design file to ingest");
+    general.add_options()("frontend-threads", po::value<int>(), "number of threads for decoding the JSON design");
     general.add_options()("write", po::value<std::string>(), "JSON design file to write");
+    general.add_options()("load-checkpoint", po::value<std::string>(),
+                          "binary checkpoint to resume from, instead of a JSON design");
+    general.add_options()("save-checkpoint", po::value<std::string>(), "binary checkpoint to write after the flow");
+    general.add_options()("eco", po::value<std::string>(),
+                          "checkpoint of a previous run, whose placement and routing is kept for the unchanged parts "
+                          "of the --json design");
+    general.add_options()("bench", po::value<std::string>(),
+                          "run the flow as a benchmark and write per-stage metrics as JSON to this file");
+    general.add_options()("bench-corpus", po::value<std::vector<std::string>>(),
+                          "JSON designs to benchmark in turn, each in a fresh context (with --bench)");
+    general.add_options()("trace", po::value<std::string>(),
+                          "write a Chrome trace-event JSON file of where the flow spends its time");
     general.add_options()("top", po::value<std::string>(), "name of top module");
     general.add_options()("seed", po::value<int>(), "seed value for random number generator");
     general.add_options()("randomize-seed,r", "randomize seed value for random number generator");
@@ -139,9 +156,12 @@ po::options_description CommandHandler::getGeneralOptions()
                         "; default: " + Arch::defaultRouter)
                     .c_str());
 
+    general.add_options()("router2-bidir", "route arcs with bidirectional A* search in router2");
+
     general.add_options()("slack_redist_iter", po::value<int>(), "number of iterations between slack redistribution");
     general.add_options()("cstrweight", po::value<float>(), "placer weighting for relative constraint satisfaction");
     general.add_options()("starttemp", po::value<float>(), "placer SA start temperature");
+    general.add_options()("placer-threads", po::value<int>(), "number of threads for SA placement");
     general.add_options()("placer-budgets", "use budget rather than criticality in placer timing weights");
 
     general.add_options()("pack-only", "pack design only without placement or routing");
@@ -245,10 +265,19 @@ void CommandHandler::setupContext(Context *ctx)
     if (vm.count("starttemp")) {
         ctx->settings[ctx->id("placer1/startTemp")] = std::to_string(vm["starttemp"].as<float>());
     }
+    if (vm.count("placer-threads")) {
+        ctx->settings[ctx->id("placer1/threads")] = std::to_string(vm["placer-threads"].as<int>());
+    }
+    if (vm.count("frontend-threads")) {
+        ctx->settings[ctx->id("frontend/threads")] = std::to_string(vm["frontend-threads"].as<int>());
+    }
 
     if (vm.count("placer-budgets")) {
         ctx->settings[ctx->id("placer1/budgetBased")] = true;
     }
+    if (vm.count("router2-bidir")) {
+        ctx->settings[ctx->id("router2/bidirectional")] = true;
+    }
     if (vm.count("freq")) {
         auto freq = vm["freq"].as<double>();
         if (freq > 0)
@@ -295,8 +324,7 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         try {
             if (vm.count("json")) {
                 std::string filename = vm["json"].as<std::string>();
-                std::ifstream f(filename);
-                if (!parse_json(f, filename, w.getContext()))
+                if (!parse_json_file(filename, w.getContext()))
                     log_error("Loading design failed.\n");
                 customAfterLoad(w.getContext());
                 w.notifyChangeContext();
@@ -311,10 +339,14 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         return a.exec();
     }
 #endif
+    conflicting_options(vm, "json", "load-checkpoint");
+    conflicting_options(vm, "eco", "load-checkpoint");
+    if (vm.count("eco") && !vm.count("json"))
+        log_error("ECO mode needs the changed design, given by --json.\n");
     if (vm.count("json")) {
+        NPNR_TRACE_SCOPE("load");
         std::string filename = vm["json"].as<std::string>();
-        std::ifstream f(filename);
-        if (!parse_json(f, filename, ctx.get()))
+        if (!parse_json_file(filename, ctx.get()))
             log_error("Loading design failed.\n");
 
         customAfterLoad(ctx.get());
@@ -323,7 +355,20 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
 #ifndef NO_PYTHON
     init_python(argv[0], true);
     python_export_global("ctx", *ctx);
+#endif
+
+    // A checkpoint already contains the arch-specific changes made after loading, so customAfterLoad is skipped.
+    // It is loaded after the pre-pack scripts, as for some archs (generic) these build the device itself; they are
+    // not run again if the checkpoint still has to be packed.
+    bool from_checkpoint = vm.count("load-checkpoint") != 0;
+    if (from_checkpoint) {
+        NPNR_TRACE_SCOPE("load");
+        run_script_hook("pre-pack");
+        if (!read_checkpoint(ctx.get(), vm["load-checkpoint"].as<std::string>()))
+            log_error("Loading checkpoint failed.\n");
+    }
 
+#ifndef NO_PYTHON
     if (vm.count("run")) {
 
         std::vector<std::string> files = vm["run"].as<std::vector<std::string>>();
@@ -331,13 +376,22 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
             execute_python_file(filename.c_str());
     } else
 #endif
-            if (vm.count("json")) {
+            if (vm.count("json") || from_checkpoint) {
         bool do_pack = vm.count("pack-only") != 0 || vm.count("no-pack") == 0;
         bool do_place = vm.count("pack-only") == 0 && vm.count("no-place") == 0;
         bool do_route = vm.count("pack-only") == 0 && vm.count("no-route") == 0;
+        // Resume a checkpoint after the last stage it had completed
+        if (from_checkpoint) {
+            auto done = [&](const char *stage) { return ctx->settings.count(ctx->id(stage)) != 0; };
+            do_pack = do_pack && !done("pack");
+            do_place = do_place && !done("place");
+            do_route = do_route && !done("route");
+        }
 
         if (do_pack) {
-            run_script_hook("pre-pack");
+            NPNR_TRACE_SCOPE("pack");
+            if (!from_checkpoint)
+                run_script_hook("pre-pack");
             if (!ctx->pack() && !ctx->force)
                 log_error("Packing design failed.\n");
         }
@@ -345,7 +399,39 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         ctx->check();
         print_utilisation(ctx.get());
 
+        EcoStats eco_stats;
+        if (vm.count("eco")) {
+            NPNR_TRACE_SCOPE("eco");
+            std::string filename = vm["eco"].as<std::string>();
+            std::unordered_map<std::string, Property> values;
+            if (!read_checkpoint_settings(filename, values))
+                log_error("Loading ECO checkpoint failed.\n");
+            std::unique_ptr<Context> old_ctx = createContext(values);
+            // As for --load-checkpoint, the pre-pack scripts may build the device the checkpoint refers to
+#ifndef NO_PYTHON
+            python_export_global("ctx", *old_ctx);
+#endif
+            run_script_hook("pre-pack");
+#ifndef NO_PYTHON
+            python_export_global("ctx", *ctx);
+#endif
+            if (!read_checkpoint(old_ctx.get(), filename))
+                log_error("Loading ECO checkpoint failed.\n");
+            eco_stats = eco_reuse(ctx.get(), old_ctx.get());
+            // Only simulated annealing places around cells that are already placed; HeAP would start over
+            if (str_or_default(ctx->settings, ctx->id("placer"), "") != "sa") {
+                log_info("ECO: using the sa placer for the changed cells.\n");
+                ctx->settings[ctx->id("placer")] = std::string("sa");
+            }
+            if (do_place && eco_stats.new_cells == 0) {
+                // Nothing to place, but the design is placed all the same
+                ctx->settings[ctx->id("place")] = 1;
+                do_place = false;
+            }
+        }
+
         if (do_place) {
+            NPNR_TRACE_SCOPE("place");
             run_script_hook("pre-place");
             if (!ctx->place() && !ctx->force)
                 log_error("Placing design failed.\n");
@@ -353,8 +439,11 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
             if (vm.count("placed-svg"))
                 ctx->writeSVG(vm["placed-svg"].as<std::string>(), "scale=50 hide_routing");
         }
+        if (vm.count("eco"))
+            eco_finish(ctx.get(), eco_stats);
 
         if (do_route) {
+            NPNR_TRACE_SCOPE("route");
             run_script_hook("pre-route");
             if (!ctx->route() && !ctx->force)
                 log_error("Routing design failed.\n");
@@ -363,16 +452,26 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
                 ctx->writeSVG(vm["routed-svg"].as<std::string>(), "scale=500");
         }
 
-        customBitstream(ctx.get());
+        {
+            NPNR_TRACE_SCOPE("bitstream");
+            customBitstream(ctx.get());
+        }
     }
 
     if (vm.count("write")) {
+        NPNR_TRACE_SCOPE("write");
         std::string filename = vm["write"].as<std::string>();
         std::ofstream f(filename);
         if (!write_json_file(f, filename, ctx.get()))
             log_error("Saving design failed.\n");
     }
 
+    if (vm.count("save-checkpoint")) {
+        NPNR_TRACE_SCOPE("write");
+        if (!write_checkpoint(ctx.get(), vm["save-checkpoint"].as<std::string>()))
+            log_error("Saving checkpoint failed.\n");
+    }
+
     if (vm.count("sdf")) {
         std::string filename = vm["sdf"].as<std::string>();
         std::ofstream f(filename);
@@ -397,6 +496,12 @@ void CommandHandler::conflicting_options(const boost::program_options::variables
     }
 }
 
+void CommandHandler::writeTrace()
+{
+    if (vm.count("trace") && !trace_write(vm["trace"].as<std::string>()))
+        log_warning("Failed to write trace file '%s'.\n", vm["trace"].as<std::string>().c_str());
+}
+
 void CommandHandler::printFooter()
 {
     int warning_count = get_or_default(message_count_by_level, LogLevel::WARNING_MSG, 0),
@@ -415,30 +520,156 @@ int CommandHandler::exec()
         if (executeBeforeContext())
             return 0;
 
+        if (vm.count("trace"))
+            trace_start();
+
+        if (vm.count("bench")) {
+            int rc = executeBenchmark();
+            writeTrace();
+            printFooter();
+            return rc;
+        }
+
         std::unordered_map<std::string, Property> values;
-        std::unique_ptr<Context> ctx = createContext(values);
-        setupContext(ctx.get());
-        setupArchContext(ctx.get());
+        // The device to create is recorded in the checkpoint's settings
+        if (vm.count("load-checkpoint") && !read_checkpoint_settings(vm["load-checkpoint"].as<std::string>(), values))
+            log_error("Loading checkpoint failed.\n");
+        if (vm.count("eco") && !read_checkpoint_settings(vm["eco"].as<std::string>(), values))
+            log_error("Loading ECO checkpoint failed.\n");
+        std::unique_ptr<Context> ctx;
+        {
+            NPNR_TRACE_SCOPE("create context");
+            ctx = createContext(values);
+            setupContext(ctx.get());
+            setupArchContext(ctx.get());
+        }
         int rc = executeMain(std::move(ctx));
+        writeTrace();
         printFooter();
         return rc;
     } catch (log_execution_error_exception) {
+        // A trace is most useful to find out where a failing run spent its time
+        writeTrace();
         printFooter();
         return -1;
     }
 }
 
+int CommandHandler::executeBenchmark()
+{
+    conflicting_options(vm, "bench", "load-checkpoint");
+    conflicting_options(vm, "bench", "randomize-seed");
+    std::vector<std::string> designs;
+    if (vm.count("json"))
+        designs.push_back(vm["json"].as<std::string>());
+    if (vm.count("bench-corpus")) {
+        auto corpus = vm["bench-corpus"].as<std::vector<std::string>>();
+        designs.insert(designs.end(), corpus.begin(), corpus.end());
+    }
+    if (designs.empty())
+        log_error("Benchmarking needs a design, given by --json or --bench-corpus.\n");
+
+    bool do_pack = vm.count("pack-only") != 0 || vm.count("no-pack") == 0;
+    bool do_place = vm.count("pack-only") == 0 && vm.count("no-place") == 0;
+    bool do_route = vm.count("pack-only") == 0 && vm.count("no-route") == 0;
+
+    // Every design gets the same fixed seed and a context of its own, so that runs are reproducible and
+    // independent of the order of the corpus
+    std::vector<BenchDesign> results;
+    bool all_ok = true;
+#ifndef NO_PYTHON
+    init_python(argv[0], true);
+#endif
+    for (auto &filename : designs) {
+        log_break();
+        log_info("Benchmarking '%s'...\n", filename.c_str());
+        std::unordered_map<std::string, Property> values;
+        std::unique_ptr<Context> ctx = createContext(values);
+        setupContext(ctx.get());
+        setupArchContext(ctx.get());
+        if (vm.count("top"))
+            ctx->settings[ctx->id("frontend/top")] = vm["top"].as<std::string>();
+
+        results.emplace_back();
+        BenchDesign &bd = results.back();
+        bd.name = filename;
+        bd.arch = ctx->archId().str(ctx.get());
+        bd.seed = ctx->rngstate;
+#ifndef NO_PYTHON
+        python_export_global("ctx", *ctx);
+#endif
+
+        bool ok = true;
+        // A failing stage ends this design's flow, but not the benchmark. As in executeMain, the script hooks run as
+        // part of their stage; on generic the pre-pack scripts build the device itself.
+        auto run_stage = [&](const char *name, std::function<bool()> func) {
+            if (!ok)
+                return;
+            TraceScope scope(name);
+            BenchTimer timer(ctx.get());
+            bool stage_ok = false;
+            try {
+                stage_ok = func();
+            } catch (log_execution_error_exception) {
+                stage_ok = false;
+            }
+            bd.stages.push_back(timer.finish(ctx.get(), name, stage_ok));
+            ok = stage_ok;
+        };
+        run_stage("load", [&]() {
+            if (!parse_json_file(filename, ctx.get()))
+                return false;
+            customAfterLoad(ctx.get());
+            return true;
+        });
+        if (do_pack)
+            run_stage("pack", [&]() {
+                run_script_hook("pre-pack");
+                if (!ctx->pack())
+                    return false;
+                assign_budget(ctx.get(), true);
+                ctx->check();
+                return true;
+            });
+        if (do_place)
+            run_stage("place", [&]() {
+                run_script_hook("pre-place");
+                return ctx->place();
+            });
+        if (do_route)
+            run_stage("route", [&]() {
+                run_script_hook("pre-route");
+                return ctx->route();
+            });
+        // Timing is only analysed once the flow is done; if that fails, the slack is left out
+        if (ok && (do_place || do_route)) {
+            try {
+                add_timing_qor(ctx.get(), bd.stages.back());
+            } catch (log_execution_error_exception) {
+            }
+        }
+        all_ok = all_ok && ok;
+    }
+#ifndef NO_PYTHON
+    deinit_python();
+#endif
+
+    std::string filename = vm["bench"].as<std::string>();
+    std::ofstream f(filename);
+    if (!f)
+        log_error("Failed to open benchmark file '%s' for writing.\n", filename.c_str());
+    write_bench_json(f, results);
+    return all_ok ? 0 : 1;
+}
+
 std::unique_ptr<Context> CommandHandler::load_json(std::string filename)
 {
     std::unordered_map<std::string, Property> values;
     std::unique_ptr<Context> ctx = createContext(values);
     setupContext(ctx.get());
     setupArchContext(ctx.get());
-    {
-        std::ifstream f(filename);
-        if (!parse_json(f, filename, ctx.get()))
-            log_error("Loading design failed.\n");
-    }
+    if (!parse_json_file(filename, ctx.get()))
+        log_error("Loading design failed.\n");
     customAfterLoad(ctx.get());
     return ctx;
 }
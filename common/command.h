@@ -54,9 +54,11 @@ class CommandHandler
     bool executeBeforeContext();
     void setupContext(Context *ctx);
     int executeMain(std::unique_ptr<Context> ctx);
+    int executeBenchmark();
     po::options_description getGeneralOptions();
     void run_script_hook(const std::string &name);
     void printFooter();
+    void writeTrace();
 
   protected:
     po::variables_map vm;
@@ -0,0 +1,59 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "diskcache.h"
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <fstream>
+
+NEXTPNR_NAMESPACE_BEGIN
+
+std::string get_cache_path(const std::string &name)
+{
+    boost::filesystem::path cache_dir;
+    if (getenv("XDG_CACHE_HOME") != nullptr)
+        cache_dir = getenv("XDG_CACHE_HOME");
+    else if (getenv("HOME") != nullptr)
+        cache_dir = boost::filesystem::path(getenv("HOME")) / ".cache";
+    else
+        cache_dir = boost::filesystem::temp_directory_path();
+    return (cache_dir / "nextpnr" / name).string();
+}
+
+bool write_file_atomic(const std::string &filename, const char *data, size_t size)
+{
+    try {
+        boost::filesystem::path path(filename);
+        if (path.has_parent_path())
+            boost::filesystem::create_directories(path.parent_path());
+        boost::filesystem::path tmp = path;
+        tmp += boost::filesystem::unique_path(".%%%%-%%%%-%%%%.tmp");
+        std::ofstream out(tmp.string(), std::ios::binary);
+        out.write(data, size);
+        out.close();
+        if (out.fail()) {
+            boost::filesystem::remove(tmp);
+            return false;
+        }
+        boost::filesystem::rename(tmp, path);
+        return true;
+    } catch (boost::filesystem::filesystem_error &) {
+        return false;
+    }
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,271 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "eco.h"
+#include <algorithm>
+#include "log.h"
+#include "util.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+struct EcoMatcher
+{
+    Context *ctx;
+    const Context *old_ctx;
+    // Each context has its own string pool, so names are compared as strings
+    IdString to_old(IdString id) const { return old_ctx->id(id.str(ctx)); }
+
+    // Bel, wire and pip IDs only mean something in their own context; on generic they are IdStrings, which is also why
+    // these are not overloads. They are translated as the checkpoint reader does: bels by location, wires by their
+    // dense index and pips by their position among the uphill pips of their destination wire.
+    std::vector<WireId> wire_by_index;
+
+    BelId new_bel(BelId old_bel) const { return ctx->getBelByLocation(old_ctx->getBelLocation(old_bel)); }
+
+    WireId new_wire(WireId old_wire)
+    {
+        if (wire_by_index.empty()) {
+            wire_by_index.resize(ctx->getWireIndexCount());
+            for (auto wire : ctx->getWires())
+                wire_by_index.at(ctx->getWireIndex(wire)) = wire;
+        }
+        int index = old_ctx->getWireIndex(old_wire);
+        return index < int(wire_by_index.size()) ? wire_by_index.at(index) : WireId();
+    }
+
+    PipId new_pip(PipId old_pip, WireId old_dst, WireId dst) const
+    {
+        int pos = 0;
+        for (auto pip : old_ctx->getPipsUphill(old_dst)) {
+            if (pip == old_pip)
+                break;
+            pos++;
+        }
+        for (auto pip : ctx->getPipsUphill(dst))
+            if (pos-- == 0)
+                return pip;
+        return PipId();
+    }
+
+    std::unordered_set<IdString> kept_cells;
+    // Cells bound here rather than by the packer, with their strength in the previous run
+    std::unordered_map<IdString, PlaceStrength> bound_cells;
+
+    const CellInfo *find_old_cell(const CellInfo *ci) const
+    {
+        auto fnd = old_ctx->cells.find(to_old(ci->name));
+        return fnd == old_ctx->cells.end() ? nullptr : fnd->second.get();
+    }
+
+    const NetInfo *find_old_net(const NetInfo *ni) const
+    {
+        auto fnd = old_ctx->nets.find(to_old(ni->name));
+        return fnd == old_ctx->nets.end() ? nullptr : fnd->second.get();
+    }
+
+    bool same_ref(const PortRef &a, const PortRef &old) const
+    {
+        if (a.cell == nullptr || old.cell == nullptr)
+            return a.cell == old.cell;
+        return to_old(a.cell->name) == old.cell->name && to_old(a.port) == old.port;
+    }
+
+    bool unchanged_cell(const CellInfo *ci, const CellInfo *old) const
+    {
+        if (to_old(ci->type) != old->type)
+            return false;
+        if (ci->params.size() != old->params.size() || ci->ports.size() != old->ports.size())
+            return false;
+        for (auto &param : ci->params) {
+            auto fnd = old->params.find(to_old(param.first));
+            if (fnd == old->params.end() || !(fnd->second == param.second))
+                return false;
+        }
+        for (auto &port : ci->ports) {
+            auto fnd = old->ports.find(to_old(port.first));
+            if (fnd == old->ports.end() || fnd->second.type != port.second.type)
+                return false;
+            const NetInfo *net = port.second.net, *old_net = fnd->second.net;
+            if ((net == nullptr) != (old_net == nullptr))
+                return false;
+            if (net != nullptr && to_old(net->name) != old_net->name)
+                return false;
+        }
+        return true;
+    }
+
+    bool keep_cell(CellInfo *ci)
+    {
+        const CellInfo *old = find_old_cell(ci);
+        if (old == nullptr || old->bel == BelId() || !unchanged_cell(ci, old))
+            return false;
+        BelId bel = new_bel(old->bel);
+        if (bel == BelId())
+            return false;
+        // Cells placed by the packer can be reused as they are, if they ended up in the same place
+        if (ci->bel != BelId()) {
+            if (ci->bel != bel)
+                return false;
+            kept_cells.insert(ci->name);
+            return true;
+        }
+        if (ctx->getBelType(bel) != ci->type || !ctx->checkBelAvail(bel))
+            return false;
+        ctx->bindBel(bel, ci, std::max(old->belStrength, STRENGTH_STRONG));
+        if (!ctx->isBelLocationValid(bel)) {
+            ctx->unbindBel(bel);
+            return false;
+        }
+        kept_cells.insert(ci->name);
+        bound_cells[ci->name] = old->belStrength;
+        return true;
+    }
+
+    void release_cell(CellInfo *ci)
+    {
+        kept_cells.erase(ci->name);
+        if (bound_cells.erase(ci->name))
+            ctx->unbindBel(ci->bel);
+    }
+
+    // A constraint chain is kept or released as a whole, so that no kept cell is locked in place while its parent
+    // or children move
+    bool keep_chain(const std::vector<CellInfo *> &chain)
+    {
+        size_t n = 0;
+        while (n < chain.size() && keep_cell(chain.at(n)))
+            ++n;
+        if (n == chain.size())
+            return true;
+        for (size_t i = 0; i < n; i++)
+            release_cell(chain.at(i));
+        return false;
+    }
+
+    bool unchanged_net(const NetInfo *ni, const NetInfo *old) const
+    {
+        if (ni->driver.cell == nullptr || !same_ref(ni->driver, old->driver))
+            return false;
+        if (!kept_cells.count(ni->driver.cell->name) || ni->users.size() != old->users.size())
+            return false;
+        // Users are matched in order; a reordering only loses the reuse of this net
+        for (size_t i = 0; i < ni->users.size(); i++) {
+            if (!same_ref(ni->users.at(i), old->users.at(i)) || !kept_cells.count(ni->users.at(i).cell->name))
+                return false;
+        }
+        return true;
+    }
+
+    bool keep_net(NetInfo *ni)
+    {
+        const NetInfo *old = find_old_net(ni);
+        if (old == nullptr || old->wires.empty() || !unchanged_net(ni, old))
+            return false;
+        // All or nothing, so that a net is never left partially routed
+        std::vector<std::pair<WireId, PipMap>> wires;
+        for (auto &wire : old->wires) {
+            WireId wire_id = new_wire(wire.first);
+            if (wire_id == WireId() || !ctx->checkWireAvail(wire_id))
+                return false;
+            PipMap pm = wire.second;
+            if (pm.pip != PipId()) {
+                pm.pip = new_pip(pm.pip, wire.first, wire_id);
+                if (pm.pip == PipId() || !ctx->checkPipAvail(pm.pip))
+                    return false;
+            }
+            wires.emplace_back(wire_id, pm);
+        }
+        for (auto &wire : wires) {
+            PlaceStrength strength = std::max(wire.second.strength, STRENGTH_WEAK);
+            if (wire.second.pip == PipId())
+                ctx->bindWire(wire.first, ni, strength);
+            else
+                ctx->bindPip(wire.second.pip, ni, strength);
+        }
+        return true;
+    }
+};
+
+void get_chain(CellInfo *ci, std::vector<CellInfo *> &chain)
+{
+    chain.push_back(ci);
+    for (auto child : ci->constr_children)
+        get_chain(child, chain);
+}
+
+} // namespace
+
+EcoStats eco_reuse(Context *ctx, const Context *old_ctx)
+{
+    if (old_ctx->archId().str(old_ctx) != ctx->archId().str(ctx) ||
+        old_ctx->archArgsToId(old_ctx->archArgs()).str(old_ctx) != ctx->archArgsToId(ctx->archArgs()).str(ctx) ||
+        old_ctx->getWireIndexCount() != ctx->getWireIndexCount())
+        log_error("ECO checkpoint is for a different device.\n");
+
+    EcoMatcher m;
+    m.ctx = ctx;
+    m.old_ctx = old_ctx;
+    EcoStats stats;
+    std::vector<CellInfo *> chain;
+    for (auto cell : sorted(ctx->cells)) {
+        CellInfo *ci = cell.second;
+        // Chains are handled from their root
+        if (ci->constr_parent != nullptr)
+            continue;
+        chain.clear();
+        get_chain(ci, chain);
+        if (m.keep_chain(chain)) {
+            stats.kept_cells += int(chain.size());
+            continue;
+        }
+        for (auto member : chain)
+            if (member->bel == BelId())
+                ++stats.new_cells;
+    }
+    for (auto cell : sorted(ctx->cells)) {
+        auto fnd = m.bound_cells.find(cell.first);
+        if (fnd != m.bound_cells.end())
+            stats.kept_strengths.emplace_back(cell.first, fnd->second);
+    }
+    for (auto net : sorted(ctx->nets)) {
+        NetInfo *ni = net.second;
+        if (!ni->wires.empty())
+            continue;
+        if (m.keep_net(ni))
+            ++stats.kept_nets;
+        else
+            ++stats.new_nets;
+    }
+    log_info("ECO: kept the placement of %d cells (%d to place) and the routing of %d nets (%d to route).\n",
+             stats.kept_cells, stats.new_cells, stats.kept_nets, stats.new_nets);
+    return stats;
+}
+
+void eco_finish(Context *ctx, const EcoStats &stats)
+{
+    for (auto &kept : stats.kept_strengths) {
+        CellInfo *ci = ctx->cells.at(kept.first).get();
+        BelId bel = ci->bel;
+        ctx->unbindBel(bel);
+        ctx->bindBel(bel, ci, kept.second);
+    }
+    ctx->archInfoToAttributes();
+}
+
+NEXTPNR_NAMESPACE_END
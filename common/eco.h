@@ -0,0 +1,47 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef ECO_H
+#define ECO_H
+
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+struct EcoStats
+{
+    int kept_cells = 0, new_cells = 0;
+    int kept_nets = 0, new_nets = 0;
+    // Kept cells that were bound STRENGTH_STRONG for placement, with the strength they had in the previous run
+    std::vector<std::pair<IdString, PlaceStrength>> kept_strengths;
+};
+
+// Incremental (ECO) flow: carry the placement and routing of a previous run over to a changed version of the design.
+//
+// old_ctx holds the previous run, loaded from a checkpoint for the same device; ctx holds the new design, packed but
+// not yet placed. Cells with the same name, type, parameters and connections (by net name) keep their bel, bound
+// STRENGTH_STRONG so that the placer only moves the cells that changed. Nets with the same driver and users, all of
+// them kept, keep their routing, which the routers leave in place as it is already legal. Constraint chains are only
+// kept if all of their cells are.
+EcoStats eco_reuse(Context *ctx, const Context *old_ctx);
+
+// Once placement is done, give the kept cells back the bel strength they had in the previous run.
+void eco_finish(Context *ctx, const EcoStats &stats);
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -3,20 +3,32 @@
 #endif
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
+#include <mutex>
 #include "embed.h"
+#include "log.h"
 #include "nextpnr.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
 #if defined(EXTERNAL_CHIPDB_ROOT)
 
+// The database is mapped read-only and shared (MAP_SHARED on POSIX) rather than copy-on-write, so that it is paged in
+// only as it is used, and all nextpnr processes using the same database share one copy of it in the page cache
 const void *get_chipdb(const std::string &filename)
 {
-    static std::map<std::string, boost::iostreams::mapped_file> files;
+    static std::mutex files_mutex;
+    static std::map<std::string, boost::iostreams::mapped_file_source> files;
+    std::lock_guard<std::mutex> lock(files_mutex);
     if (!files.count(filename)) {
         std::string full_filename = EXTERNAL_CHIPDB_ROOT "/" + filename;
-        if (boost::filesystem::exists(full_filename))
-            files[filename].open(full_filename, boost::iostreams::mapped_file::priv);
+        if (boost::filesystem::exists(full_filename)) {
+            try {
+                files[filename].open(full_filename);
+            } catch (std::exception &) {
+                files.erase(filename);
+                log_error("Failed to map chipdb '%s'.\n", full_filename.c_str());
+            }
+        }
     }
     if (files.count(filename))
         return files.at(filename).data();
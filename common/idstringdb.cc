@@ -0,0 +1,149 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <cstring>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+// FNV-1a
+uint64_t hash_string(const char *s, size_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= uint8_t(s[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+const size_t initial_table_size = 1 << 12;
+} // namespace
+
+IdStringDB::IdStringDB() : count(0), segments(new std::atomic<Entry *>[max_segments])
+{
+    for (int i = 0; i < max_segments; i++)
+        segments[i].store(nullptr, std::memory_order_relaxed);
+    tables.emplace_back(new Table(initial_table_size));
+    table.store(tables.back().get(), std::memory_order_release);
+}
+
+IdStringDB::~IdStringDB()
+{
+    for (int i = 0; i < max_segments; i++)
+        delete[] segments[i].load(std::memory_order_relaxed);
+}
+
+int IdStringDB::find_in(const Table *t, uint64_t hash, const char *s, size_t len) const
+{
+    uint64_t tag = hash >> 32;
+    for (size_t i = hash & t->mask;; i = (i + 1) & t->mask) {
+        uint64_t slot = t->slots[i].load(std::memory_order_acquire);
+        if (slot == 0)
+            return -1;
+        if ((slot >> 32) != tag)
+            continue;
+        int idx = int(slot & 0xffffffffULL) - 1;
+        const Entry &e = entry(idx);
+        if (e.size == len && memcmp(e.data, s, len) == 0)
+            return idx;
+    }
+}
+
+int IdStringDB::find(const char *s, size_t len) const
+{
+    return find_in(table.load(std::memory_order_acquire), hash_string(s, len), s, len);
+}
+
+void IdStringDB::insert_slot(Table *t, uint64_t hash, int idx)
+{
+    size_t i = hash & t->mask;
+    while (t->slots[i].load(std::memory_order_relaxed) != 0)
+        i = (i + 1) & t->mask;
+    t->slots[i].store(((hash >> 32) << 32) | uint64_t(idx + 1), std::memory_order_release);
+}
+
+void IdStringDB::grow()
+{
+    Table *old_table = table.load(std::memory_order_relaxed);
+    Table *new_table = new Table(2 * (old_table->mask + 1));
+    tables.emplace_back(new_table);
+    int n = count.load(std::memory_order_relaxed);
+    for (int idx = 0; idx < n; idx++) {
+        const Entry &e = entry(idx);
+        insert_slot(new_table, hash_string(e.data, e.size), idx);
+    }
+    table.store(new_table, std::memory_order_release);
+}
+
+const char *IdStringDB::store(const char *s, size_t len)
+{
+    char *dst;
+    if (len + 1 > chunk_size) {
+        // Rare enough that the rest of the current chunk can go unused
+        chunks.emplace_back(new char[len + 1]);
+        dst = chunks.back().get();
+        chunk_used = chunk_size;
+    } else {
+        if (chunk_used + len + 1 > chunk_size) {
+            chunks.emplace_back(new char[chunk_size]);
+            chunk_used = 0;
+        }
+        dst = chunks.back().get() + chunk_used;
+        chunk_used += len + 1;
+    }
+    memcpy(dst, s, len);
+    dst[len] = '\0';
+    return dst;
+}
+
+int IdStringDB::intern(const char *s, size_t len)
+{
+    uint64_t hash = hash_string(s, len);
+    int idx = find_in(table.load(std::memory_order_acquire), hash, s, len);
+    if (idx != -1)
+        return idx;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // Another thread may have added it, possibly to a table we had not seen yet
+    Table *t = table.load(std::memory_order_relaxed);
+    idx = find_in(t, hash, s, len);
+    if (idx != -1)
+        return idx;
+
+    idx = count.load(std::memory_order_relaxed);
+    int seg = idx >> segment_bits;
+    NPNR_ASSERT(seg < max_segments);
+    Entry *segment = segments[seg].load(std::memory_order_relaxed);
+    if (segment == nullptr) {
+        segment = new Entry[segment_mask + 1];
+        segments[seg].store(segment, std::memory_order_release);
+    }
+    segment[idx & segment_mask] = Entry{store(s, len), len};
+    count.store(idx + 1, std::memory_order_release);
+
+    // Keep the table at most half full, so that probe sequences stay short
+    if (2 * size_t(idx + 1) > t->mask + 1) {
+        grow();
+    } else {
+        insert_slot(t, hash, idx);
+    }
+    return idx;
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,105 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef NEXTPNR_H
+#error Include "idstringdb.h" via "nextpnr.h" only.
+#endif
+
+#include <atomic>
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// The string table behind IdString.
+//
+// The characters of all strings are packed, NUL-terminated, into arena chunks that never move once allocated.
+// Each index has a (pointer, length) entry in a fixed-size segment, and strings are looked up through an
+// open-addressing hash table of (hash, index) slots. Looking up the string for an index never takes a lock,
+// nor does interning a string that is already known; only adding a new string takes the mutex. This makes
+// IdString safe to create and print from worker threads.
+class IdStringDB
+{
+  public:
+    IdStringDB();
+    ~IdStringDB();
+
+    IdStringDB(const IdStringDB &) = delete;
+    IdStringDB &operator=(const IdStringDB &) = delete;
+
+    // Returns the index of the given string, adding it if it is not yet known
+    int intern(const char *s, size_t len);
+
+    // Returns the index of the given string, or -1 if it is not known
+    int find(const char *s, size_t len) const;
+
+    const char *c_str(int idx) const { return entry(idx).data; }
+
+    std::string str(int idx) const
+    {
+        const Entry &e = entry(idx);
+        return std::string(e.data, e.size);
+    }
+
+    int size() const { return count.load(std::memory_order_acquire); }
+
+  private:
+    static const int segment_bits = 14;
+    static const int segment_mask = (1 << segment_bits) - 1;
+    static const int max_segments = 1 << 14;
+    // Strings longer than this get a chunk of their own
+    static const size_t chunk_size = 1 << 16;
+
+    struct Entry
+    {
+        const char *data;
+        size_t size;
+    };
+
+    const Entry &entry(int idx) const
+    {
+        NPNR_ASSERT(idx >= 0 && idx < size());
+        return segments[idx >> segment_bits].load(std::memory_order_acquire)[idx & segment_mask];
+    }
+
+    // Each slot holds the upper 32 bits of the string hash and the string index plus one; zero is empty
+    struct Table
+    {
+        explicit Table(size_t size) : mask(size - 1), slots(new std::atomic<uint64_t>[size])
+        {
+            for (size_t i = 0; i < size; i++)
+                slots[i].store(0, std::memory_order_relaxed);
+        }
+        size_t mask;
+        std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    };
+
+    int find_in(const Table *table, uint64_t hash, const char *s, size_t len) const;
+    void insert_slot(Table *table, uint64_t hash, int idx);
+    void grow();
+    const char *store(const char *s, size_t len);
+
+    std::atomic<int> count;
+    std::unique_ptr<std::atomic<Entry *>[]> segments;
+    // Only touched with the mutex held; readers go through the entries
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t chunk_used = chunk_size;
+    std::atomic<Table *> table;
+    // Every table ever allocated, as lookups running concurrently with a resize may still be probing an old one
+    std::vector<std::unique_ptr<Table>> tables;
+    std::mutex mutex;
+};
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,236 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef INDEXED_STORE_H
+#define INDEXED_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef NEXTPNR_H
+#error Include "indexed_store.h" via "nextpnr.h" only.
+#endif
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Owning map from name to object that keeps its entries in a dense vector, in insertion order, with a name index
+// on the side. It has the subset of the std::unordered_map interface that is used for ctx->cells and ctx->nets,
+// but iterates in a deterministic order without needing a sorted copy.
+//
+// Erasing an entry leaves a tombstone rather than moving the others, so the index of an entry (see index_of) is
+// stable for as long as the store exists and can be used to key flat arrays, like udata. Tombstones are skipped by
+// iteration and are never reused; they are only reclaimed when the whole store is cleared.
+//
+// generation() changes whenever an entry is added or removed, so that caches built from the store (like the timing
+// graph) can tell they are stale even if the size is unchanged.
+template <typename T> class IndexedStore
+{
+  public:
+    typedef IdString key_type;
+    typedef std::unique_ptr<T> mapped_type;
+    typedef std::pair<const IdString, std::unique_ptr<T>> value_type;
+    typedef std::size_t size_type;
+
+  private:
+    std::vector<value_type> entries;
+    std::vector<bool> alive;
+    std::unordered_map<IdString, int> name_to_index;
+    size_type live_count = 0;
+    uint64_t gen = 0;
+
+    template <typename Store, typename Value> class iterator_base
+    {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Value *pointer;
+        typedef Value &reference;
+
+        iterator_base() : store(nullptr), idx(0) {}
+        iterator_base(Store *store, int idx) : store(store), idx(idx) { skip_dead(); }
+        // Allow iterator -> const_iterator
+        template <typename OtherStore, typename OtherValue>
+        iterator_base(const iterator_base<OtherStore, OtherValue> &other) : store(other.store), idx(other.idx)
+        {
+        }
+
+        reference operator*() const { return store->entries[idx]; }
+        pointer operator->() const { return &store->entries[idx]; }
+        iterator_base &operator++()
+        {
+            ++idx;
+            skip_dead();
+            return *this;
+        }
+        iterator_base operator++(int)
+        {
+            iterator_base prior(*this);
+            ++*this;
+            return prior;
+        }
+        bool operator==(const iterator_base &other) const { return idx == other.idx; }
+        bool operator!=(const iterator_base &other) const { return idx != other.idx; }
+
+      private:
+        template <typename, typename> friend class iterator_base;
+        Store *store;
+        int idx;
+        void skip_dead()
+        {
+            while (idx < int(store->entries.size()) && !store->alive[idx])
+                ++idx;
+        }
+    };
+
+  public:
+    typedef iterator_base<IndexedStore, value_type> iterator;
+    typedef iterator_base<const IndexedStore, const value_type> const_iterator;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, int(entries.size())); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, int(entries.size())); }
+
+    size_type size() const { return live_count; }
+    bool empty() const { return live_count == 0; }
+    size_type count(IdString name) const { return name_to_index.count(name); }
+
+    iterator find(IdString name)
+    {
+        auto fnd = name_to_index.find(name);
+        return fnd == name_to_index.end() ? end() : iterator(this, fnd->second);
+    }
+    const_iterator find(IdString name) const
+    {
+        auto fnd = name_to_index.find(name);
+        return fnd == name_to_index.end() ? end() : const_iterator(this, fnd->second);
+    }
+
+    std::unique_ptr<T> &at(IdString name) { return entries[name_to_index.at(name)].second; }
+    const std::unique_ptr<T> &at(IdString name) const { return entries[name_to_index.at(name)].second; }
+
+    std::unique_ptr<T> &operator[](IdString name)
+    {
+        auto fnd = name_to_index.find(name);
+        if (fnd != name_to_index.end())
+            return entries[fnd->second].second;
+        ++gen;
+        name_to_index.emplace(name, int(entries.size()));
+        entries.emplace_back(name, std::unique_ptr<T>());
+        alive.push_back(true);
+        ++live_count;
+        return entries.back().second;
+    }
+
+    size_type erase(IdString name)
+    {
+        auto fnd = name_to_index.find(name);
+        if (fnd == name_to_index.end())
+            return 0;
+        int idx = fnd->second;
+        ++gen;
+        name_to_index.erase(fnd);
+        entries[idx].second.reset();
+        alive[idx] = false;
+        --live_count;
+        return 1;
+    }
+
+    void clear()
+    {
+        ++gen;
+        entries.clear();
+        alive.clear();
+        name_to_index.clear();
+        live_count = 0;
+    }
+
+    uint64_t generation() const { return gen; }
+
+    // Stable index of a live entry, or -1 if there is none by that name
+    int index_of(IdString name) const
+    {
+        auto fnd = name_to_index.find(name);
+        return fnd == name_to_index.end() ? -1 : fnd->second;
+    }
+    // One past the largest index ever handed out, including tombstones; the size for arrays keyed by index_of
+    int index_limit() const { return int(entries.size()); }
+    // The object at an index, or nullptr for a tombstone
+    T *value_at(int idx) const { return alive.at(idx) ? entries[idx].second.get() : nullptr; }
+
+    // Iterate over (name, pointer) pairs in insertion order, without copying. The range is fixed when the view is
+    // created: entries added while iterating are not visited, and entries erased before they are reached are skipped,
+    // so the store may be modified from inside the loop. This is what sorted() returns for a store.
+    class ordered_view
+    {
+      public:
+        class iterator
+        {
+          public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::pair<IdString, T *> value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type *pointer;
+            typedef const value_type &reference;
+
+            iterator(const IndexedStore *store, int idx, int end) : store(store), idx(idx), end(end) { load(); }
+            reference operator*() const { return current; }
+            pointer operator->() const { return &current; }
+            iterator &operator++()
+            {
+                ++idx;
+                load();
+                return *this;
+            }
+            bool operator==(const iterator &other) const { return idx == other.idx; }
+            bool operator!=(const iterator &other) const { return idx != other.idx; }
+
+          private:
+            const IndexedStore *store;
+            int idx, end;
+            value_type current;
+            void load()
+            {
+                while (idx < end && !store->alive[idx])
+                    ++idx;
+                if (idx < end)
+                    current = value_type(store->entries[idx].first, store->entries[idx].second.get());
+            }
+        };
+
+        explicit ordered_view(const IndexedStore *store) : store(store), limit(store->index_limit()) {}
+        iterator begin() const { return iterator(store, 0, limit); }
+        iterator end() const { return iterator(store, limit, limit); }
+
+      private:
+        const IndexedStore *store;
+        int limit;
+    };
+
+    ordered_view ordered() const { return ordered_view(this); }
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
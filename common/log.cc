@@ -41,6 +41,7 @@ void (*log_error_atexit)() = NULL;
 std::unordered_map<LogLevel, int> message_count_by_level;
 static int log_newline_count = 0;
 bool had_nonfatal_error = false;
+static thread_local LogErrorCapture *log_error_capture = nullptr;
 
 std::string stringf(const char *fmt, ...)
 {
@@ -164,6 +165,12 @@ void log_error(const char *format, ...)
 {
     va_list ap;
     va_start(ap, format);
+    if (log_error_capture != nullptr) {
+        if (log_error_capture->message.empty())
+            log_error_capture->message = vstringf(format, ap);
+        va_end(ap);
+        throw log_execution_error_exception();
+    }
     logv_prefixed("ERROR: ", format, ap, LogLevel::ERROR_MSG);
 
     if (log_error_atexit)
@@ -180,6 +187,10 @@ void log_break()
         log("\n");
 }
 
+LogErrorCapture::LogErrorCapture() : outer(log_error_capture) { log_error_capture = this; }
+
+LogErrorCapture::~LogErrorCapture() { log_error_capture = outer; }
+
 void log_nonfatal_error(const char *format, ...)
 {
     va_list ap;
@@ -69,6 +69,21 @@ void log_info(const char *format, ...) NPNR_ATTRIBUTE(format(printf, 1, 2));
 void log_warning(const char *format, ...) NPNR_ATTRIBUTE(format(printf, 1, 2));
 NPNR_NORETURN void log_error(const char *format, ...) NPNR_ATTRIBUTE(format(printf, 1, 2), noreturn);
 void log_nonfatal_error(const char *format, ...) NPNR_ATTRIBUTE(format(printf, 1, 2));
+
+// While one of these exists on a thread, log_error on that thread does not print its message but keeps the first
+// one here, and then throws as usual; so that worker threads can leave reporting their errors to the main thread
+struct LogErrorCapture
+{
+    LogErrorCapture();
+    ~LogErrorCapture();
+    LogErrorCapture(const LogErrorCapture &) = delete;
+    LogErrorCapture &operator=(const LogErrorCapture &) = delete;
+
+    std::string message;
+
+  private:
+    LogErrorCapture *outer;
+};
 void log_break();
 void log_flush();
 
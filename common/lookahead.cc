@@ -0,0 +1,249 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "lookahead.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include "diskcache.h"
+#include "log.h"
+#include "trace.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+const uint32_t lookahead_magic = 0x4b4c4e50;
+const uint32_t lookahead_version = 2;
+
+struct QueuedWire
+{
+    delay_t delay;
+    WireId wire;
+
+    struct Greater
+    {
+        bool operator()(const QueuedWire &lhs, const QueuedWire &rhs) const noexcept { return lhs.delay > rhs.delay; }
+    };
+};
+} // namespace
+
+int DelayLookahead::add_type(IdString type)
+{
+    if (type.index >= int(type_by_id.size()))
+        type_by_id.resize(type.index + 1, -1);
+    if (type_by_id[type.index] == -1) {
+        type_by_id[type.index] = int(types.size());
+        types.push_back(type);
+        tables.emplace_back(width * height, delay_t(-1));
+    }
+    return type_by_id[type.index];
+}
+
+void DelayLookahead::build(const Context *ctx, std::function<Loc(WireId)> wire_loc)
+{
+    width = 0;
+    height = 0;
+    for (auto wire : ctx->getWires()) {
+        Loc loc = wire_loc(wire);
+        width = std::max(width, loc.x + 1);
+        height = std::max(height, loc.y + 1);
+    }
+
+    // Dijkstra is run from the wires of each type in the tile nearest to each corner of the grid and to its centre.
+    // Between them the corner tiles see every offset the grid allows, and the centre tile is typical of most of the
+    // device. All wires of the type in a tile are sources of the same search, as they share an origin and only the
+    // smallest delay to each offset is kept.
+    const Loc targets[] = {Loc(0, 0, 0), Loc(width - 1, 0, 0), Loc(0, height - 1, 0), Loc(width - 1, height - 1, 0),
+                           Loc(width / 2, height / 2, 0)};
+    std::vector<std::vector<WireId>> wires_by_type;
+    for (auto wire : ctx->getWires()) {
+        int type = add_type(ctx->getWireType(wire));
+        if (type >= int(wires_by_type.size()))
+            wires_by_type.resize(type + 1);
+        wires_by_type.at(type).push_back(wire);
+    }
+
+    std::vector<delay_t> dist(ctx->getWireIndexCount(), delay_t(-1));
+    std::vector<int> dirty;
+    std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> queue;
+
+    for (int type = 0; type < int(wires_by_type.size()); type++) {
+        const auto &wires = wires_by_type.at(type);
+        std::vector<Loc> origins;
+        for (const Loc &target : targets) {
+            Loc origin;
+            int origin_dist = std::numeric_limits<int>::max();
+            for (auto wire : wires) {
+                Loc loc = wire_loc(wire);
+                int d = std::abs(loc.x - target.x) + std::abs(loc.y - target.y);
+                if (d < origin_dist) {
+                    origin_dist = d;
+                    origin = loc;
+                }
+            }
+            if (std::find(origins.begin(), origins.end(), origin) == origins.end())
+                origins.push_back(origin);
+        }
+        auto &table = tables.at(type);
+
+        for (const Loc &src_loc : origins) {
+            for (int idx : dirty)
+                dist[idx] = -1;
+            dirty.clear();
+
+            for (auto src : wires) {
+                Loc loc = wire_loc(src);
+                if (loc.x != src_loc.x || loc.y != src_loc.y)
+                    continue;
+                dist[ctx->getWireIndex(src)] = 0;
+                dirty.push_back(ctx->getWireIndex(src));
+                queue.push(QueuedWire{0, src});
+            }
+            while (!queue.empty()) {
+                QueuedWire curr = queue.top();
+                queue.pop();
+                if (curr.delay > dist[ctx->getWireIndex(curr.wire)])
+                    continue;
+
+                Loc loc = wire_loc(curr.wire);
+                delay_t &entry = table[std::abs(loc.x - src_loc.x) * height + std::abs(loc.y - src_loc.y)];
+                if (entry < 0 || curr.delay < entry)
+                    entry = curr.delay;
+
+                for (auto pip : ctx->getPipsDownhill(curr.wire)) {
+                    WireId next = ctx->getPipDstWire(pip);
+                    delay_t next_delay =
+                            curr.delay + ctx->getPipDelay(pip).maxDelay() + ctx->getWireDelay(next).maxDelay();
+                    int next_idx = ctx->getWireIndex(next);
+                    if (dist[next_idx] >= 0 && dist[next_idx] <= next_delay)
+                        continue;
+                    if (dist[next_idx] < 0)
+                        dirty.push_back(next_idx);
+                    dist[next_idx] = next_delay;
+                    queue.push(QueuedWire{next_delay, next});
+                }
+            }
+        }
+    }
+}
+
+bool DelayLookahead::load(const Context *ctx, const std::string &filename, uint64_t key)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+        return false;
+    std::string buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t cursor = 0;
+    auto get = [&](void *dst, size_t size) {
+        if (cursor + size > buf.size())
+            return false;
+        memcpy(dst, buf.data() + cursor, size);
+        cursor += size;
+        return true;
+    };
+
+    uint32_t magic, version;
+    uint64_t file_key;
+    int32_t file_width, file_height, num_types;
+    if (!get(&magic, sizeof(magic)) || !get(&version, sizeof(version)) || !get(&file_key, sizeof(file_key)) ||
+        !get(&file_width, sizeof(file_width)) || !get(&file_height, sizeof(file_height)) ||
+        !get(&num_types, sizeof(num_types)))
+        return false;
+    if (magic != lookahead_magic || version != lookahead_version || file_key != key || file_width < 0 ||
+        file_height < 0 || num_types < 0)
+        return false;
+
+    width = file_width;
+    height = file_height;
+    types.clear();
+    type_by_id.clear();
+    tables.clear();
+    for (int i = 0; i < num_types; i++) {
+        uint32_t name_len;
+        if (!get(&name_len, sizeof(name_len)) || cursor + name_len > buf.size())
+            return false;
+        int type = add_type(ctx->id(buf.substr(cursor, name_len)));
+        cursor += name_len;
+        for (auto &entry : tables.at(type)) {
+            double value;
+            if (!get(&value, sizeof(value)))
+                return false;
+            entry = delay_t(value);
+        }
+    }
+    return cursor == buf.size();
+}
+
+void DelayLookahead::save(const Context *ctx, const std::string &filename, uint64_t key) const
+{
+    std::string buf;
+    auto put = [&](const void *src, size_t size) { buf.append(reinterpret_cast<const char *>(src), size); };
+    int32_t num_types = int32_t(types.size());
+    put(&lookahead_magic, sizeof(lookahead_magic));
+    put(&lookahead_version, sizeof(lookahead_version));
+    put(&key, sizeof(key));
+    put(&width, sizeof(int32_t));
+    put(&height, sizeof(int32_t));
+    put(&num_types, sizeof(num_types));
+    for (size_t i = 0; i < types.size(); i++) {
+        const std::string &name = types.at(i).str(ctx);
+        uint32_t name_len = uint32_t(name.size());
+        put(&name_len, sizeof(name_len));
+        put(name.data(), name.size());
+        for (auto entry : tables.at(i)) {
+            double value = entry;
+            put(&value, sizeof(value));
+        }
+    }
+    if (!write_file_atomic(filename, buf.data(), buf.size()))
+        log_warning("Failed to cache delay lookahead as '%s'.\n", filename.c_str());
+}
+
+void DelayLookahead::init(const Context *ctx, const std::string &filename, uint64_t key,
+                          std::function<Loc(WireId)> wire_loc)
+{
+    if (load(ctx, filename, key)) {
+        is_ready = true;
+        return;
+    }
+    NPNR_TRACE_SCOPE("lookahead/build");
+    log_info("Building delay lookahead '%s'...\n", filename.c_str());
+    auto start = std::chrono::high_resolution_clock::now();
+    types.clear();
+    type_by_id.clear();
+    tables.clear();
+    build(ctx, wire_loc);
+    auto end = std::chrono::high_resolution_clock::now();
+    // Types such as bel inputs never lead out of their own tile, so only count those that reach another offset
+    size_t known = 0, total = 0;
+    for (auto &table : tables) {
+        size_t reached = std::count_if(table.begin(), table.end(), [](delay_t d) { return d >= 0; });
+        if (reached > 1) {
+            total += table.size();
+            known += reached;
+        }
+    }
+    log_info("    sampled %d wire types over a %dx%d grid in %.02fs, %.1f%% of offsets reached\n", int(types.size()),
+             width, height, std::chrono::duration<float>(end - start).count(), total ? 100.0 * known / total : 0.0);
+    save(ctx, filename, key);
+    is_ready = true;
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,78 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// Included by arch.h, which is in turn included part-way through nextpnr.h; so pull in nextpnr.h first, letting it
+// reach this header through arch.h with everything DelayLookahead needs already declared
+#include "nextpnr.h"
+
+#ifndef LOOKAHEAD_H
+#define LOOKAHEAD_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Routing delay lookahead for Arch::estimateDelay and Arch::predictDelay.
+//
+// For each wire type, holds the smallest delay seen from a wire of that type to
+// any wire at a given (|dx|, |dy|) offset from it. The table is built by running
+// Dijkstra over the routing graph from the wires of each type at the corners and
+// centre of the grid, and cached on disk as it only depends on the device.
+struct DelayLookahead
+{
+    // Load the table from `filename` if it was built with the same key, otherwise
+    // build it and write it back. `key` must change whenever the routing graph does;
+    // `wire_loc` returns the grid location of a wire.
+    void init(const Context *ctx, const std::string &filename, uint64_t key, std::function<Loc(WireId)> wire_loc);
+
+    bool ready() const { return is_ready; }
+
+    // Returns false if nothing is known about the given type and offset, in which case
+    // the caller should fall back to an analytic estimate
+    bool lookup(IdString type, int dx, int dy, delay_t &delay) const
+    {
+        if (type.index < 0 || type.index >= int(type_by_id.size()) || type_by_id[type.index] == -1)
+            return false;
+        if (dx >= width || dy >= height)
+            return false;
+        delay_t value = tables[type_by_id[type.index]][dx * height + dy];
+        if (value < 0)
+            return false;
+        delay = value;
+        return true;
+    }
+
+  private:
+    void build(const Context *ctx, std::function<Loc(WireId)> wire_loc);
+    bool load(const Context *ctx, const std::string &filename, uint64_t key);
+    void save(const Context *ctx, const std::string &filename, uint64_t key) const;
+    int add_type(IdString type);
+
+    bool is_ready = false;
+    int width = 0, height = 0;
+    std::vector<IdString> types;
+    // Index into `types` by IdString index; -1 for wire types that were never sampled
+    std::vector<int> type_by_id;
+    // Per type, indexed by dx * height + dy; negative where unknown
+    std::vector<std::vector<delay_t>> tables;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
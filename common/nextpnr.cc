@@ -19,6 +19,7 @@
 
 #include "nextpnr.h"
 #include <boost/algorithm/string.hpp>
+#include <cstring>
 #include "design_utils.h"
 #include "log.h"
 #include "util.h"
@@ -45,28 +46,19 @@ assertion_failure::assertion_failure(std::string msg, std::string expr_str, std:
     log_flush();
 }
 
-void IdString::set(const BaseCtx *ctx, const std::string &s)
-{
-    auto it = ctx->idstring_str_to_idx->find(s);
-    if (it == ctx->idstring_str_to_idx->end()) {
-        index = ctx->idstring_idx_to_str->size();
-        auto insert_rc = ctx->idstring_str_to_idx->insert({s, index});
-        ctx->idstring_idx_to_str->push_back(&insert_rc.first->first);
-    } else {
-        index = it->second;
-    }
-}
+void IdString::set(const BaseCtx *ctx, const std::string &s) { index = ctx->idstring_db->intern(s.data(), s.size()); }
+
+void IdString::set(const BaseCtx *ctx, const char *s) { index = ctx->idstring_db->intern(s, strlen(s)); }
 
-const std::string &IdString::str(const BaseCtx *ctx) const { return *ctx->idstring_idx_to_str->at(index); }
+std::string IdString::str(const BaseCtx *ctx) const { return ctx->idstring_db->str(index); }
 
-const char *IdString::c_str(const BaseCtx *ctx) const { return str(ctx).c_str(); }
+const char *IdString::c_str(const BaseCtx *ctx) const { return ctx->idstring_db->c_str(index); }
 
 void IdString::initialize_add(const BaseCtx *ctx, const char *s, int idx)
 {
-    NPNR_ASSERT(ctx->idstring_str_to_idx->count(s) == 0);
-    NPNR_ASSERT(int(ctx->idstring_idx_to_str->size()) == idx);
-    auto insert_rc = ctx->idstring_str_to_idx->insert({s, idx});
-    ctx->idstring_idx_to_str->push_back(&insert_rc.first->first);
+    NPNR_ASSERT(ctx->idstring_db->find(s, strlen(s)) == -1);
+    NPNR_ASSERT(ctx->idstring_db->size() == idx);
+    ctx->idstring_db->intern(s, strlen(s));
 }
 
 TimingConstrObjectId BaseCtx::timingWildcardObject()
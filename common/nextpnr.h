@@ -114,11 +114,13 @@ struct IdString
 
     void set(const BaseCtx *ctx, const std::string &s);
 
+    void set(const BaseCtx *ctx, const char *s);
+
     IdString(const BaseCtx *ctx, const std::string &s) { set(ctx, s); }
 
     IdString(const BaseCtx *ctx, const char *s) { set(ctx, s); }
 
-    const std::string &str(const BaseCtx *ctx) const;
+    std::string str(const BaseCtx *ctx) const;
 
     const char *c_str(const BaseCtx *ctx) const;
 
@@ -143,6 +145,9 @@ template <> struct hash<NEXTPNR_NAMESPACE_PREFIX IdString>
 };
 } // namespace std
 
+#include "idstringdb.h"
+#include "indexed_store.h"
+
 NEXTPNR_NAMESPACE_BEGIN
 
 struct GraphicElement
@@ -661,15 +666,14 @@ struct BaseCtx
 #endif
 
     // ID String database.
-    mutable std::unordered_map<std::string, int> *idstring_str_to_idx;
-    mutable std::vector<const std::string *> *idstring_idx_to_str;
+    mutable IdStringDB *idstring_db;
 
     // Project settings and config switches
     std::unordered_map<IdString, Property> settings;
 
-    // Placed nets and cells.
-    std::unordered_map<IdString, std::unique_ptr<NetInfo>> nets;
-    std::unordered_map<IdString, std::unique_ptr<CellInfo>> cells;
+    // Placed nets and cells, in insertion order
+    IndexedStore<NetInfo> nets;
+    IndexedStore<CellInfo> cells;
 
     // Hierarchical (non-leaf) cells by full path
     std::unordered_map<IdString, HierarchicalCell> hierarchy;
@@ -690,8 +694,7 @@ struct BaseCtx
 
     BaseCtx()
     {
-        idstring_str_to_idx = new std::unordered_map<std::string, int>;
-        idstring_idx_to_str = new std::vector<const std::string *>;
+        idstring_db = new IdStringDB;
         IdString::initialize_add(this, "", 0);
         IdString::initialize_arch(this);
 
@@ -703,8 +706,7 @@ struct BaseCtx
 
     ~BaseCtx()
     {
-        delete idstring_str_to_idx;
-        delete idstring_idx_to_str;
+        delete idstring_db;
     }
 
     // Must be called before performing any mutating changes on the Ctx/Arch.
@@ -792,7 +794,18 @@ struct BaseCtx
 
     void refreshUiFrame() { frameUiReload = true; }
 
-    void refreshUiBel(BelId bel) { belUiReload.insert(bel); }
+#ifndef NPNR_DISABLE_THREADS
+    // Bels may be bound and unbound from several threads at once by the parallel placer
+    std::mutex belUiReloadMutex;
+#endif
+
+    void refreshUiBel(BelId bel)
+    {
+#ifndef NPNR_DISABLE_THREADS
+        std::lock_guard<std::mutex> lock(belUiReloadMutex);
+#endif
+        belUiReload.insert(bel);
+    }
 
     void refreshUiWire(WireId wire) { wireUiReload.insert(wire); }
 
@@ -855,6 +868,8 @@ NEXTPNR_NAMESPACE_END
 
 NEXTPNR_NAMESPACE_BEGIN
 
+struct TimingAnalyser;
+
 struct Context : Arch, DeterministicRNG
 {
     bool verbose = false;
@@ -864,6 +879,13 @@ struct Context : Arch, DeterministicRNG
     // Should we disable printing of the location of nets in the critical path?
     bool disable_critical_path_source_print = false;
 
+    // Timing graph kept between placer and router passes (see timing.h)
+    std::shared_ptr<TimingAnalyser> timing_analyser;
+
+    // Work done by the placers and routers, e.g. moves evaluated or wires expanded, accumulated
+    // over the whole run for benchmarking (see bench.h)
+    std::unordered_map<std::string, int64_t> work_counters;
+
     Context(ArchArgs args) : Arch(args) {}
 
     // --------------------------------------------------------------
@@ -24,6 +24,7 @@
 #include "placer1.h"
 #include <algorithm>
 #include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 #include <chrono>
 #include <cmath>
@@ -31,6 +32,7 @@
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <ostream>
 #include <queue>
 #include <set>
@@ -42,6 +44,7 @@
 #include "log.h"
 #include "place_common.h"
 #include "timing.h"
+#include "trace.h"
 #include "util.h"
 
 namespace std {
@@ -74,6 +77,48 @@ class SAPlacer
         }
     };
 
+    struct MoveThreadState;
+
+    // The bels random_bel_for_cell may pick for a cell of one type (in one region, if the cell is constrained to
+    // one), ordered by tile, column by column. tile_start holds the prefix sums of the number of bels per tile, so
+    // that a bel within the range limit is drawn with a single RNG call instead of by trying random tiles.
+    struct BelSampler
+    {
+        int height = 0;
+        std::vector<BelId> bels;
+        // Index in bels of the first bel of tile (x, y), at x * height + y
+        std::vector<int> tile_start;
+
+        int column_count(int x, int y0, int y1) const
+        {
+            return tile_start.at(x * height + y1 + 1) - tile_start.at(x * height + y0);
+        }
+
+        BelId sample(DeterministicRNG &rng, int x0, int x1, int y0, int y1) const
+        {
+            if (bels.empty())
+                return BelId();
+            int width = int(tile_start.size() - 1) / height;
+            x0 = std::max(x0, 0);
+            y0 = std::max(y0, 0);
+            x1 = std::min(x1, width - 1);
+            y1 = std::min(y1, height - 1);
+            int count = 0;
+            for (int x = x0; x <= x1; x++)
+                count += column_count(x, y0, y1);
+            if (count == 0)
+                return BelId();
+            int k = rng.rng(count);
+            for (int x = x0; x <= x1; x++) {
+                int col = column_count(x, y0, y1);
+                if (k < col)
+                    return bels.at(tile_start.at(x * height + y0) + k);
+                k -= col;
+            }
+            NPNR_ASSERT_FALSE("unreachable");
+        }
+    };
+
   public:
     SAPlacer(Context *ctx, Placer1Cfg cfg) : ctx(ctx), cfg(cfg)
     {
@@ -88,22 +133,13 @@ class SAPlacer
         }
         for (auto bel : ctx->getBels()) {
             Loc loc = ctx->getBelLocation(bel);
-            IdString type = ctx->getBelType(bel);
-            int type_idx = std::get<0>(bel_types.at(type));
-            int type_cnt = std::get<1>(bel_types.at(type));
-            if (type_cnt < cfg.minBelsForGridPick)
+            if (std::get<1>(bel_types.at(ctx->getBelType(bel))) < cfg.minBelsForGridPick)
                 loc.x = loc.y = 0;
-            if (int(fast_bels.size()) < type_idx + 1)
-                fast_bels.resize(type_idx + 1);
-            if (int(fast_bels.at(type_idx).size()) < (loc.x + 1))
-                fast_bels.at(type_idx).resize(loc.x + 1);
-            if (int(fast_bels.at(type_idx).at(loc.x).size()) < (loc.y + 1))
-                fast_bels.at(type_idx).at(loc.x).resize(loc.y + 1);
             max_x = std::max(max_x, loc.x);
             max_y = std::max(max_y, loc.y);
-            fast_bels.at(type_idx).at(loc.x).at(loc.y).push_back(bel);
         }
         diameter = std::max(max_x, max_y) + 1;
+        range_limit = diameter;
 
         net_bounds.resize(ctx->nets.size());
         net_arc_tcost.resize(ctx->nets.size());
@@ -150,6 +186,7 @@ class SAPlacer
 
     bool place(bool refine = false)
     {
+        NPNR_TRACE_SCOPE("placer1");
         log_break();
         ctx->lock();
 
@@ -204,10 +241,14 @@ class SAPlacer
                 CellInfo *ci = cell.second.get();
                 if (ci->bel == BelId()) {
                     autoplaced.push_back(cell.second.get());
+                } else if (ci->belStrength >= STRENGTH_STRONG) {
+                    // Already placed by the packer or kept from a previous run (ECO); never swap these out
+                    locked_bels.insert(ci->bel);
                 }
             }
             std::sort(autoplaced.begin(), autoplaced.end(), [](CellInfo *a, CellInfo *b) { return a->name < b->name; });
             ctx->shuffle(autoplaced);
+            NPNR_TRACE_SCOPE("placer1/initial");
             auto iplace_start = std::chrono::high_resolution_clock::now();
             // Place cells randomly initially
             log_info("Creating initial placement for remaining %d cells.\n", int(autoplaced.size()));
@@ -247,17 +288,26 @@ class SAPlacer
             }
             require_legal = false;
             diameter = 3;
+            range_limit = diameter;
             log_info("Running simulated annealing placer for refinement.\n");
         }
+        build_bel_samplers();
         auto saplace_start = std::chrono::high_resolution_clock::now();
 
         // Invoke timing analysis to obtain criticalities
-        if (!cfg.budgetBased)
+        if (!cfg.budgetBased) {
+            setup_timing_analyser(ctx);
             get_criticalities(ctx, &net_crit);
+        }
 
         // Calculate costs after initial placement
         setup_costs();
-        moveChange.init(this);
+        main_state.rng = ctx;
+        main_state.moveChange.init(this);
+        if (cfg.threads > 1 && cfg.netShareWeight > 0)
+            log_warning("Net sharing cost is not supported by the parallel placer, using one thread.\n");
+        else if (cfg.threads > 1)
+            setup_parallel();
         curr_wirelen_cost = total_wirelen_cost();
         curr_timing_cost = total_timing_cost();
         last_wirelen_cost = curr_wirelen_cost;
@@ -274,6 +324,7 @@ class SAPlacer
 
         // Main simulated annealing loop
         for (int iter = 1;; iter++) {
+            NPNR_TRACE_SCOPE("placer1/iteration");
             n_move = n_accept = 0;
             improved = false;
 
@@ -283,23 +334,34 @@ class SAPlacer
                          iter, temp, double(curr_timing_cost), double(curr_wirelen_cost));
 
             for (int m = 0; m < 15; ++m) {
-                // Loop through all automatically placed cells
-                for (auto cell : autoplaced) {
-                    // Find another random Bel for this cell
-                    BelId try_bel = random_bel_for_cell(cell);
-                    // If valid, try and swap to a new position and see if
-                    // the new position is valid/worthwhile
-                    if (try_bel != BelId() && try_bel != cell->bel)
-                        try_swap_position(cell, try_bel);
+                if (!worker_states.empty()) {
+                    // Alternate the direction of the region split, so cells next to a boundary
+                    // get a chance of a local move on the next sweep
+                    parallel_sweep(autoplaced, (m % 2) == 0);
+                } else {
+                    // Loop through all automatically placed cells
+                    for (auto cell : autoplaced) {
+                        // Find another random Bel for this cell
+                        BelId try_bel = random_bel_for_cell(*ctx, cell);
+                        // If valid, try and swap to a new position and see if
+                        // the new position is valid/worthwhile
+                        if (try_bel != BelId() && try_bel != cell->bel)
+                            try_swap_position(main_state, cell, try_bel);
+                    }
                 }
                 // Also try swapping chains, if applicable
                 for (auto cb : chain_basis) {
                     Loc chain_base_loc = ctx->getBelLocation(cb->bel);
-                    BelId try_base = random_bel_for_cell(cb, chain_base_loc.z);
+                    BelId try_base = random_bel_for_cell(*ctx, cb, chain_base_loc.z);
                     if (try_base != BelId() && try_base != cb->bel)
-                        try_swap_chain(cb, try_base);
+                        try_swap_chain(main_state, cb, try_base);
                 }
+                fold_move_state(main_state);
+                sync_move_states();
             }
+            total_moves += n_move;
+            trace_counter("placer1/wirelen", double(curr_wirelen_cost));
+            trace_counter("placer1/timing_cost", double(curr_timing_cost));
 
             if (ctx->debug) {
                 // Verify correctness of incremental wirelen updates
@@ -349,8 +411,10 @@ class SAPlacer
             if (curr_wirelen_cost < 0.95 * avg_wirelen && curr_wirelen_cost > 0) {
                 avg_wirelen = 0.8 * avg_wirelen + 0.2 * curr_wirelen_cost;
             } else {
-                double diam_next = diameter * (1.0 - 0.44 + Raccept);
-                diameter = std::max<int>(1, std::min<int>(M, int(diam_next + 0.5)));
+                // VPR-style range limit, aiming for an acceptance rate of 44%. It is kept as a float so that a small
+                // window can grow again, where rounding the diameter each time would pin it at 1
+                range_limit = std::max(1.0, std::min(double(M), range_limit * (1.0 - 0.44 + Raccept)));
+                diameter = int(range_limit + 0.5);
                 if (Raccept > 0.96) {
                     temp *= 0.5;
                 } else if (Raccept > 0.8) {
@@ -394,8 +458,12 @@ class SAPlacer
             // Need to rebuild costs after criticalities change
             setup_costs();
             // Reset incremental bounds
-            moveChange.reset(this);
-            moveChange.new_net_bounds = net_bounds;
+            main_state.moveChange.reset(this);
+            main_state.moveChange.new_net_bounds = net_bounds;
+            for (auto &t : worker_states) {
+                t->moveChange.reset(this);
+                t->moveChange.new_net_bounds = net_bounds;
+            }
 
             // Recalculate total metric entirely to avoid rounding errors
             // accumulating over time
@@ -407,6 +475,7 @@ class SAPlacer
             ctx->yield();
         }
 
+        ctx->work_counters["placer/moves"] += total_moves;
         auto saplace_end = std::chrono::high_resolution_clock::now();
         log_info("SA placement time %.02fs\n", std::chrono::duration<float>(saplace_end - saplace_start).count());
 
@@ -509,9 +578,10 @@ class SAPlacer
     }
 
     // Attempt a SA position swap, return true on success or false on failure
-    bool try_swap_position(CellInfo *cell, BelId newBel)
+    bool try_swap_position(MoveThreadState &t, CellInfo *cell, BelId newBel)
     {
         static const double epsilon = 1e-20;
+        MoveChangeData &moveChange = t.moveChange;
         moveChange.reset(this);
         if (!require_legal && is_constrained(cell))
             return false;
@@ -569,17 +639,17 @@ class SAPlacer
         delta += (cfg.constraintWeight / temp) * (new_dist - old_dist) / last_wirelen_cost;
         if (cfg.netShareWeight > 0)
             delta += -cfg.netShareWeight * (net_delta_score / std::max<double>(total_net_share, epsilon));
-        n_move++;
+        t.n_move++;
         // SA acceptance criterea
-        if (delta < 0 || (temp > 1e-8 && (ctx->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
-            n_accept++;
+        if (delta < 0 || (temp > 1e-8 && (t.rng->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
+            t.n_accept++;
         } else {
             if (other_cell != nullptr)
                 ctx->unbindBel(oldBel);
             ctx->unbindBel(newBel);
             goto swap_fail;
         }
-        commit_cost_changes(moveChange);
+        commit_cost_changes(t);
 #if 0
         log_info("swap %s -> %s\n", cell->name.c_str(ctx), ctx->getBelName(newBel).c_str(ctx));
         if (other_cell != nullptr)
@@ -636,8 +706,9 @@ class SAPlacer
     }
 
     // Attempt to swap a chain with a non-chain
-    bool try_swap_chain(CellInfo *cell, BelId newBase)
+    bool try_swap_chain(MoveThreadState &t, CellInfo *cell, BelId newBase)
     {
+        MoveChangeData &moveChange = t.moveChange;
         std::vector<std::pair<CellInfo *, Loc>> cell_rel;
         std::unordered_set<IdString> cells;
         std::vector<std::pair<CellInfo *, BelId>> moves_made;
@@ -700,10 +771,10 @@ class SAPlacer
             delta +=
                     cfg.netShareWeight * (orig_share_cost - total_net_share) / std::max<double>(total_net_share, 1e-20);
         }
-        n_move++;
+        t.n_move++;
         // SA acceptance criterea
-        if (delta < 0 || (temp > 1e-9 && (ctx->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
-            n_accept++;
+        if (delta < 0 || (temp > 1e-9 && (t.rng->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
+            t.n_accept++;
 #if 0
             if (ctx->debug)
                 log_info("accepted chain swap %s\n", cell->name.c_str(ctx));
@@ -711,7 +782,7 @@ class SAPlacer
         } else {
             goto swap_fail;
         }
-        commit_cost_changes(moveChange);
+        commit_cost_changes(t);
         return true;
     swap_fail:
         for (const auto &entry : boost::adaptors::reverse(moves_made))
@@ -719,54 +790,81 @@ class SAPlacer
         return false;
     }
 
+    // Build the samplers used by random_bel_for_cell, once the locked bels are known
+    void build_bel_samplers()
+    {
+        int width = ctx->getGridDimX(), height = ctx->getGridDimY();
+        auto build = [&](std::vector<BelSampler> &samplers, const Region *region) {
+            std::vector<std::vector<std::pair<int, BelId>>> by_type(bel_types.size());
+            for (auto bel : ctx->getBels()) {
+                if (locked_bels.count(bel) || (region != nullptr && !region->bels.count(bel)))
+                    continue;
+                Loc loc = ctx->getBelLocation(bel);
+                by_type.at(std::get<0>(bel_types.at(ctx->getBelType(bel)))).emplace_back(loc.x * height + loc.y, bel);
+            }
+            samplers.resize(by_type.size());
+            for (size_t i = 0; i < by_type.size(); i++) {
+                auto &tile_bels = by_type.at(i);
+                // getBels() order within a tile is kept, so that the choice of bel is deterministic
+                std::stable_sort(tile_bels.begin(), tile_bels.end(),
+                                 [](const std::pair<int, BelId> &a, const std::pair<int, BelId> &b) {
+                                     return a.first < b.first;
+                                 });
+                BelSampler &bs = samplers.at(i);
+                bs.height = height;
+                bs.tile_start.assign(width * height + 1, 0);
+                for (auto &tb : tile_bels) {
+                    bs.tile_start.at(tb.first + 1)++;
+                    bs.bels.push_back(tb.second);
+                }
+                for (int t = 0; t < width * height; t++)
+                    bs.tile_start.at(t + 1) += bs.tile_start.at(t);
+            }
+        };
+        build(bel_samplers, nullptr);
+        region_bel_samplers.clear();
+        for (auto &region : sorted(ctx->region))
+            if (region.second->constr_bels)
+                build(region_bel_samplers[region.first], region.second);
+    }
+
     // Find a random Bel of the correct type for a cell, within the specified
     // diameter
-    BelId random_bel_for_cell(CellInfo *cell, int force_z = -1)
+    BelId random_bel_for_cell(DeterministicRNG &rng, CellInfo *cell, int force_z = -1)
     {
-        IdString targetType = cell->type;
         Loc curr_loc = ctx->getBelLocation(cell->bel);
-        int count = 0;
 
         int dx = diameter, dy = diameter;
+        const std::vector<BelSampler> *samplers = &bel_samplers;
         if (cell->region != nullptr && cell->region->constr_bels) {
-            dx = std::min(cfg.hpwl_scale_x * diameter,
-                          (region_bounds[cell->region->name].x1 - region_bounds[cell->region->name].x0) + 1);
-            dy = std::min(cfg.hpwl_scale_y * diameter,
-                          (region_bounds[cell->region->name].y1 - region_bounds[cell->region->name].y0) + 1);
+            // Use at() rather than operator[] as this may be called from several threads at once
+            const BoundingBox &rb = region_bounds.at(cell->region->name);
+            dx = std::min(cfg.hpwl_scale_x * diameter, (rb.x1 - rb.x0) + 1);
+            dy = std::min(cfg.hpwl_scale_y * diameter, (rb.y1 - rb.y0) + 1);
             // Clamp location to within bounds
-            curr_loc.x = std::max(region_bounds[cell->region->name].x0, curr_loc.x);
-            curr_loc.x = std::min(region_bounds[cell->region->name].x1, curr_loc.x);
-            curr_loc.y = std::max(region_bounds[cell->region->name].y0, curr_loc.y);
-            curr_loc.y = std::min(region_bounds[cell->region->name].y1, curr_loc.y);
+            curr_loc.x = std::max(rb.x0, curr_loc.x);
+            curr_loc.x = std::min(rb.x1, curr_loc.x);
+            curr_loc.y = std::max(rb.y0, curr_loc.y);
+            curr_loc.y = std::min(rb.y1, curr_loc.y);
+            samplers = &region_bel_samplers.at(cell->region->name);
         }
 
-        while (true) {
-            int nx = ctx->rng(2 * dx + 1) + std::max(curr_loc.x - dx, 0);
-            int ny = ctx->rng(2 * dy + 1) + std::max(curr_loc.y - dy, 0);
-            int beltype_idx, beltype_cnt;
-            std::tie(beltype_idx, beltype_cnt) = bel_types.at(targetType);
-            if (beltype_cnt < cfg.minBelsForGridPick)
-                nx = ny = 0;
-            if (nx >= int(fast_bels.at(beltype_idx).size()))
-                continue;
-            if (ny >= int(fast_bels.at(beltype_idx).at(nx).size()))
-                continue;
-            const auto &fb = fast_bels.at(beltype_idx).at(nx).at(ny);
-            if (fb.size() == 0)
-                continue;
-            BelId bel = fb.at(ctx->rng(int(fb.size())));
-            if (force_z != -1) {
-                Loc loc = ctx->getBelLocation(bel);
-                if (loc.z != force_z)
-                    continue;
-            }
-            if (!check_cell_bel_region(cell, bel))
-                continue;
-            if (locked_bels.find(bel) != locked_bels.end())
-                continue;
-            count++;
-            return bel;
+        int beltype_idx, beltype_cnt;
+        std::tie(beltype_idx, beltype_cnt) = bel_types.at(cell->type);
+        const BelSampler &bs = samplers->at(beltype_idx);
+        // Rare bel types are picked from anywhere on the device
+        int x0 = curr_loc.x - dx, x1 = curr_loc.x + dx, y0 = curr_loc.y - dy, y1 = curr_loc.y + dy;
+        if (beltype_cnt < cfg.minBelsForGridPick) {
+            x0 = y0 = 0;
+            x1 = y1 = std::numeric_limits<int>::max();
         }
+        // Only the bels of chains need a particular z, so these are still found by retrying
+        for (int attempt = 0; attempt < (force_z == -1 ? 1 : 64); attempt++) {
+            BelId bel = bs.sample(rng, x0, x1, y0, y1);
+            if (bel == BelId() || force_z == -1 || ctx->getBelLocation(bel).z == force_z)
+                return bel;
+        }
+        return BelId();
     }
 
     // Return true if a net is to be entirely ignored
@@ -932,8 +1030,31 @@ class SAPlacer
             wirelen_delta = 0;
             timing_delta = 0;
         }
+    };
 
-    } moveChange;
+    // Move evaluation state owned by a single thread. Serial annealing, chain swaps and moves
+    // that cross regions all use main_state, which draws from the Context RNG.
+    struct MoveThreadState
+    {
+        DeterministicRNG *rng = nullptr;
+        MoveChangeData moveChange;
+        // Accumulated since last folded into the global state
+        int n_move = 0, n_accept = 0;
+        wirelen_t wirelen_delta = 0;
+        double timing_delta = 0;
+        // Nets whose bounds this thread has committed since the last sync
+        std::vector<decltype(NetInfo::udata)> committed_nets;
+
+        // Parallel mode only
+        int index = -1;
+        DeterministicRNG local_rng;
+        std::vector<CellInfo *> cells;
+        // Moves proposed that are not local to this thread's region; to be tried serially
+        std::vector<std::pair<CellInfo *, BelId>> deferred;
+    };
+
+    MoveThreadState main_state;
+    std::vector<std::unique_ptr<MoveThreadState>> worker_states;
 
     void add_move_cell(MoveChangeData &mc, CellInfo *cell, BelId old_bel)
     {
@@ -944,7 +1065,9 @@ class SAPlacer
             NetInfo *pn = port.second.net;
             if (pn == nullptr)
                 continue;
-            if (ignore_net(pn))
+            // The driver of an ignored net may be being moved by another thread in parallel mode, so
+            // use the value cached at the start of the sweep
+            if (in_parallel_sweep ? (net_owner[pn->udata] == NET_IGNORED) : ignore_net(pn))
                 continue;
             BoundingBox &curr_bounds = mc.new_net_bounds[pn->udata];
             // Incremental bounding box updates
@@ -1119,16 +1242,177 @@ class SAPlacer
         }
     }
 
-    void commit_cost_changes(MoveChangeData &md)
+    void commit_cost_changes(MoveThreadState &t)
     {
+        MoveChangeData &md = t.moveChange;
         for (const auto &bc : md.bounds_changed_nets_x)
             net_bounds[bc] = md.new_net_bounds[bc];
         for (const auto &bc : md.bounds_changed_nets_y)
             net_bounds[bc] = md.new_net_bounds[bc];
+        if (!worker_states.empty()) {
+            t.committed_nets.insert(t.committed_nets.end(), md.bounds_changed_nets_x.begin(),
+                                    md.bounds_changed_nets_x.end());
+            t.committed_nets.insert(t.committed_nets.end(), md.bounds_changed_nets_y.begin(),
+                                    md.bounds_changed_nets_y.end());
+        }
         for (const auto &tc : md.new_arc_costs)
             net_arc_tcost[tc.first.first].at(tc.first.second) = tc.second;
-        curr_wirelen_cost += md.wirelen_delta;
-        curr_timing_cost += md.timing_delta;
+        t.wirelen_delta += md.wirelen_delta;
+        t.timing_delta += md.timing_delta;
+    }
+
+    // Add the cost changes and move statistics of a thread to the global totals, in a fixed order so
+    // that results do not depend on thread timing
+    void fold_move_state(MoveThreadState &t)
+    {
+        curr_wirelen_cost += t.wirelen_delta;
+        curr_timing_cost += t.timing_delta;
+        n_move += t.n_move;
+        n_accept += t.n_accept;
+        t.wirelen_delta = 0;
+        t.timing_delta = 0;
+        t.n_move = 0;
+        t.n_accept = 0;
+    }
+
+    // The incremental bounds in each MoveChangeData must match net_bounds outside of a move. Copy the
+    // bounds of nets committed by one thread into the incremental state of all the others.
+    void sync_move_states()
+    {
+        std::vector<MoveThreadState *> states{&main_state};
+        for (auto &t : worker_states)
+            states.push_back(t.get());
+        for (auto src : states) {
+            for (auto dst : states) {
+                if (dst == src)
+                    continue;
+                for (auto n : src->committed_nets)
+                    dst->moveChange.new_net_bounds[n] = net_bounds[n];
+            }
+        }
+        for (auto t : states)
+            t->committed_nets.clear();
+    }
+
+    // Parallel annealing. For each sweep the device is cut into one strip per thread, along X or Y. A
+    // thread only evaluates moves where both the source and destination bel are within its strip, no
+    // chained cells are involved, and every net touched lies entirely within the strip; so no two
+    // threads ever touch the same cell, bel or net. All other moves are deferred and tried serially
+    // afterwards. As every thread's RNG is reseeded from the Context RNG before each sweep, results
+    // only depend on the seed and number of threads.
+    enum : int
+    {
+        NET_CROSSES_REGIONS = -1,
+        NET_IGNORED = -2,
+    };
+    std::vector<int> net_owner;
+    std::vector<int> strip_of;
+    bool in_parallel_sweep = false;
+
+    void setup_parallel()
+    {
+        for (int i = 0; i < cfg.threads; i++) {
+            worker_states.emplace_back(new MoveThreadState());
+            auto &t = *worker_states.back();
+            t.index = i;
+            t.rng = &t.local_rng;
+            t.moveChange.init(this);
+        }
+        net_owner.resize(net_by_udata.size());
+        log_info("Using %d threads for simulated annealing.\n", cfg.threads);
+    }
+
+    int strip_for_loc(Loc loc, bool split_x)
+    {
+        int pos = split_x ? loc.x : loc.y;
+        return strip_of.at(std::max(0, std::min(int(strip_of.size()) - 1, pos)));
+    }
+
+    bool is_local_move(MoveThreadState &t, CellInfo *cell, BelId newBel, bool split_x)
+    {
+        if (strip_for_loc(ctx->getBelLocation(newBel), split_x) != t.index)
+            return false;
+        CellInfo *other_cell = ctx->getBoundBelCell(newBel);
+        for (CellInfo *ci : {cell, other_cell}) {
+            if (ci == nullptr)
+                continue;
+            if (is_constrained(ci))
+                return false;
+            for (const auto &port : ci->ports) {
+                NetInfo *pn = port.second.net;
+                if (pn == nullptr)
+                    continue;
+                int owner = net_owner[pn->udata];
+                if (owner != NET_IGNORED && owner != t.index)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    void parallel_sweep_worker(MoveThreadState &t, bool split_x)
+    {
+        for (auto cell : t.cells) {
+            BelId try_bel = random_bel_for_cell(*t.rng, cell);
+            if (try_bel == BelId() || try_bel == cell->bel)
+                continue;
+            if (is_local_move(t, cell, try_bel, split_x))
+                try_swap_position(t, cell, try_bel);
+            else
+                t.deferred.emplace_back(cell, try_bel);
+        }
+    }
+
+    void parallel_sweep(const std::vector<CellInfo *> &autoplaced, bool split_x)
+    {
+        NPNR_TRACE_SCOPE("placer1/parallel_sweep");
+        int nthreads = int(worker_states.size());
+        int extent = (split_x ? max_x : max_y) + 1;
+        strip_of.resize(extent);
+        for (int i = 0; i < extent; i++)
+            strip_of.at(i) = std::min(nthreads - 1, (i * nthreads) / extent);
+
+        for (auto &t : worker_states) {
+            t->cells.clear();
+            t->deferred.clear();
+            t->local_rng.rngseed(ctx->rng64());
+        }
+        for (auto cell : autoplaced)
+            worker_states.at(strip_for_loc(ctx->getBelLocation(cell->bel), split_x))->cells.push_back(cell);
+        for (size_t i = 0; i < net_by_udata.size(); i++) {
+            NetInfo *ni = net_by_udata.at(i);
+            if (ignore_net(ni)) {
+                net_owner.at(i) = NET_IGNORED;
+                continue;
+            }
+            const BoundingBox &bb = net_bounds.at(i);
+            int lo = strip_for_loc(Loc(bb.x0, bb.y0, 0), split_x), hi = strip_for_loc(Loc(bb.x1, bb.y1, 0), split_x);
+            net_owner.at(i) = (lo == hi) ? lo : NET_CROSSES_REGIONS;
+        }
+
+        in_parallel_sweep = true;
+#ifdef NPNR_DISABLE_THREADS
+        for (auto &t : worker_states)
+            parallel_sweep_worker(*t, split_x);
+#else
+        std::vector<boost::thread> threads;
+        for (auto &t : worker_states) {
+            MoveThreadState *ts = t.get();
+            threads.emplace_back([this, ts, split_x]() { parallel_sweep_worker(*ts, split_x); });
+        }
+        for (auto &th : threads)
+            th.join();
+#endif
+        in_parallel_sweep = false;
+
+        for (auto &t : worker_states)
+            fold_move_state(*t);
+        sync_move_states();
+        // Serial pass for moves that cross regions
+        for (auto &t : worker_states)
+            for (auto &move : t->deferred)
+                if (move.second != move.first->bel)
+                    try_swap_position(main_state, move.first, move.second);
     }
     // Build the cell port -> user index
     void build_port_index()
@@ -1224,11 +1508,15 @@ class SAPlacer
     float lambda = 0.5;
     bool improved = false;
     int n_move, n_accept;
+    int64_t total_moves = 0;
     int diameter = 35, max_x = 1, max_y = 1;
+    double range_limit = 35;
     std::unordered_map<IdString, std::tuple<int, int>> bel_types;
     std::unordered_map<IdString, BoundingBox> region_bounds;
-    std::vector<std::vector<std::vector<std::vector<BelId>>>> fast_bels;
     std::unordered_set<BelId> locked_bels;
+    // Indexed by bel type, as in bel_types; with one set per region that constrains bels
+    std::vector<BelSampler> bel_samplers;
+    std::unordered_map<IdString, std::vector<BelSampler>> region_bel_samplers;
     std::vector<NetInfo *> net_by_udata;
     std::vector<decltype(NetInfo::udata)> old_udata;
     bool require_legal = true;
@@ -1248,6 +1536,7 @@ Placer1Cfg::Placer1Cfg(Context *ctx)
     slack_redist_iter = ctx->setting<int>("slack_redist_iter");
     hpwl_scale_x = 1;
     hpwl_scale_y = 1;
+    threads = std::max(1, ctx->setting<int>("placer1/threads", 1));
 }
 
 bool placer1(Context *ctx, Placer1Cfg cfg)
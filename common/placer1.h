@@ -35,6 +35,9 @@ struct Placer1Cfg
     bool timing_driven;
     int slack_redist_iter;
     int hpwl_scale_x, hpwl_scale_y;
+    // Number of threads for parallel annealing; 1 for the classic serial placer. Results are
+    // deterministic for a given seed and thread count.
+    int threads;
 };
 
 extern bool placer1(Context *ctx, Placer1Cfg cfg);
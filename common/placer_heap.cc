@@ -34,12 +34,13 @@
 #ifdef WITH_HEAP
 
 #include "placer_heap.h"
-#include <Eigen/Core>
-#include <Eigen/IterativeLinearSolvers>
+#include <atomic>
 #include <boost/optional.hpp>
 #include <chrono>
+#include <cmath>
 #include <deque>
 #include <fstream>
+#include <limits>
 #include <numeric>
 #include <queue>
 #include <tuple>
@@ -49,86 +50,286 @@
 #include "place_common.h"
 #include "placer1.h"
 #include "timing.h"
+#include "trace.h"
 #include "util.h"
 #include <iostream>
 NEXTPNR_NAMESPACE_BEGIN
 
 namespace {
-// A simple internal representation for a sparse system of equations Ax = rhs
+// Run func(0) .. func(n - 1), each on its own thread with func(0) on the calling thread
+template <typename Tf> void run_threads(int n, Tf func)
+{
+#ifdef NPNR_DISABLE_THREADS
+    for (int i = 0; i < n; i++)
+        func(i);
+#else
+    std::vector<boost::thread> threads;
+    for (int i = 1; i < n; i++)
+        threads.emplace_back([&func, i]() { func(i); });
+    func(0);
+    for (auto &t : threads)
+        t.join();
+#endif
+}
+
+// A reusable barrier for a fixed team of threads
+class ThreadBarrier
+{
+  public:
+    explicit ThreadBarrier(int count) : count(count) {}
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        int gen = generation;
+        if (++waiting == count) {
+            waiting = 0;
+            ++generation;
+            cv.notify_all();
+        } else {
+            cv.wait(lock, [&]() { return gen != generation; });
+        }
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    int count, waiting = 0, generation = 0;
+};
+
+// A simple internal representation for a sparse, symmetric system of equations Ax = rhs
 // This is designed to decouple the functions that build the matrix to the engine that
-// solves it, and the representation that requires
+// solves it, and the representation that requires.
+//
+// Rows are split into contiguous ranges, one per thread, on chunk_rows boundaries. Coefficients and RHS terms are
+// stamped from any number of parts into per-part, per-range buckets, and then summed in part order into a CSR
+// matrix. As long as the parts, taken in order, stamp in the same order whatever their number, every entry is
+// summed in the same order and so the system does not depend on the number of threads. The CSR sparsity pattern
+// is kept between builds and only recomputed when a coefficient falls outside it.
 template <typename T> struct EquationSystem
 {
+    struct Coeff
+    {
+        int row, col;
+        T val;
+    };
 
-    EquationSystem(size_t rows, size_t cols)
+    // Dot products in the solver are summed per chunk of this many rows, and then over the chunks in order, so
+    // that they too are independent of the number of threads
+    static const int chunk_rows = 256;
+
+    int rows = 0, threads = 1, parts = 1;
+    // part -> row range -> coefficients
+    std::vector<std::vector<std::vector<Coeff>>> stamped;
+    // part -> row range -> RHS contributions (col is unused)
+    std::vector<std::vector<std::vector<Coeff>>> stamped_rhs;
+
+    // CSR matrix
+    std::vector<int> row_start, col_idx;
+    std::vector<T> values;
+    std::vector<T> rhs;
+
+    void reset(int num_rows, int num_threads, int num_parts)
     {
-        A.resize(cols);
-        rhs.resize(rows);
+        if (num_rows != rows) {
+            row_start.clear();
+            col_idx.clear();
+        }
+        rows = num_rows;
+        threads = std::max(1, num_threads);
+        parts = std::max(1, num_parts);
+        for (auto *buckets : {&stamped, &stamped_rhs}) {
+            buckets->resize(parts);
+            for (auto &part : *buckets) {
+                part.resize(threads);
+                for (auto &bucket : part)
+                    bucket.clear();
+            }
+        }
     }
 
-    // Simple sparse format, easy to convert to CCS for solver
-    std::vector<std::vector<std::pair<int, T>>> A; // col -> (row, x[row, col]) sorted by row
-    std::vector<T> rhs;                            // RHS vector
-    void reset()
+    int num_chunks() const { return (rows + chunk_rows - 1) / chunk_rows; }
+    int chunk_begin(int t) const { return int((int64_t(num_chunks()) * t) / threads); }
+    int range_begin(int t) const { return std::min(rows, chunk_begin(t) * chunk_rows); }
+
+    int range_of(int row) const
     {
-        for (auto &col : A)
-            col.clear();
-        std::fill(rhs.begin(), rhs.end(), T());
+        // Find the range owning this row, allowing for rounding in range_begin
+        int t = std::min(threads - 1, int((int64_t(row) * threads) / std::max(1, rows)));
+        while (t > 0 && row < range_begin(t))
+            --t;
+        while (t < threads - 1 && row >= range_begin(t + 1))
+            ++t;
+        return t;
     }
 
-    void add_coeff(int row, int col, T val)
+    void add_coeff(int part, int row, int col, T val) { stamped[part][range_of(row)].push_back(Coeff{row, col, val}); }
+
+    void add_rhs(int part, int row, T val) { stamped_rhs[part][range_of(row)].push_back(Coeff{row, -1, val}); }
+
+    // Sum the stamped coefficients of a row range into the existing pattern; returns false if any falls outside
+    bool accumulate_range(int t)
     {
-        auto &Ac = A.at(col);
-        // Binary search
-        int b = 0, e = int(Ac.size()) - 1;
-        while (b <= e) {
-            int i = (b + e) / 2;
-            if (Ac.at(i).first == row) {
-                Ac.at(i).second += val;
-                return;
+        int begin = range_begin(t), end = range_begin(t + 1);
+        std::fill(values.begin() + row_start.at(begin), values.begin() + row_start.at(end), T());
+        for (int part = 0; part < parts; part++) {
+            for (auto &c : stamped[part][t]) {
+                auto row_b = col_idx.begin() + row_start[c.row], row_e = col_idx.begin() + row_start[c.row + 1];
+                auto found = std::lower_bound(row_b, row_e, c.col);
+                if (found == row_e || *found != c.col)
+                    return false;
+                values[found - col_idx.begin()] += c.val;
             }
-            if (Ac.at(i).first > row)
-                e = i - 1;
-            else
-                b = i + 1;
         }
-        Ac.insert(Ac.begin() + b, std::make_pair(row, val));
+        std::fill(rhs.begin() + begin, rhs.begin() + end, T());
+        for (int part = 0; part < parts; part++)
+            for (auto &c : stamped_rhs[part][t])
+                rhs[c.row] += c.val;
+        return true;
     }
 
-    void add_rhs(int row, T val) { rhs[row] += val; }
+    // Convert the stamped coefficients into the CSR matrix and RHS vector
+    void finalise()
+    {
+        rhs.resize(rows);
+        std::vector<char> missed(threads, 0);
+        if (!row_start.empty()) {
+            run_threads(threads, [&](int t) { missed[t] = !accumulate_range(t); });
+            if (std::none_of(missed.begin(), missed.end(), [](char m) { return m; }))
+                return;
+        }
+
+        // Recompute the pattern. Each range finds its (row, col) pairs, sorted, and then these are concatenated
+        std::vector<std::vector<int>> range_cols(threads);
+        std::vector<int> row_nnz(rows, 0);
+        run_threads(threads, [&](int t) {
+            std::vector<std::pair<int, int>> entries;
+            for (int part = 0; part < parts; part++)
+                for (auto &c : stamped[part][t])
+                    entries.emplace_back(c.row, c.col);
+            std::sort(entries.begin(), entries.end());
+            entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+            for (auto &e : entries) {
+                range_cols[t].push_back(e.second);
+                row_nnz[e.first]++;
+            }
+        });
+        row_start.assign(rows + 1, 0);
+        for (int row = 0; row < rows; row++)
+            row_start[row + 1] = row_start[row] + row_nnz[row];
+        col_idx.resize(row_start[rows]);
+        values.resize(row_start[rows]);
+        run_threads(threads, [&](int t) {
+            std::copy(range_cols[t].begin(), range_cols[t].end(), col_idx.begin() + row_start[range_begin(t)]);
+            bool ok = accumulate_range(t);
+            NPNR_ASSERT(ok);
+        });
+    }
 
-    void solve(std::vector<T> &x, float tolerance)
+    // Jacobi-preconditioned conjugate gradient, with the rows split across threads. Dot products are summed
+    // per chunk and then over the chunks in order, so results do not depend on the number of threads.
+    // Returns the number of iterations.
+    int solve(std::vector<T> &x, float tolerance)
     {
-        using namespace Eigen;
         if (x.empty())
-            return;
-        NPNR_ASSERT(x.size() == A.size());
-
-        VectorXd vx(x.size()), vb(rhs.size());
-        SparseMatrix<T> mat(A.size(), A.size());
-
-        std::vector<int> colnnz;
-        for (auto &Ac : A)
-            colnnz.push_back(int(Ac.size()));
-        mat.reserve(colnnz);
-        for (int col = 0; col < int(A.size()); col++) {
-            auto &Ac = A.at(col);
-            for (auto &el : Ac)
-                mat.insert(el.first, col) = el.second;
-        }
+            return 0;
+        NPNR_ASSERT(int(x.size()) == rows);
+        int n = rows;
+
+        std::vector<T> r(n), z(n), p(n), q(n), inv_diag(n);
+        std::vector<T> part_pq(num_chunks()), part_rr(num_chunks()), part_rz(num_chunks()), part_bb(num_chunks());
+        ThreadBarrier barrier(threads);
+        int max_iters = 2 * n;
+        int iterations = 0;
+
+        run_threads(threads, [&](int t) {
+            int begin = range_begin(t), end = range_begin(t + 1);
+            auto sum_parts = [&](const std::vector<T> &chunks) {
+                T sum = T();
+                for (auto v : chunks)
+                    sum += v;
+                return sum;
+            };
+            auto mul_row = [&](const std::vector<T> &v, int row) {
+                T sum = T();
+                for (int i = row_start[row]; i < row_start[row + 1]; i++)
+                    sum += values[i] * v[col_idx[i]];
+                return sum;
+            };
+
+            int chunk_lo = chunk_begin(t), chunk_hi = chunk_begin(t + 1);
+            auto chunk_end = [&](int c) { return std::min(n, (c + 1) * chunk_rows); };
+
+            for (int c = chunk_lo; c < chunk_hi; c++) {
+                T rr = T(), rz = T(), bb = T();
+                for (int row = c * chunk_rows; row < chunk_end(c); row++) {
+                    T diag = T();
+                    for (int i = row_start[row]; i < row_start[row + 1]; i++)
+                        if (col_idx[i] == row)
+                            diag = values[i];
+                    inv_diag[row] = (diag != T()) ? T(1) / diag : T(1);
+                    r[row] = rhs[row] - mul_row(x, row);
+                    z[row] = inv_diag[row] * r[row];
+                    p[row] = z[row];
+                    rr += r[row] * r[row];
+                    rz += r[row] * z[row];
+                    bb += rhs[row] * rhs[row];
+                }
+                part_rr[c] = rr;
+                part_rz[c] = rz;
+                part_bb[c] = bb;
+            }
+            barrier.wait();
+
+            T rhs_norm2 = sum_parts(part_bb);
+            if (rhs_norm2 == T()) {
+                std::fill(x.begin() + begin, x.begin() + end, T());
+                return;
+            }
+            T threshold = std::max<T>(T(tolerance) * T(tolerance) * rhs_norm2, std::numeric_limits<T>::min());
+            T resid_norm2 = sum_parts(part_rr);
+            T abs_new = sum_parts(part_rz);
+            for (int iter = 0; resid_norm2 >= threshold && iter < max_iters; iter++) {
+                if (t == 0)
+                    iterations = iter + 1;
+                // All of p must be updated before any thread multiplies by it
+                barrier.wait();
+                for (int c = chunk_lo; c < chunk_hi; c++) {
+                    T pq = T();
+                    for (int row = c * chunk_rows; row < chunk_end(c); row++) {
+                        q[row] = mul_row(p, row);
+                        pq += p[row] * q[row];
+                    }
+                    part_pq[c] = pq;
+                }
+                barrier.wait();
+
+                T alpha = abs_new / sum_parts(part_pq);
+                for (int c = chunk_lo; c < chunk_hi; c++) {
+                    T rr = T(), rz = T();
+                    for (int row = c * chunk_rows; row < chunk_end(c); row++) {
+                        x[row] += alpha * p[row];
+                        r[row] -= alpha * q[row];
+                        z[row] = inv_diag[row] * r[row];
+                        rr += r[row] * r[row];
+                        rz += r[row] * z[row];
+                    }
+                    part_rr[c] = rr;
+                    part_rz[c] = rz;
+                }
+                barrier.wait();
 
-        for (int i = 0; i < int(x.size()); i++)
-            vx[i] = x.at(i);
-        for (int i = 0; i < int(rhs.size()); i++)
-            vb[i] = rhs.at(i);
-
-        ConjugateGradient<SparseMatrix<T>, Lower | Upper> solver;
-        solver.setTolerance(tolerance);
-        VectorXd xr = solver.compute(mat).solveWithGuess(vb, vx);
-        for (int i = 0; i < int(x.size()); i++)
-            x.at(i) = xr[i];
-        // for (int i = 0; i < int(x.size()); i++)
-        //    log_info("x[%d] = %f\n", i, x.at(i));
+                resid_norm2 = sum_parts(part_rr);
+                if (resid_norm2 < threshold)
+                    break;
+                T abs_old = abs_new;
+                abs_new = sum_parts(part_rz);
+                T beta = abs_new / abs_old;
+                for (int row = begin; row < end; row++)
+                    p[row] = z[row] + beta * p[row];
+            }
+        });
+        return iterations;
     }
 };
 
@@ -137,10 +338,11 @@ template <typename T> struct EquationSystem
 class HeAPPlacer
 {
   public:
-    HeAPPlacer(Context *ctx, PlacerHeapCfg cfg) : ctx(ctx), cfg(cfg) { Eigen::initParallel(); }
+    HeAPPlacer(Context *ctx, PlacerHeapCfg cfg) : ctx(ctx), cfg(cfg) {}
 
     bool place()
     {
+        NPNR_TRACE_SCOPE("heap");
         auto startt = std::chrono::high_resolution_clock::now();
 
         ctx->lock();
@@ -148,6 +350,8 @@ class HeAPPlacer
         build_fast_bels();
         seed_placement();
         update_all_chains();
+        if (cfg.timing_driven)
+            setup_timing_analyser(ctx);
         wirelen_t hpwl = total_hpwl();
         log_info("Creating initial analytic placement for %d cells, random placement wirelen = %d.\n",
                  int(place_cells.size()), int(hpwl));
@@ -155,11 +359,12 @@ class HeAPPlacer
             setup_solve_cells();
             auto solve_startt = std::chrono::high_resolution_clock::now();
 #ifdef NPNR_DISABLE_THREADS
-            build_solve_direction(false, -1);
-            build_solve_direction(true, -1);
+            build_solve_direction(false, -1, 1);
+            build_solve_direction(true, -1, 1);
 #else
-            boost::thread xaxis([&]() { build_solve_direction(false, -1); });
-            build_solve_direction(true, -1);
+            int threads = axis_threads(true);
+            boost::thread xaxis([&]() { build_solve_direction(false, -1, threads); });
+            build_solve_direction(true, -1, threads);
             xaxis.join();
 #endif
             auto solve_endt = std::chrono::high_resolution_clock::now();
@@ -209,6 +414,7 @@ class HeAPPlacer
         while (stalled < 5 && (solved_hpwl <= legal_hpwl * 0.8)) {
             // Alternate between particular Bel types and all bels
             for (auto &run : heap_runs) {
+                NPNR_TRACE_SCOPE("heap/run");
                 auto run_startt = std::chrono::high_resolution_clock::now();
 
                 setup_solve_cells(&run);
@@ -219,14 +425,16 @@ class HeAPPlacer
 
 #ifndef NPNR_DISABLE_THREADS
                 if (solve_cells.size() >= 500) {
-                    boost::thread xaxis([&]() { build_solve_direction(false, (iter == 0) ? -1 : iter); });
-                    build_solve_direction(true, (iter == 0) ? -1 : iter);
+                    int threads = axis_threads(true);
+                    boost::thread xaxis([&]() { build_solve_direction(false, (iter == 0) ? -1 : iter, threads); });
+                    build_solve_direction(true, (iter == 0) ? -1 : iter, threads);
                     xaxis.join();
                 } else
 #endif
                 {
-                    build_solve_direction(false, (iter == 0) ? -1 : iter);
-                    build_solve_direction(true, (iter == 0) ? -1 : iter);
+                    int threads = axis_threads(false);
+                    build_solve_direction(false, (iter == 0) ? -1 : iter, threads);
+                    build_solve_direction(true, (iter == 0) ? -1 : iter, threads);
                 }
                 auto solve_endt = std::chrono::high_resolution_clock::now();
                 solve_time += std::chrono::duration<double>(solve_endt - solve_startt).count();
@@ -249,6 +457,7 @@ class HeAPPlacer
                 update_all_chains();
 
                 legal_hpwl = total_hpwl();
+                trace_counter("heap/legal_hpwl", double(legal_hpwl));
                 auto run_stopt = std::chrono::high_resolution_clock::now();
                 log_info("    at iteration #%d, type %s: wirelen solved = %d, spread = %d, legal = %d; time = %.02fs\n",
                          iter + 1, (run.size() > 1 ? "ALL" : run.begin()->c_str(ctx)), int(solved_hpwl),
@@ -311,6 +520,9 @@ class HeAPPlacer
         }
 
         ctx->unlock();
+        ctx->work_counters["placer/heap_iterations"] += iter;
+        ctx->work_counters["placer/solver_iterations"] += solver_iterations;
+        ctx->work_counters["placer/cells_legalised"] += cells_legalised;
         auto endtt = std::chrono::high_resolution_clock::now();
         log_info("HeAP Placer Time: %.02fs\n", std::chrono::duration<double>(endtt - startt).count());
         log_info("  of which solving equations: %.02fs\n", solve_time);
@@ -462,6 +674,12 @@ class HeAPPlacer
 
     // Performance counting
     double solve_time = 0, cl_time = 0, sl_time = 0;
+    // Work counters; the two axes are solved on different threads
+    std::atomic<int64_t> solver_iterations{0};
+    int64_t cells_legalised = 0;
+
+    // Equation systems for each axis, kept between solves so that their sparsity patterns can be reused
+    EquationSystem<double> es_x, es_y;
 
     NetCriticalityMap net_crit;
 
@@ -596,13 +814,23 @@ class HeAPPlacer
         }
     }
 
+    // Number of threads for building and solving the equations of one axis. When both axes are solved at
+    // once, each gets half of the threads
+    int axis_threads(bool both_axes)
+    {
+        int threads = both_axes ? std::max(1, cfg.threads / 2) : cfg.threads;
+        return std::max(1, std::min(threads, int(solve_cells.size()) / cfg.minRowsPerThread));
+    }
+
     // Build and solve in one direction
-    void build_solve_direction(bool yaxis, int iter)
+    void build_solve_direction(bool yaxis, int iter, int threads)
     {
+        NPNR_TRACE_SCOPE("heap/solve");
+        EquationSystem<double> &es = yaxis ? es_y : es_x;
         for (int i = 0; i < 5; i++) {
-            EquationSystem<double> esx(solve_cells.size(), solve_cells.size());
-            build_equations(esx, yaxis, iter);
-            solve_equations(esx, yaxis);
+            es.reset(int(solve_cells.size()), threads, 2 * threads);
+            build_equations(es, yaxis, iter);
+            solve_equations(es, yaxis);
         }
     }
 
@@ -749,98 +977,107 @@ class HeAPPlacer
             return yaxis ? cell_locs.at(cell->name).legal_y : cell_locs.at(cell->name).legal_x;
         };
 
-        es.reset();
-
-        for (auto net : sorted(ctx->nets)) {
-            NetInfo *ni = net.second;
-            if (ni->driver.cell == nullptr)
-                continue;
-            // Ignore constant cells for now
-            if (ni->driver.cell->type == ctx->id("VCC") ||
-                ni->driver.cell->type == ctx->id("GND") ||
-                ni->driver.cell->type == ctx->id("$nextpnr_ibuf"))
-              continue;
-            if (ni->users.empty())
-                continue;
-            if (cell_locs.at(ni->driver.cell->name).global)
-                continue;
-            // Find the bounds of the net in this axis, and the ports that correspond to these bounds
-            PortRef *lbport = nullptr, *ubport = nullptr;
-            int lbpos = std::numeric_limits<int>::max(), ubpos = std::numeric_limits<int>::min();
-            foreach_port(ni, [&](PortRef &port, int user_idx) {
-                int pos = cell_pos(port.cell);
-                if (pos < lbpos) {
-                    lbpos = pos;
-                    lbport = &port;
-                }
-                if (pos > ubpos) {
-                    ubpos = pos;
-                    ubport = &port;
-                }
-            });
-            NPNR_ASSERT(lbport != nullptr);
-            NPNR_ASSERT(ubport != nullptr);
-
-            auto stamp_equation = [&](PortRef &var, PortRef &eqn, double weight) {
-                if (eqn.cell->udata == dont_solve)
-                    return;
-                int row = eqn.cell->udata;
-                int v_pos = cell_pos(var.cell);
-                if (var.cell->udata != dont_solve) {
-                    es.add_coeff(row, var.cell->udata, weight);
-                } else {
-                    es.add_rhs(row, -v_pos * weight);
-                }
-                if (cell_offsets.count(var.cell->name)) {
-                    es.add_rhs(row, -(yaxis ? cell_offsets.at(var.cell->name).second
-                                            : cell_offsets.at(var.cell->name).first) *
-                                            weight);
-                }
-            };
+        std::vector<NetInfo *> nets;
+        for (auto net : sorted(ctx->nets))
+            nets.push_back(net.second);
+
+        // Each thread stamps the equations for a contiguous slice of nets into part t, and the legalisation arcs
+        // for a slice of rows into part threads + t; so taken in part order, all stamps are in net and then row
+        // order whatever the number of threads
+        run_threads(es.threads, [&](int part) {
+            for (size_t i = nets.size() * part / es.threads; i < nets.size() * (part + 1) / es.threads; i++) {
+                NetInfo *ni = nets.at(i);
+                if (ni->driver.cell == nullptr)
+                    continue;
+                // Ignore constant cells for now
+                if (ni->driver.cell->type == ctx->id("VCC") ||
+                    ni->driver.cell->type == ctx->id("GND") ||
+                    ni->driver.cell->type == ctx->id("$nextpnr_ibuf"))
+                  continue;
+                if (ni->users.empty())
+                    continue;
+                if (cell_locs.at(ni->driver.cell->name).global)
+                    continue;
+                // Find the bounds of the net in this axis, and the ports that correspond to these bounds
+                PortRef *lbport = nullptr, *ubport = nullptr;
+                int lbpos = std::numeric_limits<int>::max(), ubpos = std::numeric_limits<int>::min();
+                foreach_port(ni, [&](PortRef &port, int user_idx) {
+                    int pos = cell_pos(port.cell);
+                    if (pos < lbpos) {
+                        lbpos = pos;
+                        lbport = &port;
+                    }
+                    if (pos > ubpos) {
+                        ubpos = pos;
+                        ubport = &port;
+                    }
+                });
+                NPNR_ASSERT(lbport != nullptr);
+                NPNR_ASSERT(ubport != nullptr);
 
-            // Add all relevant connections to the matrix
-            foreach_port(ni, [&](PortRef &port, int user_idx) {
-                int this_pos = cell_pos(port.cell);
-                auto process_arc = [&](PortRef *other) {
-                    if (other == &port)
+                auto stamp_equation = [&](PortRef &var, PortRef &eqn, double weight) {
+                    if (eqn.cell->udata == dont_solve)
                         return;
-                    int o_pos = cell_pos(other->cell);
-                    double weight = 1.0 / (ni->users.size() *
-                                           std::max<double>(1, (yaxis ? cfg.hpwl_scale_y : cfg.hpwl_scale_x) *
-                                                                       std::abs(o_pos - this_pos)));
-
-                    if (user_idx != -1 && net_crit.count(ni->name)) {
-                        auto &nc = net_crit.at(ni->name);
-                        if (user_idx < int(nc.criticality.size()))
-                            weight *= (1.0 + cfg.timingWeight *
-                                                     std::pow(nc.criticality.at(user_idx), cfg.criticalityExponent));
+                    int row = eqn.cell->udata;
+                    int v_pos = cell_pos(var.cell);
+                    if (var.cell->udata != dont_solve) {
+                        es.add_coeff(part, row, var.cell->udata, weight);
+                    } else {
+                        es.add_rhs(part, row, -v_pos * weight);
+                    }
+                    if (cell_offsets.count(var.cell->name)) {
+                        es.add_rhs(part, row,
+                                   -(yaxis ? cell_offsets.at(var.cell->name).second
+                                           : cell_offsets.at(var.cell->name).first) *
+                                           weight);
                     }
-
-                    // If cell 0 is not fixed, it will stamp +w on its equation and -w on the other end's equation,
-                    // if the other end isn't fixed
-                    stamp_equation(port, port, weight);
-                    stamp_equation(port, *other, -weight);
-                    stamp_equation(*other, *other, weight);
-                    stamp_equation(*other, port, -weight);
                 };
-                process_arc(lbport);
-                process_arc(ubport);
-            });
-        }
-        if (iter != -1) {
-            float alpha = cfg.alpha;
-            for (size_t row = 0; row < solve_cells.size(); row++) {
-                int l_pos = legal_pos(solve_cells.at(row));
-                int c_pos = cell_pos(solve_cells.at(row));
-
-                double weight =
-                        alpha * iter /
-                        std::max<double>(1, (yaxis ? cfg.hpwl_scale_y : cfg.hpwl_scale_x) * std::abs(l_pos - c_pos));
-                // Add an arc from legalised to current position
-                es.add_coeff(row, row, weight);
-                es.add_rhs(row, weight * l_pos);
+
+                // Add all relevant connections to the matrix
+                foreach_port(ni, [&](PortRef &port, int user_idx) {
+                    int this_pos = cell_pos(port.cell);
+                    auto process_arc = [&](PortRef *other) {
+                        if (other == &port)
+                            return;
+                        int o_pos = cell_pos(other->cell);
+                        double weight = 1.0 / (ni->users.size() *
+                                               std::max<double>(1, (yaxis ? cfg.hpwl_scale_y : cfg.hpwl_scale_x) *
+                                                                           std::abs(o_pos - this_pos)));
+
+                        if (user_idx != -1 && net_crit.count(ni->name)) {
+                            auto &nc = net_crit.at(ni->name);
+                            if (user_idx < int(nc.criticality.size()))
+                                weight *= (1.0 + cfg.timingWeight * std::pow(nc.criticality.at(user_idx),
+                                                                             cfg.criticalityExponent));
+                        }
+
+                        // If cell 0 is not fixed, it will stamp +w on its equation and -w on the other end's
+                        // equation, if the other end isn't fixed
+                        stamp_equation(port, port, weight);
+                        stamp_equation(port, *other, -weight);
+                        stamp_equation(*other, *other, weight);
+                        stamp_equation(*other, port, -weight);
+                    };
+                    process_arc(lbport);
+                    process_arc(ubport);
+                });
             }
-        }
+            if (iter != -1) {
+                float alpha = cfg.alpha;
+                for (size_t row = solve_cells.size() * part / es.threads;
+                     row < solve_cells.size() * (part + 1) / es.threads; row++) {
+                    int l_pos = legal_pos(solve_cells.at(row));
+                    int c_pos = cell_pos(solve_cells.at(row));
+
+                    double weight = alpha * iter / std::max<double>(1, (yaxis ? cfg.hpwl_scale_y : cfg.hpwl_scale_x) *
+                                                                               std::abs(l_pos - c_pos));
+                    // Add an arc from legalised to current position
+                    es.add_coeff(es.threads + part, row, row, weight);
+                    es.add_rhs(es.threads + part, row, weight * l_pos);
+                }
+            }
+        });
+        es.finalise();
     }
 
     // Build the system of equations for either X or Y
@@ -850,7 +1087,7 @@ class HeAPPlacer
         auto cell_pos = [&](CellInfo *cell) { return yaxis ? cell_locs.at(cell->name).y : cell_locs.at(cell->name).x; };
         std::vector<double> vals;
         std::transform(solve_cells.begin(), solve_cells.end(), std::back_inserter(vals), cell_pos);
-        es.solve(vals, cfg.solverTolerance);
+        solver_iterations += es.solve(vals, cfg.solverTolerance);
         for (size_t i = 0; i < vals.size(); i++)
             if (yaxis) {
                 cell_locs.at(solve_cells.at(i)->name).rawy = vals.at(i);
@@ -896,356 +1133,519 @@ class HeAPPlacer
         return hpwl;
     }
 
-    // Strict placement legalisation, performed after the initial HeAP spreading
-    void legalise_placement_strict(bool require_validity = false)
+    // The cells being legalised together, and the part of the device they may be placed in
+    struct LegaliseState
     {
-        auto startt = std::chrono::high_resolution_clock::now();
-
-        // Unbind all cells placed in this solution
-        for (auto cell : sorted(ctx->cells)) {
-            CellInfo *ci = cell.second;
-            if (ci->bel != BelId() && (ci->udata != dont_solve ||
-                                       (chain_root.count(ci->name) && chain_root.at(ci->name)->udata != dont_solve)))
-                ctx->unbindBel(ci->bel);
-        }
-
-        // At the moment we don't follow the full HeAP algorithm using cuts for legalisation, instead using
-        // the simple greedy largest-macro-first approach.
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        // Windows are legalised in parallel, and only ever bind bels within their own bounds
+        bool windowed = false;
+        DeterministicRNG window_rng;
+        DeterministicRNG *rng = nullptr;
         std::priority_queue<std::pair<int, IdString>> remaining;
-        for (auto cell : solve_cells) {
-            remaining.emplace(chain_size[cell->name], cell->name);
-        }
+        int num_cells = 0;
         int ripup_radius = 2;
         int total_iters = 0;
         int total_iters_noreset = 0;
-        while (!remaining.empty()) {
-            auto top = remaining.top();
-            remaining.pop();
+        // Windows only: legalised cells in the order they were placed, whose locations are applied once all windows
+        // are done
+        std::vector<CellInfo *> moved;
+        // Windows only: cells that could not be placed in the window, left to the final pass
+        std::vector<CellInfo *> deferred;
+        // Windows only: per bel type, whether the window contains any such bels (-1 if not yet known)
+        std::vector<int> has_bels;
+    };
 
-            CellInfo *ci = ctx->cells.at(top.second).get();
-            std::cout << "Legalizing cell " << ci->name.str(ctx) << '\n';
-            // Was now placed, ignore
-            if (ci->bel != BelId()) {
-                std::cout << "already placed!\n";
-                continue;
-            }
-            // log_info("   Legalising %s (%s)\n", top.second.c_str(ctx), ci->type.c_str(ctx));
-            int bt = std::get<0>(bel_types.at(ci->type));
-            auto &fb = fast_bels.at(bt);
-            int radius = 0;
-            int iter = 0;
-            int iter_at_radius = 0;
-            bool placed = false;
-            BelId bestBel;
-            int best_inp_len = std::numeric_limits<int>::max();
-
-            total_iters++;
-            total_iters_noreset++;
-            if (total_iters > int(solve_cells.size())) {
-                total_iters = 0;
-                ripup_radius = std::max(std::max(max_x, max_y), ripup_radius * 2);
-            }
+    // Legalisation windows are about this many tiles across, and never smaller than min_window_size
+    static const int window_size = 16;
+    static const int min_window_size = 8;
 
-            if (total_iters_noreset > std::max(5000, 8 * int(ctx->cells.size()))) {
-                log_error("Unable to find legal placement for all cells, design is probably at utilisation limit.\n");
-            }
+    int chain_size_of(IdString cell) const
+    {
+        auto found = chain_size.find(cell);
+        return found == chain_size.end() ? 0 : found->second;
+    }
+
+    void set_legal_loc(LegaliseState &st, CellInfo *ci, Loc loc)
+    {
+        if (st.windowed) {
+            st.moved.push_back(ci);
+        } else {
+            cell_locs.at(ci->name).x = loc.x;
+            cell_locs.at(ci->name).y = loc.y;
+        }
+    }
 
-            while (!placed) {
+    // Chains and region-constrained cells may need bels outside any one window, and the arch may have cell types
+    // whose legalisation binds other cells, so these are only legalised in the final pass
+    bool can_legalise_in_window(LegaliseState &st, CellInfo *ci)
+    {
+        if (ci->region != nullptr || ci->constr_parent != nullptr || !ci->constr_children.empty() ||
+            ci->constr_abs_z || cfg.serialLegaliseTypes.count(ci->type))
+            return false;
+        int bt = std::get<0>(bel_types.at(ci->type));
+        if (bt >= int(st.has_bels.size()))
+            st.has_bels.resize(bt + 1, -1);
+        if (st.has_bels.at(bt) == -1) {
+            auto &fb = fast_bels.at(bt);
+            st.has_bels.at(bt) = 0;
+            for (int x = st.x0; x <= std::min(st.x1, int(fb.size()) - 1); x++)
+                for (int y = st.y0; y <= std::min(st.y1, int(fb.at(x).size()) - 1); y++)
+                    if (!fb.at(x).at(y).empty())
+                        st.has_bels.at(bt) = 1;
+        }
+        return st.has_bels.at(bt) == 1;
+    }
 
-                // Set a conservative timeout
-                if (iter > std::max(10000, 3 * int(ctx->cells.size())))
-                    log_error("Unable to find legal placement for cell '%s', check constraints and utilisation.\n",
-                              ctx->nameOf(ci));
+    // Find a legal bel for a cell, within the bounds of the given state. Returns false if a window gave up on
+    // the cell; the final pass over the whole device either places the cell or fails with an error.
+    bool legalise_cell(LegaliseState &st, CellInfo *ci, bool require_validity)
+    {
+        int bt = std::get<0>(bel_types.at(ci->type));
+        auto &fb = fast_bels.at(bt);
+        int radius = 0;
+        int iter = 0;
+        int iter_at_radius = 0;
+        bool placed = false;
+        BelId bestBel;
+        int best_inp_len = std::numeric_limits<int>::max();
+
+        // Search around the target location, clamped into the area this state may place into
+        int cx = std::min(st.x1, std::max(st.x0, cell_locs.at(ci->name).x));
+        int cy = std::min(st.y1, std::max(st.y0, cell_locs.at(ci->name).y));
+        int span = std::max(st.x1 - st.x0, st.y1 - st.y0);
+
+        st.total_iters++;
+        st.total_iters_noreset++;
+        if (st.total_iters > st.num_cells) {
+            st.total_iters = 0;
+            st.ripup_radius = std::max(span, st.ripup_radius * 2);
+        }
+
+        if (st.windowed && st.total_iters_noreset > std::max(1000, 8 * st.num_cells))
+            return false;
+        if (st.total_iters_noreset > std::max(5000, 8 * int(ctx->cells.size()))) {
+            log_error("Unable to find legal placement for all cells, design is probably at utilisation limit.\n");
+        }
 
-                int rx = radius, ry = radius;
+        int tries = 0;
+        while (!placed) {
+
+            // Set a conservative timeout. Within a window, give up much sooner and leave the cell to the final pass
+            if (st.windowed && ++tries > std::max(1000, 3 * st.num_cells))
+                return false;
+            if (iter > std::max(10000, 3 * int(ctx->cells.size())))
+                log_error("Unable to find legal placement for cell '%s', check constraints and utilisation.\n",
+                          ctx->nameOf(ci));
+
+            int rx = radius, ry = radius;
+
+            if (ci->region != nullptr) {
+                rx = std::min(radius, (constraint_region_bounds[ci->region->name].x1 -
+                                       constraint_region_bounds[ci->region->name].x0) /
+                                                      2 +
+                                              1);
+                ry = std::min(radius, (constraint_region_bounds[ci->region->name].y1 -
+                                       constraint_region_bounds[ci->region->name].y0) /
+                                                      2 +
+                                              1);
+            }
 
-                if (ci->region != nullptr) {
-                    rx = std::min(radius, (constraint_region_bounds[ci->region->name].x1 -
-                                           constraint_region_bounds[ci->region->name].x0) /
-                                                          2 +
-                                                  1);
-                    ry = std::min(radius, (constraint_region_bounds[ci->region->name].y1 -
-                                           constraint_region_bounds[ci->region->name].y0) /
-                                                          2 +
-                                                  1);
-                }
+            int nx = st.rng->rng(2 * rx + 1) + std::max(cx - rx, st.x0);
+            int ny = st.rng->rng(2 * ry + 1) + std::max(cy - ry, st.y0);
 
-                int nx = ctx->rng(2 * rx + 1) + std::max(cell_locs.at(ci->name).x - rx, 0);
-                int ny = ctx->rng(2 * ry + 1) + std::max(cell_locs.at(ci->name).y - ry, 0);
-
-                iter++;
-                iter_at_radius++;
-                if (iter >= (10 * (radius + 1))) {
-                    radius = std::min(std::max(max_x, max_y), radius + 1);
-                    while (radius < std::max(max_x, max_y)) {
-                        for (int x = std::max(0, cell_locs.at(ci->name).x - radius);
-                             x <= std::min(max_x, cell_locs.at(ci->name).x + radius); x++) {
-                            if (x >= int(fb.size()))
+            iter++;
+            iter_at_radius++;
+            if (iter >= (10 * (radius + 1))) {
+                radius = std::min(span, radius + 1);
+                while (radius < span) {
+                    for (int x = std::max(st.x0, cx - radius); x <= std::min(st.x1, cx + radius); x++) {
+                        if (x >= int(fb.size()))
+                            break;
+                        for (int y = std::max(st.y0, cy - radius); y <= std::min(st.y1, cy + radius); y++) {
+                            if (y >= int(fb.at(x).size()))
                                 break;
-                            for (int y = std::max(0, cell_locs.at(ci->name).y - radius);
-                                 y <= std::min(max_y, cell_locs.at(ci->name).y + radius); y++) {
-                                if (y >= int(fb.at(x).size()))
-                                    break;
-                                if (fb.at(x).at(y).size() > 0)
-                                    goto notempty;
-                            }
+                            if (fb.at(x).at(y).size() > 0)
+                                goto notempty;
                         }
-                        radius = std::min(std::max(max_x, max_y), radius + 1);
                     }
-                notempty:
-                    iter_at_radius = 0;
-                    iter = 0;
+                    radius = std::min(span, radius + 1);
                 }
-                if (nx < 0 || nx > max_x)
-                    continue;
-                if (ny < 0 || ny > max_y)
-                    continue;
+            notempty:
+                iter_at_radius = 0;
+                iter = 0;
+            }
+            if (nx < st.x0 || nx > st.x1)
+                continue;
+            if (ny < st.y0 || ny > st.y1)
+                continue;
 
-                // ny = nearest_row_with_bel.at(bt).at(ny);
-                // nx = nearest_col_with_bel.at(bt).at(nx);
+            // ny = nearest_row_with_bel.at(bt).at(ny);
+            // nx = nearest_col_with_bel.at(bt).at(nx);
 
-                if (nx >= int(fb.size()))
-                    continue;
-                if (ny >= int(fb.at(nx).size()))
-                    continue;
-                if (fb.at(nx).at(ny).empty())
-                    continue;
+            if (nx >= int(fb.size()))
+                continue;
+            if (ny >= int(fb.at(nx).size()))
+                continue;
+            if (fb.at(nx).at(ny).empty())
+                continue;
 
-                int need_to_explore = 2 * radius;
+            int need_to_explore = 2 * radius;
 
-                if (iter_at_radius >= need_to_explore && bestBel != BelId()) {
-                    CellInfo *bound = ctx->getBoundBelCell(bestBel);
-                    if (bound != nullptr) {
-                        ctx->unbindBel(bound->bel);
-                        remaining.emplace(chain_size[bound->name], bound->name);
-                    }
-                    ctx->bindBel(bestBel, ci, STRENGTH_WEAK);
-                    placed = true;
-                    Loc loc = ctx->getBelLocation(bestBel);
-                    cell_locs[ci->name].x = loc.x;
-                    cell_locs[ci->name].y = loc.y;
-                    break;
+            if (iter_at_radius >= need_to_explore && bestBel != BelId()) {
+                CellInfo *bound = ctx->getBoundBelCell(bestBel);
+                if (bound != nullptr) {
+                    ctx->unbindBel(bound->bel);
+                    st.remaining.emplace(chain_size_of(bound->name), bound->name);
                 }
+                ctx->bindBel(bestBel, ci, STRENGTH_WEAK);
+                placed = true;
+                set_legal_loc(st, ci, ctx->getBelLocation(bestBel));
+                break;
+            }
 
-                if (ci->constr_children.empty() && !ci->constr_abs_z) {
-                    for (auto sz : fb.at(nx).at(ny)) {
-                        if (ci->region != nullptr && ci->region->constr_bels && !ci->region->bels.count(sz))
-                            continue;
-                        if (ctx->checkBelAvail(sz) || (radius > ripup_radius || ctx->rng(20000) < 10)) {
-                            CellInfo *bound = ctx->getBoundBelCell(sz);
-                            if (bound != nullptr) {
-                                if (bound->constr_parent != nullptr || !bound->constr_children.empty() ||
-                                    bound->constr_abs_z)
+            if (ci->constr_children.empty() && !ci->constr_abs_z) {
+                for (auto sz : fb.at(nx).at(ny)) {
+                    if (ci->region != nullptr && ci->region->constr_bels && !ci->region->bels.count(sz))
+                        continue;
+                    if (ctx->checkBelAvail(sz) || (radius > st.ripup_radius || st.rng->rng(20000) < 10)) {
+                        CellInfo *bound = ctx->getBoundBelCell(sz);
+                        if (bound != nullptr) {
+                            if (bound->constr_parent != nullptr || !bound->constr_children.empty() ||
+                                bound->constr_abs_z)
+                                continue;
+                            ctx->unbindBel(bound->bel);
+                        }
+                        ctx->bindBel(sz, ci, STRENGTH_WEAK);
+                        if (require_validity && !ctx->isBelLocationValid(sz)) {
+                            ctx->unbindBel(sz);
+                            if (bound != nullptr)
+                                ctx->bindBel(sz, bound, STRENGTH_WEAK);
+                        } else if (iter_at_radius < need_to_explore) {
+                            ctx->unbindBel(sz);
+                            if (bound != nullptr)
+                                ctx->bindBel(sz, bound, STRENGTH_WEAK);
+                            int input_len = 0;
+                            for (auto &port : ci->ports) {
+                                auto &p = port.second;
+                                if (p.type != PORT_IN || p.net == nullptr || p.net->driver.cell == nullptr)
+                                    continue;
+                                CellInfo *drv = p.net->driver.cell;
+                                auto drv_loc = cell_locs.find(drv->name);
+                                if (drv_loc == cell_locs.end())
+                                    continue;
+                                if (drv_loc->second.global)
                                     continue;
-                                ctx->unbindBel(bound->bel);
+                                input_len += std::abs(drv_loc->second.x - nx) + std::abs(drv_loc->second.y - ny);
                             }
-                            ctx->bindBel(sz, ci, STRENGTH_WEAK);
-                            if (require_validity && !ctx->isBelLocationValid(sz)) {
-                                ctx->unbindBel(sz);
-                                if (bound != nullptr)
-                                    ctx->bindBel(sz, bound, STRENGTH_WEAK);
-                            } else if (iter_at_radius < need_to_explore) {
-                                ctx->unbindBel(sz);
-                                if (bound != nullptr)
-                                    ctx->bindBel(sz, bound, STRENGTH_WEAK);
-                                int input_len = 0;
-                                for (auto &port : ci->ports) {
-                                    auto &p = port.second;
-                                    if (p.type != PORT_IN || p.net == nullptr || p.net->driver.cell == nullptr)
-                                        continue;
-                                    CellInfo *drv = p.net->driver.cell;
-                                    auto drv_loc = cell_locs.find(drv->name);
-                                    if (drv_loc == cell_locs.end())
-                                        continue;
-                                    if (drv_loc->second.global)
-                                        continue;
-                                    input_len += std::abs(drv_loc->second.x - nx) + std::abs(drv_loc->second.y - ny);
-                                }
-                                if (input_len < best_inp_len) {
-                                    best_inp_len = input_len;
-                                    bestBel = sz;
-                                }
-                                break;
-                            } else {
-                                if (bound != nullptr)
-                                    remaining.emplace(chain_size[bound->name], bound->name);
-                                Loc loc = ctx->getBelLocation(sz);
-                                cell_locs[ci->name].x = loc.x;
-                                cell_locs[ci->name].y = loc.y;
-                                placed = true;
-                                break;
+                            if (input_len < best_inp_len) {
+                                best_inp_len = input_len;
+                                bestBel = sz;
                             }
+                            break;
+                        } else {
+                            if (bound != nullptr)
+                                st.remaining.emplace(chain_size_of(bound->name), bound->name);
+                            set_legal_loc(st, ci, ctx->getBelLocation(sz));
+                            placed = true;
+                            break;
                         }
                     }
-                } else {
-                    for (auto sz : fb.at(nx).at(ny)) {
-                        Loc loc = ctx->getBelLocation(sz);
-                        if (ci->constr_abs_z && loc.z != ci->constr_z)
-                            continue;
-                        std::vector<std::pair<CellInfo *, BelId>> targets;
-                        std::vector<std::pair<BelId, CellInfo *>> swaps_made;
-                        std::queue<std::pair<CellInfo *, Loc>> visit;
-                        visit.emplace(ci, loc);
-                        while (!visit.empty()) {
-                            CellInfo *vc = visit.front().first;
-                            NPNR_ASSERT(vc->bel == BelId());
-                            Loc ploc = visit.front().second;
-                            visit.pop();
-                            BelId target = ctx->getBelByLocation(ploc);
-                            if (vc->region != nullptr && vc->region->constr_bels && !vc->region->bels.count(target))
-                                goto fail;
-                            CellInfo *bound;
-                            if (target == BelId() || ctx->getBelType(target) != vc->type)
+                }
+            } else {
+                for (auto sz : fb.at(nx).at(ny)) {
+                    Loc loc = ctx->getBelLocation(sz);
+                    if (ci->constr_abs_z && loc.z != ci->constr_z)
+                        continue;
+                    std::vector<std::pair<CellInfo *, BelId>> targets;
+                    std::vector<std::pair<BelId, CellInfo *>> swaps_made;
+                    std::queue<std::pair<CellInfo *, Loc>> visit;
+                    visit.emplace(ci, loc);
+                    while (!visit.empty()) {
+                        CellInfo *vc = visit.front().first;
+                        NPNR_ASSERT(vc->bel == BelId());
+                        Loc ploc = visit.front().second;
+                        visit.pop();
+                        BelId target = ctx->getBelByLocation(ploc);
+                        if (vc->region != nullptr && vc->region->constr_bels && !vc->region->bels.count(target))
+                            goto fail;
+                        CellInfo *bound;
+                        if (target == BelId() || ctx->getBelType(target) != vc->type)
+                            goto fail;
+                        bound = ctx->getBoundBelCell(target);
+                        // Chains cannot overlap
+                        if (bound != nullptr)
+                            if (bound->constr_z != bound->UNCONSTR || bound->constr_parent != nullptr ||
+                                !bound->constr_children.empty() || bound->belStrength > STRENGTH_WEAK)
                                 goto fail;
-                            bound = ctx->getBoundBelCell(target);
-                            // Chains cannot overlap
-                            if (bound != nullptr)
-                                if (bound->constr_z != bound->UNCONSTR || bound->constr_parent != nullptr ||
-                                    !bound->constr_children.empty() || bound->belStrength > STRENGTH_WEAK)
-                                    goto fail;
-                            targets.emplace_back(vc, target);
-                            for (auto child : vc->constr_children) {
-                                Loc cloc = ploc;
-                                if (child->constr_x != child->UNCONSTR)
-                                    cloc.x += child->constr_x;
-                                if (child->constr_y != child->UNCONSTR)
-                                    cloc.y += child->constr_y;
-                                if (child->constr_z != child->UNCONSTR)
-                                    cloc.z = child->constr_abs_z ? child->constr_z : (ploc.z + child->constr_z);
-                                visit.emplace(child, cloc);
-                            }
+                        targets.emplace_back(vc, target);
+                        for (auto child : vc->constr_children) {
+                            Loc cloc = ploc;
+                            if (child->constr_x != child->UNCONSTR)
+                                cloc.x += child->constr_x;
+                            if (child->constr_y != child->UNCONSTR)
+                                cloc.y += child->constr_y;
+                            if (child->constr_z != child->UNCONSTR)
+                                cloc.z = child->constr_abs_z ? child->constr_z : (ploc.z + child->constr_z);
+                            visit.emplace(child, cloc);
                         }
+                    }
 
-                        for (auto &target : targets) {
-                            CellInfo *bound = ctx->getBoundBelCell(target.second);
-                            if (bound != nullptr)
-                                ctx->unbindBel(target.second);
-                            ctx->bindBel(target.second, target.first, STRENGTH_STRONG);
-                            swaps_made.emplace_back(target.second, bound);
-                        }
+                    for (auto &target : targets) {
+                        CellInfo *bound = ctx->getBoundBelCell(target.second);
+                        if (bound != nullptr)
+                            ctx->unbindBel(target.second);
+                        ctx->bindBel(target.second, target.first, STRENGTH_STRONG);
+                        swaps_made.emplace_back(target.second, bound);
+                    }
 
-                        for (auto &sm : swaps_made) {
-                            if (!ctx->isBelLocationValid(sm.first))
-                                goto fail;
-                        }
+                    for (auto &sm : swaps_made) {
+                        if (!ctx->isBelLocationValid(sm.first))
+                            goto fail;
+                    }
 
-                        if (false) {
-                        fail:
-                            for (auto &swap : swaps_made) {
-                                ctx->unbindBel(swap.first);
-                                if (swap.second != nullptr)
-                                    ctx->bindBel(swap.first, swap.second, STRENGTH_WEAK);
-                            }
-                            continue;
-                        }
-                        for (auto &target : targets) {
-                            Loc loc = ctx->getBelLocation(target.second);
-                            cell_locs[target.first->name].x = loc.x;
-                            cell_locs[target.first->name].y = loc.y;
-                            // log_info("%s %d %d %d\n", target.first->name.c_str(ctx), loc.x, loc.y, loc.z);
-                        }
+                    if (false) {
+                    fail:
                         for (auto &swap : swaps_made) {
+                            ctx->unbindBel(swap.first);
                             if (swap.second != nullptr)
-                                remaining.emplace(chain_size[swap.second->name], swap.second->name);
+                                ctx->bindBel(swap.first, swap.second, STRENGTH_WEAK);
                         }
-
-                        placed = true;
-                        break;
+                        continue;
+                    }
+                    for (auto &target : targets) {
+                        set_legal_loc(st, target.first, ctx->getBelLocation(target.second));
+                        // log_info("%s %d %d %d\n", target.first->name.c_str(ctx), loc.x, loc.y, loc.z);
+                    }
+                    for (auto &swap : swaps_made) {
+                        if (swap.second != nullptr)
+                            st.remaining.emplace(chain_size_of(swap.second->name), swap.second->name);
                     }
+
+                    placed = true;
+                    break;
                 }
             }
+        }
+        return true;
+    }
 
-            if (ci->type == ctx->id("LUT4")) {
-                // Enforce LUT->LUT connections (S44) into correct z positions
-                // LUT0 (1) -> LUT1 (0), LUT2 (3) -> LUT3 (2), LUT4 (5) -> LUT5 (4), LUT6 (7) -> LUT7 (6)
-
-                Loc loc = ctx->getBelLocation(ci->bel);
-                BelId newBel;
-
-                PortInfo &port_i0 = ci->ports.at(ctx->id("I0"));
-                CellInfo *drv_i0 = port_i0.net->driver.cell;
-                if (drv_i0->type == ctx->id("LUT4")) {
-                    cell_locs[drv_i0->name].x = loc.x;
-                    cell_locs[drv_i0->name].y = loc.y;
-                    if (loc.z % 2 == 1) {
-                        //ctx->unbindBel(ctx->getBelByLocation(loc));
-                        //ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, loc.z - 1)), ci, STRENGTH_FIXED);
-                        //ctx->bindBel(ctx->getBelByLocation(loc), drv_i0, STRENGTH_FIXED);
-                    } else {
-                        //ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, loc.z + 1)), drv_i0, STRENGTH_FIXED);
-                    }
+    // Fix up the placement of cells connected to a cell that was legalised at bel_loc
+    void apply_legalisation_hooks(CellInfo *ci, Loc bel_loc)
+    {
+        if (ci->type == ctx->id("LUT4")) {
+            // Enforce LUT->LUT connections (S44) into correct z positions
+            // LUT0 (1) -> LUT1 (0), LUT2 (3) -> LUT3 (2), LUT4 (5) -> LUT5 (4), LUT6 (7) -> LUT7 (6)
+
+            Loc loc = bel_loc;
+            BelId newBel;
+
+            PortInfo &port_i0 = ci->ports.at(ctx->id("I0"));
+            CellInfo *drv_i0 = port_i0.net->driver.cell;
+            if (drv_i0->type == ctx->id("LUT4")) {
+                cell_locs[drv_i0->name].x = loc.x;
+                cell_locs[drv_i0->name].y = loc.y;
+                if (loc.z % 2 == 1) {
+                    //ctx->unbindBel(ctx->getBelByLocation(loc));
+                    //ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, loc.z - 1)), ci, STRENGTH_FIXED);
+                    //ctx->bindBel(ctx->getBelByLocation(loc), drv_i0, STRENGTH_FIXED);
+                } else {
+                    //ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, loc.z + 1)), drv_i0, STRENGTH_FIXED);
                 }
             }
+        }
+
+        if (ci->type == ctx->id("CARRY4")) {
+            // Enforce LUT->CARRY4 connections into correct z positions
+            Loc loc = bel_loc;
+            BelId newBel;
+
+            PortInfo &port_p0 = ci->ports.at(ctx->id("P[0]"));
+            CellInfo *drv_p0 = port_p0.net->driver.cell;
+            NPNR_ASSERT(drv_p0->type == ctx->id("LUT4"));
+            cell_locs[drv_p0->name].x = loc.x;
+            cell_locs[drv_p0->name].y = loc.y;
+            // LUT1
+            ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 0)), drv_p0, STRENGTH_FIXED);
+
+            PortInfo &port_p1 = ci->ports.at(ctx->id("P[1]"));
+            CellInfo *drv_p1 = port_p1.net->driver.cell;
+            NPNR_ASSERT(drv_p1->type == ctx->id("LUT4"));
+            cell_locs[drv_p1->name].x = loc.x;
+            cell_locs[drv_p1->name].y = loc.y;
+            // LUT3
+            ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 2)), drv_p1, STRENGTH_FIXED);
+
+            PortInfo &port_p2 = ci->ports.at(ctx->id("P[2]"));
+            CellInfo *drv_p2 = port_p2.net->driver.cell;
+            NPNR_ASSERT(drv_p2->type == ctx->id("LUT4"));
+            cell_locs[drv_p2->name].x = loc.x;
+            cell_locs[drv_p2->name].y = loc.y;
+            // LUT5
+            ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 4)), drv_p2, STRENGTH_FIXED);
+
+            PortInfo &port_p3 = ci->ports.at(ctx->id("P[3]"));
+            CellInfo *drv_p3 = port_p3.net->driver.cell;
+            NPNR_ASSERT(drv_p3->type == ctx->id("LUT4"));
+            cell_locs[drv_p3->name].x = loc.x;
+            cell_locs[drv_p3->name].y = loc.y;
+            // LUT7
+            ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 6)), drv_p3, STRENGTH_FIXED);
+
+            PortInfo &port_g0 = ci->ports.at(ctx->id("G[0]"));
+            CellInfo *drv_g0 = port_g0.net->driver.cell;
+            NPNR_ASSERT(drv_g0->type == ctx->id("LUT4"));
+            cell_locs[drv_g0->name].x = loc.x;
+            cell_locs[drv_g0->name].y = loc.y;
+            // LUT0
+            ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 1)), drv_g0, STRENGTH_FIXED);
+
+            PortInfo &port_g1 = ci->ports.at(ctx->id("G[1]"));
+            CellInfo *drv_g1 = port_g1.net->driver.cell;
+            NPNR_ASSERT(drv_g1->type == ctx->id("LUT4"));
+            cell_locs[drv_g1->name].x = loc.x;
+            cell_locs[drv_g1->name].y = loc.y;
+            // LUT2
+            ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 3)), drv_g1, STRENGTH_FIXED);
+
+            PortInfo &port_g2 = ci->ports.at(ctx->id("G[2]"));
+            CellInfo *drv_g2 = port_g2.net->driver.cell;
+            NPNR_ASSERT(drv_g2->type == ctx->id("LUT4"));
+            cell_locs[drv_g2->name].x = loc.x;
+            cell_locs[drv_g2->name].y = loc.y;
+            // LUT4
+            ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 5)), drv_g2, STRENGTH_FIXED);
+
+            PortInfo &port_g3 = ci->ports.at(ctx->id("G[3]"));
+            CellInfo *drv_g3 = port_g3.net->driver.cell;
+            NPNR_ASSERT(drv_g3->type == ctx->id("LUT4"));
+            cell_locs[drv_g3->name].x = loc.x;
+            cell_locs[drv_g3->name].y = loc.y;
+            // LUT6
+            ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 7)), drv_g3, STRENGTH_FIXED);
+        }
+    }
+
+    // Legalise cells in disjoint windows of the device, in parallel. The windows depend only on the grid, each
+    // window only binds bels within it, and has its own RNG seeded in window order; locations are written back in
+    // window order, so the result depends neither on thread timing nor on the number of threads. Returns the
+    // cells still to be placed by the final pass.
+    std::vector<CellInfo *> legalise_windows(const std::vector<CellInfo *> &cells, bool require_validity)
+    {
+        int width = max_x + 1, height = max_y + 1;
+        int nwx = std::max(1, (width + window_size / 2) / window_size);
+        nwx = std::max(1, std::min(width / min_window_size, nwx));
+        int nwy = std::max(1, (height + window_size / 2) / window_size);
+        nwy = std::max(1, std::min(height / min_window_size, nwy));
+        if (nwx * nwy < 2)
+            return cells;
+
+        std::vector<LegaliseState> windows(nwx * nwy);
+        for (int wy = 0; wy < nwy; wy++)
+            for (int wx = 0; wx < nwx; wx++) {
+                auto &st = windows.at(wy * nwx + wx);
+                st.x0 = (width * wx) / nwx;
+                st.x1 = (width * (wx + 1)) / nwx - 1;
+                st.y0 = (height * wy) / nwy;
+                st.y1 = (height * (wy + 1)) / nwy - 1;
+                st.windowed = true;
+                st.window_rng.rngseed(ctx->rng64());
+                st.rng = &st.window_rng;
+            }
+        for (auto cell : cells) {
+            auto &loc = cell_locs.at(cell->name);
+            // The window whose bounds (as computed above) contain the cell
+            int wx = std::min(nwx - 1, ((std::max(0, loc.x) + 1) * nwx - 1) / width);
+            int wy = std::min(nwy - 1, ((std::max(0, loc.y) + 1) * nwy - 1) / height);
+            auto &st = windows.at(wy * nwx + wx);
+            st.remaining.emplace(chain_size_of(cell->name), cell->name);
+            st.num_cells++;
+        }
 
-            if (ci->type == ctx->id("CARRY4")) {
-                // Enforce LUT->CARRY4 connections into correct z positions
+        std::atomic<int> next_window(0);
+        run_threads(std::min(cfg.threads, int(windows.size())), [&](int) {
+            for (int w = next_window++; w < int(windows.size()); w = next_window++) {
+                auto &st = windows.at(w);
+                while (!st.remaining.empty()) {
+                    CellInfo *ci = ctx->cells.at(st.remaining.top().second).get();
+                    st.remaining.pop();
+                    if (ci->bel != BelId())
+                        continue;
+                    if (!can_legalise_in_window(st, ci) || !legalise_cell(st, ci, require_validity))
+                        st.deferred.push_back(ci);
+                }
+            }
+        });
+
+        std::vector<CellInfo *> deferred;
+        std::unordered_set<IdString> seen;
+        for (auto &st : windows) {
+            // A cell that was ripped up by a later swap has several entries; only the last is current, and it
+            // may since have been unbound and deferred
+            std::vector<CellInfo *> final_moves;
+            seen.clear();
+            for (auto it = st.moved.rbegin(); it != st.moved.rend(); ++it)
+                if (seen.insert((*it)->name).second)
+                    final_moves.push_back(*it);
+            std::reverse(final_moves.begin(), final_moves.end());
+            for (auto ci : final_moves) {
+                if (ci->bel == BelId())
+                    continue;
                 Loc loc = ctx->getBelLocation(ci->bel);
-                BelId newBel;
-
-                PortInfo &port_p0 = ci->ports.at(ctx->id("P[0]"));
-                CellInfo *drv_p0 = port_p0.net->driver.cell;
-                NPNR_ASSERT(drv_p0->type == ctx->id("LUT4"));
-                cell_locs[drv_p0->name].x = loc.x;
-                cell_locs[drv_p0->name].y = loc.y;
-                // LUT1
-                ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 0)), drv_p0, STRENGTH_FIXED);
-
-                PortInfo &port_p1 = ci->ports.at(ctx->id("P[1]"));
-                CellInfo *drv_p1 = port_p1.net->driver.cell;
-                NPNR_ASSERT(drv_p1->type == ctx->id("LUT4"));
-                cell_locs[drv_p1->name].x = loc.x;
-                cell_locs[drv_p1->name].y = loc.y;
-                // LUT3
-                ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 2)), drv_p1, STRENGTH_FIXED);
-
-                PortInfo &port_p2 = ci->ports.at(ctx->id("P[2]"));
-                CellInfo *drv_p2 = port_p2.net->driver.cell;
-                NPNR_ASSERT(drv_p2->type == ctx->id("LUT4"));
-                cell_locs[drv_p2->name].x = loc.x;
-                cell_locs[drv_p2->name].y = loc.y;
-                // LUT5
-                ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 4)), drv_p2, STRENGTH_FIXED);
-
-                PortInfo &port_p3 = ci->ports.at(ctx->id("P[3]"));
-                CellInfo *drv_p3 = port_p3.net->driver.cell;
-                NPNR_ASSERT(drv_p3->type == ctx->id("LUT4"));
-                cell_locs[drv_p3->name].x = loc.x;
-                cell_locs[drv_p3->name].y = loc.y;
-                // LUT7
-                ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 6)), drv_p3, STRENGTH_FIXED);
-
-                PortInfo &port_g0 = ci->ports.at(ctx->id("G[0]"));
-                CellInfo *drv_g0 = port_g0.net->driver.cell;
-                NPNR_ASSERT(drv_g0->type == ctx->id("LUT4"));
-                cell_locs[drv_g0->name].x = loc.x;
-                cell_locs[drv_g0->name].y = loc.y;
-                // LUT0
-                ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 1)), drv_g0, STRENGTH_FIXED);
-
-                PortInfo &port_g1 = ci->ports.at(ctx->id("G[1]"));
-                CellInfo *drv_g1 = port_g1.net->driver.cell;
-                NPNR_ASSERT(drv_g1->type == ctx->id("LUT4"));
-                cell_locs[drv_g1->name].x = loc.x;
-                cell_locs[drv_g1->name].y = loc.y;
-                // LUT2
-                ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 3)), drv_g1, STRENGTH_FIXED);
-
-                PortInfo &port_g2 = ci->ports.at(ctx->id("G[2]"));
-                CellInfo *drv_g2 = port_g2.net->driver.cell;
-                NPNR_ASSERT(drv_g2->type == ctx->id("LUT4"));
-                cell_locs[drv_g2->name].x = loc.x;
-                cell_locs[drv_g2->name].y = loc.y;
-                // LUT4
-                ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 5)), drv_g2, STRENGTH_FIXED);
-
-                PortInfo &port_g3 = ci->ports.at(ctx->id("G[3]"));
-                CellInfo *drv_g3 = port_g3.net->driver.cell;
-                NPNR_ASSERT(drv_g3->type == ctx->id("LUT4"));
-                cell_locs[drv_g3->name].x = loc.x;
-                cell_locs[drv_g3->name].y = loc.y;
-                // LUT6
-                ctx->bindBel(ctx->getBelByLocation(Loc(loc.x, loc.y, 7)), drv_g3, STRENGTH_FIXED);
+                cell_locs.at(ci->name).x = loc.x;
+                cell_locs.at(ci->name).y = loc.y;
+                apply_legalisation_hooks(ci, loc);
+            }
+            for (auto ci : st.deferred)
+                if (ci->bel == BelId())
+                    deferred.push_back(ci);
+        }
+        return deferred;
+    }
+
+    // Strict placement legalisation, performed after the initial HeAP spreading
+    void legalise_placement_strict(bool require_validity = false)
+    {
+        NPNR_TRACE_SCOPE("heap/legalise");
+        auto startt = std::chrono::high_resolution_clock::now();
+
+        // Unbind all cells placed in this solution
+        for (auto cell : sorted(ctx->cells)) {
+            CellInfo *ci = cell.second;
+            if (ci->bel != BelId() && (ci->udata != dont_solve ||
+                                       (chain_root.count(ci->name) && chain_root.at(ci->name)->udata != dont_solve)))
+                ctx->unbindBel(ci->bel);
+        }
+
+        // At the moment we don't follow the full HeAP algorithm using cuts for legalisation, instead using
+        // the simple greedy largest-macro-first approach. For larger designs, most cells are first legalised in
+        // parallel windows, leaving only the rest to the serial pass over the whole device.
+        cells_legalised += solve_cells.size();
+        std::vector<CellInfo *> to_place = solve_cells;
+        if (int(solve_cells.size()) >= cfg.minWindowCells)
+            to_place = legalise_windows(solve_cells, require_validity);
+
+        LegaliseState st;
+        st.x1 = max_x;
+        st.y1 = max_y;
+        st.rng = ctx;
+        st.num_cells = int(solve_cells.size());
+        for (auto cell : to_place) {
+            st.remaining.emplace(chain_size_of(cell->name), cell->name);
+        }
+        while (!st.remaining.empty()) {
+            auto top = st.remaining.top();
+            st.remaining.pop();
+
+            CellInfo *ci = ctx->cells.at(top.second).get();
+            std::cout << "Legalizing cell " << ci->name.str(ctx) << '\n';
+            // Was now placed, ignore
+            if (ci->bel != BelId()) {
+                std::cout << "already placed!\n";
+                continue;
             }
+            // log_info("   Legalising %s (%s)\n", top.second.c_str(ctx), ci->type.c_str(ctx));
+            legalise_cell(st, ci, require_validity);
+            apply_legalisation_hooks(ci, ctx->getBelLocation(ci->bel));
         }
 
         auto endt = std::chrono::high_resolution_clock::now();
@@ -1257,8 +1657,10 @@ class HeAPPlacer
     {
         if (reg == nullptr)
             return val;
-        int limit_low = dir ? constraint_region_bounds[reg->name].y0 : constraint_region_bounds[reg->name].x0;
-        int limit_high = dir ? constraint_region_bounds[reg->name].y1 : constraint_region_bounds[reg->name].x1;
+        // Called from spreader threads, so must not insert
+        auto &bounds = constraint_region_bounds.at(reg->name);
+        int limit_low = dir ? bounds.y0 : bounds.x0;
+        int limit_high = dir ? bounds.y1 : bounds.x1;
         return std::max<T>(std::min<T>(val, limit_high), limit_low);
     }
 
@@ -1302,6 +1704,7 @@ class HeAPPlacer
         static int seq;
         void run()
         {
+            NPNR_TRACE_SCOPE("heap/spread");
             auto startt = std::chrono::high_resolution_clock::now();
             init();
             find_overused_regions();
@@ -1314,13 +1717,13 @@ class HeAPPlacer
 #endif
             }
             expand_regions();
-            std::queue<std::pair<int, bool>> workqueue;
 #if 0
             std::vector<std::pair<double, double>> orig;
             if (ctx->debug)
                 for (auto c : p->solve_cells)
                     orig.emplace_back(p->cell_locs[c->name].rawx, p->cell_locs[c->name].rawy);
 #endif
+            std::vector<int> roots;
             for (auto &r : regions) {
                 if (merged_regions.count(r.id))
                     continue;
@@ -1331,29 +1734,15 @@ class HeAPPlacer
                 }
 
 #endif
-                workqueue.emplace(r.id, false);
-                // cut_region(r, false);
-            }
-            while (!workqueue.empty()) {
-                auto front = workqueue.front();
-                workqueue.pop();
-                auto &r = regions.at(front.first);
-                if (std::all_of(r.cells.begin(), r.cells.end(), [](int x) { return x == 0; }))
-                    continue;
-                auto res = cut_region(r, front.second);
-                if (res) {
-                    workqueue.emplace(res->first, !front.second);
-                    workqueue.emplace(res->second, !front.second);
-                } else {
-                    // Try the other dir, in case stuck in one direction only
-                    auto res2 = cut_region(r, !front.second);
-                    if (res2) {
-                        // log_info("RETRY SUCCESS\n");
-                        workqueue.emplace(res2->first, front.second);
-                        workqueue.emplace(res2->second, front.second);
-                    }
-                }
+                roots.push_back(r.id);
             }
+            // The expanded regions are disjoint, and cutting a region only ever touches the cells and locations
+            // inside it, so each region is cut independently; the result does not depend on the order they run in
+            std::atomic<int> next_root(0);
+            run_threads(std::min(p->cfg.threads, int(roots.size())), [&](int) {
+                for (int i = next_root++; i < int(roots.size()); i = next_root++)
+                    cut_recursively(regions.at(roots.at(i)));
+            });
 #if 0
             if (ctx->debug) {
                 std::ofstream sp("spread" + std::to_string(seq) + ".csv");
@@ -1659,9 +2048,42 @@ class HeAPPlacer
         // Implementation of the recursive cut-based spreading as described in the HeAP paper
         // Note we use "left" to mean "-x/-y" depending on dir and "right" to mean "+x/+y" depending on dir
 
-        std::vector<CellInfo *> cut_cells;
+        // Cut a region, and then the regions produced by cutting it, until no further cuts can be made
+        void cut_recursively(const SpreaderRegion &root)
+        {
+            // Subregions are numbered within this root only, as are the cuts of other roots on other threads
+            std::vector<SpreaderRegion> subregions;
+            subregions.push_back(root);
+            subregions.back().id = 0;
+            std::vector<CellInfo *> cut_cells;
+            std::queue<std::pair<int, bool>> workqueue;
+            workqueue.emplace(0, false);
+            while (!workqueue.empty()) {
+                auto front = workqueue.front();
+                workqueue.pop();
+                // Copied, as cutting adds to subregions
+                SpreaderRegion r = subregions.at(front.first);
+                if (std::all_of(r.cells.begin(), r.cells.end(), [](int x) { return x == 0; }))
+                    continue;
+                auto res = cut_region(r, front.second, subregions, cut_cells);
+                if (res) {
+                    workqueue.emplace(res->first, !front.second);
+                    workqueue.emplace(res->second, !front.second);
+                } else {
+                    // Try the other dir, in case stuck in one direction only
+                    auto res2 = cut_region(r, !front.second, subregions, cut_cells);
+                    if (res2) {
+                        // log_info("RETRY SUCCESS\n");
+                        workqueue.emplace(res2->first, front.second);
+                        workqueue.emplace(res2->second, front.second);
+                    }
+                }
+            }
+        }
 
-        boost::optional<std::pair<int, int>> cut_region(SpreaderRegion &r, bool dir)
+        boost::optional<std::pair<int, int>> cut_region(const SpreaderRegion &r, bool dir,
+                                                        std::vector<SpreaderRegion> &subregions,
+                                                        std::vector<CellInfo *> &cut_cells)
         {
             cut_cells.clear();
             auto &cal = cells_at_location;
@@ -1902,28 +2324,22 @@ class HeAPPlacer
                 // log_info("spread pos %d %d\n", cl.x, cl.y);
             }
             SpreaderRegion rl, rr;
-            rl.id = int(regions.size());
+            rl.id = int(subregions.size());
             rl.x0 = r.x0;
             rl.y0 = r.y0;
             rl.x1 = dir ? r.x1 : best_tgt_cut;
             rl.y1 = dir ? best_tgt_cut : r.y1;
             rl.cells = left_cells_v;
             rl.bels = left_bels_v;
-            rr.id = int(regions.size()) + 1;
+            rr.id = int(subregions.size()) + 1;
             rr.x0 = dir ? r.x0 : (best_tgt_cut + 1);
             rr.y0 = dir ? (best_tgt_cut + 1) : r.y0;
             rr.x1 = r.x1;
             rr.y1 = r.y1;
             rr.cells = right_cells_v;
             rr.bels = right_bels_v;
-            regions.push_back(rl);
-            regions.push_back(rr);
-            for (int x = rl.x0; x <= rl.x1; x++)
-                for (int y = rl.y0; y <= rl.y1; y++)
-                    groups.at(x).at(y) = rl.id;
-            for (int x = rr.x0; x <= rr.x1; x++)
-                for (int y = rr.y0; y <= rr.y1; y++)
-                    groups.at(x).at(y) = rr.id;
+            subregions.push_back(rl);
+            subregions.push_back(rr);
             return std::make_pair(rl.id, rr.id);
         };
     };
@@ -1943,6 +2359,13 @@ PlacerHeapCfg::PlacerHeapCfg(Context *ctx)
     timing_driven = ctx->setting<bool>("timing_driven");
     solverTolerance = 1e-5;
     placeAllAtOnce = true;
+#ifdef NPNR_DISABLE_THREADS
+    threads = 1;
+#else
+    threads = ctx->setting<int>("placerHeap/threads", std::max(1, int(boost::thread::hardware_concurrency())));
+#endif
+    minRowsPerThread = std::max(1, ctx->setting<int>("placerHeap/minRowsPerThread", 1000));
+    minWindowCells = ctx->setting<int>("placerHeap/minWindowCells", 1000);
 
     hpwl_scale_x = 1;
     hpwl_scale_y = 1;
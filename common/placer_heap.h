@@ -41,12 +41,21 @@ struct PlacerHeapCfg
     bool timing_driven;
     float solverTolerance;
     bool placeAllAtOnce;
+    // Number of threads for building and solving the equation systems
+    int threads;
+    // Below this many cells per thread, building and solving equations is not worth splitting further
+    int minRowsPerThread;
+    // Below this many cells, strict legalisation is not worth splitting into windows
+    int minWindowCells;
 
     int hpwl_scale_x, hpwl_scale_y;
     int spread_scale_x, spread_scale_y;
 
     // These cell types will be randomly locked to prevent singular matrices
     std::unordered_set<IdString> ioBufTypes;
+    // Legalising these cell types also binds other cells (see apply_legalisation_hooks), so they are never
+    // legalised in parallel windows
+    std::unordered_set<IdString> serialLegaliseTypes;
     // These cell types are part of the same unit (e.g. slices split into
     // components) so will always be spread together
     std::vector<std::unordered_set<IdString>> cellGroups;
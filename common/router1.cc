@@ -17,6 +17,7 @@
  *
  */
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <queue>
@@ -25,6 +26,7 @@
 #include "log.h"
 #include "router1.h"
 #include "timing.h"
+#include "trace.h"
 
 namespace {
 
@@ -92,31 +94,174 @@ struct QueuedWire
     };
 };
 
+// Search state of a wire, valid for the arc being routed if visit_gen matches Router1::visit_gen
+struct WireVisit
+{
+    QueuedWire qw;
+    uint32_t visit_gen = 0;
+    // Position in Router1::queue, or -1 once the wire has been popped
+    int heap_pos = -1;
+};
+
 struct Router1
 {
     Context *ctx;
     const Router1Cfg &cfg;
 
     std::priority_queue<arc_entry, std::vector<arc_entry>, arc_entry::Less> arc_queue;
-    std::unordered_map<WireId, std::unordered_set<arc_key, arc_key::Hash>> wire_to_arcs;
-    std::unordered_map<arc_key, std::unordered_set<WireId>, arc_key::Hash> arc_to_wires;
-    std::unordered_set<arc_key, arc_key::Hash> queued_arcs;
 
-    std::unordered_map<WireId, QueuedWire> visited;
-    std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> queue;
+    // Nets are numbered by udata for the lifetime of the router, and the arcs of a net are numbered consecutively
+    // from net_arc_base[net->udata]
+    std::vector<decltype(NetInfo::udata)> old_udata;
+    std::vector<int> net_arc_base;
+    std::vector<arc_key> arcs;
+
+    // Indexed by ctx->getWireIndex() and by arc number; both are small, so kept as plain vectors
+    std::vector<std::vector<int>> wire_to_arcs;
+    std::vector<std::vector<WireId>> arc_to_wires;
+    std::vector<bool> queued_arcs;
 
-    std::unordered_map<WireId, int> wireScores;
-    std::unordered_map<NetInfo *, int> netScores;
+    // Per-wire A* state. Starting a new search only bumps visit_gen, rather than clearing every visited wire
+    std::vector<WireVisit> visited;
+    uint32_t visit_gen = 0;
+    // Binary min-heap of wire indices, which supports decreasing the cost of a queued wire in place
+    std::vector<int> queue;
+
+    std::vector<int> wireScores;
+    std::vector<int> netScores;
 
     int arcs_with_ripup = 0;
     int arcs_without_ripup = 0;
+    int64_t wires_expanded = 0;
     bool ripup_flag;
 
-    Router1(Context *ctx, const Router1Cfg &cfg) : ctx(ctx), cfg(cfg) {}
+    Router1(Context *ctx, const Router1Cfg &cfg) : ctx(ctx), cfg(cfg)
+    {
+        int num_arcs = 0;
+        for (auto &net : ctx->nets) {
+            NetInfo *ni = net.second.get();
+            old_udata.push_back(ni->udata);
+            ni->udata = int(net_arc_base.size());
+            net_arc_base.push_back(num_arcs);
+            for (int user_idx = 0; user_idx < int(ni->users.size()); user_idx++) {
+                arc_key arc;
+                arc.net_info = ni;
+                arc.user_idx = user_idx;
+                arcs.push_back(arc);
+            }
+            num_arcs += int(ni->users.size());
+        }
+        arc_to_wires.resize(num_arcs);
+        queued_arcs.resize(num_arcs);
+        netScores.resize(net_arc_base.size());
+
+        int num_wires = ctx->getWireIndexCount();
+        wire_to_arcs.resize(num_wires);
+        visited.resize(num_wires);
+        wireScores.resize(num_wires);
+    }
+
+    ~Router1()
+    {
+        ctx->work_counters["router/wires_expanded"] += wires_expanded;
+        ctx->work_counters["router/arcs_routed"] += arcs_with_ripup + arcs_without_ripup;
+        for (auto &net : ctx->nets)
+            net.second->udata = old_udata.at(net.second->udata);
+    }
+
+    int arc_index(const arc_key &arc) const { return net_arc_base.at(arc.net_info->udata) + arc.user_idx; }
+    int wire_index(WireId wire) const { return ctx->getWireIndex(wire); }
+
+    void add_arc_wire(int arc, WireId wire)
+    {
+        auto &wire_arcs = wire_to_arcs.at(wire_index(wire));
+        if (std::find(wire_arcs.begin(), wire_arcs.end(), arc) != wire_arcs.end())
+            return;
+        wire_arcs.push_back(arc);
+        arc_to_wires.at(arc).push_back(wire);
+    }
+
+    // Remove every arc from a wire, returning them; the caller unbinds the wire
+    std::vector<arc_key> take_wire_arcs(WireId wire)
+    {
+        std::vector<arc_key> result;
+        auto &wire_arcs = wire_to_arcs.at(wire_index(wire));
+        for (int arc : wire_arcs) {
+            auto &arc_wires = arc_to_wires.at(arc);
+            auto found = std::find(arc_wires.begin(), arc_wires.end(), wire);
+            NPNR_ASSERT(found != arc_wires.end());
+            *found = arc_wires.back();
+            arc_wires.pop_back();
+            result.push_back(arcs.at(arc));
+        }
+        wire_arcs.clear();
+        return result;
+    }
+
+    bool queue_less(int a, int b) const { return QueuedWire::Greater()(visited[b].qw, visited[a].qw); }
+
+    void queue_sift_up(int pos)
+    {
+        int wire = queue[pos];
+        while (pos > 0) {
+            int parent = (pos - 1) / 2;
+            if (!queue_less(wire, queue[parent]))
+                break;
+            queue[pos] = queue[parent];
+            visited[queue[pos]].heap_pos = pos;
+            pos = parent;
+        }
+        queue[pos] = wire;
+        visited[wire].heap_pos = pos;
+    }
+
+    void queue_sift_down(int pos)
+    {
+        int wire = queue[pos];
+        int size = int(queue.size());
+        while (true) {
+            int child = 2 * pos + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size && queue_less(queue[child + 1], queue[child]))
+                child++;
+            if (!queue_less(queue[child], wire))
+                break;
+            queue[pos] = queue[child];
+            visited[queue[pos]].heap_pos = pos;
+            pos = child;
+        }
+        queue[pos] = wire;
+        visited[wire].heap_pos = pos;
+    }
+
+    // Insert a wire, or move it if it is already queued, after its QueuedWire has been updated
+    void queue_update(int wire)
+    {
+        int pos = visited[wire].heap_pos;
+        if (pos < 0) {
+            queue.push_back(wire);
+            queue_sift_up(int(queue.size()) - 1);
+        } else {
+            queue_sift_up(pos);
+            queue_sift_down(visited[wire].heap_pos);
+        }
+    }
+
+    int queue_pop()
+    {
+        int top = queue.front();
+        visited[top].heap_pos = -1;
+        queue.front() = queue.back();
+        queue.pop_back();
+        if (!queue.empty())
+            queue_sift_down(0);
+        return top;
+    }
 
     void arc_queue_insert(const arc_key &arc, WireId src_wire, WireId dst_wire)
     {
-        if (queued_arcs.count(arc))
+        if (queued_arcs[arc_index(arc)])
             return;
 
         delay_t pri = ctx->estimateDelay(src_wire, dst_wire) - arc.net_info->users[arc.user_idx].budget;
@@ -133,12 +278,12 @@ struct Router1
 #endif
 
         arc_queue.push(entry);
-        queued_arcs.insert(arc);
+        queued_arcs[arc_index(arc)] = true;
     }
 
     void arc_queue_insert(const arc_key &arc)
     {
-        if (queued_arcs.count(arc))
+        if (queued_arcs[arc_index(arc)])
             return;
 
         NetInfo *net_info = arc.net_info;
@@ -161,7 +306,7 @@ struct Router1
 #endif
 
         arc_queue.pop();
-        queued_arcs.erase(entry.arc);
+        queued_arcs[arc_index(entry.arc)] = false;
         return entry.arc;
     }
 
@@ -170,7 +315,7 @@ struct Router1
         if (ctx->debug)
             log("      ripup net %s\n", ctx->nameOf(net));
 
-        netScores[net]++;
+        netScores[net->udata]++;
 
         std::vector<WireId> wires;
         for (auto &it : net->wires)
@@ -179,12 +324,7 @@ struct Router1
         ctx->sorted_shuffle(wires);
 
         for (WireId w : wires) {
-            std::vector<arc_key> arcs;
-            for (auto &it : wire_to_arcs[w]) {
-                arc_to_wires[it].erase(w);
-                arcs.push_back(it);
-            }
-            wire_to_arcs[w].clear();
+            std::vector<arc_key> arcs = take_wire_arcs(w);
 
             ctx->sorted_shuffle(arcs);
 
@@ -195,7 +335,7 @@ struct Router1
                 log("        unbind wire %s\n", ctx->nameOfWire(w));
 
             ctx->unbindWire(w);
-            wireScores[w]++;
+            wireScores[wire_index(w)]++;
         }
 
         ripup_flag = true;
@@ -213,12 +353,7 @@ struct Router1
             if (n != nullptr)
                 ripup_net(n);
         } else {
-            std::vector<arc_key> arcs;
-            for (auto &it : wire_to_arcs[w]) {
-                arc_to_wires[it].erase(w);
-                arcs.push_back(it);
-            }
-            wire_to_arcs[w].clear();
+            std::vector<arc_key> arcs = take_wire_arcs(w);
 
             ctx->sorted_shuffle(arcs);
 
@@ -229,7 +364,7 @@ struct Router1
                 log("      unbind wire %s\n", ctx->nameOfWire(w));
 
             ctx->unbindWire(w);
-            wireScores[w]++;
+            wireScores[wire_index(w)]++;
         }
 
         ripup_flag = true;
@@ -247,12 +382,7 @@ struct Router1
             if (n != nullptr)
                 ripup_net(n);
         } else {
-            std::vector<arc_key> arcs;
-            for (auto &it : wire_to_arcs[w]) {
-                arc_to_wires[it].erase(w);
-                arcs.push_back(it);
-            }
-            wire_to_arcs[w].clear();
+            std::vector<arc_key> arcs = take_wire_arcs(w);
 
             ctx->sorted_shuffle(arcs);
 
@@ -263,7 +393,7 @@ struct Router1
                 log("      unbind wire %s\n", ctx->nameOfWire(w));
 
             ctx->unbindWire(w);
-            wireScores[w]++;
+            wireScores[wire_index(w)]++;
         }
 
         ripup_flag = true;
@@ -322,13 +452,14 @@ struct Router1
                     log("[check]   arc: %s %s\n", ctx->nameOfWire(src_wire), ctx->nameOfWire(dst_wire));
 #endif
 
-                for (WireId wire : arc_to_wires[arc]) {
+                for (WireId wire : arc_to_wires.at(arc_index(arc))) {
 #if 1
                     if (ctx->debug)
                         log("[check]     wire: %s\n", ctx->nameOfWire(wire));
 #endif
                     valid_wires_for_net.insert(wire);
-                    log_assert(wire_to_arcs[wire].count(arc));
+                    auto &wire_arcs = wire_to_arcs.at(wire_index(wire));
+                    log_assert(std::count(wire_arcs.begin(), wire_arcs.end(), arc_index(arc)) == 1);
                     log_assert(net_info->wires.count(wire));
                 }
             }
@@ -339,13 +470,14 @@ struct Router1
             }
         }
 
-        for (auto &it : wire_to_arcs) {
-            for (auto &arc : it.second)
-                log_assert(valid_arcs.count(arc));
+        for (auto &wire_arcs : wire_to_arcs) {
+            for (int arc : wire_arcs)
+                log_assert(valid_arcs.count(arcs.at(arc)));
         }
 
-        for (auto &it : arc_to_wires) {
-            log_assert(valid_arcs.count(it.first));
+        for (int arc = 0; arc < int(arc_to_wires.size()); arc++) {
+            if (!arc_to_wires.at(arc).empty())
+                log_assert(valid_arcs.count(arcs.at(arc)));
         }
     }
 
@@ -413,8 +545,7 @@ struct Router1
                 }
 
                 WireId cursor = dst_wire;
-                wire_to_arcs[cursor].insert(arc);
-                arc_to_wires[arc].insert(cursor);
+                add_arc_wire(arc_index(arc), cursor);
 
                 while (src_wire != cursor) {
                     auto it = net_info->wires.find(cursor);
@@ -425,8 +556,7 @@ struct Router1
 
                     NPNR_ASSERT(it->second.pip != PipId());
                     cursor = ctx->getPipSrcWire(it->second.pip);
-                    wire_to_arcs[cursor].insert(arc);
-                    arc_to_wires[arc].insert(cursor);
+                    add_arc_wire(arc_index(arc), cursor);
                 }
             }
 
@@ -435,7 +565,7 @@ struct Router1
             std::vector<WireId> unbind_wires;
 
             for (auto &it : net_info->wires)
-                if (it.second.strength < STRENGTH_LOCKED && wire_to_arcs.count(it.first) == 0)
+                if (it.second.strength < STRENGTH_LOCKED && wire_to_arcs.at(wire_index(it.first)).empty())
                     unbind_wires.push_back(it.first);
 
             for (auto it : unbind_wires)
@@ -462,13 +592,16 @@ struct Router1
 
         // unbind wires that are currently used exclusively by this arc
 
-        std::unordered_set<WireId> old_arc_wires;
-        old_arc_wires.swap(arc_to_wires[arc]);
+        int arc_idx = arc_index(arc);
+        std::vector<WireId> old_arc_wires;
+        old_arc_wires.swap(arc_to_wires.at(arc_idx));
 
         for (WireId wire : old_arc_wires) {
-            auto &arc_wires = wire_to_arcs.at(wire);
-            NPNR_ASSERT(arc_wires.count(arc));
-            arc_wires.erase(arc);
+            auto &arc_wires = wire_to_arcs.at(wire_index(wire));
+            auto found = std::find(arc_wires.begin(), arc_wires.end(), arc_idx);
+            NPNR_ASSERT(found != arc_wires.end());
+            *found = arc_wires.back();
+            arc_wires.pop_back();
             if (arc_wires.empty()) {
                 if (ctx->debug)
                     log("  unbind %s\n", ctx->nameOfWire(wire));
@@ -478,11 +611,12 @@ struct Router1
 
         // reset wire queue
 
-        if (!queue.empty()) {
-            std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-            queue.swap(new_queue);
+        queue.clear();
+        if (++visit_gen == 0) {
+            for (auto &v : visited)
+                v.visit_gen = 0;
+            visit_gen = 1;
         }
-        visited.clear();
 
         // A* main loop
 
@@ -504,13 +638,15 @@ struct Router1
             }
             qw.randtag = ctx->rng();
 
-            queue.push(qw);
-            visited[qw.wire] = qw;
+            int src_idx = wire_index(src_wire);
+            visited[src_idx].qw = qw;
+            visited[src_idx].visit_gen = visit_gen;
+            visited[src_idx].heap_pos = -1;
+            queue_update(src_idx);
         }
 
         while (visitCnt++ < maxVisitCnt && !queue.empty()) {
-            QueuedWire qw = queue.top();
-            queue.pop();
+            QueuedWire qw = visited[queue_pop()].qw;
 
             //std::cout << "Visiting Wire " << ctx->nameOfPip(qw.wire) << " " << ctx->getPipsDownhill(qw.wire).size() << '\n';
             for (auto pip : ctx->getPipsDownhill(qw.wire)) {
@@ -589,31 +725,23 @@ struct Router1
                         conflictWireNet = nullptr;
 
                     if (conflictWireWire != WireId()) {
-                        auto scores_it = wireScores.find(conflictWireWire);
-                        if (scores_it != wireScores.end())
-                            next_penalty += scores_it->second * cfg.wireRipupPenalty;
+                        next_penalty += wireScores[wire_index(conflictWireWire)] * cfg.wireRipupPenalty;
                         next_penalty += cfg.wireRipupPenalty;
                     }
 
                     if (conflictPipWire != WireId()) {
-                        auto scores_it = wireScores.find(conflictPipWire);
-                        if (scores_it != wireScores.end())
-                            next_penalty += scores_it->second * cfg.wireRipupPenalty;
+                        next_penalty += wireScores[wire_index(conflictPipWire)] * cfg.wireRipupPenalty;
                         next_penalty += cfg.wireRipupPenalty;
                     }
 
                     if (conflictWireNet != nullptr) {
-                        auto scores_it = netScores.find(conflictWireNet);
-                        if (scores_it != netScores.end())
-                            next_penalty += scores_it->second * cfg.netRipupPenalty;
+                        next_penalty += netScores[conflictWireNet->udata] * cfg.netRipupPenalty;
                         next_penalty += cfg.netRipupPenalty;
                         next_penalty += conflictWireNet->wires.size() * cfg.wireRipupPenalty;
                     }
 
                     if (conflictPipNet != nullptr) {
-                        auto scores_it = netScores.find(conflictPipNet);
-                        if (scores_it != netScores.end())
-                            next_penalty += scores_it->second * cfg.netRipupPenalty;
+                        next_penalty += netScores[conflictPipNet->udata] * cfg.netRipupPenalty;
                         next_penalty += cfg.netRipupPenalty;
                         next_penalty += conflictPipNet->wires.size() * cfg.wireRipupPenalty;
                     }
@@ -625,10 +753,11 @@ struct Router1
                 if ((best_score >= 0) && (next_score - next_bonus - cfg.estimatePrecision > best_score))
                     continue;
 
-                auto old_visited_it = visited.find(next_wire);
-                if (old_visited_it != visited.end()) {
-                    delay_t old_delay = old_visited_it->second.delay;
-                    delay_t old_score = old_delay + old_visited_it->second.penalty;
+                int next_idx = wire_index(next_wire);
+                WireVisit &next_visit = visited[next_idx];
+                if (next_visit.visit_gen == visit_gen) {
+                    delay_t old_delay = next_visit.qw.delay;
+                    delay_t old_score = old_delay + next_visit.qw.penalty;
                     NPNR_ASSERT(old_score >= 0);
 
                     if (next_score + ctx->getDelayEpsilon() >= old_score)
@@ -639,7 +768,7 @@ struct Router1
                         log("Found better route to %s. Old vs new delay estimate: %.3f (%.3f) %.3f (%.3f)\n",
                             ctx->nameOfWire(next_wire),
                             ctx->getDelayNS(old_score),
-                            ctx->getDelayNS(old_visited_it->second.delay),
+                            ctx->getDelayNS(next_visit.qw.delay),
                             ctx->getDelayNS(next_score),
                             ctx->getDelayNS(next_delay));
 #endif
@@ -670,8 +799,13 @@ struct Router1
                         ctx->getDelayNS(next_delay));
 #endif
 
-                visited[next_qw.wire] = next_qw;
-                queue.push(next_qw);
+                // A wire that is still queued has its cost lowered in place, rather than being queued twice
+                if (next_visit.visit_gen != visit_gen) {
+                    next_visit.visit_gen = visit_gen;
+                    next_visit.heap_pos = -1;
+                }
+                next_visit.qw = next_qw;
+                queue_update(next_idx);
 
                 if (next_wire == dst_wire) {
                     maxVisitCnt = std::min(maxVisitCnt, 2 * visitCnt + (next_qw.penalty > 0 ? 100 : 0));
@@ -680,31 +814,31 @@ struct Router1
             }
         }
 
+        wires_expanded += visitCnt;
         if (ctx->debug)
             log("  total number of visited nodes: %d\n", visitCnt);
 
-        if (visited.count(dst_wire) == 0) {
+        int dst_idx = wire_index(dst_wire);
+        if (visited[dst_idx].visit_gen != visit_gen) {
             if (ctx->debug)
                 log("  no route found for this arc\n");
             return false;
         }
 
         if (ctx->debug) {
-            log("  final route delay:   %8.2f\n", ctx->getDelayNS(visited[dst_wire].delay));
-            log("  final route penalty: %8.2f\n", ctx->getDelayNS(visited[dst_wire].penalty));
-            log("  final route bonus:   %8.2f\n", ctx->getDelayNS(visited[dst_wire].bonus));
+            log("  final route delay:   %8.2f\n", ctx->getDelayNS(visited[dst_idx].qw.delay));
+            log("  final route penalty: %8.2f\n", ctx->getDelayNS(visited[dst_idx].qw.penalty));
+            log("  final route bonus:   %8.2f\n", ctx->getDelayNS(visited[dst_idx].qw.bonus));
             log("  arc budget:      %12.2f\n", ctx->getDelayNS(net_info->users[user_idx].budget));
         }
 
         // bind resulting route (and maybe unroute other nets)
 
-        std::unordered_set<WireId> unassign_wires = arc_to_wires[arc];
-
         WireId cursor = dst_wire;
         delay_t accumulated_path_delay = 0;
         delay_t last_path_delay_delta = 0;
         while (1) {
-            auto pip = visited[cursor].pip;
+            auto pip = visited[wire_index(cursor)].qw.pip;
 
             if (ctx->debug) {
                 delay_t path_delay_delta = ctx->estimateDelay(cursor, dst_wire) - accumulated_path_delay;
@@ -744,8 +878,7 @@ struct Router1
                 }
             }
 
-            wire_to_arcs[cursor].insert(arc);
-            arc_to_wires[arc].insert(cursor);
+            add_arc_wire(arc_idx, cursor);
 
             if (pip == PipId())
                 break;
@@ -782,6 +915,7 @@ Router1Cfg::Router1Cfg(Context *ctx)
 
 bool router1(Context *ctx, const Router1Cfg &cfg)
 {
+    NPNR_TRACE_SCOPE("router1");
     try {
         log_break();
         log_info("Routing..\n");
@@ -791,7 +925,10 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
         log_info("Setting up routing queue.\n");
 
         Router1 router(ctx, cfg);
-        router.setup();
+        {
+            NPNR_TRACE_SCOPE("router1/setup");
+            router.setup();
+        }
 #ifndef NDEBUG
         router.check();
 #endif
@@ -814,6 +951,7 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
                          router.arcs_without_ripup - last_arcs_without_ripup, int(router.arc_queue.size()),
                          std::chrono::duration<float>(curr_time - prev_time).count(),
                          std::chrono::duration<float>(curr_time - rstart).count());
+                trace_counter("router1/arcs_remaining", double(router.arc_queue.size()));
                 prev_time = curr_time;
                 last_arcs_with_ripup = router.arcs_with_ripup;
                 last_arcs_without_ripup = router.arcs_without_ripup;
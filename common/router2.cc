@@ -28,15 +28,21 @@
 
 #include "router2.h"
 #include <algorithm>
+#include <atomic>
 #include <boost/container/flat_map.hpp>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include "log.h"
 #include "nextpnr.h"
 #include "router1.h"
 #include "timing.h"
+#include "trace.h"
 #include "util.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -63,6 +69,8 @@ struct Router2
         int cx, cy, hpwl;
         int total_route_us = 0;
         float max_crit = 0;
+        // Set once an arc has been routed without the bounding box, so that the net's routing may lie outside it
+        bool outside_bb = false;
     };
 
     struct WireScore
@@ -85,13 +93,20 @@ struct Router2
         bool unavailable = false;
         // This wire has to be used for this net
         int reserved_net = -1;
-        // Visit data
-        struct
-        {
-            bool dirty = false, visited = false;
-            PipId pip;
-            WireScore score;
-        } visit;
+    };
+
+    // Visit data, which is read and written for every wire explored. This is kept
+    // apart from PerWireData so that A* expansion only touches a few cache lines
+    // per wire
+    struct WireVisit
+    {
+        PipId pip;
+        WireScore score;
+        // Backwards frontier of bidirectional search: the pip leaving this wire towards the sink,
+        // and the cost of the path from here to the sink
+        PipId bwd_pip;
+        float bwd_cost = 0;
+        bool dirty = false, visited = false, bwd_visited = false;
     };
 
     float present_wire_cost(const PerWireData &w, int net_uid)
@@ -182,17 +197,20 @@ struct Router2
         }
     }
 
-    std::unordered_map<WireId, int> wire_to_idx;
+    // Both indexed by the Arch dense wire index
     std::vector<PerWireData> flat_wires;
+    std::vector<WireVisit> wire_visit;
 
-    PerWireData &wire_data(WireId w) { return flat_wires[wire_to_idx.at(w)]; }
+    int wire_idx(WireId w) const { return ctx->getWireIndex(w); }
+    PerWireData &wire_data(WireId w) { return flat_wires[wire_idx(w)]; }
 
     void setup_wires()
     {
         // Set up per-wire structures, so that MT parts don't have to do any memory allocation
-        // This is possibly quite wasteful and not cache-optimal; further consideration necessary
+        flat_wires.resize(ctx->getWireIndexCount());
+        wire_visit.resize(ctx->getWireIndexCount());
         for (auto wire : ctx->getWires()) {
-            PerWireData pwd;
+            PerWireData &pwd = wire_data(wire);
             pwd.w = wire;
             NetInfo *bound = ctx->getBoundWireNet(wire);
             if (bound != nullptr) {
@@ -200,8 +218,6 @@ struct Router2
                 if (bound->wires.at(wire).strength > STRENGTH_STRONG)
                     pwd.unavailable = true;
             }
-            wire_to_idx[wire] = int(flat_wires.size());
-            flat_wires.push_back(pwd);
         }
     }
 
@@ -247,6 +263,8 @@ struct Router2
         std::vector<int> route_arcs;
 
         std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> queue;
+        // Backwards frontier of bidirectional A*
+        std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> bwd_queue;
         // Special case where one net has multiple logical arcs to the same physical sink
         std::unordered_set<WireId> processed_sinks;
 
@@ -254,6 +272,12 @@ struct Router2
         std::queue<int> backwards_queue;
 
         std::vector<int> dirty_wires;
+
+        // Wires expanded by forwards and backwards A*, for performance reporting
+        int64_t fwd_expanded = 0, bwd_expanded = 0;
+
+        // Tie-breaks for the A* queues, reseeded for each net (see route_net)
+        DeterministicRNG rng;
     };
 
     enum ArcRouteResult
@@ -343,6 +367,16 @@ struct Router2
         return (ctx->getDelayNS(ctx->estimateDelay(wd.w, sink)) / (1 + source_uses)) + cfg.ipin_cost_adder;
     }
 
+    // Estimated cost from the source to a wire, for the backwards frontier of bidirectional A*
+    float get_togo_cost_bwd(NetInfo *net, int wire, WireId src)
+    {
+        auto &wd = flat_wires[wire];
+        int source_uses = 0;
+        if (wd.bound_nets.count(net->udata))
+            source_uses = wd.bound_nets.at(net->udata).first;
+        return ctx->getDelayNS(ctx->estimateDelay(src, wd.w)) / (1 + source_uses);
+    }
+
     bool check_arc_routing(NetInfo *net, size_t usr)
     {
         auto &ad = nets.at(net->udata).arcs.at(usr);
@@ -420,18 +454,14 @@ struct Router2
 
     void reset_wires(ThreadContext &t)
     {
-        for (auto w : t.dirty_wires) {
-            flat_wires[w].visit.visited = false;
-            flat_wires[w].visit.dirty = false;
-            flat_wires[w].visit.pip = PipId();
-            flat_wires[w].visit.score = WireScore();
-        }
+        for (auto w : t.dirty_wires)
+            wire_visit[w] = WireVisit();
         t.dirty_wires.clear();
     }
 
     void set_visited(ThreadContext &t, int wire, PipId pip, WireScore score)
     {
-        auto &v = flat_wires.at(wire).visit;
+        auto &v = wire_visit[wire];
         if (!v.dirty)
             t.dirty_wires.push_back(wire);
         v.dirty = true;
@@ -439,7 +469,18 @@ struct Router2
         v.pip = pip;
         v.score = score;
     }
-    bool was_visited(int wire) { return flat_wires.at(wire).visit.visited; }
+    bool was_visited(int wire) { return wire_visit[wire].visited; }
+
+    void set_bwd_visited(ThreadContext &t, int wire, PipId pip, float cost)
+    {
+        auto &v = wire_visit[wire];
+        if (!v.dirty)
+            t.dirty_wires.push_back(wire);
+        v.dirty = true;
+        v.bwd_visited = true;
+        v.bwd_pip = pip;
+        v.bwd_cost = cost;
+    }
 
     ArcRouteResult route_arc(ThreadContext &t, NetInfo *net, size_t i, bool is_mt, bool is_bb = true)
     {
@@ -456,8 +497,8 @@ struct Router2
         if (dst_wire == WireId())
             ARC_LOG_ERR("No wire found for port %s on destination cell %s.\n", ctx->nameOf(usr.port),
                         ctx->nameOf(usr.cell));
-        int src_wire_idx = wire_to_idx.at(src_wire);
-        int dst_wire_idx = wire_to_idx.at(dst_wire);
+        int src_wire_idx = wire_idx(src_wire);
+        int dst_wire_idx = wire_idx(dst_wire);
         // Check if arc was already done _in this iteration_
         if (t.processed_sinks.count(dst_wire))
             return ARC_SUCCESS;
@@ -466,6 +507,10 @@ struct Router2
             std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
             t.queue.swap(new_queue);
         }
+        if (!t.bwd_queue.empty()) {
+            std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
+            t.bwd_queue.swap(new_queue);
+        }
         if (!t.backwards_queue.empty()) {
             std::queue<int> new_queue;
             t.backwards_queue.swap(new_queue);
@@ -473,12 +518,12 @@ struct Router2
         // First try strongly iteration-limited routing backwards BFS
         // this will deal with certain nets faster than forward A*
         // and comes at a minimal performance cost for the others
-        // This could also be used to speed up forwards routing by a hybrid
-        // bidirectional approach
+        // Routing with cfg.bidirectional is the full version of this, as an A*
+        // search from both ends
         int backwards_iter = 0;
         int backwards_limit =
                 ctx->getBelGlobalBuf(net->driver.cell->bel) ? cfg.global_backwards_max_iter : cfg.backwards_max_iter;
-        t.backwards_queue.push(wire_to_idx.at(dst_wire));
+        t.backwards_queue.push(wire_idx(dst_wire));
         while (!t.backwards_queue.empty() && backwards_iter < backwards_limit) {
             int cursor = t.backwards_queue.front();
             t.backwards_queue.pop();
@@ -497,7 +542,7 @@ struct Router2
                     PipId p = flat_wires.at(cursor2).bound_nets.at(net->udata).second;
                     if (p == PipId())
                         break;
-                    cursor2 = wire_to_idx.at(ctx->getPipSrcWire(p));
+                    cursor2 = wire_idx(ctx->getPipSrcWire(p));
                 }
                 if (!bwd_merge_fail && cursor2 == src_wire_idx) {
                     // Found a path to merge to existing routing; backwards
@@ -506,7 +551,7 @@ struct Router2
                         PipId p = flat_wires.at(cursor2).bound_nets.at(net->udata).second;
                         if (p == PipId())
                             break;
-                        cursor2 = wire_to_idx.at(ctx->getPipSrcWire(p));
+                        cursor2 = wire_idx(ctx->getPipSrcWire(p));
                         set_visited(t, cursor2, p, WireScore());
                     }
                     break;
@@ -516,11 +561,13 @@ struct Router2
             bool did_something = false;
             for (auto uh : ctx->getPipsUphill(flat_wires[cursor].w)) {
                 did_something = true;
+                if (is_bb && !hit_test_pip(ad.bb, ctx->getPipLocation(uh)))
+                    continue;
                 if (!ctx->checkPipAvail(uh) && ctx->getBoundPipNet(uh) != net)
                     continue;
                 if (cpip != PipId() && cpip != uh)
                     continue; // don't allow multiple pips driving a wire with a net
-                int next = wire_to_idx.at(ctx->getPipSrcWire(uh));
+                int next = wire_idx(ctx->getPipSrcWire(uh));
                 if (was_visited(next))
                     continue; // skip wires that have already been visited
                 auto &wd = flat_wires[next];
@@ -542,8 +589,8 @@ struct Router2
             int cursor_fwd = src_wire_idx;
             bind_pip_internal(net, i, src_wire_idx, PipId());
             while (was_visited(cursor_fwd)) {
-                auto &v = flat_wires.at(cursor_fwd).visit;
-                cursor_fwd = wire_to_idx.at(ctx->getPipDstWire(v.pip));
+                auto &v = wire_visit[cursor_fwd];
+                cursor_fwd = wire_idx(ctx->getPipDstWire(v.pip));
                 bind_pip_internal(net, i, cursor_fwd, v.pip);
                 if (ctx->debug) {
                     auto &wd = flat_wires.at(cursor_fwd);
@@ -558,8 +605,17 @@ struct Router2
             return ARC_SUCCESS;
         }
 
-        // Normal forwards A* routing
         reset_wires(t);
+        if (cfg.bidirectional) {
+            int64_t fwd_before = t.fwd_expanded, bwd_before = t.bwd_expanded;
+            auto result = route_arc_bidir(t, net, i, src_wire, dst_wire, is_bb);
+            if (result == ARC_SUCCESS)
+                ROUTE_LOG_DBG("   Routed (bidirectional, expanded %d forwards and %d backwards)\n",
+                              int(t.fwd_expanded - fwd_before), int(t.bwd_expanded - bwd_before));
+            return result;
+        }
+
+        // Normal forwards A* routing
         WireScore base_score;
         base_score.cost = 0;
         base_score.delay = ctx->getWireDelay(src_wire).maxDelay();
@@ -580,6 +636,7 @@ struct Router2
             auto &d = flat_wires.at(curr.wire);
             t.queue.pop();
             ++iter;
+            ++t.fwd_expanded;
 #if 0
             ROUTE_LOG_DBG("current wire %s\n", ctx->nameOfWire(curr.wire));
 #endif
@@ -601,7 +658,7 @@ struct Router2
 #endif
                 // Evaluate score of next wire
                 WireId next = ctx->getPipDstWire(dh);
-                int next_idx = wire_to_idx.at(next);
+                int next_idx = wire_idx(next);
                 if (was_visited(next_idx))
                     continue;
 #if 1
@@ -620,7 +677,7 @@ struct Router2
                 next_score.delay =
                         curr.score.delay + ctx->getPipDelay(dh).maxDelay() + ctx->getWireDelay(next).maxDelay();
                 next_score.togo_cost = cfg.estimate_weight * get_togo_cost(net, i, next_idx, dst_wire);
-                const auto &v = nwd.visit;
+                const auto &v = wire_visit[next_idx];
                 if (!v.visited || (v.score.total() > next_score.total())) {
                     ++explored;
 #if 0
@@ -628,7 +685,7 @@ struct Router2
                                   next_score.togo_cost);
 #endif
                     // Add wire to queue if it meets criteria
-                    t.queue.push(QueuedWire(next_idx, dh, ctx->getPipLocation(dh), next_score, ctx->rng()));
+                    t.queue.push(QueuedWire(next_idx, dh, ctx->getPipLocation(dh), next_score, t.rng.rng()));
                     set_visited(t, next_idx, dh, next_score);
                     if (next == dst_wire) {
                         toexplore = std::min(toexplore, iter + 5);
@@ -640,7 +697,7 @@ struct Router2
             ROUTE_LOG_DBG("   Routed (explored %d wires): ", explored);
             int cursor_bwd = dst_wire_idx;
             while (was_visited(cursor_bwd)) {
-                auto &v = flat_wires.at(cursor_bwd).visit;
+                auto &v = wire_visit[cursor_bwd];
                 bind_pip_internal(net, i, cursor_bwd, v.pip);
                 if (ctx->debug) {
                     auto &wd = flat_wires.at(cursor_bwd);
@@ -654,7 +711,7 @@ struct Router2
                 }
                 ROUTE_LOG_DBG("         pip: %s (%d, %d)\n", ctx->nameOfPip(v.pip), ctx->getPipLocation(v.pip).x,
                               ctx->getPipLocation(v.pip).y);
-                cursor_bwd = wire_to_idx.at(ctx->getPipSrcWire(v.pip));
+                cursor_bwd = wire_idx(ctx->getPipSrcWire(v.pip));
             }
             t.processed_sinks.insert(dst_wire);
             ad.routed = true;
@@ -665,6 +722,149 @@ struct Router2
             return ARC_RETRY_WITHOUT_BB;
         }
     }
+
+    // Bidirectional A*: a forwards search from the source and a backwards search from the sink, each
+    // advancing whichever frontier has the cheaper head, until that head cannot improve on the best path
+    // through a wire reached by both.
+    //
+    // The stop rule compares the head's estimated total (cost plus weighted estimate to go) with the plain
+    // cost of the best path. That is only a lower bound on paths through the head if the weighted estimate
+    // never overestimates, and even then the two frontiers are not coordinated as in bidirectional Dijkstra,
+    // so like forwards A* with estimate_weight > 1, the path found is not guaranteed to be the cheapest.
+    ArcRouteResult route_arc_bidir(ThreadContext &t, NetInfo *net, size_t i, WireId src_wire, WireId dst_wire,
+                                   bool is_bb)
+    {
+        auto &ad = nets[net->udata].arcs[i];
+        int src_wire_idx = wire_idx(src_wire);
+        int dst_wire_idx = wire_idx(dst_wire);
+
+        WireScore src_score;
+        src_score.cost = 0;
+        src_score.delay = ctx->getWireDelay(src_wire).maxDelay();
+        src_score.togo_cost = get_togo_cost(net, i, src_wire_idx, dst_wire);
+        t.queue.push(QueuedWire(src_wire_idx, PipId(), Loc(), src_score));
+        set_visited(t, src_wire_idx, PipId(), src_score);
+
+        WireScore dst_score;
+        dst_score.cost = 0;
+        dst_score.delay = 0;
+        dst_score.togo_cost = get_togo_cost_bwd(net, dst_wire_idx, src_wire);
+        t.bwd_queue.push(QueuedWire(dst_wire_idx, PipId(), Loc(), dst_score));
+        set_bwd_visited(t, dst_wire_idx, PipId(), 0);
+
+        // Wire where the best path found so far crosses from the forwards to the backwards search
+        int meet = -1;
+        float meet_cost = std::numeric_limits<float>::max();
+        auto check_meet = [&](int wire) {
+            auto &v = wire_visit[wire];
+            if (v.visited && v.bwd_visited && (v.score.cost + v.bwd_cost) < meet_cost) {
+                meet = wire;
+                meet_cost = v.score.cost + v.bwd_cost;
+            }
+        };
+        check_meet(src_wire_idx);
+
+        int toexplore = 25000 * std::max(1, (ad.bb.x1 - ad.bb.x0) + (ad.bb.y1 - ad.bb.y0));
+        int iter = 0;
+        int fwd_explored = 0, bwd_explored = 0;
+        while ((!t.queue.empty() || !t.bwd_queue.empty()) && (!is_bb || iter < toexplore)) {
+            bool fwd = t.bwd_queue.empty() ||
+                       (!t.queue.empty() && t.queue.top().score.total() <= t.bwd_queue.top().score.total());
+            auto curr = fwd ? t.queue.top() : t.bwd_queue.top();
+            if (meet != -1 && curr.score.total() >= meet_cost)
+                break;
+            (fwd ? t.queue : t.bwd_queue).pop();
+            ++iter;
+            auto &d = flat_wires.at(curr.wire);
+            if (fwd) {
+                ++fwd_explored;
+                for (auto dh : ctx->getPipsDownhill(d.w)) {
+                    if (is_bb && !hit_test_pip(ad.bb, ctx->getPipLocation(dh)))
+                        continue;
+                    if (!ctx->checkPipAvail(dh) && ctx->getBoundPipNet(dh) != net)
+                        continue;
+                    WireId next = ctx->getPipDstWire(dh);
+                    int next_idx = wire_idx(next);
+                    if (was_visited(next_idx))
+                        continue;
+                    auto &nwd = flat_wires.at(next_idx);
+                    if (nwd.unavailable)
+                        continue;
+                    if (nwd.reserved_net != -1 && nwd.reserved_net != net->udata)
+                        continue;
+                    if (nwd.bound_nets.count(net->udata) && nwd.bound_nets.at(net->udata).second != dh)
+                        continue;
+                    WireScore next_score;
+                    next_score.cost = curr.score.cost + score_wire_for_arc(net, i, next, dh);
+                    next_score.delay =
+                            curr.score.delay + ctx->getPipDelay(dh).maxDelay() + ctx->getWireDelay(next).maxDelay();
+                    next_score.togo_cost = cfg.estimate_weight * get_togo_cost(net, i, next_idx, dst_wire);
+                    t.queue.push(QueuedWire(next_idx, dh, ctx->getPipLocation(dh), next_score, t.rng.rng()));
+                    set_visited(t, next_idx, dh, next_score);
+                    check_meet(next_idx);
+                }
+            } else {
+                ++bwd_explored;
+                // The same constraints as forwards search applies when entering this wire, for all of its pips
+                if (d.unavailable)
+                    continue;
+                if (d.reserved_net != -1 && d.reserved_net != net->udata)
+                    continue;
+                PipId cpip;
+                if (d.bound_nets.count(net->udata))
+                    cpip = d.bound_nets.at(net->udata).second;
+                for (auto uh : ctx->getPipsUphill(d.w)) {
+                    if (cpip != PipId() && cpip != uh)
+                        continue;
+                    if (is_bb && !hit_test_pip(ad.bb, ctx->getPipLocation(uh)))
+                        continue;
+                    if (!ctx->checkPipAvail(uh) && ctx->getBoundPipNet(uh) != net)
+                        continue;
+                    int prev_idx = wire_idx(ctx->getPipSrcWire(uh));
+                    if (wire_visit[prev_idx].bwd_visited)
+                        continue;
+                    WireScore prev_score;
+                    prev_score.cost = curr.score.cost + score_wire_for_arc(net, i, d.w, uh);
+                    prev_score.delay =
+                            curr.score.delay + ctx->getPipDelay(uh).maxDelay() + ctx->getWireDelay(d.w).maxDelay();
+                    prev_score.togo_cost = cfg.estimate_weight * get_togo_cost_bwd(net, prev_idx, src_wire);
+                    t.bwd_queue.push(QueuedWire(prev_idx, uh, ctx->getPipLocation(uh), prev_score, t.rng.rng()));
+                    set_bwd_visited(t, prev_idx, uh, prev_score.cost);
+                    check_meet(prev_idx);
+                }
+            }
+        }
+        t.fwd_expanded += fwd_explored;
+        t.bwd_expanded += bwd_explored;
+        if (meet == -1) {
+            reset_wires(t);
+            return ARC_RETRY_WITHOUT_BB;
+        }
+
+        // Source side of the path, from the meeting wire back to the source
+        int cursor = meet;
+        while (true) {
+            auto &v = wire_visit[cursor];
+            bind_pip_internal(net, i, cursor, v.pip);
+            if (v.pip == PipId()) {
+                NPNR_ASSERT(cursor == src_wire_idx);
+                break;
+            }
+            cursor = wire_idx(ctx->getPipSrcWire(v.pip));
+        }
+        // Sink side, from the meeting wire onwards
+        cursor = meet;
+        while (cursor != dst_wire_idx) {
+            PipId pip = wire_visit[cursor].bwd_pip;
+            NPNR_ASSERT(pip != PipId());
+            cursor = wire_idx(ctx->getPipDstWire(pip));
+            bind_pip_internal(net, i, cursor, pip);
+        }
+        t.processed_sinks.insert(dst_wire);
+        ad.routed = true;
+        reset_wires(t);
+        return ARC_SUCCESS;
+    }
 #undef ARC_ERR
 
     bool route_net(ThreadContext &t, NetInfo *net, bool is_mt)
@@ -683,6 +883,10 @@ struct Router2
         if (net->driver.cell == nullptr)
             return true;
 
+        // Seed from the net rather than sharing ctx's RNG, so that the result does not depend on which thread routes
+        // the net or on what the other threads are doing
+        t.rng.rngseed(iter_seed ^ (uint64_t(net->udata + 1) * 0x9e3779b97f4a7c15ULL));
+
         bool have_failures = false;
         t.processed_sinks.clear();
         t.route_arcs.clear();
@@ -713,6 +917,7 @@ struct Router2
                     ROUTE_LOG_DBG("Rerouting arc %d of net '%s' without bounding box, possible tricky routing...\n",
                                   int(i), ctx->nameOf(net));
                     auto res2 = route_arc(t, net, i, is_mt, false);
+                    nets.at(net->udata).outside_bb = true;
                     // If this also fails, no choice but to give up
                     if (res2 != ARC_SUCCESS)
                         log_error("Failed to route arc %d of net '%s', from %s to %s.\n", int(i), ctx->nameOf(net),
@@ -735,9 +940,21 @@ struct Router2
     int total_overuse = 0;
     std::vector<int> route_queue;
     std::set<int> failed_nets;
+    // Drawn from ctx's RNG once per iteration, to seed each net's tie-breaks
+    uint64_t iter_seed = 0;
+    // Wires expanded by A* in the current iteration and in total
+    int64_t iter_fwd_expanded = 0, iter_bwd_expanded = 0;
+    int64_t total_fwd_expanded = 0, total_bwd_expanded = 0;
+
+    void add_expansions(const ThreadContext &t)
+    {
+        iter_fwd_expanded += t.fwd_expanded;
+        iter_bwd_expanded += t.bwd_expanded;
+    }
 
     void update_congestion()
     {
+        NPNR_TRACE_SCOPE("router2/update_congestion");
         total_overuse = 0;
         overused_wires = 0;
         total_wire_use = 0;
@@ -821,6 +1038,7 @@ struct Router2
     int arch_fail = 0;
     bool bind_and_check_all()
     {
+        NPNR_TRACE_SCOPE("router2/bind");
         bool success = true;
         std::vector<WireId> net_wires;
         for (auto net : nets_by_udata) {
@@ -884,162 +1102,290 @@ struct Router2
             out << std::endl;
         }
     }
-    int mid_x = 0, mid_y = 0;
+    // Recursive (k-d tree) spatial partitioning of the nets to be routed. At each
+    // node the nets are split at the median of their centres along whichever axis
+    // leaves fewer nets straddling the cut; nets whose bounding box plus margin
+    // crosses the cut stay at that node. Multi-threaded routing only uses pips
+    // inside the margin-expanded box, and a wire is only reached through its
+    // pips; the two halves are kept further apart than the longest wire span, so
+    // nodes in disjoint subtrees never touch the same wires and any set of ready
+    // nodes can be routed concurrently. Nets with routing outside their box (from
+    // an earlier single-threaded retry without it) would touch wires anywhere when
+    // ripped up, so they always stay at the root. A node becomes ready once all of
+    // its children have been routed; the root is always routed last and
+    // single-threaded.
+    struct PartitionNode
+    {
+        std::vector<int> nets;
+        int parent = -1;
+        int depth = 0;
+        int num_children = 0;
+    };
+
+    std::vector<PartitionNode> part_nodes;
+    int part_max_depth = 0;
+    // Largest distance along each axis between two pips using the same wire; -1 until first needed
+    int wire_span_x = -1, wire_span_y = -1;
 
-    void partition_nets()
+    void find_wire_span()
     {
-        // Create a histogram of positions in X and Y positions
-        std::map<int, int> cxs, cys;
-        for (auto &n : nets) {
-            if (n.cx != -1)
-                ++cxs[n.cx];
-            if (n.cy != -1)
-                ++cys[n.cy];
+        int nwires = ctx->getWireIndexCount();
+        std::vector<int> x0(nwires, std::numeric_limits<int>::max()), x1(nwires, std::numeric_limits<int>::min());
+        std::vector<int> y0(nwires, std::numeric_limits<int>::max()), y1(nwires, std::numeric_limits<int>::min());
+        for (auto pip : ctx->getPips()) {
+            Loc l = ctx->getPipLocation(pip);
+            for (WireId w : {ctx->getPipSrcWire(pip), ctx->getPipDstWire(pip)}) {
+                int i = wire_idx(w);
+                x0.at(i) = std::min(x0.at(i), l.x);
+                x1.at(i) = std::max(x1.at(i), l.x);
+                y0.at(i) = std::min(y0.at(i), l.y);
+                y1.at(i) = std::max(y1.at(i), l.y);
+            }
         }
-        // 4-way split for now
-        int accum_x = 0, accum_y = 0;
-        int halfway = int(nets.size()) / 2;
-        for (auto &p : cxs) {
-            if (accum_x < halfway && (accum_x + p.second) >= halfway)
-                mid_x = p.first;
-            accum_x += p.second;
+        wire_span_x = wire_span_y = 0;
+        for (int i = 0; i < nwires; i++) {
+            if (x0.at(i) > x1.at(i))
+                continue;
+            wire_span_x = std::max(wire_span_x, x1.at(i) - x0.at(i));
+            wire_span_y = std::max(wire_span_y, y1.at(i) - y0.at(i));
         }
-        for (auto &p : cys) {
-            if (accum_y < halfway && (accum_y + p.second) >= halfway)
-                mid_y = p.first;
-            accum_y += p.second;
+        if (ctx->verbose)
+            log_info("Longest wire spans %d tiles in x and %d tiles in y\n", wire_span_x, wire_span_y);
+    }
+
+    int partition_nets(std::vector<int> &to_part, int parent, int depth)
+    {
+        int idx = int(part_nodes.size());
+        part_nodes.emplace_back();
+        part_nodes.at(idx).parent = parent;
+        part_nodes.at(idx).depth = depth;
+        part_max_depth = std::max(part_max_depth, depth);
+
+        // Lower and upper bound of a net's routing region along an axis
+        auto net_lo = [&](int n, bool y) {
+            return y ? (nets.at(n).bb.y0 - cfg.bb_margin_y) : (nets.at(n).bb.x0 - cfg.bb_margin_x);
+        };
+        auto net_hi = [&](int n, bool y) {
+            return y ? (nets.at(n).bb.y1 + cfg.bb_margin_y) : (nets.at(n).bb.x1 + cfg.bb_margin_x);
+        };
+        // Which side of a cut at pos a net goes to: the low side ends a wire span before the cut, and the high side
+        // starts at it, so that no wire can be reached from both
+        auto goes_lo = [&](int n, bool y, int pos) {
+            return !nets.at(n).outside_bb && net_hi(n, y) + (y ? wire_span_y : wire_span_x) < pos;
+        };
+        auto goes_hi = [&](int n, bool y, int pos) { return !nets.at(n).outside_bb && net_lo(n, y) >= pos; };
+
+        bool found_split = false, split_y = false;
+        int split = 0;
+        if (int(to_part.size()) >= cfg.partition_min_nets) {
+            size_t best_cross = to_part.size();
+            std::vector<int> centres;
+            for (bool y : {false, true}) {
+                centres.clear();
+                for (int n : to_part)
+                    centres.push_back(y ? nets.at(n).cy : nets.at(n).cx);
+                auto mid = centres.begin() + centres.size() / 2;
+                std::nth_element(centres.begin(), mid, centres.end());
+                int pos = *mid;
+                size_t lo = 0, hi = 0, cross = 0;
+                for (int n : to_part) {
+                    if (goes_lo(n, y, pos))
+                        ++lo;
+                    else if (goes_hi(n, y, pos))
+                        ++hi;
+                    else
+                        ++cross;
+                }
+                // A split is only useful if it creates two independent halves
+                if (lo > 0 && hi > 0 && cross < best_cross) {
+                    found_split = true;
+                    split_y = y;
+                    split = pos;
+                    best_cross = cross;
+                }
+            }
         }
-        if (ctx->verbose) {
-            log_info("    x splitpoint: %d\n", mid_x);
-            log_info("    y splitpoint: %d\n", mid_y);
+
+        if (!found_split) {
+            part_nodes.at(idx).nets = std::move(to_part);
+            return idx;
         }
-        std::vector<int> bins(5, 0);
-        for (auto &n : nets) {
-            if (n.bb.x0 < mid_x && n.bb.x1 < mid_x && n.bb.y0 < mid_y && n.bb.y1 < mid_y)
-                ++bins[0]; // TL
-            else if (n.bb.x0 >= mid_x && n.bb.x1 >= mid_x && n.bb.y0 < mid_y && n.bb.y1 < mid_y)
-                ++bins[1]; // TR
-            else if (n.bb.x0 < mid_x && n.bb.x1 < mid_x && n.bb.y0 >= mid_y && n.bb.y1 >= mid_y)
-                ++bins[2]; // BL
-            else if (n.bb.x0 >= mid_x && n.bb.x1 >= mid_x && n.bb.y0 >= mid_y && n.bb.y1 >= mid_y)
-                ++bins[3]; // BR
+
+        std::vector<int> lo_nets, hi_nets;
+        for (int n : to_part) {
+            if (goes_lo(n, split_y, split))
+                lo_nets.push_back(n);
+            else if (goes_hi(n, split_y, split))
+                hi_nets.push_back(n);
             else
-                ++bins[4]; // cross-boundary
+                part_nodes.at(idx).nets.push_back(n);
         }
-        if (ctx->verbose)
-            for (int i = 0; i < 5; i++)
-                log_info("        bin %d N=%d\n", i, bins[i]);
+        to_part.clear();
+        partition_nets(lo_nets, idx, depth + 1);
+        partition_nets(hi_nets, idx, depth + 1);
+        part_nodes.at(idx).num_children = 2;
+        return idx;
+    }
+
+    // Work-stealing pool over the partition tree. Each worker owns a queue of ready
+    // nodes; it always takes the deepest node in its own queue, and when that is
+    // empty steals the deepest node from another worker. Workers with nothing to
+    // steal sleep on pool_cv until a node becomes ready or the tree is finished.
+    struct WorkerQueue
+    {
+        std::mutex mtx;
+        std::vector<int> ready;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> worker_queues;
+    std::unique_ptr<std::atomic<int>[]> part_pending;
+    std::atomic<int> part_remaining;
+    // Protects ready_nodes and orders the wakeups on pool_cv against part_remaining
+    std::mutex pool_mtx;
+    std::condition_variable pool_cv;
+    int ready_nodes = 0;
+
+    int take_deepest(WorkerQueue &q)
+    {
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (q.ready.empty())
+            return -1;
+        auto best = q.ready.begin();
+        for (auto it = q.ready.begin(); it != q.ready.end(); ++it)
+            if (part_nodes.at(*it).depth >= part_nodes.at(*best).depth)
+                best = it;
+        int node = *best;
+        q.ready.erase(best);
+        return node;
     }
 
-    void router_thread(ThreadContext &t)
+    void router_thread(ThreadContext &t, int tid)
     {
-        for (auto n : t.route_nets) {
-            bool result = route_net(t, n, true);
-            if (!result)
-                t.failed_nets.push_back(n);
+        NPNR_TRACE_SCOPE("router2/worker");
+        int nworkers = int(worker_queues.size());
+        while (part_remaining.load() > 0) {
+            int node = take_deepest(*worker_queues.at(tid));
+            for (int i = 1; node == -1 && i < nworkers; i++)
+                node = take_deepest(*worker_queues.at((tid + i) % nworkers));
+            if (node == -1) {
+                // Everything left is either being routed or waiting on its children
+                std::unique_lock<std::mutex> lock(pool_mtx);
+                pool_cv.wait(lock, [&]() { return ready_nodes > 0 || part_remaining.load() == 0; });
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> lock(pool_mtx);
+                --ready_nodes;
+            }
+            for (int n : part_nodes.at(node).nets) {
+                NetInfo *ni = nets_by_udata.at(n);
+                if (!route_net(t, ni, true))
+                    t.failed_nets.push_back(ni);
+            }
+            // The root is left to the single-threaded pass
+            int parent = part_nodes.at(node).parent;
+            bool parent_ready = parent > 0 && --part_pending[parent] == 0;
+            if (parent_ready) {
+                auto &q = *worker_queues.at(tid);
+                std::lock_guard<std::mutex> lock(q.mtx);
+                q.ready.push_back(parent);
+            }
+            std::lock_guard<std::mutex> lock(pool_mtx);
+            if (parent_ready)
+                ++ready_nodes;
+            if (--part_remaining == 0 || ready_nodes > 0)
+                pool_cv.notify_all();
         }
     }
 
     void do_route()
     {
+        NPNR_TRACE_SCOPE("router2/route");
         // Don't multithread if fewer than 200 nets (heuristic)
         if (route_queue.size() < 200) {
             ThreadContext st;
             for (size_t j = 0; j < route_queue.size(); j++) {
                 route_net(st, nets_by_udata[route_queue[j]], false);
             }
+            add_expansions(st);
             return;
         }
-        const int Nq = 4, Nv = 2, Nh = 2;
-        const int N = Nq + Nv + Nh;
-        std::vector<ThreadContext> tcs(N + 1);
-        for (auto n : route_queue) {
-            auto &nd = nets.at(n);
-            auto ni = nets_by_udata.at(n);
-            int bin = N;
-            int le_x = mid_x - cfg.bb_margin_x;
-            int rs_x = mid_x + cfg.bb_margin_x;
-            int le_y = mid_y - cfg.bb_margin_y;
-            int rs_y = mid_y + cfg.bb_margin_y;
-            // Quadrants
-            if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 1;
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 2;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 3;
-            // Vertical split
-            else if (nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = Nq + 0;
-            else if (nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = Nq + 1;
-            // Horizontal split
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x)
-                bin = Nq + Nv + 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x)
-                bin = Nq + Nv + 1;
-            tcs.at(bin).route_nets.push_back(ni);
+        // The partitioning is rebuilt every iteration, as the set of nets being
+        // ripped up and rerouted shrinks and moves around
+        part_nodes.clear();
+        part_max_depth = 0;
+        if (wire_span_x == -1)
+            find_wire_span();
+        std::vector<int> to_part(route_queue);
+        partition_nets(to_part, -1, 0);
+
+        std::vector<int> leaves;
+        part_pending.reset(new std::atomic<int>[part_nodes.size()]);
+        for (int i = 0; i < int(part_nodes.size()); i++) {
+            part_pending[i] = part_nodes.at(i).num_children;
+            if (i > 0 && part_nodes.at(i).num_children == 0)
+                leaves.push_back(i);
         }
+        part_remaining = int(part_nodes.size()) - 1;
+        ready_nodes = int(leaves.size());
+
+#ifdef NPNR_DISABLE_THREADS
+        int nworkers = 1;
+#else
+        int nworkers = std::max(1, std::min(cfg.threads, int(leaves.size())));
+#endif
         if (ctx->verbose)
-            log_info("%d/%d nets not multi-threadable\n", int(tcs.at(N).route_nets.size()), int(route_queue.size()));
+            log_info("%d/%d nets not multi-threadable, %d regions (depth %d) across %d threads\n",
+                     int(part_nodes.at(0).nets.size()), int(route_queue.size()), int(part_nodes.size()),
+                     part_max_depth, nworkers);
+
+        // Seed each worker with a contiguous run of leaves; as nodes are numbered
+        // in depth-first order, this keeps each worker spatially local
+        worker_queues.clear();
+        for (int i = 0; i < nworkers; i++)
+            worker_queues.emplace_back(new WorkerQueue());
+        for (size_t i = 0; i < leaves.size(); i++)
+            worker_queues.at((i * nworkers) / leaves.size())->ready.push_back(leaves.at(i));
+
+        std::vector<ThreadContext> tcs(nworkers + 1);
 #ifdef NPNR_DISABLE_THREADS
-        // Singlethreaded routing - quadrants
-        for (int i = 0; i < Nq; i++) {
-            router_thread(tcs.at(i));
-        }
-        // Vertical splits
-        for (int i = Nq; i < Nq + Nv; i++) {
-            router_thread(tcs.at(i));
-        }
-        // Horizontal splits
-        for (int i = Nq + Nv; i < Nq + Nv + Nh; i++) {
-            router_thread(tcs.at(i));
-        }
+        router_thread(tcs.at(0), 0);
 #else
-        // Multithreaded part of routing - quadrants
         std::vector<boost::thread> threads;
-        for (int i = 0; i < Nq; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i)); });
-        }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Vertical splits
-        for (int i = Nq; i < Nq + Nv; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i)); });
-        }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Horizontal splits
-        for (int i = Nq + Nv; i < Nq + Nv + Nh; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i)); });
+        for (int i = 0; i < nworkers; i++) {
+            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), i); });
         }
         for (auto &t : threads)
             t.join();
         threads.clear();
 #endif
-        // Singlethreaded part of routing - nets that cross partitions
+        // Singlethreaded part of routing - nets that cross the top-level split
         // or don't fit within bounding box
-        for (auto st_net : tcs.at(N).route_nets)
-            route_net(tcs.at(N), st_net, false);
-        // Failed nets
-        for (int i = 0; i < N; i++)
-            for (auto fail : tcs.at(i).failed_nets)
-                route_net(tcs.at(N), fail, false);
+        auto &st = tcs.at(nworkers);
+        for (int st_net : part_nodes.at(0).nets)
+            route_net(st, nets_by_udata.at(st_net), false);
+        // Failed nets. Which worker routed (and so failed) a net depends on
+        // scheduling, so replay them in net order to keep the result independent
+        // of the thread count and timing
+        std::vector<NetInfo *> failed;
+        for (int i = 0; i < nworkers; i++)
+            failed.insert(failed.end(), tcs.at(i).failed_nets.begin(), tcs.at(i).failed_nets.end());
+        std::sort(failed.begin(), failed.end(), [](const NetInfo *a, const NetInfo *b) { return a->udata < b->udata; });
+        for (auto fail : failed)
+            route_net(st, fail, false);
+        for (auto &tc : tcs)
+            add_expansions(tc);
     }
 
     void operator()()
     {
+        NPNR_TRACE_SCOPE("router2");
         log_info("Running router2...\n");
         log_info("Setting up routing resources...\n");
         auto rstart = std::chrono::high_resolution_clock::now();
         setup_nets();
         setup_wires();
         find_all_reserved_wires();
-        partition_nets();
         curr_cong_weight = cfg.init_curr_cong_weight;
         hist_cong_weight = cfg.hist_cong_weight;
         ThreadContext st;
@@ -1049,8 +1395,11 @@ struct Router2
             route_queue.push_back(i);
 
         bool timing_driven = ctx->setting<bool>("timing_driven");
+        if (timing_driven)
+            setup_timing_analyser(ctx);
         log_info("Running main router loop...\n");
         do {
+            NPNR_TRACE_SCOPE("router2/iteration");
             ctx->sorted_shuffle(route_queue);
 
             if (timing_driven && (int(route_queue.size()) > (int(nets_by_udata.size()) / 50))) {
@@ -1078,7 +1427,12 @@ struct Router2
                     log("    routed %d/%d\n", int(j), int(route_queue.size()));
             }
 #endif
+            iter_fwd_expanded = 0;
+            iter_bwd_expanded = 0;
+            iter_seed = ctx->rng64();
             do_route();
+            total_fwd_expanded += iter_fwd_expanded;
+            total_bwd_expanded += iter_bwd_expanded;
             route_queue.clear();
             update_congestion();
 #if 0
@@ -1090,11 +1444,18 @@ struct Router2
             if (overused_wires == 0) {
                 // Try and actually bind nextpnr Arch API wires
                 bind_and_check_all();
+                // Route delays of all nets have now changed
+                if (timing_driven)
+                    ctx->timing_analyser->invalidate_all();
             }
             for (auto cn : failed_nets)
                 route_queue.push_back(cn);
+            trace_counter("router2/overused_wires", overused_wires);
             log_info("    iter=%d wires=%d overused=%d overuse=%d archfail=%s\n", iter, total_wire_use, overused_wires,
                      total_overuse, overused_wires > 0 ? "NA" : std::to_string(arch_fail).c_str());
+            log_info("        expanded %lld wires (%lld forwards, %lld backwards)\n",
+                     (long long)(iter_fwd_expanded + iter_bwd_expanded), (long long)iter_fwd_expanded,
+                     (long long)iter_bwd_expanded);
             ++iter;
             if (curr_cong_weight < 1e9)
                 curr_cong_weight *= cfg.curr_cong_mult;
@@ -1114,6 +1475,10 @@ struct Router2
         }
         auto rend = std::chrono::high_resolution_clock::now();
         log_info("Router2 time %.02fs\n", std::chrono::duration<float>(rend - rstart).count());
+        log_info("Router2 expanded %lld wires (%lld forwards, %lld backwards)%s\n",
+                 (long long)(total_fwd_expanded + total_bwd_expanded), (long long)total_fwd_expanded,
+                 (long long)total_bwd_expanded, cfg.bidirectional ? " with bidirectional A*" : "");
+        ctx->work_counters["router/wires_expanded"] += total_fwd_expanded + total_bwd_expanded;
 
         log_info("Running router1 to check that route is legal...\n");
 
@@ -1141,6 +1506,13 @@ Router2Cfg::Router2Cfg(Context *ctx)
     hist_cong_weight = ctx->setting<float>("router2/histCongWeight", 1.0f);
     curr_cong_mult = ctx->setting<float>("router2/currCongWeightMult", 2.0f);
     estimate_weight = ctx->setting<float>("router2/estimateWeight", 1.75f);
+#ifdef NPNR_DISABLE_THREADS
+    threads = 1;
+#else
+    threads = ctx->setting<int>("router2/threads", std::max(1, int(boost::thread::hardware_concurrency())));
+#endif
+    partition_min_nets = ctx->setting<int>("router2/partitionMinNets", 64);
+    bidirectional = ctx->setting<bool>("router2/bidirectional", false);
     perf_profile = ctx->setting<float>("router2/perfProfile", false);
 }
 
@@ -47,6 +47,15 @@ struct Router2Cfg
     // of choosing a less congestion/delay-optimal route
     float estimate_weight;
 
+    // Number of threads used for routing partitioned regions in parallel
+    int threads;
+    // Regions with fewer nets than this are not split further
+    int partition_min_nets;
+
+    // Route arcs with bidirectional A*, searching from the sink as well as the source,
+    // which expands far fewer wires on long arcs
+    bool bidirectional;
+
     // Print additional performance profiling information
     bool perf_profile = false;
 };
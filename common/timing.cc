@@ -26,6 +26,7 @@
 #include <unordered_map>
 #include <utility>
 #include "log.h"
+#include "trace.h"
 #include "util.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -1025,12 +1026,463 @@ void timing_analysis(Context *ctx, bool print_histogram, bool print_fmax, bool p
     }
 }
 
-void get_criticalities(Context *ctx, NetCriticalityMap *net_crit)
+int TimingAnalyser::domain_id(IdString clock, ClockEdge edge)
 {
-    CriticalPathMap crit_paths;
+    for (size_t i = 0; i < domains.size(); i++)
+        if (domains.at(i).clock == clock && domains.at(i).edge == edge)
+            return int(i);
+    domains.push_back(ClockDomain{clock, edge});
+    return int(domains.size()) - 1;
+}
+
+delay_t TimingAnalyser::domain_period(int start, int end, delay_t clk_period) const
+{
+    const ClockDomain &sd = domains.at(start), &ed = domains.at(end);
+    // Set default period
+    delay_t period = (ed.edge == sd.edge) ? clk_period : clk_period / 2;
+    if (ed.clock != domains.at(0).clock) {
+        auto &clknet = ctx->nets.at(ed.clock);
+        if (clknet->clkconstr) {
+            if (ed.edge == sd.edge) {
+                // same edge
+                period = clknet->clkconstr->period.minDelay();
+            } else if (ed.edge == RISING_EDGE) {
+                // falling -> rising
+                period = clknet->clkconstr->low.minDelay();
+            } else if (ed.edge == FALLING_EDGE) {
+                // rising -> falling
+                period = clknet->clkconstr->high.minDelay();
+            }
+        }
+    }
+    return period;
+}
+
+void TimingAnalyser::setup()
+{
+    NPNR_TRACE_SCOPE("timing/setup");
+    graph_stale = false;
+    cells_generation = ctx->cells.generation();
+    nets_generation = ctx->nets.generation();
+    domains.clear();
+    nets.clear();
+    sinks.clear();
+    arcs.clear();
+    endpoints.clear();
+    startpoints.clear();
+    topo_order.clear();
+    net_to_idx.clear();
+    cells.clear();
+    cell_bels.clear();
+    cell_nets_begin.clear();
+    cell_nets.clear();
+
+    // Domain 0 is always used for unclocked paths
+    domain_id(ctx->id("$async$"), RISING_EDGE);
+
+    bool ooc = bool_or_default(ctx->settings, ctx->id("arch.ooc"));
+    std::unordered_set<IdString> ooc_port_nets;
+    // In out-of-context mode, top-level inputs look floating but aren't
+    if (ooc) {
+        for (auto &p : ctx->ports) {
+            if (p.second.type != PORT_IN || p.second.net == nullptr)
+                continue;
+            ooc_port_nets.insert(p.second.net->name);
+        }
+    }
+
+    for (auto &net : ctx->nets) {
+        net_to_idx[net.first] = int(nets.size());
+        NetData nd;
+        nd.net = net.second.get();
+        nets.push_back(nd);
+    }
+
+    // Create sinks, with their combinational arcs and endpoints; also count fanin to each net for the topological
+    // sort. Only arcs from driven nets take part, as undriven nets are never visited
+    std::vector<int> net_fanin(nets.size(), 0);
+    std::vector<bool> topo_arc;
+    for (auto &nd : nets) {
+        NetInfo *ni = nd.net;
+        nd.sinks_begin = int(sinks.size());
+        bool is_driven = ni->driver.cell != nullptr || ooc_port_nets.count(ni->name);
+        for (auto &usr : ni->users) {
+            SinkData sd;
+            sd.net = int(&nd - nets.data());
+            int port_clocks;
+            sd.cls = ctx->getPortTimingClass(usr.cell, usr.port, port_clocks);
+            sd.arcs_begin = int(arcs.size());
+            if (sd.cls != TMG_ENDPOINT && sd.cls != TMG_IGNORE && sd.cls != TMG_CLOCK_INPUT) {
+                for (auto &port : usr.cell->ports) {
+                    if (port.second.type != PORT_OUT || !port.second.net)
+                        continue;
+                    DelayInfo comb_delay;
+                    if (!ctx->getCellDelay(usr.cell, usr.port, port.first, comb_delay))
+                        continue;
+                    int to_net = net_to_idx.at(port.second.net->name);
+                    arcs.push_back(CombArc{to_net, comb_delay.maxDelay()});
+                    int out_clocks;
+                    TimingPortClass out_cls = ctx->getPortTimingClass(usr.cell, port.first, out_clocks);
+                    // Clocked outputs and other startpoints are seeded directly, rather than reached topologically
+                    bool is_topo = is_driven && out_cls != TMG_REGISTER_OUTPUT && out_cls != TMG_STARTPOINT &&
+                                   out_cls != TMG_IGNORE && out_cls != TMG_GEN_CLOCK;
+                    topo_arc.push_back(is_topo);
+                    if (is_topo)
+                        ++net_fanin.at(to_net);
+                }
+            }
+            sd.arcs_end = int(arcs.size());
+            sd.endpoints_begin = int(endpoints.size());
+            if (sd.cls == TMG_REGISTER_INPUT) {
+                for (int i = 0; i < port_clocks; i++) {
+                    TimingClockingInfo clkInfo = ctx->getPortClockingInfo(usr.cell, usr.port, i);
+                    const NetInfo *clknet = get_net_or_empty(usr.cell, clkInfo.clock_port);
+                    int domain = clknet ? domain_id(clknet->name, clkInfo.edge) : 0;
+                    endpoints.push_back(Endpoint{domain, clkInfo.setup.maxDelay()});
+                }
+            } else if (sd.cls == TMG_ENDPOINT) {
+                endpoints.push_back(Endpoint{0, 0});
+            }
+            sd.endpoints_end = int(endpoints.size());
+            sinks.push_back(sd);
+        }
+        nd.sinks_end = int(sinks.size());
+    }
+
+    // Find startpoints, which also form the start of the topological order
+    std::vector<bool> net_seeded(nets.size(), false);
+    std::vector<int> initial;
+    for (auto &cell : ctx->cells) {
+        CellInfo *ci = cell.second.get();
+        for (auto &port : ci->ports) {
+            if (port.second.type != PORT_OUT || !port.second.net)
+                continue;
+            int net = net_to_idx.at(port.second.net->name);
+            int clocks = 0;
+            TimingPortClass portClass = ctx->getPortTimingClass(ci, port.first, clocks);
+            if (portClass == TMG_REGISTER_OUTPUT) {
+                for (int i = 0; i < clocks; i++) {
+                    TimingClockingInfo clkInfo = ctx->getPortClockingInfo(ci, port.first, i);
+                    const NetInfo *clknet = get_net_or_empty(ci, clkInfo.clock_port);
+                    int domain = clknet ? domain_id(clknet->name, clkInfo.edge) : 0;
+                    startpoints.push_back(StartPoint{net, domain, clkInfo.clockToQ.maxDelay(), false});
+                }
+            } else if (portClass == TMG_STARTPOINT || portClass == TMG_GEN_CLOCK || portClass == TMG_IGNORE) {
+                startpoints.push_back(
+                        StartPoint{net, 0, 0, portClass == TMG_GEN_CLOCK || portClass == TMG_IGNORE});
+            } else if (portClass == TMG_CLOCK_INPUT || net_fanin.at(net) > 0) {
+                continue;
+            } else {
+                // If there is no fanin, add the port as a false startpoint
+                startpoints.push_back(StartPoint{net, 0, 0, true});
+            }
+            if (!net_seeded.at(net)) {
+                initial.push_back(net);
+                net_seeded.at(net) = true;
+            }
+        }
+    }
+    // In out-of-context mode, handle top-level ports correctly
+    if (ooc) {
+        for (auto &p : ctx->ports) {
+            if (p.second.type != PORT_IN || p.second.net == nullptr)
+                continue;
+            int net = net_to_idx.at(p.second.net->name);
+            if (!net_seeded.at(net)) {
+                initial.push_back(net);
+                net_seeded.at(net) = true;
+            }
+        }
+    }
+
+    // Walk the design from the startpoints, building up a topological order of nets. In lieu of deleting edges from
+    // the graph, the fanin count of each net is decremented as its drivers are visited
+    std::deque<int> queue(initial.begin(), initial.end());
+    for (int net : initial) {
+        topo_order.push_back(net);
+        nets.at(net).in_topo = true;
+    }
+    while (!queue.empty()) {
+        int net = queue.front();
+        queue.pop_front();
+        auto &nd = nets.at(net);
+        for (int s = nd.sinks_begin; s < nd.sinks_end; s++) {
+            auto &sd = sinks.at(s);
+            for (int a = sd.arcs_begin; a < sd.arcs_end; a++) {
+                if (!topo_arc.at(a))
+                    continue;
+                int to_net = arcs.at(a).to_net;
+                if (--net_fanin.at(to_net) == 0 && !nets.at(to_net).in_topo) {
+                    topo_order.push_back(to_net);
+                    nets.at(to_net).in_topo = true;
+                    queue.push_back(to_net);
+                }
+            }
+        }
+    }
+
+    // Sanity check to ensure that all nets where fanins were recorded were indeed visited
+    bool have_loops = false;
+    bool ignore_loops = bool_or_default(ctx->settings, ctx->id("timing/ignoreLoops"), false);
+    for (size_t i = 0; i < nets.size() && !ignore_loops; i++) {
+        if (net_fanin.at(i) <= 0)
+            continue;
+        have_loops = true;
+        NetInfo *net = nets.at(i).net;
+        log_info("   remaining fanin includes %s.%s (net %s)\n", ctx->nameOf(net->driver.cell),
+                 ctx->nameOf(net->driver.port), ctx->nameOf(net));
+        for (auto net_user : net->users)
+            log_info("        user: %s.%s\n", ctx->nameOf(net_user.cell), ctx->nameOf(net_user.port));
+    }
+    if (have_loops) {
+        if (ctx->force)
+            log_warning("timing analysis failed due to presence of combinatorial loops, incomplete specification "
+                        "of timing ports, etc.\n");
+        else
+            log_error("timing analysis failed due to presence of combinatorial loops, incomplete specification of "
+                      "timing ports, etc.\n");
+    }
+
+    // Record the nets connected to each cell, so that moved cells can be detected cheaply
+    for (auto &cell : ctx->cells) {
+        CellInfo *ci = cell.second.get();
+        cells.push_back(ci);
+        cell_bels.push_back(ci->bel);
+        cell_nets_begin.push_back(int(cell_nets.size()));
+        for (auto &port : ci->ports)
+            if (port.second.net != nullptr)
+                cell_nets.push_back(net_to_idx.at(port.second.net->name));
+    }
+    cell_nets_begin.push_back(int(cell_nets.size()));
+
+    size_t n_domains = domains.size();
+    domain_state.resize(nets.size() * n_domains);
+    arrival.resize(nets.size() * n_domains);
+    path_length.resize(nets.size() * n_domains);
+    net_min_required.resize(nets.size() * n_domains);
+    required.resize(sinks.size() * n_domains);
+    crit_delay.resize(n_domains);
+    has_crit_delay.resize(n_domains);
+
+    invalidate_all();
+}
+
+void TimingAnalyser::invalidate_net(const NetInfo *net)
+{
+    auto fnd = net_to_idx.find(net->name);
+    if (fnd == net_to_idx.end())
+        return;
+    nets.at(fnd->second).dirty = true;
+    any_dirty = true;
+}
+
+void TimingAnalyser::invalidate_all()
+{
+    for (auto &nd : nets)
+        nd.dirty = true;
+    any_dirty = true;
+}
+
+void TimingAnalyser::update_delays()
+{
+    // Any net connected to a cell that has moved since the last update needs new delays
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (cells.at(i)->bel == cell_bels.at(i))
+            continue;
+        cell_bels.at(i) = cells.at(i)->bel;
+        for (int j = cell_nets_begin.at(i); j < cell_nets_begin.at(i + 1); j++)
+            nets.at(cell_nets.at(j)).dirty = true;
+        any_dirty = true;
+    }
+    if (!any_dirty)
+        return;
+    for (auto &nd : nets) {
+        if (!nd.dirty)
+            continue;
+        for (int s = nd.sinks_begin; s < nd.sinks_end; s++) {
+            auto &sd = sinks.at(s);
+            auto &usr = nd.net->users.at(s - nd.sinks_begin);
+            // Undriven nets are never propagated through, and have no source to estimate a delay from
+            sd.delay = nd.net->driver.cell != nullptr ? ctx->getNetinfoRouteDelay(nd.net, usr) : 0;
+            delay_t budget = sd.delay;
+            sd.budget_override = ctx->getBudgetOverride(nd.net, usr, budget);
+        }
+        nd.dirty = false;
+    }
+    any_dirty = false;
+}
+
+void TimingAnalyser::propagate()
+{
+    const size_t n_domains = domains.size();
+    const delay_t clk_period = ctx->getDelayFromNS(1.0e9 / ctx->setting<float>("target_freq")).maxDelay();
+
+    std::fill(domain_state.begin(), domain_state.end(), DOMAIN_ABSENT);
+    std::fill(arrival.begin(), arrival.end(), delay_t());
+    std::fill(path_length.begin(), path_length.end(), 0);
+    std::fill(net_min_required.begin(), net_min_required.end(), std::numeric_limits<delay_t>::max());
+    std::fill(required.begin(), required.end(), std::numeric_limits<delay_t>::max());
+    std::fill(has_crit_delay.begin(), has_crit_delay.end(), false);
+
+    std::vector<delay_t> periods(n_domains * n_domains);
+    for (size_t i = 0; i < n_domains; i++)
+        for (size_t j = 0; j < n_domains; j++)
+            periods.at(i * n_domains + j) = domain_period(int(i), int(j), clk_period);
+
+    for (auto &sp : startpoints) {
+        size_t idx = sp.net * n_domains + sp.domain;
+        if (domain_state.at(idx) != DOMAIN_ABSENT && !sp.false_startpoint)
+            arrival.at(idx) = std::max(arrival.at(idx), sp.arrival);
+        else
+            arrival.at(idx) = sp.arrival;
+        domain_state.at(idx) = sp.false_startpoint ? DOMAIN_FALSE_START : DOMAIN_PRESENT;
+    }
+
+    // Go forwards topologically to find the maximum arrival time and max path length for each net, and the longest
+    // path into each endpoint
+    for (int net : topo_order) {
+        auto &nd = nets.at(net);
+        for (size_t d = 0; d < n_domains; d++) {
+            size_t idx = net * n_domains + d;
+            if (domain_state.at(idx) != DOMAIN_PRESENT)
+                continue;
+            const delay_t net_arrival = arrival.at(idx);
+            const unsigned net_length_plus_one = path_length.at(idx) + 1;
+            for (int s = nd.sinks_begin; s < nd.sinks_end; s++) {
+                auto &sd = sinks.at(s);
+                const delay_t usr_arrival = net_arrival + sd.delay;
+                for (int a = sd.arcs_begin; a < sd.arcs_end; a++) {
+                    auto &arc = arcs.at(a);
+                    size_t to_idx = arc.to_net * n_domains + d;
+                    if (domain_state.at(to_idx) == DOMAIN_ABSENT)
+                        domain_state.at(to_idx) = DOMAIN_PRESENT;
+                    arrival.at(to_idx) = std::max(arrival.at(to_idx), usr_arrival + arc.delay);
+                    // Do not increment path length if budget overriden since it doesn't require a share of the slack
+                    if (!sd.budget_override)
+                        path_length.at(to_idx) = std::max(path_length.at(to_idx), net_length_plus_one);
+                }
+                for (int e = sd.endpoints_begin; e < sd.endpoints_end; e++) {
+                    auto &ep = endpoints.at(e);
+                    // Only intra-domain paths are considered for criticality
+                    if (ep.domain != int(d))
+                        continue;
+                    delay_t endpoint_arrival = usr_arrival + ep.setup;
+                    if (!has_crit_delay.at(d) || endpoint_arrival > crit_delay.at(d)) {
+                        crit_delay.at(d) = endpoint_arrival;
+                        has_crit_delay.at(d) = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Go backwards topologically to set required times, ignoring unclocked paths
+    for (auto it = topo_order.rbegin(); it != topo_order.rend(); ++it) {
+        int net = *it;
+        auto &nd = nets.at(net);
+        for (size_t d = 1; d < n_domains; d++) {
+            size_t idx = net * n_domains + d;
+            if (domain_state.at(idx) != DOMAIN_PRESENT)
+                continue;
+            delay_t min_req = std::numeric_limits<delay_t>::max();
+            for (int s = nd.sinks_begin; s < nd.sinks_end; s++) {
+                auto &sd = sinks.at(s);
+                delay_t &req = required.at(s * n_domains + d);
+                for (int e = sd.endpoints_begin; e < sd.endpoints_end; e++) {
+                    auto &ep = endpoints.at(e);
+                    req = std::min(req, periods.at(d * n_domains + ep.domain) - ep.setup);
+                }
+                if (sd.cls == TMG_COMB_INPUT) {
+                    // Nets driven through this sink have already been visited
+                    for (int a = sd.arcs_begin; a < sd.arcs_end; a++) {
+                        auto &arc = arcs.at(a);
+                        size_t to_idx = arc.to_net * n_domains + d;
+                        if (domain_state.at(to_idx) == DOMAIN_PRESENT && nets.at(arc.to_net).in_topo)
+                            req = std::min(req, net_min_required.at(to_idx) - arc.delay);
+                    }
+                }
+                min_req = std::min(min_req, req - sd.delay);
+            }
+            net_min_required.at(idx) = min_req;
+        }
+    }
+}
+
+void TimingAnalyser::run()
+{
+    NPNR_TRACE_SCOPE("timing/run");
+    // Rebuild the graph if cells or nets have been added or removed since setup(), or it was invalidated
+    if (graph_stale || cells_generation != ctx->cells.generation() || nets_generation != ctx->nets.generation())
+        setup();
+    update_delays();
+    propagate();
+}
+
+void TimingAnalyser::get_criticalities(NetCriticalityMap *net_crit) const
+{
+    const size_t n_domains = domains.size();
     net_crit->clear();
-    Timing timing(ctx, true, true, &crit_paths, nullptr, net_crit);
-    timing.walk_paths();
+
+    // Assign slack values, finding the worst slack in each domain
+    std::vector<delay_t> worst_slack(n_domains, std::numeric_limits<delay_t>::max());
+    for (auto &nd : nets) {
+        if (!nd.in_topo || nd.sinks_begin == nd.sinks_end)
+            continue;
+        size_t net = &nd - nets.data();
+        for (size_t d = 1; d < n_domains; d++) {
+            size_t idx = net * n_domains + d;
+            if (domain_state.at(idx) != DOMAIN_PRESENT)
+                continue;
+            auto &nc = (*net_crit)[nd.net->name];
+            if (nc.slack.empty()) {
+                nc.slack.resize(nd.sinks_end - nd.sinks_begin, std::numeric_limits<delay_t>::max());
+                nc.criticality.resize(nd.sinks_end - nd.sinks_begin, 0);
+            }
+            for (int s = nd.sinks_begin; s < nd.sinks_end; s++) {
+                delay_t slack = required.at(s * n_domains + d) - (arrival.at(idx) + sinks.at(s).delay);
+                worst_slack.at(d) = std::min(worst_slack.at(d), slack);
+                nc.slack.at(s - nd.sinks_begin) = std::min(nc.slack.at(s - nd.sinks_begin), slack);
+            }
+        }
+    }
+
+    // Assign criticality values, normalised against the longest path in the domain
+    for (auto &nd : nets) {
+        if (!nd.in_topo || nd.sinks_begin == nd.sinks_end)
+            continue;
+        size_t net = &nd - nets.data();
+        for (size_t d = 1; d < n_domains; d++) {
+            size_t idx = net * n_domains + d;
+            if (domain_state.at(idx) != DOMAIN_PRESENT || !has_crit_delay.at(d))
+                continue;
+            auto &nc = net_crit->at(nd.net->name);
+            delay_t dmax = crit_delay.at(d);
+            for (int s = nd.sinks_begin; s < nd.sinks_end; s++) {
+                delay_t slack = required.at(s * n_domains + d) - (arrival.at(idx) + sinks.at(s).delay);
+                float criticality = 1.0f - ((float(slack) - float(worst_slack.at(d))) / dmax);
+                float &crit = nc.criticality.at(s - nd.sinks_begin);
+                crit = std::max<float>(crit, std::min<double>(1.0, std::max<double>(0.0, criticality)));
+            }
+            nc.max_path_length = std::max(nc.max_path_length, path_length.at(idx));
+            nc.cd_worst_slack = std::min(nc.cd_worst_slack, worst_slack.at(d));
+        }
+    }
+}
+
+TimingAnalyser &setup_timing_analyser(Context *ctx)
+{
+    if (!ctx->timing_analyser)
+        ctx->timing_analyser = std::make_shared<TimingAnalyser>(ctx);
+    ctx->timing_analyser->setup();
+    return *ctx->timing_analyser;
+}
+
+void get_criticalities(Context *ctx, NetCriticalityMap *net_crit)
+{
+    if (!ctx->timing_analyser)
+        setup_timing_analyser(ctx);
+    ctx->timing_analyser->run();
+    ctx->timing_analyser->get_criticalities(net_crit);
 }
 
 NEXTPNR_NAMESPACE_END
@@ -43,8 +43,132 @@ struct NetCriticalityInfo
 };
 
 typedef std::unordered_map<IdString, NetCriticalityInfo> NetCriticalityMap;
+
+// Persistent timing graph used to compute criticalities. The graph (ports, arcs,
+// topological order and clock domains) is built once by setup() and then kept on
+// the Context, so that repeated calls from the placer and router only need to
+// refresh the delays of arcs that changed and repropagate over flat arrays.
+//
+// Cell moves are picked up automatically, by comparing each cell's bel against the
+// one seen at the last update; changes to routing must be reported using
+// invalidate_net(). Cells and nets being added or removed are detected by run(),
+// from the generation of ctx->cells and ctx->nets; other changes to connectivity
+// must be reported using invalidate(), or by calling setup() again.
+struct TimingAnalyser
+{
+    explicit TimingAnalyser(Context *ctx) : ctx(ctx) {}
+
+    // Build the timing graph from the current netlist
+    void setup();
+    // Mark the whole graph as stale after a change to the netlist, so that run() rebuilds it
+    void invalidate() { graph_stale = true; }
+    // Mark the delays of all arcs of a net as stale, e.g. after it has been rerouted
+    void invalidate_net(const NetInfo *net);
+    void invalidate_all();
+    // Refresh any stale arc delays and recompute arrival/required times and slack
+    void run();
+    void get_criticalities(NetCriticalityMap *net_crit) const;
+
+  private:
+    Context *ctx;
+
+    struct ClockDomain
+    {
+        IdString clock;
+        ClockEdge edge;
+    };
+
+    struct NetData
+    {
+        NetInfo *net;
+        // Range of sinks in 'sinks', one per user in the same order as NetInfo::users
+        int sinks_begin, sinks_end;
+        // Set if the net is part of the topological order
+        bool in_topo = false;
+        bool dirty = true;
+    };
+
+    struct SinkData
+    {
+        int net;
+        TimingPortClass cls;
+        delay_t delay = 0;
+        bool budget_override = false;
+        // Ranges into 'arcs' (combinational arcs through the sink cell) and 'endpoints'
+        int arcs_begin, arcs_end;
+        int endpoints_begin, endpoints_end;
+    };
+
+    struct CombArc
+    {
+        int to_net;
+        delay_t delay;
+    };
+
+    struct Endpoint
+    {
+        int domain;
+        delay_t setup;
+    };
+
+    struct StartPoint
+    {
+        int net, domain;
+        delay_t arrival;
+        bool false_startpoint;
+    };
+
+    // Per-(net, domain) propagation state
+    enum : uint8_t
+    {
+        DOMAIN_ABSENT = 0,
+        DOMAIN_PRESENT = 1,
+        DOMAIN_FALSE_START = 2,
+    };
+
+    int domain_id(IdString clock, ClockEdge edge);
+    delay_t domain_period(int start, int end, delay_t clk_period) const;
+    void update_delays();
+    void propagate();
+
+    std::vector<ClockDomain> domains;
+    std::vector<NetData> nets;
+    std::vector<SinkData> sinks;
+    std::vector<CombArc> arcs;
+    std::vector<Endpoint> endpoints;
+    std::vector<StartPoint> startpoints;
+    std::vector<int> topo_order;
+    std::unordered_map<IdString, int> net_to_idx;
+
+    // Cells and the nets connected to them, used to detect moved cells
+    std::vector<CellInfo *> cells;
+    std::vector<BelId> cell_bels;
+    std::vector<int> cell_nets_begin, cell_nets;
+    bool any_dirty = true;
+    // Set by invalidate(), and otherwise the netlist generations the graph was built from
+    bool graph_stale = true;
+    uint64_t cells_generation = 0, nets_generation = 0;
+
+    // Flat propagation results, indexed by [net * domains.size() + domain]
+    // or [sink * domains.size() + domain]
+    std::vector<uint8_t> domain_state;
+    std::vector<delay_t> arrival;
+    std::vector<unsigned> path_length;
+    std::vector<delay_t> net_min_required;
+    std::vector<delay_t> required;
+    // Per-domain longest intra-domain path, used to normalise criticality
+    std::vector<delay_t> crit_delay;
+    std::vector<bool> has_crit_delay;
+};
+
+// Compute slack and criticality for all net users, using the persistent TimingAnalyser
+// on the Context (which is created on first use)
 void get_criticalities(Context *ctx, NetCriticalityMap *net_crit);
 
+// Get the Context's TimingAnalyser, rebuilding its graph from the current netlist.
+// Called at the start of each placement/routing pass
+TimingAnalyser &setup_timing_analyser(Context *ctx);
+
 NEXTPNR_NAMESPACE_END
 
 #endif
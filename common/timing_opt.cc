@@ -60,7 +60,6 @@ template <> struct hash<std::pair<int, NEXTPNR_NAMESPACE_PREFIX BelId>>
     }
 };
 #ifndef ARCH_GENERIC
-#ifndef ARCH_BORCA
 template <> struct hash<std::pair<NEXTPNR_NAMESPACE_PREFIX IdString, NEXTPNR_NAMESPACE_PREFIX BelId>>
 {
     std::size_t
@@ -73,7 +72,6 @@ template <> struct hash<std::pair<NEXTPNR_NAMESPACE_PREFIX IdString, NEXTPNR_NAM
     }
 };
 #endif
-#endif
 } // namespace std
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -88,6 +86,7 @@ class TimingOptimiser
         ctx->lock();
         if (ctx->verbose)
             timing_analysis(ctx, false, true, false, false);
+        setup_timing_analyser(ctx);
         for (int i = 0; i < 30; i++) {
             log_info("   Iteration %d...\n", i);
             get_criticalities(ctx, &net_crit);
@@ -0,0 +1,142 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "trace.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+NEXTPNR_NAMESPACE_BEGIN
+
+std::atomic<bool> trace_enabled_flag{false};
+
+namespace {
+
+struct TraceEvent
+{
+    const char *name;
+    // 'X' for a complete scope, where value is its duration, or 'C' for a counter
+    char phase;
+    double ts, value;
+};
+
+// Buffers are only ever appended to by their own thread, and are kept when the thread exits so
+// that its events can still be written out
+struct ThreadBuffer
+{
+    int tid;
+    std::vector<TraceEvent> events;
+};
+
+std::mutex buffers_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+std::chrono::steady_clock::time_point trace_epoch;
+thread_local ThreadBuffer *thread_buffer = nullptr;
+
+ThreadBuffer &get_thread_buffer()
+{
+    if (thread_buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        buffers.emplace_back(new ThreadBuffer());
+        buffers.back()->tid = int(buffers.size()) - 1;
+        thread_buffer = buffers.back().get();
+    }
+    return *thread_buffer;
+}
+
+void write_escaped(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', f);
+        if (uint8_t(*s) >= 0x20)
+            fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+} // namespace
+
+void trace_start()
+{
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        for (auto &buf : buffers)
+            buf->events.clear();
+        trace_epoch = std::chrono::steady_clock::now();
+    }
+    trace_enabled_flag.store(true);
+}
+
+double trace_now_us()
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - trace_epoch).count();
+}
+
+void trace_record_scope(const char *name, double start_us)
+{
+    double end_us = trace_now_us();
+    get_thread_buffer().events.push_back(TraceEvent{name, 'X', start_us, end_us - start_us});
+}
+
+void trace_record_counter(const char *name, double value)
+{
+    get_thread_buffer().events.push_back(TraceEvent{name, 'C', trace_now_us(), value});
+}
+
+bool trace_write(const std::string &filename)
+{
+    trace_enabled_flag.store(false);
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    FILE *f = fopen(filename.c_str(), "w");
+    if (f == nullptr)
+        return false;
+    fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool first = true;
+    for (auto &buf : buffers) {
+        if (buf->events.empty())
+            continue;
+        // Threads are numbered in the order they first recorded an event, which is the main thread first
+        char thread_name[32];
+        if (buf->tid == 0)
+            snprintf(thread_name, sizeof(thread_name), "main");
+        else
+            snprintf(thread_name, sizeof(thread_name), "worker %d", buf->tid);
+        fprintf(f, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+                   "\"args\": {\"name\": \"%s\"}}",
+                first ? "" : ",\n", buf->tid, thread_name);
+        first = false;
+        for (auto &ev : buf->events) {
+            fprintf(f, ",\n{\"name\": ");
+            write_escaped(f, ev.name);
+            if (ev.phase == 'X')
+                fprintf(f, ", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}", buf->tid, ev.ts,
+                        ev.value);
+            else
+                fprintf(f, ", \"ph\": \"C\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"args\": {\"value\": %.9g}}",
+                        buf->tid, ev.ts, ev.value);
+        }
+    }
+    fprintf(f, "\n]}\n");
+    bool ok = !ferror(f);
+    return (fclose(f) == 0) && ok;
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,76 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <string>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Hierarchical tracing of where the flow spends its time, written as Chrome trace-event JSON (--trace) for
+// chrome://tracing or Perfetto.
+//
+// NPNR_TRACE_SCOPE("name") records the time from the macro to the end of the enclosing block; scopes nest
+// naturally on each thread. trace_counter() records a value over time, such as the cost after each iteration.
+// Names must be string literals, as only the pointer is stored. Each thread records into a buffer of its own,
+// and when tracing is off a scope costs a single relaxed load and branch.
+
+extern std::atomic<bool> trace_enabled_flag;
+
+inline bool trace_enabled() { return trace_enabled_flag.load(std::memory_order_relaxed); }
+
+// Start recording events, discarding any recorded before
+void trace_start();
+// Stop recording and write the events as JSON; returns false if the file could not be written
+bool trace_write(const std::string &filename);
+
+// Microseconds since trace_start()
+double trace_now_us();
+void trace_record_scope(const char *name, double start_us);
+void trace_record_counter(const char *name, double value);
+
+inline void trace_counter(const char *name, double value)
+{
+    if (trace_enabled())
+        trace_record_counter(name, value);
+}
+
+struct TraceScope
+{
+    explicit TraceScope(const char *name) : name(name), start_us(trace_enabled() ? trace_now_us() : -1) {}
+    ~TraceScope()
+    {
+        if (start_us >= 0)
+            trace_record_scope(name, start_us);
+    }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+    const char *name;
+    double start_us;
+};
+
+#define NPNR_TRACE_CONCAT2(a, b) a##b
+#define NPNR_TRACE_CONCAT(a, b) NPNR_TRACE_CONCAT2(a, b)
+#define NPNR_TRACE_SCOPE(name) TraceScope NPNR_TRACE_CONCAT(trace_scope_, __LINE__)(name)
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -112,6 +112,13 @@ template <typename K, typename V> std::map<K, V *> sorted(const std::unordered_m
     return retVal;
 };
 
+// Iterate over the cells or nets of a context in their deterministic (insertion) order. Unlike the above this
+// does not copy anything; see IndexedStore::ordered_view for what happens if the store is modified meanwhile
+template <typename V> typename IndexedStore<V>::ordered_view sorted(const IndexedStore<V> &orig)
+{
+    return orig.ordered();
+}
+
 // Wrap an unordered_set, and allow it to be iterated over sorted by key
 template <typename K> std::set<K> sorted(const std::unordered_set<K> &orig)
 {
@@ -115,6 +115,11 @@ Arch::Arch(ArchArgs args) : args(args)
         log_error("Unsupported package '%s' for '%s'.\n", args.package.c_str(), getChipName().c_str());
 
     bel_to_cell.resize(chip_info->height * chip_info->width * max_loc_bels, nullptr);
+
+    tile_wire_base.reserve(chip_info->height * chip_info->width + 1);
+    tile_wire_base.push_back(0);
+    for (int i = 0; i < chip_info->height * chip_info->width; i++)
+        tile_wire_base.push_back(tile_wire_base.back() + chip_info->locations[chip_info->location_type[i]].num_wires);
 }
 
 // -----------------------------------------------------------------------
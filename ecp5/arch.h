@@ -480,6 +480,8 @@ struct Arch : BaseCtx
     std::unordered_map<WireId, NetInfo *> wire_to_net;
     std::unordered_map<PipId, NetInfo *> pip_to_net;
     std::unordered_map<WireId, int> wire_fanout;
+    // Offset of the first wire of each tile in the dense wire index, plus a final total
+    std::vector<int> tile_wire_base;
 
     ArchArgs args;
     Arch(ArchArgs args);
@@ -726,6 +728,12 @@ struct Arch : BaseCtx
         return range;
     }
 
+    int getWireIndex(WireId wire) const
+    {
+        return tile_wire_base[wire.location.y * chip_info->width + wire.location.x] + wire.index;
+    }
+    int getWireIndexCount() const { return tile_wire_base.back(); }
+
     IdString getWireBasename(WireId wire) const { return id(locInfo(wire)->wire_data[wire.index].name.get()); }
 
     WireId getWireByLocAndBasename(Location loc, std::string basename) const
@@ -47,8 +47,8 @@ void arch_wrap_python(py::module &m)
     fn_wrapper_2a<Context, decltype(&Context::isValidBelForCell), &Context::isValidBelForCell, pass_through<bool>,
                   addr_and_unwrap<CellInfo>, conv_from_str<BelId>>::def_wrap(ctx_cls, "isValidBelForCell");
 
-    typedef std::unordered_map<IdString, std::unique_ptr<CellInfo>> CellMap;
-    typedef std::unordered_map<IdString, std::unique_ptr<NetInfo>> NetMap;
+    typedef IndexedStore<CellInfo> CellMap;
+    typedef IndexedStore<NetInfo> NetMap;
     typedef std::unordered_map<IdString, IdString> AliasMap;
     typedef std::unordered_map<IdString, HierarchicalCell> HierarchyMap;
 
@@ -68,6 +68,11 @@
  *   const std::string& get_cell_type(const CellDataType &cell) const;
  *       gets the type of a cell
  *
+ *   (bit vectors and cell types may also be returned by value, for frontends that decode them on demand)
+ *
+ * The cells of each module are decoded once, on several threads, before the hierarchy is flattened; so the
+ * functions used on a CellDataType must be safe to call concurrently, and CellDataType must be cheap to copy.
+ *
  *   void foreach_attr(const {ModuleDataType|CellDataType|ModulePortDataType|NetnameDataType} &obj, Func) const;
  *       calls Func(const std::string &name, const Property &value);
  *       for each attribute on a module, cell, module port or net
@@ -105,6 +110,10 @@
  *
  */
 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <type_traits>
 #include "design_utils.h"
 #include "log.h"
 #include "nextpnr.h"
@@ -113,12 +122,37 @@ NEXTPNR_NAMESPACE_BEGIN
 
 namespace {
 
+// A port connection of a StagedCell
+struct StagedConn
+{
+    std::string name;
+    bool has_dir = false;
+    PortType dir = PORT_IN;
+    // Signal numbers, or a constant [01xz] as its negated character code
+    std::vector<int> bits;
+};
+
+// A cell of a module definition, decoded from the frontend data ahead of the import
+struct StagedCell
+{
+    std::string name;
+    IdString type;
+    std::vector<StagedConn> conns;
+    std::vector<std::pair<IdString, Property>> attrs, params;
+};
+
 // Used for hierarchy resolution
 struct ModuleInfo
 {
     bool is_top = false, is_blackbox = false, is_whitebox = false;
     inline bool is_box() const { return is_blackbox || is_whitebox; }
-    std::unordered_set<IdString> instantiated_celltypes;
+    // Cell type -> number of cells of that type
+    std::unordered_map<IdString, int> instantiated_celltypes;
+    // Number of instances of the module still to be imported
+    int64_t instances_left = 0;
+    // Decoded when the module is first imported, however many times it is instantiated, and freed after the last
+    bool staged = false;
+    std::vector<StagedCell> cells;
 };
 
 template <typename FrontendType> struct GenericFrontend
@@ -133,6 +167,7 @@ template <typename FrontendType> struct GenericFrontend
         m.prefix = "";
         m.path = top;
         ctx->top_module = top;
+        count_instances(top, 1);
         // Do the actual import, starting from the top level module
         import_module(m, top.str(ctx), top.str(ctx), mod_refs.at(top));
     }
@@ -144,6 +179,7 @@ template <typename FrontendType> struct GenericFrontend
     using cell_dat_t = typename FrontendType::CellDataType;
     using netname_dat_t = typename FrontendType::NetnameDataType;
     using bitvector_t = typename FrontendType::BitVectorDataType;
+    using cell_handle_t = typename std::decay<cell_dat_t>::type;
 
     std::unordered_map<IdString, ModuleInfo> mods;
     std::unordered_map<IdString, const mod_dat_t &> mod_refs;
@@ -166,7 +202,7 @@ template <typename FrontendType> struct GenericFrontend
                     mi.is_whitebox = (value.intval != 0);
             });
             impl.foreach_cell(mod, [&](const std::string &name, const cell_dat_t &cell) {
-                mi.instantiated_celltypes.insert(ctx->id(impl.get_cell_type(cell)));
+                mi.instantiated_celltypes[ctx->id(impl.get_cell_type(cell))]++;
             });
         });
         // First of all, see if a top module has been manually specified
@@ -199,7 +235,7 @@ template <typename FrontendType> struct GenericFrontend
                 candidate_top.insert(mod.first);
         for (auto &mod : mods)
             for (auto &c : mod.second.instantiated_celltypes)
-                candidate_top.erase(c);
+                candidate_top.erase(c.first);
         if (candidate_top.size() != 1) {
             if (candidate_top.size() == 0)
                 log_info("No candidate top level modules.\n");
@@ -211,6 +247,117 @@ template <typename FrontendType> struct GenericFrontend
         top = *(candidate_top.begin());
     }
 
+    void stage_cell(StagedCell &sc, const cell_dat_t &cd)
+    {
+        sc.type = ctx->id(impl.get_cell_type(cd));
+        std::unordered_map<std::string, PortType> port_dirs;
+        impl.foreach_port_dir(cd, [&](const std::string &port, PortType dir) { port_dirs[port] = dir; });
+        impl.foreach_port_conn(cd, [&](const std::string &name, const bitvector_t &bits) {
+            sc.conns.emplace_back();
+            StagedConn &conn = sc.conns.back();
+            conn.name = name;
+            auto dir = port_dirs.find(name);
+            if (dir != port_dirs.end()) {
+                conn.has_dir = true;
+                conn.dir = dir->second;
+            }
+            int width = impl.get_vector_length(bits);
+            conn.bits.reserve(width);
+            for (int i = 0; i < width; i++)
+                conn.bits.push_back(impl.is_vector_bit_constant(bits, i) ? -int(impl.get_vector_bit_constval(bits, i))
+                                                                         : impl.get_vector_bit_signal(bits, i));
+        });
+        impl.foreach_attr(cd, [&](const std::string &name, const Property &value) {
+            sc.attrs.emplace_back(ctx->id(name), value);
+        });
+        impl.foreach_param(cd, [&](const std::string &name, const Property &value) {
+            sc.params.emplace_back(ctx->id(name), value);
+        });
+    }
+
+    // Count how many times each module is instantiated below the top one, so that its staged cells can be freed
+    // once the last instance has been imported
+    void count_instances(IdString mod_type, int64_t count)
+    {
+        auto &mi = mods.at(mod_type);
+        mi.instances_left += count;
+        for (auto &c : mi.instantiated_celltypes)
+            if (mods.count(c.first) && !mods.at(c.first).is_box())
+                count_instances(c.first, count * c.second);
+    }
+
+    // Decode the cells of a module, in chunks spread over frontend/threads threads. Each chunk writes only its own
+    // cells, so the result does not depend on the thread count. Workers do not print errors themselves; the error
+    // of the first failing chunk is reported from the calling thread once they are done.
+    void stage_cells(ModuleInfo &mi, IdString mod_type)
+    {
+        std::vector<cell_handle_t> handles;
+        impl.foreach_cell(mod_refs.at(mod_type), [&](const std::string &name, const cell_dat_t &cell) {
+            mi.cells.emplace_back();
+            mi.cells.back().name = name;
+            handles.push_back(cell);
+        });
+        mi.staged = true;
+
+        const size_t chunk_size = 256;
+        size_t num_chunks = (handles.size() + chunk_size - 1) / chunk_size;
+#ifdef NPNR_DISABLE_THREADS
+        int threads = 1;
+#else
+        int threads = std::max(1, ctx->setting<int>("frontend/threads", int(boost::thread::hardware_concurrency())));
+#endif
+        threads = std::max(1, std::min(threads, int(num_chunks)));
+
+        std::atomic<size_t> next_chunk(0);
+        // Chunks are handed out in order, so once a chunk fails, all those before it have been or are being staged
+        std::mutex error_mutex;
+        size_t error_chunk = num_chunks;
+        std::string error_message;
+        std::exception_ptr error;
+        auto worker = [&]() {
+            LogErrorCapture capture;
+            for (size_t c = next_chunk++; c < num_chunks; c = next_chunk++) {
+                {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (c > error_chunk)
+                        break;
+                }
+                try {
+                    for (size_t i = c * chunk_size; i < std::min(handles.size(), (c + 1) * chunk_size); i++)
+                        stage_cell(mi.cells.at(i), handles.at(i));
+                } catch (log_execution_error_exception) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (c < error_chunk) {
+                        error_chunk = c;
+                        error_message = capture.message;
+                        error = nullptr;
+                    }
+                    capture.message.clear();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (c < error_chunk) {
+                        error_chunk = c;
+                        error = std::current_exception();
+                    }
+                }
+            }
+        };
+#ifdef NPNR_DISABLE_THREADS
+        worker();
+#else
+        std::vector<boost::thread> workers;
+        for (int i = 1; i < threads; i++)
+            workers.emplace_back(worker);
+        worker();
+        for (auto &w : workers)
+            w.join();
+#endif
+        if (error)
+            std::rethrow_exception(error);
+        if (error_chunk != num_chunks)
+            log_error("%s", error_message.c_str());
+    }
+
     // Create a unique name (guaranteed collision free) for a net or a cell; based on
     // a base name and suffix. __unique__i will be be appended with increasing i
     // if a collision is found until no collision
@@ -283,7 +430,7 @@ template <typename FrontendType> struct GenericFrontend
             });
         }
         import_module_netnames(m, data);
-        import_module_cells(m, data);
+        import_module_cells(m, ctx->id(type));
         import_net_attrs(m, data);
         if (m.is_toplevel) {
             import_toplevel_ports(m, data);
@@ -442,22 +589,21 @@ template <typename FrontendType> struct GenericFrontend
     }
 
     // Import a leaf cell - (white|black)box
-    void import_leaf_cell(HierModuleState &m, const std::string &name, const cell_dat_t &cd)
+    void import_leaf_cell(HierModuleState &m, const StagedCell &sc)
     {
+        const std::string &name = sc.name;
         IdString inst_name = unique_name(m.prefix, name, false);
         ctx->hierarchy[m.path].leaf_cells_by_gname[inst_name] = ctx->id(name);
         ctx->hierarchy[m.path].leaf_cells[ctx->id(name)] = inst_name;
-        CellInfo *ci = ctx->createCell(inst_name, ctx->id(impl.get_cell_type(cd)));
+        CellInfo *ci = ctx->createCell(inst_name, sc.type);
         ci->hierpath = m.path;
-        // Import port directions
-        std::unordered_map<IdString, PortType> port_dirs;
-        impl.foreach_port_dir(cd, [&](const std::string &port, PortType dir) { port_dirs[ctx->id(port)] = dir; });
         // Import port connectivity
-        impl.foreach_port_conn(cd, [&](const std::string &name, const bitvector_t &bits) {
-            if (!port_dirs.count(ctx->id(name)))
+        for (auto &conn : sc.conns) {
+            const std::string &name = conn.name;
+            if (!conn.has_dir)
                 log_error("Failed to get direction for port '%s' of cell '%s'\n", name.c_str(), inst_name.c_str(ctx));
-            PortType dir = port_dirs.at(ctx->id(name));
-            int width = impl.get_vector_length(bits);
+            PortType dir = conn.dir;
+            int width = int(conn.bits.size());
             for (int i = 0; i < width; i++) {
                 std::string port_bit_name = get_bit_name(name, i, width);
                 IdString port_bit_ids = ctx->id(port_bit_name);
@@ -466,13 +612,13 @@ template <typename FrontendType> struct GenericFrontend
                 ci->ports[port_bit_ids].type = dir;
                 // Resolve connectivity
                 NetInfo *net;
-                if (impl.is_vector_bit_constant(bits, i)) {
+                int bit = conn.bits.at(i);
+                if (bit < 0) {
                     // Create a constant driver if one is needed
-                    net = create_constant_net(m, inst_name.str(ctx) + "." + port_bit_name + "$const",
-                                              impl.get_vector_bit_constval(bits, i));
+                    net = create_constant_net(m, inst_name.str(ctx) + "." + port_bit_name + "$const", char(-bit));
                 } else {
                     // Otherwise, lookup (creating if needed) the net with this index
-                    net = create_or_get_net(m, impl.get_vector_bit_signal(bits, i));
+                    net = create_or_get_net(m, bit);
                 }
                 NPNR_ASSERT(net != nullptr);
 
@@ -483,42 +629,44 @@ template <typename FrontendType> struct GenericFrontend
                               port_bit_name.c_str());
                 connect_port(ctx, net, ci, port_bit_ids);
             }
-        });
+        }
         // Import attributes and parameters
-        impl.foreach_attr(cd,
-                          [&](const std::string &name, const Property &value) { ci->attrs[ctx->id(name)] = value; });
-        impl.foreach_param(cd,
-                           [&](const std::string &name, const Property &value) { ci->params[ctx->id(name)] = value; });
+        for (auto &attr : sc.attrs)
+            ci->attrs[attr.first] = attr.second;
+        for (auto &param : sc.params)
+            ci->params[param.first] = param.second;
     }
 
     // Import a submodule cell
-    void import_submodule_cell(HierModuleState &m, const std::string &name, const cell_dat_t &cd)
+    void import_submodule_cell(HierModuleState &m, const StagedCell &sc)
     {
+        const std::string &name = sc.name;
         HierModuleState submod;
         submod.is_toplevel = false;
         // Create mapping from submodule port to nets (referenced by index in flatindex)
-        impl.foreach_port_conn(cd, [&](const std::string &name, const bitvector_t &bits) {
-            int width = impl.get_vector_length(bits);
+        for (auto &conn : sc.conns) {
+            const std::string &name = conn.name;
+            int width = int(conn.bits.size());
             for (int i = 0; i < width; i++) {
                 // Index of port net in flatindex
                 int net_ref = -1;
-                if (impl.is_vector_bit_constant(bits, i)) {
+                int bit = conn.bits.at(i);
+                if (bit < 0) {
                     // Create a constant driver if one is needed
                     std::string port_bit_name = get_bit_name(name, i, width);
-                    NetInfo *cnet = create_constant_net(m, name + "." + port_bit_name + "$const",
-                                                        impl.get_vector_bit_constval(bits, i));
+                    NetInfo *cnet = create_constant_net(m, name + "." + port_bit_name + "$const", char(-bit));
                     cnet->udata = int(net_flatindex.size());
                     net_flatindex.push_back(cnet);
                     net_old_indices.emplace_back();
                     net_ref = cnet->udata;
                 } else {
                     // Otherwise, lookup (creating if needed) the net with given in-module index
-                    net_ref = create_or_get_net(m, impl.get_vector_bit_signal(bits, i))->udata;
+                    net_ref = create_or_get_net(m, bit)->udata;
                 }
                 NPNR_ASSERT(net_ref != -1);
                 submod.port_to_bus[ctx->id(name)].push_back(net_ref);
             }
-        });
+        }
         // Create prefix for submodule
         submod.prefix = m.prefix;
         submod.prefix += name;
@@ -527,23 +675,29 @@ template <typename FrontendType> struct GenericFrontend
         submod.path = ctx->id(m.path.str(ctx) + "/" + name);
         ctx->hierarchy[m.path].hier_cells[ctx->id(name)] = submod.path;
         // Do the submodule import
-        auto type = impl.get_cell_type(cd);
-        import_module(submod, name, type, mod_refs.at(ctx->id(type)));
+        import_module(submod, name, sc.type.str(ctx), mod_refs.at(sc.type));
     }
 
-    // Import the cells section of a module
-    void import_module_cells(HierModuleState &m, const mod_dat_t &data)
+    // Import the cells section of a module, staging them on its first import and freeing them after its last
+    void import_module_cells(HierModuleState &m, IdString mod_type)
     {
-        impl.foreach_cell(data, [&](const std::string &cellname, const cell_dat_t &cd) {
-            IdString type = ctx->id(impl.get_cell_type(cd));
-            if (mods.count(type) && !mods.at(type).is_box()) {
+        auto &mi = mods.at(mod_type);
+        if (!mi.staged)
+            stage_cells(mi, mod_type);
+        auto &cells = mi.cells;
+        for (auto &sc : cells) {
+            if (mods.count(sc.type) && !mods.at(sc.type).is_box()) {
                 // Module type is known; and not boxed. Import as a submodule by flattening hierarchy
-                import_submodule_cell(m, cellname, cd);
+                import_submodule_cell(m, sc);
             } else {
                 // Module type is unknown or boxes. Import as a leaf cell (nextpnr CellInfo)
-                import_leaf_cell(m, cellname, cd);
+                import_leaf_cell(m, sc);
             }
-        });
+        }
+        if (--mi.instances_left <= 0) {
+            std::vector<StagedCell>().swap(cells);
+            mi.staged = false;
+        }
     }
 
     // Create a top level input/output buffer
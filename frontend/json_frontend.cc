@@ -16,61 +16,472 @@
  *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  *
  */
-
 #include "json_frontend.h"
+#include <algorithm>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include "frontend_base.h"
-#include "json11.hpp"
 #include "log.h"
 #include "nextpnr.h"
 
-#include <streambuf>
-
 NEXTPNR_NAMESPACE_BEGIN
 
-using namespace json11;
+namespace {
+
+// A value in the JSON text. Nothing is parsed until it is needed, so the netlist never exists as a DOM; cells and
+// nets are imported straight from the (usually memory-mapped) file.
+struct JsonValue
+{
+    JsonValue() : ptr(nullptr) {}
+    explicit JsonValue(const char *ptr) : ptr(ptr) {}
+    const char *ptr;
+    bool is_null() const { return ptr == nullptr; }
+};
+
+// The sections of a module, found once so that they are not searched for on every pass of the frontend
+struct JsonModule
+{
+    JsonValue attributes, ports, cells, netnames, settings;
+};
+
+class JsonText
+{
+  public:
+    JsonText(const char *begin, const char *end, const std::string &filename)
+            : begin(begin), end(end), filename(filename)
+    {
+    }
+
+    // Check the syntax of the whole text once, so that the lazy accessors below can assume it is well formed
+    JsonValue validate() const
+    {
+        const char *p = skip_ws(begin);
+        JsonValue root{p};
+        p = skip_ws(validate_value(p, 0));
+        if (p != end)
+            error(p, "unexpected trailing characters");
+        return root;
+    }
+
+    bool is_string(JsonValue v) const { return *v.ptr == '"'; }
+    bool is_object(JsonValue v) const { return *v.ptr == '{'; }
+    bool is_number(JsonValue v) const { return *v.ptr == '-' || (*v.ptr >= '0' && *v.ptr <= '9'); }
+
+    // Calls Func(const std::string &key, JsonValue value) for each member of an object
+    template <typename TFunc> void foreach_member(JsonValue obj, TFunc Func) const
+    {
+        if (obj.is_null())
+            return;
+        if (!is_object(obj))
+            error(obj.ptr, "expected an object");
+        std::string key;
+        const char *p = skip_ws(obj.ptr + 1);
+        while (*p != '}') {
+            p = decode_string(p, key);
+            JsonValue value{skip_ws(skip_ws(p) + 1)};
+            Func(key, value);
+            p = skip_ws(skip_value(value.ptr));
+            if (*p == ',')
+                p = skip_ws(p + 1);
+        }
+    }
+
+    // Calls Func(JsonValue value) for each element of an array
+    template <typename TFunc> void foreach_element(JsonValue arr, TFunc Func) const
+    {
+        if (arr.is_null())
+            return;
+        if (*arr.ptr != '[')
+            error(arr.ptr, "expected an array");
+        const char *p = skip_ws(arr.ptr + 1);
+        while (*p != ']') {
+            Func(JsonValue{p});
+            p = skip_ws(skip_value(p));
+            if (*p == ',')
+                p = skip_ws(p + 1);
+        }
+    }
+
+    // Find a member of an object by name, or a null value if there is none
+    JsonValue member(JsonValue obj, const char *name) const
+    {
+        if (obj.is_null() || !is_object(obj))
+            return JsonValue();
+        size_t name_len = strlen(name);
+        const char *p = skip_ws(obj.ptr + 1);
+        while (*p != '}') {
+            bool escaped;
+            const char *key_end = scan_string(p, escaped);
+            bool match = !escaped && size_t(key_end - p - 2) == name_len && memcmp(p + 1, name, name_len) == 0;
+            const char *value = skip_ws(skip_ws(key_end) + 1);
+            if (match)
+                return JsonValue{value};
+            p = skip_ws(skip_value(value));
+            if (*p == ',')
+                p = skip_ws(p + 1);
+        }
+        return JsonValue();
+    }
+
+    std::string get_string(JsonValue v) const
+    {
+        std::string s;
+        if (v.is_null())
+            return s;
+        if (!is_string(v))
+            error(v.ptr, "expected a string");
+        decode_string(v.ptr, s);
+        return s;
+    }
+
+    // The characters of a string without escapes, straight from the text; false if it has escapes
+    bool get_raw_string(JsonValue v, const char *&data, size_t &len) const
+    {
+        bool escaped;
+        const char *str_end = scan_string(v.ptr, escaped);
+        data = v.ptr + 1;
+        len = size_t(str_end - v.ptr - 2);
+        return !escaped;
+    }
+
+    double get_number(JsonValue v) const
+    {
+        if (!is_number(v))
+            error(v.ptr, "expected a number");
+        // The number is always followed by a delimiter inside the text, so strtod cannot run off the end
+        return strtod(v.ptr, nullptr);
+    }
+
+    int get_int(JsonValue v) const
+    {
+        if (!is_number(v))
+            error(v.ptr, "expected a number");
+        const char *p = v.ptr;
+        bool neg = (*p == '-');
+        if (neg)
+            p++;
+        int64_t value = 0;
+        while (*p >= '0' && *p <= '9' && value <= INT32_MAX)
+            value = value * 10 + (*p++ - '0');
+        if (*p == '.' || *p == 'e' || *p == 'E' || value > INT32_MAX)
+            return int(get_number(v));
+        return int(neg ? -value : value);
+    }
+
+    NPNR_NORETURN void error(const char *p, const char *msg) const
+    {
+        int line = 1 + int(std::count(begin, std::min(p, end), '\n'));
+        log_error("Failed to parse JSON file '%s': %s on line %d.\n", filename.c_str(), msg, line);
+    }
+
+  private:
+    const char *begin, *end;
+    const std::string &filename;
+
+    static const int max_depth = 200;
+
+    // Whitespace and comments
+    const char *skip_ws(const char *p) const
+    {
+        while (p != end) {
+            if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+                p++;
+            } else if (*p == '/' && p + 1 != end && p[1] == '/') {
+                p = std::find(p, end, '\n');
+            } else if (*p == '/' && p + 1 != end && p[1] == '*') {
+                const char *close = std::search(p + 2, end, "*/", "*/" + 2);
+                if (close == end)
+                    error(p, "unterminated comment");
+                p = close + 2;
+            } else {
+                break;
+            }
+        }
+        return p;
+    }
+
+    // The end of the string starting at p (after the closing quote)
+    const char *scan_string(const char *p, bool &escaped) const
+    {
+        escaped = false;
+        for (p++;; p++) {
+            if (*p == '\\') {
+                escaped = true;
+                p++;
+            } else if (*p == '"') {
+                return p + 1;
+            }
+        }
+    }
+
+    // The end of the (already validated) value starting at p
+    const char *skip_value(const char *p) const
+    {
+        if (*p == '"') {
+            bool escaped;
+            return scan_string(p, escaped);
+        }
+        if (*p != '{' && *p != '[') {
+            while (p != end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\r' &&
+                   *p != '\n' && *p != '/')
+                p++;
+            return p;
+        }
+        int depth = 0;
+        for (;; p++) {
+            if (*p == '"') {
+                bool escaped;
+                p = scan_string(p, escaped) - 1;
+            } else if (*p == '{' || *p == '[') {
+                depth++;
+            } else if (*p == '}' || *p == ']') {
+                if (--depth == 0)
+                    return p + 1;
+            } else if (*p == '/') {
+                p = skip_ws(p) - 1;
+            }
+        }
+    }
+
+    static void append_utf8(std::string &out, uint32_t cp)
+    {
+        if (cp < 0x80) {
+            out += char(cp);
+        } else if (cp < 0x800) {
+            out += char(0xC0 | (cp >> 6));
+            out += char(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += char(0xE0 | (cp >> 12));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        } else {
+            out += char(0xF0 | (cp >> 18));
+            out += char(0x80 | ((cp >> 12) & 0x3F));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        }
+    }
+
+    static uint32_t parse_hex4(const char *p)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = p[i];
+            value = (value << 4) | uint32_t(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+        }
+        return value;
+    }
+
+    // Decode the (already validated) string starting at p into out, reusing its storage; returns the end of the string
+    const char *decode_string(const char *p, std::string &out) const
+    {
+        out.clear();
+        const char *run = ++p;
+        for (;; p++) {
+            if (*p == '"') {
+                out.append(run, p);
+                return p + 1;
+            }
+            if (*p != '\\')
+                continue;
+            out.append(run, p);
+            p++;
+            switch (*p) {
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u': {
+                uint32_t cp = parse_hex4(p + 1);
+                p += 4;
+                if (cp >= 0xD800 && cp < 0xDC00 && p[1] == '\\' && p[2] == 'u') {
+                    uint32_t low = parse_hex4(p + 3);
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    }
+                }
+                append_utf8(out, cp);
+                break;
+            }
+            default:
+                out += *p;
+                break;
+            }
+            run = p + 1;
+        }
+    }
+
+    const char *validate_string(const char *p) const
+    {
+        for (p++;; p++) {
+            if (p == end)
+                error(p, "unterminated string");
+            if (*p == '"')
+                return p + 1;
+            if (uint8_t(*p) < 0x20)
+                error(p, "unescaped control character in string");
+            if (*p != '\\')
+                continue;
+            if (++p == end)
+                error(p, "unterminated string");
+            if (*p == 'u') {
+                for (int i = 0; i < 4; i++)
+                    if (++p == end || !isxdigit(uint8_t(*p)))
+                        error(p, "invalid \\u escape");
+            } else if (strchr("\"\\/bfnrt", *p) == nullptr) {
+                error(p, "invalid escape");
+            }
+        }
+    }
+
+    const char *validate_literal(const char *p, const char *literal) const
+    {
+        size_t len = strlen(literal);
+        if (size_t(end - p) < len || memcmp(p, literal, len) != 0)
+            error(p, "invalid value");
+        return p + len;
+    }
+
+    const char *validate_number(const char *p) const
+    {
+        auto digits = [&](const char *q) {
+            const char *start = q;
+            while (q != end && *q >= '0' && *q <= '9')
+                q++;
+            if (q == start)
+                error(q, "invalid number");
+            return q;
+        };
+        if (*p == '-')
+            p++;
+        p = digits(p);
+        if (p != end && *p == '.')
+            p = digits(p + 1);
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            p++;
+            if (p != end && (*p == '+' || *p == '-'))
+                p++;
+            p = digits(p);
+        }
+        return p;
+    }
+
+    const char *validate_value(const char *p, int depth) const
+    {
+        if (p == end)
+            error(p, "unexpected end of file");
+        if (depth > max_depth)
+            error(p, "too deeply nested");
+        switch (*p) {
+        case '"':
+            return validate_string(p);
+        case '{':
+        case '[': {
+            char close = (*p == '{') ? '}' : ']';
+            bool is_obj = (*p == '{');
+            p = skip_ws(p + 1);
+            if (p != end && *p == close)
+                return p + 1;
+            while (true) {
+                if (is_obj) {
+                    if (p == end || *p != '"')
+                        error(p, "expected an object key");
+                    p = skip_ws(validate_string(p));
+                    if (p == end || *p != ':')
+                        error(p, "expected ':'");
+                    p = skip_ws(p + 1);
+                }
+                p = skip_ws(validate_value(p, depth + 1));
+                if (p == end)
+                    error(p, "unexpected end of file");
+                if (*p == close)
+                    return p + 1;
+                if (*p != ',')
+                    error(p, is_obj ? "expected ',' or '}'" : "expected ',' or ']'");
+                p = skip_ws(p + 1);
+            }
+        }
+        case 't':
+            return validate_literal(p, "true");
+        case 'f':
+            return validate_literal(p, "false");
+        case 'n':
+            return validate_literal(p, "null");
+        default:
+            if (*p == '-' || (*p >= '0' && *p <= '9'))
+                return validate_number(p);
+            error(p, "invalid value");
+        }
+    }
+};
 
 struct JsonFrontendImpl
 {
     // See specification in frontend_base.h
-    JsonFrontendImpl(Json &root) : root(root){};
-    Json &root;
-    typedef const Json &ModuleDataType;
-    typedef const Json &ModulePortDataType;
-    typedef const Json &CellDataType;
-    typedef const Json &NetnameDataType;
-    typedef const Json::array &BitVectorDataType;
+    JsonFrontendImpl(const JsonText &text, JsonValue modules) : text(text)
+    {
+        text.foreach_member(modules, [&](const std::string &name, JsonValue mod) {
+            JsonModule md;
+            text.foreach_member(mod, [&](const std::string &key, JsonValue value) {
+                if (key == "attributes")
+                    md.attributes = value;
+                else if (key == "ports")
+                    md.ports = value;
+                else if (key == "cells")
+                    md.cells = value;
+                else if (key == "netnames")
+                    md.netnames = value;
+                else if (key == "settings")
+                    md.settings = value;
+            });
+            module_list.emplace_back(name, md);
+        });
+    }
+    const JsonText &text;
+    std::vector<std::pair<std::string, JsonModule>> module_list;
+
+    typedef JsonModule ModuleDataType;
+    typedef JsonValue ModulePortDataType;
+    typedef JsonValue CellDataType;
+    typedef JsonValue NetnameDataType;
+    // Signal numbers, or a constant [01xz] as its negated character code
+    typedef std::vector<int> BitVectorDataType;
 
     template <typename TFunc> void foreach_module(TFunc Func) const
     {
-        for (const auto &mod : root.object_items())
+        for (const auto &mod : module_list)
             Func(mod.first, mod.second);
     }
 
-    template <typename TFunc> void foreach_port(ModuleDataType &mod, TFunc Func) const
+    template <typename TFunc> void foreach_port(const ModuleDataType &mod, TFunc Func) const
     {
-        const auto &ports = mod["ports"];
-        if (ports.is_null())
-            return;
-        for (const auto &port : ports.object_items())
-            Func(port.first, port.second);
+        text.foreach_member(mod.ports, Func);
     }
 
-    template <typename TFunc> void foreach_cell(ModuleDataType &mod, TFunc Func) const
+    template <typename TFunc> void foreach_cell(const ModuleDataType &mod, TFunc Func) const
     {
-        const auto &cells = mod["cells"];
-        if (cells.is_null())
-            return;
-        for (const auto &cell : cells.object_items())
-            Func(cell.first, cell.second);
+        text.foreach_member(mod.cells, Func);
     }
 
-    template <typename TFunc> void foreach_netname(ModuleDataType &mod, TFunc Func) const
+    template <typename TFunc> void foreach_netname(const ModuleDataType &mod, TFunc Func) const
     {
-        const auto &netnames = mod["netnames"];
-        if (netnames.is_null())
-            return;
-        for (const auto &netname : netnames.object_items())
-            Func(netname.first, netname.second);
+        text.foreach_member(mod.netnames, Func);
     }
 
     PortType lookup_portdir(const std::string &dir) const
@@ -85,119 +496,165 @@ struct JsonFrontendImpl
             NPNR_ASSERT_FALSE("invalid json port direction");
     }
 
-    PortType get_port_dir(ModulePortDataType &port) const { return lookup_portdir(port["direction"].string_value()); }
+    PortType get_port_dir(const ModulePortDataType &port) const
+    {
+        return lookup_portdir(text.get_string(text.member(port, "direction")));
+    }
+
+    int get_array_offset(JsonValue obj) const
+    {
+        auto offset = text.member(obj, "offset");
+        return offset.is_null() ? 0 : text.get_int(offset);
+    }
 
-    int get_array_offset(const Json &obj) const
+    bool is_array_upto(JsonValue obj) const
     {
-        auto offset = obj["offset"];
-        return offset.is_null() ? 0 : offset.int_value();
+        auto upto = text.member(obj, "upto");
+        return upto.is_null() ? false : bool(text.get_int(upto));
     }
 
-    bool is_array_upto(const Json &obj) const
+    BitVectorDataType get_bits(JsonValue arr) const
     {
-        auto upto = obj["upto"];
-        return upto.is_null() ? false : bool(upto.int_value());
+        BitVectorDataType bits;
+        text.foreach_element(arr, [&](JsonValue bit) {
+            if (text.is_string(bit)) {
+                const char *data;
+                size_t len;
+                if (!text.get_raw_string(bit, data, len) || len != 1)
+                    text.error(bit.ptr, "invalid constant bit");
+                bits.push_back(-int(data[0]));
+            } else {
+                bits.push_back(text.get_int(bit));
+            }
+        });
+        return bits;
     }
 
-    BitVectorDataType &get_port_bits(ModulePortDataType &port) const { return port["bits"].array_items(); }
+    BitVectorDataType get_port_bits(const ModulePortDataType &port) const
+    {
+        return get_bits(text.member(port, "bits"));
+    }
 
-    const std::string &get_cell_type(CellDataType &cell) const { return cell["type"].string_value(); }
+    std::string get_cell_type(const CellDataType &cell) const { return text.get_string(text.member(cell, "type")); }
 
-    Property parse_property(const Json &val) const
+    Property parse_property(JsonValue val) const
     {
-        if (val.is_number()) {
-            if (val.int_value() != val.number_value())
+        if (text.is_number(val)) {
+            double number = text.get_number(val);
+            if (number < INT32_MIN || number > INT32_MAX || number != std::floor(number))
                 log_error("Found an out-of-range integer parameter in the JSON file.\n"
                           "Please regenerate the input file with an up-to-date version of yosys.\n");
-            return Property(val.int_value(), 32);
-        } else {
-            return Property::from_string(val.string_value());
+            return Property(int(number), 32);
+        }
+        const char *data;
+        size_t len;
+        if (text.is_string(val) && text.get_raw_string(val, data, len) && len > 0 &&
+            std::all_of(data, data + len, [](char c) { return c == '0' || c == '1' || c == 'x' || c == 'z'; })) {
+            // Bit strings, such as large INIT values, are stored LSB first straight from the text
+            Property p;
+            p.is_string = false;
+            p.str.assign(std::reverse_iterator<const char *>(data + len), std::reverse_iterator<const char *>(data));
+            p.update_intval();
+            return p;
         }
+        return Property::from_string(text.get_string(val));
     }
 
-    template <typename TFunc> void foreach_attr(const Json &obj, TFunc Func) const
+    template <typename TFunc> void foreach_property(JsonValue dict, TFunc Func) const
     {
-        const auto &attrs = obj["attributes"];
-        if (attrs.is_null())
-            return;
-        for (const auto &attr : attrs.object_items()) {
-            Func(attr.first, parse_property(attr.second));
-        }
+        text.foreach_member(dict, [&](const std::string &name, JsonValue value) { Func(name, parse_property(value)); });
     }
 
-    template <typename TFunc> void foreach_param(const Json &obj, TFunc Func) const
+    template <typename TFunc> void foreach_attr(const ModuleDataType &mod, TFunc Func) const
     {
-        const auto &params = obj["parameters"];
-        if (params.is_null())
-            return;
-        for (const auto &param : params.object_items()) {
-            Func(param.first, parse_property(param.second));
-        }
+        foreach_property(mod.attributes, Func);
     }
 
-    template <typename TFunc> void foreach_setting(const Json &obj, TFunc Func) const
+    template <typename TFunc> void foreach_attr(JsonValue obj, TFunc Func) const
     {
-        const auto &settings = obj["settings"];
-        if (settings.is_null())
-            return;
-        for (const auto &setting : settings.object_items()) {
-            Func(setting.first, parse_property(setting.second));
-        }
+        foreach_property(text.member(obj, "attributes"), Func);
     }
 
-    template <typename TFunc> void foreach_port_dir(CellDataType &cell, TFunc Func) const
+    template <typename TFunc> void foreach_param(JsonValue obj, TFunc Func) const
     {
-        for (const auto &pdir : cell["port_directions"].object_items())
-            Func(pdir.first, lookup_portdir(pdir.second.string_value()));
+        foreach_property(text.member(obj, "parameters"), Func);
     }
 
-    template <typename TFunc> void foreach_port_conn(CellDataType &cell, TFunc Func) const
+    template <typename TFunc> void foreach_setting(const ModuleDataType &mod, TFunc Func) const
     {
-        for (const auto &pconn : cell["connections"].object_items())
-            Func(pconn.first, pconn.second.array_items());
+        foreach_property(mod.settings, Func);
     }
 
-    BitVectorDataType &get_net_bits(NetnameDataType &net) const { return net["bits"].array_items(); }
+    template <typename TFunc> void foreach_port_dir(const CellDataType &cell, TFunc Func) const
+    {
+        text.foreach_member(text.member(cell, "port_directions"), [&](const std::string &name, JsonValue dir) {
+            Func(name, lookup_portdir(text.get_string(dir)));
+        });
+    }
+
+    template <typename TFunc> void foreach_port_conn(const CellDataType &cell, TFunc Func) const
+    {
+        text.foreach_member(text.member(cell, "connections"),
+                            [&](const std::string &name, JsonValue conn) { Func(name, get_bits(conn)); });
+    }
+
+    BitVectorDataType get_net_bits(const NetnameDataType &net) const { return get_bits(text.member(net, "bits")); }
 
-    int get_vector_length(BitVectorDataType &bits) const { return int(bits.size()); }
+    int get_vector_length(const BitVectorDataType &bits) const { return int(bits.size()); }
 
-    bool is_vector_bit_constant(BitVectorDataType &bits, int i) const
+    bool is_vector_bit_constant(const BitVectorDataType &bits, int i) const
     {
         NPNR_ASSERT(i < int(bits.size()));
-        return bits[i].is_string();
+        return bits[i] < 0;
     }
 
-    char get_vector_bit_constval(BitVectorDataType &bits, int i) const
+    char get_vector_bit_constval(const BitVectorDataType &bits, int i) const
     {
-        auto s = bits.at(i).string_value();
-        NPNR_ASSERT(s.size() == 1);
-        return s.at(0);
+        int bit = bits.at(i);
+        NPNR_ASSERT(bit < 0);
+        return char(-bit);
     }
 
-    int get_vector_bit_signal(BitVectorDataType &bits, int i) const
+    int get_vector_bit_signal(const BitVectorDataType &bits, int i) const
     {
-        NPNR_ASSERT(bits.at(i).is_number());
-        return bits.at(i).int_value();
+        NPNR_ASSERT(bits.at(i) >= 0);
+        return bits.at(i);
     }
 };
 
+void parse_json_text(const char *begin, const char *end, const std::string &filename, Context *ctx)
+{
+    JsonText text(begin, end, filename);
+    JsonValue root = text.validate();
+    JsonValue modules = text.member(root, "modules");
+    if (modules.is_null() || !text.is_object(modules))
+        log_error("JSON file '%s' doesn't look like a netlist (doesn't contain \"modules\" key)\n", filename.c_str());
+    JsonFrontendImpl impl(text, modules);
+    GenericFrontend<JsonFrontendImpl>(ctx, impl)();
+}
+
+} // namespace
+
 bool parse_json(std::istream &in, const std::string &filename, Context *ctx)
 {
-    Json root;
-    {
-        if (!in)
-            log_error("Failed to open JSON file '%s'.\n", filename.c_str());
-        std::string json_str((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
-        std::string error;
-        root = Json::parse(json_str, error, JsonParse::COMMENTS);
-        if (root.is_null())
-            log_error("Failed to parse JSON file '%s': %s.\n", filename.c_str(), error.c_str());
-        root = root["modules"];
-        if (root.is_null())
-            log_error("JSON file '%s' doesn't look like a netlist (doesn't contain \"modules\" key)\n",
-                      filename.c_str());
-    }
-    GenericFrontend<JsonFrontendImpl>(ctx, JsonFrontendImpl(root))();
+    if (!in)
+        log_error("Failed to open JSON file '%s'.\n", filename.c_str());
+    std::string json_str((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    parse_json_text(json_str.data(), json_str.data() + json_str.size(), filename, ctx);
+    return true;
+}
+
+bool parse_json_file(const std::string &filename, Context *ctx)
+{
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(filename);
+    } catch (std::exception &) {
+        // Also covers empty files, which cannot be mapped
+        std::ifstream f(filename);
+        return parse_json(f, filename, ctx);
+    }
+    parse_json_text(file.data(), file.data() + file.size(), filename, ctx);
     return true;
 }
 
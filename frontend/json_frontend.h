@@ -22,5 +22,7 @@
 NEXTPNR_NAMESPACE_BEGIN
 
 bool parse_json(std::istream &in, const std::string &filename, Context *ctx);
+// Parse a JSON netlist straight from the memory-mapped file
+bool parse_json_file(const std::string &filename, Context *ctx);
 
 NEXTPNR_NAMESPACE_END
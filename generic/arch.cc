@@ -17,8 +17,11 @@
  *
  */
 
+#include <algorithm>
+#include <boost/functional/hash.hpp>
 #include <iostream>
 #include <math.h>
+#include "diskcache.h"
 #include "nextpnr.h"
 #include "placer1.h"
 #include "placer_heap.h"
@@ -60,6 +63,7 @@ void Arch::addWire(IdString name, IdString type, int x, int y)
     wi.type = type;
     wi.x = x;
     wi.y = y;
+    wi.index = int(wire_ids.size());
 
     wire_ids.push_back(name);
 }
@@ -86,7 +90,7 @@ void Arch::addPip(IdString name, IdString type, IdString srcWire, IdString dstWi
         tilePipDimZ[loc.x].resize(loc.y + 1);
 
     gridDimX = std::max(gridDimX, loc.x + 1);
-    gridDimY = std::max(gridDimY, loc.x + 1);
+    gridDimY = std::max(gridDimY, loc.y + 1);
     tilePipDimZ[loc.x][loc.y] = std::max(tilePipDimZ[loc.x][loc.y], loc.z + 1);
 }
 
@@ -134,7 +138,7 @@ void Arch::addBel(IdString name, IdString type, Loc loc, bool gb)
         tileBelDimZ[loc.x].resize(loc.y + 1);
 
     gridDimX = std::max(gridDimX, loc.x + 1);
-    gridDimY = std::max(gridDimY, loc.x + 1);
+    gridDimY = std::max(gridDimY, loc.y + 1);
     tileBelDimZ[loc.x][loc.y] = std::max(tileBelDimZ[loc.x][loc.y], loc.z + 1);
 }
 
@@ -226,36 +230,48 @@ void Arch::setDelayScaling(double scale, double offset)
     args.delayOffset = offset;
 }
 
-void Arch::addCellTimingClock(IdString cell, IdString port) { cellTiming[cell].portClasses[port] = TMG_CLOCK_INPUT; }
+// The constant drivers made by the packer are slices too, but have no timing: their outputs are false startpoints
+// rather than slice outputs
+const CellTiming *Arch::getCellTiming(const CellInfo *cell) const
+{
+    if (cell->name == packerGndName || cell->name == packerVccName)
+        return nullptr;
+    return cellTimings.get(cell);
+}
+
+void Arch::addCellTimingClock(IdString cell, IdString port) { cellTimings.cell_for_update(cell).add_clock(port); }
 
 void Arch::addCellTimingDelay(IdString cell, IdString fromPort, IdString toPort, DelayInfo delay)
 {
-    if (get_or_default(cellTiming[cell].portClasses, fromPort, TMG_IGNORE) == TMG_IGNORE)
-        cellTiming[cell].portClasses[fromPort] = TMG_COMB_INPUT;
-    if (get_or_default(cellTiming[cell].portClasses, toPort, TMG_IGNORE) == TMG_IGNORE)
-        cellTiming[cell].portClasses[toPort] = TMG_COMB_OUTPUT;
-    cellTiming[cell].combDelays[CellDelayKey{fromPort, toPort}] = delay;
+    cellTimings.cell_for_update(cell).add_delay(fromPort, toPort, delay);
 }
 
 void Arch::addCellTimingSetupHold(IdString cell, IdString port, IdString clock, DelayInfo setup, DelayInfo hold)
 {
-    TimingClockingInfo ci;
-    ci.clock_port = clock;
-    ci.edge = RISING_EDGE;
-    ci.setup = setup;
-    ci.hold = hold;
-    cellTiming[cell].clockingInfo[port].push_back(ci);
-    cellTiming[cell].portClasses[port] = TMG_REGISTER_INPUT;
+    cellTimings.cell_for_update(cell).add_setup_hold(port, clock, setup, hold);
 }
 
 void Arch::addCellTimingClockToOut(IdString cell, IdString port, IdString clock, DelayInfo clktoq)
 {
-    TimingClockingInfo ci;
-    ci.clock_port = clock;
-    ci.edge = RISING_EDGE;
-    ci.clockToQ = clktoq;
-    cellTiming[cell].clockingInfo[port].push_back(ci);
-    cellTiming[cell].portClasses[port] = TMG_REGISTER_OUTPUT;
+    cellTimings.cell_for_update(cell).add_clock_to_out(port, clock, clktoq);
+}
+
+void Arch::addCellTypeTimingClock(IdString type, IdString port) { cellTimings.type_for_update(type).add_clock(port); }
+
+void Arch::addCellTypeTimingDelay(IdString type, IdString fromPort, IdString toPort, DelayInfo delay)
+{
+    cellTimings.type_for_update(type).add_delay(fromPort, toPort, delay);
+}
+
+void Arch::addCellTypeTimingSetupHold(IdString type, IdString port, IdString clock, DelayInfo setup,
+                                      DelayInfo hold)
+{
+    cellTimings.type_for_update(type).add_setup_hold(port, clock, setup, hold);
+}
+
+void Arch::addCellTypeTimingClockToOut(IdString type, IdString port, IdString clock, DelayInfo clktoq)
+{
+    cellTimings.type_for_update(type).add_clock_to_out(port, clock, clktoq);
 }
 
 // ---------------------------------------------------------------
@@ -264,6 +280,8 @@ Arch::Arch(ArchArgs args) : chipName("generic"), args(args)
 {
     // Dummy for empty decals
     decal_graphics[IdString()];
+    packerGndName = id("$PACKER_GND");
+    packerVccName = id("$PACKER_VCC");
 }
 
 void IdString::initialize_arch(const BaseCtx *ctx) {}
@@ -339,6 +357,13 @@ WireId Arch::getBelPinWire(BelId bel, IdString pin) const
     return bdata.pins.at(pin).wire;
 }
 
+WireId Arch::findBelPinWire(BelId bel, IdString pin) const
+{
+    const auto &bdata = bels.at(bel);
+    auto found = bdata.pins.find(pin);
+    return found == bdata.pins.end() ? WireId() : found->second.wire;
+}
+
 PortType Arch::getBelPinType(BelId bel, IdString pin) const { return bels.at(bel).pins.at(pin).type; }
 
 std::vector<IdString> Arch::getBelPins(BelId bel) const
@@ -403,6 +428,10 @@ const std::vector<BelPin> &Arch::getWireBelPins(WireId wire) const { return wire
 
 const std::vector<WireId> &Arch::getWires() const { return wire_ids; }
 
+int Arch::getWireIndex(WireId wire) const { return wires.at(wire).index; }
+
+int Arch::getWireIndexCount() const { return int(wire_ids.size()); }
+
 // ---------------------------------------------------------------
 
 PipId Arch::getPipByName(IdString name) const
@@ -493,18 +522,55 @@ const std::vector<GroupId> &Arch::getGroupGroups(GroupId group) const { return g
 
 // ---------------------------------------------------------------
 
+void Arch::setupLookahead()
+{
+    if (lookahead.ready())
+        return;
+    // Generic devices are built by scripts rather than loaded from a database, so key the cached table on the
+    // structure of the routing graph itself
+    uint64_t key = 0;
+    for (auto wire : wire_ids) {
+        const WireInfo &wi = wires.at(wire);
+        boost::hash_combine(key, wi.name.str(this));
+        boost::hash_combine(key, wi.type.str(this));
+        boost::hash_combine(key, wi.x);
+        boost::hash_combine(key, wi.y);
+    }
+    for (auto pip : pip_ids) {
+        const PipInfo &pi = pips.at(pip);
+        boost::hash_combine(key, wires.at(pi.srcWire).index);
+        boost::hash_combine(key, wires.at(pi.dstWire).index);
+        boost::hash_combine(key, double(pi.delay.maxDelay()));
+    }
+    lookahead.init(getCtx(), get_cache_path(stringf("generic-%016llx.lookahead", (unsigned long long)key)), key,
+                   [&](WireId wire) {
+                       const WireInfo &wi = wires.at(wire);
+                       return Loc(wi.x, wi.y, 0);
+                   });
+}
+
 delay_t Arch::estimateDelay(WireId src, WireId dst) const
 {
     const WireInfo &s = wires.at(src);
     const WireInfo &d = wires.at(dst);
     int dx = abs(s.x - d.x);
     int dy = abs(s.y - d.y);
+    delay_t delay;
+    if (lookahead.lookup(s.type, dx, dy, delay))
+        return delay;
     return (dx + dy) * args.delayScale + args.delayOffset;
 }
 
 delay_t Arch::predictDelay(const NetInfo *net_info, const PortRef &sink) const
 {
     const auto &driver = net_info->driver;
+    if (lookahead.ready()) {
+        WireId src = findBelPinWire(driver.cell->bel, driver.port);
+        WireId dst = findBelPinWire(sink.cell->bel, sink.port);
+        if (src != WireId() && dst != WireId())
+            return estimateDelay(src, dst);
+    }
+
     auto driver_loc = getBelLocation(driver.cell->bel);
     auto sink_loc = getBelLocation(sink.cell->bel);
 
@@ -543,6 +609,8 @@ ArcBounds Arch::getRouteBoundingBox(WireId src, WireId dst) const
 
 bool Arch::place()
 {
+    setupLookahead();
+    cellTimings.intern();
     std::string placer = str_or_default(settings, id("placer"), defaultPlacer);
     if (placer == "heap") {
         bool have_iobuf_or_constr = false;
@@ -578,6 +646,8 @@ bool Arch::place()
 
 bool Arch::route()
 {
+    setupLookahead();
+    cellTimings.intern();
     std::string router = str_or_default(settings, id("router"), defaultRouter);
     bool result;
     if (router == "router1") {
@@ -616,11 +686,11 @@ DecalXY Arch::getGroupDecal(GroupId group) const { return groups.at(group).decal
 
 bool Arch::getCellDelay(const CellInfo *cell, IdString fromPort, IdString toPort, DelayInfo &delay) const
 {
-    if (!cellTiming.count(cell->name))
+    const CellTiming *tmg = getCellTiming(cell);
+    if (tmg == nullptr)
         return false;
-    const auto &tmg = cellTiming.at(cell->name);
-    auto fnd = tmg.combDelays.find(CellDelayKey{fromPort, toPort});
-    if (fnd != tmg.combDelays.end()) {
+    auto fnd = tmg->combDelays.find(CellDelayKey{fromPort, toPort});
+    if (fnd != tmg->combDelays.end()) {
         delay = fnd->second;
         return true;
     } else {
@@ -631,22 +701,20 @@ bool Arch::getCellDelay(const CellInfo *cell, IdString fromPort, IdString toPort
 // Get the port class, also setting clockPort if applicable
 TimingPortClass Arch::getPortTimingClass(const CellInfo *cell, IdString port, int &clockInfoCount) const
 {
-    if (!cellTiming.count(cell->name))
+    const CellTiming *tmg = getCellTiming(cell);
+    if (tmg == nullptr)
         return TMG_IGNORE;
-    const auto &tmg = cellTiming.at(cell->name);
-    if (tmg.clockingInfo.count(port))
-        clockInfoCount = int(tmg.clockingInfo.at(port).size());
-    else
-        clockInfoCount = 0;
-    return get_or_default(tmg.portClasses, port, TMG_IGNORE);
+    auto fnd = tmg->clockingInfo.find(port);
+    clockInfoCount = fnd != tmg->clockingInfo.end() ? int(fnd->second.size()) : 0;
+    return tmg->port_class(port);
 }
 
 TimingClockingInfo Arch::getPortClockingInfo(const CellInfo *cell, IdString port, int index) const
 {
-    NPNR_ASSERT(cellTiming.count(cell->name));
-    const auto &tmg = cellTiming.at(cell->name);
-    NPNR_ASSERT(tmg.clockingInfo.count(port));
-    return tmg.clockingInfo.at(port).at(index);
+    const CellTiming *tmg = getCellTiming(cell);
+    NPNR_ASSERT(tmg != nullptr);
+    NPNR_ASSERT(tmg->clockingInfo.count(port));
+    return tmg->clockingInfo.at(port).at(index);
 }
 
 bool Arch::isValidBelForCell(CellInfo *cell, BelId bel) const
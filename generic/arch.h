@@ -21,6 +21,9 @@
 #error Include "arch.h" via "nextpnr.h" only.
 #endif
 
+#include "cell_timing.h"
+#include "lookahead.h"
+
 NEXTPNR_NAMESPACE_BEGIN
 
 struct ArchArgs
@@ -56,6 +59,7 @@ struct WireInfo
     std::vector<BelPin> bel_pins;
     DecalXY decalxy;
     int x, y;
+    int index;
 };
 
 struct PinInfo
@@ -86,33 +90,6 @@ struct GroupInfo
     DecalXY decalxy;
 };
 
-struct CellDelayKey
-{
-    IdString from, to;
-    inline bool operator==(const CellDelayKey &other) const { return from == other.from && to == other.to; }
-};
-
-NEXTPNR_NAMESPACE_END
-namespace std {
-template <> struct hash<NEXTPNR_NAMESPACE_PREFIX CellDelayKey>
-{
-    std::size_t operator()(const NEXTPNR_NAMESPACE_PREFIX CellDelayKey &dk) const noexcept
-    {
-        std::size_t seed = std::hash<NEXTPNR_NAMESPACE_PREFIX IdString>()(dk.from);
-        seed ^= std::hash<NEXTPNR_NAMESPACE_PREFIX IdString>()(dk.to) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        return seed;
-    }
-};
-} // namespace std
-NEXTPNR_NAMESPACE_BEGIN
-
-struct CellTiming
-{
-    std::unordered_map<IdString, TimingPortClass> portClasses;
-    std::unordered_map<CellDelayKey, DelayInfo> combDelays;
-    std::unordered_map<IdString, std::vector<TimingClockingInfo>> clockingInfo;
-};
-
 struct Arch : BaseCtx
 {
     std::string chipName;
@@ -134,11 +111,14 @@ struct Arch : BaseCtx
 
     std::unordered_map<DecalId, std::vector<GraphicElement>> decal_graphics;
 
-    int gridDimX, gridDimY;
+    int gridDimX = 0, gridDimY = 0;
     std::vector<std::vector<int>> tileBelDimZ;
     std::vector<std::vector<int>> tilePipDimZ;
 
-    std::unordered_map<IdString, CellTiming> cellTiming;
+    CellTimingStore cellTimings;
+    // Names of the constant drivers made by the packer
+    IdString packerGndName, packerVccName;
+    const CellTiming *getCellTiming(const CellInfo *cell) const;
 
     void addWire(IdString name, IdString type, int x, int y);
     void addPip(IdString name, IdString type, IdString srcWire, IdString dstWire, DelayInfo delay, Loc loc);
@@ -172,6 +152,11 @@ struct Arch : BaseCtx
     void addCellTimingSetupHold(IdString cell, IdString port, IdString clock, DelayInfo setup, DelayInfo hold);
     void addCellTimingClockToOut(IdString cell, IdString port, IdString clock, DelayInfo clktoq);
 
+    void addCellTypeTimingClock(IdString type, IdString port);
+    void addCellTypeTimingDelay(IdString type, IdString fromPort, IdString toPort, DelayInfo delay);
+    void addCellTypeTimingSetupHold(IdString type, IdString port, IdString clock, DelayInfo setup, DelayInfo hold);
+    void addCellTypeTimingClockToOut(IdString type, IdString port, IdString clock, DelayInfo clktoq);
+
     // ---------------------------------------------------------------
     // Common Arch API. Every arch must provide the following methods.
 
@@ -205,6 +190,8 @@ struct Arch : BaseCtx
     IdString getBelType(BelId bel) const;
     const std::map<IdString, std::string> &getBelAttrs(BelId bel) const;
     WireId getBelPinWire(BelId bel, IdString pin) const;
+    // As getBelPinWire, but returns WireId() if the bel has no such pin
+    WireId findBelPinWire(BelId bel, IdString pin) const;
     PortType getBelPinType(BelId bel, IdString pin) const;
     std::vector<IdString> getBelPins(BelId bel) const;
 
@@ -221,6 +208,8 @@ struct Arch : BaseCtx
     NetInfo *getConflictingWireNet(WireId wire) const;
     DelayInfo getWireDelay(WireId wire) const { return DelayInfo(); }
     const std::vector<WireId> &getWires() const;
+    int getWireIndex(WireId wire) const;
+    int getWireIndexCount() const;
     const std::vector<BelPin> &getWireBelPins(WireId wire) const;
 
     PipId getPipByName(IdString name) const;
@@ -251,6 +240,10 @@ struct Arch : BaseCtx
     const std::vector<PipId> &getGroupPips(GroupId group) const;
     const std::vector<GroupId> &getGroupGroups(GroupId group) const;
 
+    // Routing delay table, built (or loaded from the cache) on the first place or route
+    DelayLookahead lookahead;
+    void setupLookahead();
+
     delay_t estimateDelay(WireId src, WireId dst) const;
     delay_t predictDelay(const NetInfo *net_info, const PortRef &sink) const;
     delay_t getDelayEpsilon() const { return 0.001; }
@@ -141,8 +141,8 @@ void arch_wrap_python(py::module &m)
     fn_wrapper_3a<Context, decltype(&Context::constructDecalXY), &Context::constructDecalXY, wrap_context<DecalXY>,
                   conv_from_str<DecalId>, pass_through<float>, pass_through<float>>::def_wrap(ctx_cls, "DecalXY");
 
-    typedef std::unordered_map<IdString, std::unique_ptr<CellInfo>> CellMap;
-    typedef std::unordered_map<IdString, std::unique_ptr<NetInfo>> NetMap;
+    typedef IndexedStore<CellInfo> CellMap;
+    typedef IndexedStore<NetInfo> NetMap;
     typedef std::unordered_map<IdString, HierarchicalCell> HierarchyMap;
 
     readonly_wrapper<Context, decltype(&Context::cells), &Context::cells, wrap_context<CellMap &>>::def_wrap(ctx_cls,
@@ -231,6 +231,21 @@ void arch_wrap_python(py::module &m)
                     conv_from_str<IdString>, conv_from_str<IdString>, conv_from_str<IdString>,
                     pass_through<DelayInfo>>::def_wrap(ctx_cls, "addCellTimingClockToOut", "cell"_a, "port"_a,
                                                        "clock"_a, "clktoq"_a);
+    fn_wrapper_2a_v<Context, decltype(&Context::addCellTypeTimingClock), &Context::addCellTypeTimingClock,
+                    conv_from_str<IdString>, conv_from_str<IdString>>::def_wrap(ctx_cls, "addCellTypeTimingClock",
+                                                                                "type"_a, "port"_a);
+    fn_wrapper_4a_v<Context, decltype(&Context::addCellTypeTimingDelay), &Context::addCellTypeTimingDelay,
+                    conv_from_str<IdString>, conv_from_str<IdString>, conv_from_str<IdString>,
+                    pass_through<DelayInfo>>::def_wrap(ctx_cls, "addCellTypeTimingDelay", "type"_a, "fromPort"_a,
+                                                       "toPort"_a, "delay"_a);
+    fn_wrapper_5a_v<Context, decltype(&Context::addCellTypeTimingSetupHold), &Context::addCellTypeTimingSetupHold,
+                    conv_from_str<IdString>, conv_from_str<IdString>, conv_from_str<IdString>, pass_through<DelayInfo>,
+                    pass_through<DelayInfo>>::def_wrap(ctx_cls, "addCellTypeTimingSetupHold", "type"_a, "port"_a,
+                                                       "clock"_a, "setup"_a, "hold"_a);
+    fn_wrapper_4a_v<Context, decltype(&Context::addCellTypeTimingClockToOut), &Context::addCellTypeTimingClockToOut,
+                    conv_from_str<IdString>, conv_from_str<IdString>, conv_from_str<IdString>,
+                    pass_through<DelayInfo>>::def_wrap(ctx_cls, "addCellTypeTimingClockToOut", "type"_a, "port"_a,
+                                                       "clock"_a, "clktoq"_a);
 
     WRAP_MAP_UPTR(m, CellMap, "IdCellMap");
     WRAP_MAP_UPTR(m, NetMap, "IdNetMap");
@@ -1,13 +1,13 @@
+# Every slice has the same timing, so it is set once for the cell type rather than for each cell
+K = 4
 for cname, cell in ctx.cells:
-    if cell.type != "GENERIC_SLICE":
-        continue
-    if cname in ("$PACKER_GND", "$PACKER_VCC"):
-        continue
-    K = int(cell.params["K"])
-    ctx.addCellTimingClock(cell=cname, port="CLK")
-    for i in range(K):
-        ctx.addCellTimingSetupHold(cell=cname, port="I[%d]" % i, clock="CLK",
-            setup=ctx.getDelayFromNS(0.2), hold=ctx.getDelayFromNS(0))
-    ctx.addCellTimingClockToOut(cell=cname, port="Q", clock="CLK", clktoq=ctx.getDelayFromNS(0.2))
-    for i in range(K):
-        ctx.addCellTimingDelay(cell=cname, fromPort="I[%d]" % i, toPort="F", delay=ctx.getDelayFromNS(0.2))
+    if cell.type == "GENERIC_SLICE":
+        K = int(cell.params["K"])
+        break
+ctx.addCellTypeTimingClock(type="GENERIC_SLICE", port="CLK")
+for i in range(K):
+    ctx.addCellTypeTimingSetupHold(type="GENERIC_SLICE", port="I[%d]" % i, clock="CLK",
+        setup=ctx.getDelayFromNS(0.2), hold=ctx.getDelayFromNS(0))
+ctx.addCellTypeTimingClockToOut(type="GENERIC_SLICE", port="Q", clock="CLK", clktoq=ctx.getDelayFromNS(0.2))
+for i in range(K):
+    ctx.addCellTypeTimingDelay(type="GENERIC_SLICE", fromPort="I[%d]" % i, toPort="F", delay=ctx.getDelayFromNS(0.2))
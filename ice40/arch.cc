@@ -111,6 +111,7 @@ Arch::Arch(ArchArgs args) : args(args)
         log_error("Unsupported package '%s'.\n", args.package.c_str());
 
     bel_carry.resize(chip_info->num_bels);
+    logic_tile_status.resize(chip_info->width * chip_info->height);
     bel_to_cell.resize(chip_info->num_bels);
     wire_to_net.resize(chip_info->num_wires);
     pip_to_net.resize(chip_info->num_pips);
@@ -1230,6 +1231,7 @@ void Arch::assignArchInfo()
         CellInfo *ci = cell.second.get();
         assignCellInfo(ci);
     }
+    rebuildLogicTileStatus();
 }
 
 void Arch::assignCellInfo(CellInfo *cell)
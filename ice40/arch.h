@@ -410,12 +410,33 @@ struct Arch : BaseCtx
     mutable std::unordered_map<IdString, int> pip_by_name;
     mutable std::unordered_map<Loc, int> bel_by_loc;
 
-    std::vector<bool> bel_carry;
+    // Not std::vector<bool>, so that bels can be bound from several threads at once
+    std::vector<uint8_t> bel_carry;
     std::vector<CellInfo *> bel_to_cell;
     std::vector<NetInfo *> wire_to_net;
     std::vector<NetInfo *> pip_to_net;
     std::vector<WireId> switches_locked;
 
+    // Summary of the logic cells bound in each logic tile, kept up to date by bindBel and unbindBel so that the
+    // validity checks in arch_place.cc do not have to gather and recheck every cell in the tile
+    struct LogicDffConfig
+    {
+        const NetInfo *clk = nullptr, *cen = nullptr, *sr = nullptr;
+        bool neg_clk = false;
+        bool operator==(const LogicDffConfig &other) const
+        {
+            return clk == other.clk && cen == other.cen && sr == other.sr && neg_clk == other.neg_clk;
+        }
+    };
+    struct LogicTileStatus
+    {
+        // DFF configurations used in the tile, with the number of cells using each. A legal tile has at most
+        // one; there are only more while the placer is trying out a move.
+        std::vector<std::pair<LogicDffConfig, int>> dff_configs;
+        int input_count = 0;
+    };
+    std::vector<LogicTileStatus> logic_tile_status;
+
     ArchArgs args;
     Arch(ArchArgs args);
 
@@ -454,6 +475,8 @@ struct Arch : BaseCtx
 
         bel_to_cell[bel.index] = cell;
         bel_carry[bel.index] = (cell->type == id_ICESTORM_LC && cell->lcInfo.carryEnable);
+        if (cell->type == id_ICESTORM_LC)
+            updateLogicTile(bel, cell, 1);
         cell->bel = bel;
         cell->belStrength = strength;
         refreshUiBel(bel);
@@ -463,6 +486,8 @@ struct Arch : BaseCtx
     {
         NPNR_ASSERT(bel != BelId());
         NPNR_ASSERT(bel_to_cell[bel.index] != nullptr);
+        if (bel_to_cell[bel.index]->type == id_ICESTORM_LC)
+            updateLogicTile(bel, bel_to_cell[bel.index], -1);
         bel_to_cell[bel.index]->bel = BelId();
         bel_to_cell[bel.index]->belStrength = STRENGTH_NONE;
         bel_to_cell[bel.index] = nullptr;
@@ -618,6 +643,9 @@ struct Arch : BaseCtx
         return range;
     }
 
+    int getWireIndex(WireId wire) const { return wire.index; }
+    int getWireIndexCount() const { return chip_info->num_wires; }
+
     // -------------------------------------------------
 
     PipId getPipByName(IdString name) const;
@@ -868,6 +896,13 @@ struct Arch : BaseCtx
     // Helper function for above
     bool logicCellsCompatible(const CellInfo **it, const size_t size) const;
 
+    // Whether a logic tile stays legal if one cell is removed from it and another added (either may be nullptr),
+    // checked against its LogicTileStatus in constant time
+    bool logicTileCompatible(BelId bel, const CellInfo *removed, const CellInfo *added) const;
+    void updateLogicTile(BelId bel, const CellInfo *cell, int delta);
+    // Recompute the status of all logic tiles, after the lcInfo of bound cells has changed
+    void rebuildLogicTileStatus();
+
     // -------------------------------------------------
     // Assign architecure-specific arguments to nets and cells, which must be
     // called between packing or further
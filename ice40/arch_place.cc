@@ -70,18 +70,103 @@ bool Arch::logicCellsCompatible(const CellInfo **it, const size_t size) const
     return locals_count <= 32;
 }
 
+static Arch::LogicDffConfig lc_dff_config(const CellInfo *cell)
+{
+    Arch::LogicDffConfig config;
+    config.clk = cell->lcInfo.clk;
+    config.cen = cell->lcInfo.cen;
+    config.sr = cell->lcInfo.sr;
+    config.neg_clk = cell->lcInfo.negClk;
+    return config;
+}
+
+void Arch::updateLogicTile(BelId bel, const CellInfo *cell, int delta)
+{
+    auto &bd = chip_info->bel_data[bel.index];
+    LogicTileStatus &ts = logic_tile_status[bd.y * chip_info->width + bd.x];
+    ts.input_count += delta * cell->lcInfo.inputCount;
+    if (!cell->lcInfo.dffEnable)
+        return;
+    LogicDffConfig config = lc_dff_config(cell);
+    for (auto it = ts.dff_configs.begin(); it != ts.dff_configs.end(); ++it) {
+        if (it->first == config) {
+            it->second += delta;
+            if (it->second <= 0)
+                ts.dff_configs.erase(it);
+            return;
+        }
+    }
+    if (delta > 0)
+        ts.dff_configs.emplace_back(config, delta);
+}
+
+void Arch::rebuildLogicTileStatus()
+{
+    for (auto &ts : logic_tile_status) {
+        ts.dff_configs.clear();
+        ts.input_count = 0;
+    }
+    for (int i = 0; i < chip_info->num_bels; i++) {
+        const CellInfo *ci = bel_to_cell[i];
+        if (ci != nullptr && ci->type == id_ICESTORM_LC) {
+            BelId bel;
+            bel.index = i;
+            updateLogicTile(bel, ci, 1);
+        }
+    }
+}
+
+// Equivalent to logicCellsCompatible on the cells of the tile, with removed taken out and added put in
+bool Arch::logicTileCompatible(BelId bel, const CellInfo *removed, const CellInfo *added) const
+{
+    auto &bd = chip_info->bel_data[bel.index];
+    const LogicTileStatus &ts = logic_tile_status[bd.y * chip_info->width + bd.x];
+
+    int locals_count = ts.input_count;
+    bool removed_dff = removed != nullptr && removed->lcInfo.dffEnable;
+    LogicDffConfig removed_config, config;
+    if (removed_dff)
+        removed_config = lc_dff_config(removed);
+    int num_configs = 0;
+    for (auto &dc : ts.dff_configs) {
+        int count = dc.second;
+        if (removed_dff && dc.first == removed_config)
+            --count;
+        if (count > 0) {
+            if (++num_configs > 1)
+                return false;
+            config = dc.first;
+        }
+    }
+    if (added != nullptr && added->lcInfo.dffEnable) {
+        LogicDffConfig added_config = lc_dff_config(added);
+        if (num_configs == 0) {
+            config = added_config;
+            num_configs = 1;
+        } else if (!(config == added_config)) {
+            return false;
+        }
+    }
+
+    if (removed != nullptr)
+        locals_count -= removed->lcInfo.inputCount;
+    if (added != nullptr)
+        locals_count += added->lcInfo.inputCount;
+    if (num_configs > 0) {
+        if (config.cen != nullptr && !config.cen->is_global)
+            locals_count++;
+        if (config.clk != nullptr && !config.clk->is_global)
+            locals_count++;
+        if (config.sr != nullptr && !config.sr->is_global)
+            locals_count++;
+    }
+    return locals_count <= 32;
+}
+
 bool Arch::isBelLocationValid(BelId bel) const
 {
     if (getBelType(bel) == id_ICESTORM_LC) {
-        std::array<const CellInfo *, 8> bel_cells;
-        size_t num_cells = 0;
-        Loc bel_loc = getBelLocation(bel);
-        for (auto bel_other : getBelsByTile(bel_loc.x, bel_loc.y)) {
-            CellInfo *ci_other = getBoundBelCell(bel_other);
-            if (ci_other != nullptr)
-                bel_cells[num_cells++] = ci_other;
-        }
-        return logicCellsCompatible(bel_cells.data(), num_cells);
+        return logicTileCompatible(bel, nullptr, nullptr);
     } else {
         CellInfo *ci = getBoundBelCell(bel);
         if (ci == nullptr)
@@ -107,19 +192,11 @@ bool Arch::isValidBelForCell(CellInfo *cell, BelId bel) const
 {
     if (cell->type == id_ICESTORM_LC) {
         NPNR_ASSERT(getBelType(bel) == id_ICESTORM_LC);
-
-        std::array<const CellInfo *, 8> bel_cells;
-        size_t num_cells = 0;
-
-        Loc bel_loc = getBelLocation(bel);
-        for (auto bel_other : getBelsByTile(bel_loc.x, bel_loc.y)) {
-            CellInfo *ci_other = getBoundBelCell(bel_other);
-            if (ci_other != nullptr && bel_other != bel)
-                bel_cells[num_cells++] = ci_other;
-        }
-
-        bel_cells[num_cells++] = cell;
-        return logicCellsCompatible(bel_cells.data(), num_cells);
+        // Whatever is bound at the bel itself is replaced by cell
+        const CellInfo *bound = getBoundBelCell(bel);
+        if (bound != nullptr && bound->type != id_ICESTORM_LC)
+            bound = nullptr;
+        return logicTileCompatible(bel, bound, cell);
     } else if (cell->type == id_SB_IO) {
         // Do not allow placement of input SB_IOs on blocks where there a PLL is outputting to.
 
@@ -0,0 +1,112 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <boost/filesystem.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "checkpoint.h"
+#include "gtest/gtest.h"
+#include "nextpnr.h"
+#include "test_fabric.h"
+#include "timing.h"
+
+USING_NEXTPNR_NAMESPACE
+
+class CheckpointTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("nextpnr-%%%%%%%%.ckpt"))
+                           .string();
+    }
+
+    virtual void TearDown() { boost::filesystem::remove(filename); }
+
+    // As for generic's --load-checkpoint, the device is built before the checkpoint is loaded
+    std::unique_ptr<Context> new_context()
+    {
+        std::unique_ptr<Context> ctx(new Context(chipArgs));
+        fabric.build(ctx.get());
+        return ctx;
+    }
+
+    // Each context has its own IdStrings, so compare properties by name
+    static std::map<std::string, std::string> describe(const Context *ctx,
+                                                       const std::unordered_map<IdString, Property> &props)
+    {
+        std::map<std::string, std::string> result;
+        for (auto &prop : props)
+            result[prop.first.str(ctx)] = prop.second.to_string();
+        return result;
+    }
+
+    ArchArgs chipArgs;
+    TestFabric fabric;
+    std::string filename;
+};
+
+TEST_F(CheckpointTest, round_trip)
+{
+    auto ctx = new_context();
+    setup_test_settings(ctx.get());
+    load_test_design(ctx.get(), make_test_design(60, 20));
+    ASSERT_TRUE(ctx->pack());
+    assign_budget(ctx.get(), true);
+    ASSERT_TRUE(ctx->place());
+    ASSERT_TRUE(ctx->route());
+    ASSERT_TRUE(write_checkpoint(ctx.get(), filename));
+
+    std::unordered_map<std::string, Property> settings;
+    ASSERT_TRUE(read_checkpoint_settings(filename, settings));
+    ASSERT_EQ(settings.at("arch.name").as_string(), "generic");
+    ASSERT_EQ(settings.count("route"), size_t(1));
+
+    auto loaded = new_context();
+    ASSERT_TRUE(read_checkpoint(loaded.get(), filename));
+    ASSERT_EQ(describe(loaded.get(), loaded->settings), describe(ctx.get(), ctx->settings));
+    ASSERT_EQ(describe_placement(loaded.get()), describe_placement(ctx.get()));
+    ASSERT_EQ(describe_routing(loaded.get()), describe_routing(ctx.get()));
+    for (auto cell : sorted(ctx->cells)) {
+        const CellInfo *loaded_cell = loaded->cells.at(loaded->id(cell.first.str(ctx.get()))).get();
+        ASSERT_EQ(describe(loaded.get(), loaded_cell->params), describe(ctx.get(), cell.second->params));
+        ASSERT_EQ(describe(loaded.get(), loaded_cell->attrs), describe(ctx.get(), cell.second->attrs));
+        if (loaded_cell->bel != BelId()) {
+            ASSERT_EQ(loaded->getBoundBelCell(loaded_cell->bel), loaded_cell);
+        }
+    }
+    for (auto net : sorted(loaded->nets))
+        for (auto &wire : net.second->wires)
+            ASSERT_EQ(loaded->getBoundWireNet(wire.first), net.second);
+    loaded->check();
+}
+
+TEST_F(CheckpointTest, wrong_device)
+{
+    auto ctx = new_context();
+    setup_test_settings(ctx.get());
+    load_test_design(ctx.get(), make_test_design(10, 4));
+    ASSERT_TRUE(ctx->pack());
+    ASSERT_TRUE(write_checkpoint(ctx.get(), filename));
+
+    // A smaller device has a different number of wires
+    fabric.X = fabric.Y = 8;
+    auto other = new_context();
+    ASSERT_THROW(read_checkpoint(other.get(), filename), log_execution_error_exception);
+}
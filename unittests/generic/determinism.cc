@@ -0,0 +1,102 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nextpnr.h"
+#include "test_fabric.h"
+#include "timing.h"
+
+USING_NEXTPNR_NAMESPACE
+
+// With the same seed, the multi-threaded placers and router must give the same result whatever the number of threads
+class DeterminismTest : public ::testing::Test
+{
+  protected:
+    std::unique_ptr<Context> packed_context(const std::string &placer, int luts, int ffs)
+    {
+        std::unique_ptr<Context> ctx(new Context(chipArgs));
+        fabric.build(ctx.get());
+        setup_test_settings(ctx.get(), placer);
+        ctx->rngseed(1);
+        load_test_design(ctx.get(), make_test_design(luts, ffs));
+        EXPECT_TRUE(ctx->pack());
+        assign_budget(ctx.get(), true);
+        return ctx;
+    }
+
+    ArchArgs chipArgs;
+    TestFabric fabric;
+};
+
+TEST_F(DeterminismTest, heap_solve_threads)
+{
+    std::vector<std::string> expected;
+    for (int threads : {1, 2, 5}) {
+        auto ctx = packed_context("heap", 120, 40);
+        ctx->settings[ctx->id("placerHeap/threads")] = std::to_string(threads);
+        // A low threshold, so that this small design still has its equations split between threads
+        ctx->settings[ctx->id("placerHeap/minRowsPerThread")] = std::string("30");
+        ASSERT_TRUE(ctx->place());
+        auto placement = describe_placement(ctx.get());
+        if (threads == 1)
+            expected = placement;
+        else
+            ASSERT_EQ(placement, expected) << threads << " threads";
+    }
+}
+
+TEST_F(DeterminismTest, heap_legalise_threads)
+{
+    // Large enough for legalisation to be split into 2x2 windows
+    fabric.X = fabric.Y = 24;
+    std::vector<std::string> expected;
+    for (int threads : {1, 2, 5}) {
+        auto ctx = packed_context("heap", 300, 80);
+        ctx->settings[ctx->id("placerHeap/threads")] = std::to_string(threads);
+        // A low threshold, so that this small design is still legalised in windows
+        ctx->settings[ctx->id("placerHeap/minWindowCells")] = std::string("50");
+        ASSERT_TRUE(ctx->place());
+        auto placement = describe_placement(ctx.get());
+        if (threads == 1)
+            expected = placement;
+        else
+            ASSERT_EQ(placement, expected) << threads << " threads";
+    }
+}
+
+TEST_F(DeterminismTest, router2_threads)
+{
+    // router2 only partitions the design with at least 200 nets to route
+    fabric.X = fabric.Y = 20;
+    std::vector<std::string> expected;
+    for (int threads : {1, 2, 5}) {
+        auto ctx = packed_context("sa", 300, 80);
+        ASSERT_TRUE(ctx->place());
+        // Small partitions, so that the design is split into many regions routed in parallel
+        ctx->settings[ctx->id("router2/threads")] = std::to_string(threads);
+        ctx->settings[ctx->id("router2/partitionMinNets")] = std::string("8");
+        ASSERT_TRUE(ctx->route());
+        auto routing = describe_routing(ctx.get());
+        if (threads == 1)
+            expected = routing;
+        else
+            ASSERT_EQ(routing, expected) << threads << " threads";
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <boost/filesystem.hpp>
+#include <memory>
+#include <string>
+#include "checkpoint.h"
+#include "eco.h"
+#include "gtest/gtest.h"
+#include "nextpnr.h"
+#include "test_fabric.h"
+#include "timing.h"
+
+USING_NEXTPNR_NAMESPACE
+
+class EcoTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("nextpnr-%%%%%%%%.ckpt"))
+                           .string();
+        // The previous run, placed and routed, and the same run read back from its checkpoint
+        first = new_context();
+        setup_test_settings(first.get());
+        load_test_design(first.get(), make_test_design(60, 20));
+        ASSERT_TRUE(first->pack());
+        assign_budget(first.get(), true);
+        ASSERT_TRUE(first->place());
+        ASSERT_TRUE(first->route());
+        ASSERT_TRUE(write_checkpoint(first.get(), filename));
+        old_ctx = new_context();
+        ASSERT_TRUE(read_checkpoint(old_ctx.get(), filename));
+    }
+
+    virtual void TearDown() { boost::filesystem::remove(filename); }
+
+    // On generic, bels, wires and pips are IdStrings. Interning a few strings first gives them different indices
+    // than in the previous run, as they would have if the design had been loaded before the device was built.
+    std::unique_ptr<Context> new_context(int skew = 0)
+    {
+        std::unique_ptr<Context> ctx(new Context(chipArgs));
+        for (int i = 0; i < skew; i++)
+            ctx->id(stringf("eco_test_%d", i));
+        fabric.build(ctx.get());
+        return ctx;
+    }
+
+    // The new run of the same design, packed and ready for eco_reuse
+    std::unique_ptr<Context> new_run()
+    {
+        auto ctx = new_context(7);
+        setup_test_settings(ctx.get());
+        load_test_design(ctx.get(), make_test_design(60, 20));
+        EXPECT_TRUE(ctx->pack());
+        assign_budget(ctx.get(), true);
+        return ctx;
+    }
+
+    ArchArgs chipArgs;
+    TestFabric fabric;
+    std::string filename;
+    std::unique_ptr<Context> first, old_ctx;
+};
+
+TEST_F(EcoTest, unchanged_design)
+{
+    auto ctx = new_run();
+    EcoStats stats = eco_reuse(ctx.get(), old_ctx.get());
+    ASSERT_EQ(stats.kept_cells, int(ctx->cells.size()));
+    ASSERT_EQ(stats.new_cells, 0);
+    // Nets that had no routing, such as those with no users, are counted as new
+    int routed = 0;
+    for (auto net : sorted(first->nets))
+        routed += !net.second->wires.empty();
+    ASSERT_EQ(stats.kept_nets, routed);
+    eco_finish(ctx.get(), stats);
+    ASSERT_EQ(describe_placement(ctx.get()), describe_placement(first.get()));
+    ASSERT_EQ(describe_routing(ctx.get()), describe_routing(first.get()));
+    ctx->check();
+}
+
+TEST_F(EcoTest, changed_cell)
+{
+    auto ctx = new_run();
+    CellInfo *changed = nullptr;
+    for (auto cell : sorted(ctx->cells)) {
+        if (cell.second->type == ctx->id("GENERIC_SLICE")) {
+            changed = cell.second;
+            break;
+        }
+    }
+    ASSERT_NE(changed, nullptr);
+    changed->params[ctx->id("INIT")] = Property(0xbeef, 16);
+
+    EcoStats stats = eco_reuse(ctx.get(), old_ctx.get());
+    ASSERT_EQ(stats.kept_cells, int(ctx->cells.size()) - 1);
+    ASSERT_EQ(stats.new_cells, 1);
+    ASSERT_EQ(changed->bel, BelId());
+    for (auto &port : changed->ports) {
+        if (port.second.net != nullptr)
+            ASSERT_TRUE(port.second.net->wires.empty());
+    }
+    ASSERT_TRUE(ctx->place());
+    eco_finish(ctx.get(), stats);
+    ASSERT_TRUE(ctx->route());
+    ctx->check();
+
+    // Everything else is where it was
+    auto before = describe_placement(first.get()), after = describe_placement(ctx.get());
+    ASSERT_EQ(before.size(), after.size());
+    int moved = 0;
+    for (size_t i = 0; i < before.size(); i++)
+        moved += (before.at(i) != after.at(i));
+    ASSERT_LE(moved, 1);
+}
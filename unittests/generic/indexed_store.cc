@@ -0,0 +1,121 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nextpnr.h"
+#include "util.h"
+
+USING_NEXTPNR_NAMESPACE
+
+class IndexedStoreTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        ctx = new Context(chipArgs);
+        for (const char *name : {"c", "a", "d", "b"})
+            add(name);
+    }
+
+    virtual void TearDown() { delete ctx; }
+
+    void add(const std::string &name) { store[ctx->id(name)].reset(new std::string(name)); }
+
+    std::vector<std::string> names() const
+    {
+        std::vector<std::string> result;
+        for (auto &entry : store) {
+            EXPECT_EQ(entry.first.str(ctx), *entry.second);
+            result.push_back(entry.first.str(ctx));
+        }
+        return result;
+    }
+
+    ArchArgs chipArgs;
+    Context *ctx;
+    IndexedStore<std::string> store;
+};
+
+TEST_F(IndexedStoreTest, insertion_order)
+{
+    ASSERT_EQ(store.size(), size_t(4));
+    ASSERT_EQ(names(), std::vector<std::string>({"c", "a", "d", "b"}));
+    // Looking up an existing entry does not add or move it
+    ASSERT_EQ(*store[ctx->id("a")], "a");
+    ASSERT_EQ(names(), std::vector<std::string>({"c", "a", "d", "b"}));
+    ASSERT_EQ(store.count(ctx->id("e")), size_t(0));
+    ASSERT_TRUE(store.find(ctx->id("e")) == store.end());
+    ASSERT_EQ(*store.find(ctx->id("d"))->second, "d");
+}
+
+TEST_F(IndexedStoreTest, erase)
+{
+    int index_b = store.index_of(ctx->id("b"));
+    ASSERT_EQ(store.erase(ctx->id("a")), size_t(1));
+    ASSERT_EQ(store.erase(ctx->id("a")), size_t(0));
+    ASSERT_EQ(store.erase(ctx->id("c")), size_t(1));
+    ASSERT_EQ(store.size(), size_t(2));
+    ASSERT_EQ(names(), std::vector<std::string>({"d", "b"}));
+    ASSERT_EQ(store.count(ctx->id("a")), size_t(0));
+    ASSERT_EQ(store.index_of(ctx->id("a")), -1);
+
+    // Indices of the remaining entries are stable, and the tombstones are not reused
+    ASSERT_EQ(store.index_of(ctx->id("b")), index_b);
+    ASSERT_EQ(store.value_at(store.index_of(ctx->id("b"))), store.at(ctx->id("b")).get());
+    add("a");
+    ASSERT_EQ(names(), std::vector<std::string>({"d", "b", "a"}));
+    ASSERT_EQ(store.index_of(ctx->id("a")), 4);
+    ASSERT_EQ(store.index_limit(), 5);
+    ASSERT_EQ(store.value_at(0), nullptr);
+    ASSERT_EQ(store.value_at(1), nullptr);
+
+    store.clear();
+    ASSERT_TRUE(store.empty());
+    ASSERT_EQ(store.index_limit(), 0);
+    ASSERT_TRUE(store.begin() == store.end());
+}
+
+TEST_F(IndexedStoreTest, generation)
+{
+    uint64_t gen = store.generation();
+    store[ctx->id("a")];
+    ASSERT_EQ(store.generation(), gen);
+    // Replacing an entry with another keeps the size, but must still be seen as a change
+    store.erase(ctx->id("a"));
+    add("e");
+    ASSERT_EQ(store.size(), size_t(4));
+    ASSERT_NE(store.generation(), gen);
+}
+
+TEST_F(IndexedStoreTest, ordered_view)
+{
+    // Entries may be erased and added while iterating: erased ones not yet reached are skipped, and new ones are not
+    // visited
+    std::vector<std::string> visited;
+    for (auto entry : sorted(store)) {
+        visited.push_back(entry.first.str(ctx));
+        ASSERT_EQ(*entry.second, entry.first.str(ctx));
+        if (entry.first == ctx->id("c")) {
+            store.erase(ctx->id("d"));
+            add("e");
+        }
+    }
+    ASSERT_EQ(visited, std::vector<std::string>({"c", "a", "b"}));
+    ASSERT_EQ(names(), std::vector<std::string>({"c", "a", "b", "e"}));
+}
@@ -0,0 +1,163 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nextpnr.h"
+#include "test_fabric.h"
+
+USING_NEXTPNR_NAMESPACE
+
+class JsonFrontendTest : public ::testing::Test
+{
+  protected:
+    std::unique_ptr<Context> load(const std::string &json, int threads = 1)
+    {
+        std::unique_ptr<Context> ctx(new Context(chipArgs));
+        ctx->settings[ctx->id("frontend/threads")] = std::to_string(threads);
+        load_test_design(ctx.get(), json);
+        return ctx;
+    }
+
+    // Everything about the netlist that the frontend decides, in order
+    static std::vector<std::string> describe(const Context *ctx)
+    {
+        std::vector<std::string> result;
+        for (auto cell : sorted(ctx->cells)) {
+            CellInfo *ci = cell.second;
+            result.push_back(ci->name.str(ctx) + " " + ci->type.str(ctx));
+            // IdString indices depend on which thread saw a name first, so sort by the name itself
+            std::vector<std::string> fields;
+            for (auto &param : ci->params)
+                fields.push_back("  " + param.first.str(ctx) + "=" + param.second.to_string());
+            for (auto &port : ci->ports)
+                fields.push_back("  " + port.first.str(ctx) + " " + std::to_string(int(port.second.type)) + " " +
+                                 (port.second.net ? port.second.net->name.str(ctx) : "-"));
+            std::sort(fields.begin(), fields.end());
+            result.insert(result.end(), fields.begin(), fields.end());
+        }
+        for (auto net : sorted(ctx->nets))
+            result.push_back(net.first.str(ctx) + " " + std::to_string(net.second->users.size()));
+        return result;
+    }
+
+    ArchArgs chipArgs;
+};
+
+TEST_F(JsonFrontendTest, parse)
+{
+    auto ctx = load(make_test_design(20, 10));
+    // 20 LUTs, 10 DFFs, and IO buffers for the clock, 4 inputs and 4 outputs
+    ASSERT_EQ(ctx->cells.size(), size_t(20 + 10 + 9));
+    ASSERT_EQ(ctx->cells.at(ctx->id("lut3"))->type, ctx->id("LUT"));
+    ASSERT_EQ(ctx->cells.at(ctx->id("ff0"))->type, ctx->id("DFF"));
+    ASSERT_EQ(ctx->cells.at(ctx->id("lut3"))->params.at(ctx->id("K")).as_int64(), 4);
+
+    for (auto cell : sorted(ctx->cells)) {
+        CellInfo *ci = cell.second;
+        if (ci->type != ctx->id("LUT"))
+            continue;
+        NetInfo *out = ci->ports.at(ctx->id("Q")).net;
+        ASSERT_NE(out, nullptr);
+        ASSERT_EQ(out->driver.cell, ci);
+        for (int k = 0; k < 4; k++) {
+            auto &port = ci->ports.at(ctx->id(stringf("I[%d]", k)));
+            ASSERT_EQ(port.type, PORT_IN);
+            ASSERT_NE(port.net, nullptr);
+        }
+    }
+    NetInfo *clk = ctx->cells.at(ctx->id("ff0"))->ports.at(ctx->id("CLK")).net;
+    ASSERT_NE(clk, nullptr);
+    ASSERT_EQ(clk->users.size(), size_t(10));
+}
+
+TEST_F(JsonFrontendTest, hierarchy)
+{
+    auto ctx = load(R"({
+  "modules": {
+    "top": {
+      "attributes": { "top": "00000000000000000000000000000001" },
+      "ports": { "a": { "direction": "input", "bits": [ 2 ] }, "y": { "direction": "output", "bits": [ 4 ] } },
+      "cells": {
+        "u0": { "type": "sub", "port_directions": { "A": "input", "Y": "output" },
+                "connections": { "A": [ 2 ], "Y": [ 3 ] } },
+        "u1": { "type": "sub", "port_directions": { "A": "input", "Y": "output" },
+                "connections": { "A": [ 3 ], "Y": [ 4 ] } }
+      },
+      "netnames": { "a": { "bits": [ 2 ] }, "mid": { "bits": [ 3 ] }, "y": { "bits": [ 4 ] } }
+    },
+    "sub": {
+      "ports": { "A": { "direction": "input", "bits": [ 2 ] }, "Y": { "direction": "output", "bits": [ 3 ] } },
+      "cells": {
+        "l0": { "type": "LUT", "parameters": { "K": 1, "INIT": "10" },
+                "port_directions": { "I[0]": "input", "Q": "output" },
+                "connections": { "I[0]": [ 2 ], "Q": [ 4 ] } },
+        "l1": { "type": "LUT", "parameters": { "K": 1, "INIT": "01" },
+                "port_directions": { "I[0]": "input", "Q": "output" },
+                "connections": { "I[0]": [ 4 ], "Q": [ 3 ] } }
+      },
+      "netnames": { "A": { "bits": [ 2 ] }, "t": { "bits": [ 4 ] }, "Y": { "bits": [ 3 ] } }
+    },
+    "unused": {
+      "ports": { },
+      "cells": { "l2": { "type": "LUT", "parameters": { }, "port_directions": { }, "connections": { } } },
+      "netnames": { }
+    }
+  }
+})");
+    ASSERT_EQ(ctx->top_module, ctx->id("top"));
+    for (const char *name : {"u0.l0", "u0.l1", "u1.l0", "u1.l1"})
+        ASSERT_EQ(ctx->cells.count(ctx->id(name)), size_t(1)) << name;
+    ASSERT_EQ(ctx->cells.count(ctx->id("l2")), size_t(0));
+    ASSERT_EQ(ctx->cells.at(ctx->id("u1.l0"))->params.at(ctx->id("INIT")).as_int64(), 2);
+    ASSERT_EQ(ctx->cells.at(ctx->id("u0.l0"))->hierpath, ctx->id("top/u0"));
+
+    // u0's output drives u1's input
+    NetInfo *mid = ctx->cells.at(ctx->id("u0.l1"))->ports.at(ctx->id("Q")).net;
+    ASSERT_NE(mid, nullptr);
+    ASSERT_EQ(mid->users.size(), size_t(1));
+    ASSERT_EQ(mid->users.at(0).cell, ctx->cells.at(ctx->id("u1.l0")).get());
+}
+
+TEST_F(JsonFrontendTest, threads)
+{
+    // Enough cells for several chunks of staged cells
+    std::string json = make_test_design(700, 200);
+    auto expected = describe(load(json, 1).get());
+    for (int threads : {2, 4, 7})
+        ASSERT_EQ(describe(load(json, threads).get()), expected) << threads << " threads";
+}
+
+TEST_F(JsonFrontendTest, thread_errors)
+{
+    // An error in a cell staged on a worker thread is reported once, from the calling thread
+    std::string json = make_test_design(700, 200);
+    std::string cell = "\"lut600\": { \"type\": \"LUT\",\n          \"parameters\": { \"K\": ";
+    size_t pos = json.find(cell);
+    ASSERT_NE(pos, std::string::npos);
+    pos += cell.size();
+    json.replace(pos, json.find(',', pos) - pos, "1e12");
+
+    for (int threads : {1, 4}) {
+        LogErrorCapture capture;
+        ASSERT_THROW(load(json, threads), log_execution_error_exception) << threads << " threads";
+        ASSERT_NE(capture.message.find("out-of-range integer parameter"), std::string::npos) << capture.message;
+    }
+}
@@ -0,0 +1,249 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef GENERIC_TEST_FABRIC_H
+#define GENERIC_TEST_FABRIC_H
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "json_frontend.h"
+#include "log.h"
+#include "nextpnr.h"
+#include "util.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Shared by the generic tests, which place and route without Python: a C++ version of generic/examples/simple.py
+// and a generator for small yosys-style JSON designs to run through it.
+
+struct TestFabric
+{
+    // Grid size including IOBs at edges
+    int X = 12, Y = 12;
+    // SLICEs per tile
+    int N = 4;
+    // LUT input count
+    int K = 4;
+    // 1/Fc for bel input wire pips, Q to local wire pips and local to neighbour local wire pips
+    int Si = 4, Sq = 4, Sl = 8;
+
+    int local_wires() const { return N * (K + 1) + 8; }
+
+    void build(Context *ctx) const
+    {
+        int Wl = local_wires();
+        auto is_io = [&](int x, int y) { return x == 0 || x == X - 1 || y == 0 || y == Y - 1; };
+        auto add_pip = [&](int x, int y, const std::string &src, const std::string &dst, const char *type) {
+            ctx->addPip(ctx->id(stringf("X%dY%d.%s.%s", x, y, src.c_str(), dst.c_str())), ctx->id(type), ctx->id(src),
+                        ctx->id(dst), ctx->getDelayFromNS(0.05), Loc(x, y, 0));
+        };
+
+        for (int x = 0; x < X; x++) {
+            for (int y = 0; y < Y; y++) {
+                // Bel port wires
+                for (int z = 0; z < N; z++) {
+                    ctx->addWire(ctx->id(stringf("X%dY%dZ%d_CLK", x, y, z)), ctx->id("BEL_CLK"), x, y);
+                    ctx->addWire(ctx->id(stringf("X%dY%dZ%d_Q", x, y, z)), ctx->id("BEL_Q"), x, y);
+                    ctx->addWire(ctx->id(stringf("X%dY%dZ%d_F", x, y, z)), ctx->id("BEL_F"), x, y);
+                    for (int i = 0; i < K; i++)
+                        ctx->addWire(ctx->id(stringf("X%dY%dZ%d_I%d", x, y, z, i)), ctx->id("BEL_I"), x, y);
+                }
+                // Local wires
+                for (int l = 0; l < Wl; l++)
+                    ctx->addWire(ctx->id(stringf("X%dY%d_LOCAL%d", x, y, l)), ctx->id("LOCAL"), x, y);
+                // Bels
+                if (is_io(x, y)) {
+                    if (x == y)
+                        continue;
+                    for (int z = 0; z < 2; z++) {
+                        IdString bel = ctx->id(stringf("X%dY%d_IO%d", x, y, z));
+                        ctx->addBel(bel, ctx->id("GENERIC_IOB"), Loc(x, y, z), false);
+                        ctx->addBelInput(bel, ctx->id("I"), ctx->id(stringf("X%dY%dZ%d_I0", x, y, z)));
+                        ctx->addBelInput(bel, ctx->id("EN"), ctx->id(stringf("X%dY%dZ%d_I1", x, y, z)));
+                        ctx->addBelOutput(bel, ctx->id("O"), ctx->id(stringf("X%dY%dZ%d_Q", x, y, z)));
+                    }
+                } else {
+                    for (int z = 0; z < N; z++) {
+                        IdString bel = ctx->id(stringf("X%dY%d_SLICE%d", x, y, z));
+                        ctx->addBel(bel, ctx->id("GENERIC_SLICE"), Loc(x, y, z), false);
+                        ctx->addBelInput(bel, ctx->id("CLK"), ctx->id(stringf("X%dY%dZ%d_CLK", x, y, z)));
+                        for (int k = 0; k < K; k++)
+                            ctx->addBelInput(bel, ctx->id(stringf("I[%d]", k)),
+                                             ctx->id(stringf("X%dY%dZ%d_I%d", x, y, z, k)));
+                        ctx->addBelOutput(bel, ctx->id("F"), ctx->id(stringf("X%dY%dZ%d_F", x, y, z)));
+                        ctx->addBelOutput(bel, ctx->id("Q"), ctx->id(stringf("X%dY%dZ%d_Q", x, y, z)));
+                    }
+                }
+            }
+        }
+
+        for (int x = 0; x < X; x++) {
+            for (int y = 0; y < Y; y++) {
+                // Bel input wires are driven by every Si'th local with an offset
+                auto create_input_pips = [&](const std::string &dst, int offset) {
+                    for (int i = offset % Si; i < Wl; i += Si)
+                        add_pip(x, y, stringf("X%dY%d_LOCAL%d", x, y, i), dst, "BEL_INPUT");
+                };
+                for (int z = 0; z < N; z++) {
+                    create_input_pips(stringf("X%dY%dZ%d_CLK", x, y, z), 0);
+                    for (int k = 0; k < K; k++)
+                        create_input_pips(stringf("X%dY%dZ%d_I%d", x, y, z, k), k % Si);
+                }
+                for (int l = 0; l < Wl; l++) {
+                    std::string dst = stringf("X%dY%d_LOCAL%d", x, y, l);
+                    // Bel outputs to locals
+                    for (int i = l % Sq; i < N; i += Sq) {
+                        add_pip(x, y, stringf("X%dY%dZ%d_F", x, y, i), dst, "BEL_OUTPUT");
+                        add_pip(x, y, stringf("X%dY%dZ%d_Q", x, y, i), dst, "BEL_OUTPUT");
+                    }
+                    // Neighbour locals to locals
+                    const int dx[] = {-1, -1, -1, 0, 0, 1, 1, 1}, dy[] = {-1, 0, 1, -1, 1, -1, 0, 1};
+                    const int offsets[] = {1, 2, 2, 3, 4, 5, 6, 7};
+                    for (int d = 0; d < 8; d++) {
+                        int nx = x + dx[d], ny = y + dy[d];
+                        if (nx < 0 || nx >= X || ny < 0 || ny >= Y)
+                            continue;
+                        for (int i = (l + offsets[d]) % Sl; i < Wl; i += Sl)
+                            add_pip(x, y, stringf("X%dY%d_LOCAL%d", nx, ny, i), dst, "NEIGHBOUR");
+                    }
+                }
+            }
+        }
+    }
+};
+
+// The settings that CommandHandler::setupContext would otherwise fill in
+inline void setup_test_settings(Context *ctx, const std::string &placer = "sa", const std::string &router = "router2")
+{
+    ctx->settings[ctx->id("target_freq")] = std::to_string(12e6);
+    ctx->settings[ctx->id("timing_driven")] = true;
+    ctx->settings[ctx->id("slack_redist_iter")] = 0;
+    ctx->settings[ctx->id("auto_freq")] = false;
+    ctx->settings[ctx->id("placer")] = placer;
+    ctx->settings[ctx->id("router")] = router;
+    ctx->settings[ctx->id("arch.name")] = std::string(ctx->archId().c_str(ctx));
+    ctx->settings[ctx->id("arch.type")] = std::string(ctx->archArgsToId(ctx->archArgs()).c_str(ctx));
+}
+
+// A design of LUTs and DFFs with pseudo-random connections, as yosys would write it. Signals are created in order:
+// the design's inputs, then each LUT followed by the DFFs it feeds. LUT inputs come from the few signals created just
+// before the LUT, so there are no combinational loops and the design is local enough to route on a small fabric.
+inline std::string make_test_design(int luts, int ffs, uint32_t seed = 1)
+{
+    const int num_inputs = 4, num_outputs = 4, window = 16;
+    auto rand = [&](int n) {
+        seed = seed * 1103515245U + 12345U;
+        return int((seed >> 8) % uint32_t(n));
+    };
+    // Bits 0 and 1 are the constants in yosys JSON
+    int clk_bit = 2, input_bit = 3, lut_bit = input_bit + num_inputs, ff_bit = lut_bit + luts;
+    auto bits = [](int bit) { return stringf("[ %d ]", bit); };
+    auto sep = [](int i) { return i > 0 ? ",\n" : "\n"; };
+
+    std::vector<int> signals, lut_signal(luts), ff_driver(ffs);
+    for (int i = 0; i < num_inputs; i++)
+        signals.push_back(input_bit + i);
+    for (int i = 0, ff = 0; i < luts; i++) {
+        lut_signal.at(i) = int(signals.size());
+        signals.push_back(lut_bit + i);
+        // Spread the DFFs evenly over the LUTs
+        for (; ff < ffs && int64_t(ff) * luts < int64_t(i + 1) * ffs; ff++) {
+            ff_driver.at(ff) = i;
+            signals.push_back(ff_bit + ff);
+        }
+    }
+
+    std::ostringstream out;
+    out << "{\n  \"modules\": {\n    \"top\": {\n";
+    out << "      \"attributes\": { \"top\": \"00000000000000000000000000000001\" },\n";
+    out << "      \"ports\": {\n";
+    out << "        \"clk\": { \"direction\": \"input\", \"bits\": " << bits(clk_bit) << " }";
+    for (int i = 0; i < num_inputs; i++)
+        out << ",\n        \"in" << i << "\": { \"direction\": \"input\", \"bits\": " << bits(input_bit + i) << " }";
+    for (int i = 0; i < num_outputs; i++)
+        out << ",\n        \"out" << i << "\": { \"direction\": \"output\", \"bits\": "
+            << bits(lut_bit + luts - 1 - i) << " }";
+    out << "\n      },\n      \"cells\": {";
+    for (int i = 0; i < luts; i++) {
+        out << sep(i) << "        \"lut" << i << "\": { \"type\": \"LUT\",\n";
+        out << "          \"parameters\": { \"K\": \"00000000000000000000000000000100\", \"INIT\": \"";
+        for (int b = 0; b < 16; b++)
+            out << rand(2);
+        out << "\" },\n";
+        out << "          \"port_directions\": { \"I[0]\": \"input\", \"I[1]\": \"input\", \"I[2]\": \"input\", "
+               "\"I[3]\": \"input\", \"Q\": \"output\" },\n";
+        out << "          \"connections\": { ";
+        int first = std::max(0, lut_signal.at(i) - window);
+        for (int k = 0; k < 4; k++)
+            out << "\"I[" << k << "]\": " << bits(signals.at(first + rand(lut_signal.at(i) - first))) << ", ";
+        out << "\"Q\": " << bits(lut_bit + i) << " } }";
+    }
+    for (int i = 0; i < ffs; i++) {
+        out << ",\n        \"ff" << i << "\": { \"type\": \"DFF\", \"parameters\": { },\n";
+        out << "          \"port_directions\": { \"CLK\": \"input\", \"D\": \"input\", \"Q\": \"output\" },\n";
+        out << "          \"connections\": { \"CLK\": " << bits(clk_bit) << ", \"D\": " << bits(lut_bit + ff_driver.at(i))
+            << ", \"Q\": " << bits(ff_bit + i) << " } }";
+    }
+    out << "\n      },\n      \"netnames\": {";
+    for (int bit = clk_bit; bit < ff_bit + ffs; bit++)
+        out << sep(bit - clk_bit) << "        \"n" << bit << "\": { \"bits\": " << bits(bit) << " }";
+    out << "\n      }\n    }\n  }\n}\n";
+    return out.str();
+}
+
+inline void load_test_design(Context *ctx, const std::string &json)
+{
+    std::istringstream in(json);
+    parse_json(in, "test.json", ctx);
+}
+
+// The bel and strength of each cell, in the order of ctx->cells
+inline std::vector<std::string> describe_placement(const Context *ctx)
+{
+    std::vector<std::string> result;
+    for (auto cell : sorted(ctx->cells)) {
+        const CellInfo *ci = cell.second;
+        result.push_back(stringf("%s %s %s %d", ci->name.c_str(ctx), ci->type.c_str(ctx),
+                                 ci->bel == BelId() ? "-" : ctx->getBelName(ci->bel).c_str(ctx), int(ci->belStrength)));
+    }
+    return result;
+}
+
+// The wires of each net, with the pip driving them and their strength, in the order of ctx->nets
+inline std::vector<std::string> describe_routing(const Context *ctx)
+{
+    std::vector<std::string> result;
+    for (auto net : sorted(ctx->nets)) {
+        const NetInfo *ni = net.second;
+        result.push_back(ni->name.str(ctx));
+        std::vector<std::string> wires;
+        for (auto &wire : ni->wires)
+            wires.push_back(stringf("  %s %s %d", ctx->getWireName(wire.first).c_str(ctx),
+                                    wire.second.pip == PipId() ? "-" : ctx->getPipName(wire.second.pip).c_str(ctx),
+                                    int(wire.second.strength)));
+        std::sort(wires.begin(), wires.end());
+        result.insert(result.end(), wires.begin(), wires.end());
+    }
+    return result;
+}
+
+NEXTPNR_NAMESPACE_END
+
+#endif
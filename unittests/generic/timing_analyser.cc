@@ -0,0 +1,178 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "design_utils.h"
+#include "gtest/gtest.h"
+#include "nextpnr.h"
+#include "test_fabric.h"
+#include "timing.h"
+
+USING_NEXTPNR_NAMESPACE
+
+// After each kind of change, an incremental update of a persistent TimingAnalyser must give the same result as one
+// built from scratch
+class TimingAnalyserTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        ctx.reset(new Context(chipArgs));
+        TestFabric().build(ctx.get());
+        setup_test_settings(ctx.get());
+        load_test_design(ctx.get(), make_test_design(60, 20));
+        ASSERT_TRUE(ctx->pack());
+        // As in examples/simple_timing.py
+        IdString slice = ctx->id("GENERIC_SLICE"), clk = ctx->id("CLK");
+        ctx->addCellTypeTimingClock(slice, clk);
+        for (int i = 0; i < 4; i++) {
+            IdString input = ctx->id(stringf("I[%d]", i));
+            ctx->addCellTypeTimingSetupHold(slice, input, clk, ctx->getDelayFromNS(0.2), ctx->getDelayFromNS(0));
+            ctx->addCellTypeTimingDelay(slice, input, ctx->id("F"), ctx->getDelayFromNS(0.2));
+        }
+        ctx->addCellTypeTimingClockToOut(slice, ctx->id("Q"), clk, ctx->getDelayFromNS(0.2));
+        ASSERT_TRUE(ctx->place());
+    }
+
+    NetCriticalityMap run(TimingAnalyser &analyser)
+    {
+        NetCriticalityMap crit;
+        analyser.run();
+        analyser.get_criticalities(&crit);
+        return crit;
+    }
+
+    NetCriticalityMap from_scratch()
+    {
+        TimingAnalyser analyser(ctx.get());
+        analyser.setup();
+        return run(analyser);
+    }
+
+    // Criticalities are compared exactly, as both analysers do the same arithmetic on the same delays
+    static bool same(const NetCriticalityMap &a, const NetCriticalityMap &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (auto &entry : a) {
+            auto fnd = b.find(entry.first);
+            if (fnd == b.end())
+                return false;
+            const NetCriticalityInfo &x = entry.second, &y = fnd->second;
+            if (x.slack != y.slack || x.criticality != y.criticality || x.max_path_length != y.max_path_length ||
+                x.cd_worst_slack != y.cd_worst_slack)
+                return false;
+        }
+        return true;
+    }
+
+    // Slices that are placed and timed, in netlist order
+    std::vector<CellInfo *> slices()
+    {
+        std::vector<CellInfo *> result;
+        for (auto cell : sorted(ctx->cells))
+            if (cell.second->type == ctx->id("GENERIC_SLICE") && cell.second->bel != BelId())
+                result.push_back(cell.second);
+        return result;
+    }
+
+    ArchArgs chipArgs;
+    std::unique_ptr<Context> ctx;
+};
+
+TEST_F(TimingAnalyserTest, from_scratch)
+{
+    auto crit = from_scratch();
+    ASSERT_FALSE(crit.empty());
+    bool any_critical = false;
+    for (auto &entry : crit) {
+        ASSERT_EQ(entry.second.slack.size(), ctx->nets.at(entry.first)->users.size());
+        for (float c : entry.second.criticality) {
+            ASSERT_GE(c, 0.0f);
+            ASSERT_LE(c, 1.0f);
+            any_critical |= (c == 1.0f);
+        }
+    }
+    ASSERT_TRUE(any_critical);
+    // get_criticalities keeps its analyser on the Context between calls
+    NetCriticalityMap via_ctx;
+    get_criticalities(ctx.get(), &via_ctx);
+    ASSERT_TRUE(same(via_ctx, crit));
+}
+
+TEST_F(TimingAnalyserTest, moved_cells)
+{
+    TimingAnalyser analyser(ctx.get());
+    analyser.setup();
+    auto before = run(analyser);
+
+    // Swap cells far apart, so that the delay estimates of their nets change
+    auto cells = slices();
+    ASSERT_GE(cells.size(), size_t(10));
+    for (size_t i = 0; i < 5; i++) {
+        CellInfo *a = cells.at(i), *b = cells.at(cells.size() - 1 - i);
+        BelId bel_a = a->bel, bel_b = b->bel;
+        ctx->unbindBel(bel_a);
+        ctx->unbindBel(bel_b);
+        ctx->bindBel(bel_b, a, STRENGTH_WEAK);
+        ctx->bindBel(bel_a, b, STRENGTH_WEAK);
+    }
+    auto after = run(analyser);
+    ASSERT_FALSE(same(after, before));
+    ASSERT_TRUE(same(after, from_scratch()));
+}
+
+TEST_F(TimingAnalyserTest, rerouted_nets)
+{
+    TimingAnalyser analyser(ctx.get());
+    analyser.setup();
+    auto before = run(analyser);
+
+    ASSERT_TRUE(ctx->route());
+    // No cell has moved, so the delays of the routed nets are only picked up once the nets are invalidated
+    ASSERT_TRUE(same(run(analyser), before));
+    for (auto net : sorted(ctx->nets))
+        analyser.invalidate_net(net.second);
+    auto after = run(analyser);
+    ASSERT_FALSE(same(after, before));
+    ASSERT_TRUE(same(after, from_scratch()));
+}
+
+TEST_F(TimingAnalyserTest, netlist_changes)
+{
+    TimingAnalyser analyser(ctx.get());
+    analyser.setup();
+    run(analyser);
+
+    // Removing a cell changes the generation of ctx->cells, so the graph is rebuilt without being told
+    CellInfo *removed = slices().at(3);
+    for (auto &port : removed->ports)
+        disconnect_port(ctx.get(), removed, port.first);
+    ctx->unbindBel(removed->bel);
+    ctx->cells.erase(removed->name);
+    ASSERT_TRUE(same(run(analyser), from_scratch()));
+
+    // Disconnecting a port does not, and needs invalidate()
+    CellInfo *cell = slices().at(5);
+    IdString port = ctx->id("I[0]");
+    ASSERT_NE(cell->ports.at(port).net, nullptr);
+    disconnect_port(ctx.get(), cell, port);
+    analyser.invalidate();
+    ASSERT_TRUE(same(run(analyser), from_scratch()));
+}